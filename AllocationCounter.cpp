@@ -0,0 +1,210 @@
+
+/** $VER: AllocationCounter.cpp (2026.10.17) P. Stuer - Counts the heap allocations of the calling thread. Host-independent. **/
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+static thread_local uint64_t _AllocationCount = 0;
+
+static void * Allocate(size_t size);
+static void * Allocate(size_t size, std::align_val_t alignment);
+static void FreeAligned(void * p) noexcept;
+
+/// <summary>
+/// Gets the number of allocations made by the calling thread.
+/// </summary>
+uint64_t AllocationCounter::Get() noexcept
+{
+    return _AllocationCount;
+}
+
+#pragma region operator new
+
+/// <summary>
+/// Replaces the global operator new.
+/// </summary>
+void * operator new(size_t size)
+{
+    return Allocate(size);
+}
+
+/// <summary>
+/// Replaces the global array operator new.
+/// </summary>
+void * operator new[](size_t size)
+{
+    return Allocate(size);
+}
+
+/// <summary>
+/// Replaces the global nothrow operator new.
+/// </summary>
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return Allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+/// <summary>
+/// Replaces the global nothrow array operator new.
+/// </summary>
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return Allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+/// <summary>
+/// Replaces the global aligned operator new.
+/// </summary>
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, alignment);
+}
+
+/// <summary>
+/// Replaces the global aligned array operator new.
+/// </summary>
+void * operator new[](size_t size, std::align_val_t alignment)
+{
+    return Allocate(size, alignment);
+}
+
+/// <summary>
+/// Replaces the global aligned nothrow operator new.
+/// </summary>
+void * operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return Allocate(size, alignment);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+/// <summary>
+/// Replaces the global aligned nothrow array operator new.
+/// </summary>
+void * operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return Allocate(size, alignment);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+#pragma endregion
+
+#pragma region operator delete
+
+// Replace all variants of the global operator delete so each allocation is freed by the function that matches its operator new.
+void operator delete(void * p) noexcept { ::free(p); }
+void operator delete[](void * p) noexcept { ::free(p); }
+void operator delete(void * p, size_t) noexcept { ::free(p); }
+void operator delete[](void * p, size_t) noexcept { ::free(p); }
+void operator delete(void * p, const std::nothrow_t &) noexcept { ::free(p); }
+void operator delete[](void * p, const std::nothrow_t &) noexcept { ::free(p); }
+
+void operator delete(void * p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void * p, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void * p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void * p, size_t, std::align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void * p, std::align_val_t, const std::nothrow_t &) noexcept { FreeAligned(p); }
+void operator delete[](void * p, std::align_val_t, const std::nothrow_t &) noexcept { FreeAligned(p); }
+
+#pragma endregion
+
+/// <summary>
+/// Counts and makes an allocation. Calls the new handler until the allocation succeeds or there is no handler.
+/// </summary>
+static void * Allocate(size_t size)
+{
+    ++_AllocationCount;
+
+    if (size == 0)
+        size = 1;
+
+    for (;;)
+    {
+        void * p = ::malloc(size);
+
+        if (p != nullptr)
+            return p;
+
+        std::new_handler Handler = std::get_new_handler();
+
+        if (Handler == nullptr)
+            throw std::bad_alloc();
+
+        Handler();
+    }
+}
+
+/// <summary>
+/// Counts and makes an aligned allocation. Calls the new handler until the allocation succeeds or there is no handler.
+/// </summary>
+static void * Allocate(size_t size, std::align_val_t alignment)
+{
+    ++_AllocationCount;
+
+    const size_t Alignment = (size_t) alignment;
+
+    // aligned_alloc() requires a size that is a multiple of the alignment.
+    size = (size == 0) ? Alignment : (size + Alignment - 1) & ~(Alignment - 1);
+
+    for (;;)
+    {
+    #ifdef _MSC_VER
+        void * p = ::_aligned_malloc(size, Alignment);
+    #else
+        void * p = std::aligned_alloc(Alignment, size);
+    #endif
+
+        if (p != nullptr)
+            return p;
+
+        std::new_handler Handler = std::get_new_handler();
+
+        if (Handler == nullptr)
+            throw std::bad_alloc();
+
+        Handler();
+    }
+}
+
+/// <summary>
+/// Frees an aligned allocation.
+/// </summary>
+static void FreeAligned(void * p) noexcept
+{
+#ifdef _MSC_VER
+    ::_aligned_free(p);
+#else
+    ::free(p);
+#endif
+}
@@ -0,0 +1,16 @@
+
+/** $VER: AllocationCounter.h (2026.10.16) P. Stuer - Counts the heap allocations of the calling thread. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// Counts the calls to the global operator new of this component per thread, including the array, nothrow and aligned variants. The difference of two readings on the same thread is the number of allocations made in between.
+/// Allocations made by the host or the CRT with malloc() are not counted.
+/// </summary>
+class AllocationCounter
+{
+public:
+    static uint64_t Get() noexcept;
+};
@@ -1,5 +1,5 @@
 
-/** $VER: configuration_t.cpp (2024.08.04) P. Stuer **/
+/** $VER: configuration_t.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -78,6 +78,47 @@ void configuration_t::Reset() noexcept
     _InPrivateMode = false;
 
     _ScrollbarStyle = ScrollbarStyle::Fluent;
+
+    _CallOnTimer = true;
+    _SampleFormat = SampleFormat::Float64;
+
+    _SpectrumEnabled = false;
+    _FFTSize = 4096;
+    _WindowFunction = WindowFunction::Hann;
+    _BandLayout = BandLayout::Logarithmic;
+    _BandCount = 64;
+    _MinFrequency = 20.;
+    _MaxFrequency = 20000.;
+    _AmplitudeScale = AmplitudeScale::Decibel;
+
+    _EnvelopeEnabled = false;
+    _EnvelopeBucketCount = 0;
+
+    _WaveformEnabled = false;
+
+    _FrameRate = 60;
+
+    _LoudnessEnabled = false;
+
+    _LevelsEnabled = false;
+    _MeterAttackTime = 0;
+    _MeterReleaseTime = 300;
+    _MeterPeakHoldTime = 1500;
+
+    _SpectrogramBudget = 0;
+
+    _StereoEnabled = false;
+    _StereoMapping = StereoMapping::Front;
+    _StereoPointCount = 512;
+
+    _OnsetsEnabled = false;
+
+    _WindowHop = 0;
+
+    _SilenceThreshold = -90;
+    _SilenceDelay = 500;
+
+    _EventLimit = 8;
 }
 
 /// <summary>
@@ -99,7 +140,48 @@ configuration_t & configuration_t::operator=(const configuration_t & other)
     _InPrivateMode = other._InPrivateMode;
 
     _ScrollbarStyle = other._ScrollbarStyle;
- 
+
+    _CallOnTimer = other._CallOnTimer;
+    _SampleFormat = other._SampleFormat;
+
+    _SpectrumEnabled = other._SpectrumEnabled;
+    _FFTSize = other._FFTSize;
+    _WindowFunction = other._WindowFunction;
+    _BandLayout = other._BandLayout;
+    _BandCount = other._BandCount;
+    _MinFrequency = other._MinFrequency;
+    _MaxFrequency = other._MaxFrequency;
+    _AmplitudeScale = other._AmplitudeScale;
+
+    _EnvelopeEnabled = other._EnvelopeEnabled;
+    _EnvelopeBucketCount = other._EnvelopeBucketCount;
+
+    _WaveformEnabled = other._WaveformEnabled;
+
+    _FrameRate = other._FrameRate;
+
+    _LoudnessEnabled = other._LoudnessEnabled;
+
+    _LevelsEnabled = other._LevelsEnabled;
+    _MeterAttackTime = other._MeterAttackTime;
+    _MeterReleaseTime = other._MeterReleaseTime;
+    _MeterPeakHoldTime = other._MeterPeakHoldTime;
+
+    _SpectrogramBudget = other._SpectrogramBudget;
+
+    _StereoEnabled = other._StereoEnabled;
+    _StereoMapping = other._StereoMapping;
+    _StereoPointCount = other._StereoPointCount;
+
+    _OnsetsEnabled = other._OnsetsEnabled;
+
+    _WindowHop = other._WindowHop;
+
+    _SilenceThreshold = other._SilenceThreshold;
+    _SilenceDelay = other._SilenceDelay;
+
+    _EventLimit = other._EventLimit;
+
     return *this;
 }
 
@@ -159,6 +241,106 @@ void configuration_t::Read(stream_reader * reader, size_t size, abort_callback &
         {
             uint32_t Value; reader->read_object_t(Value, abortHandler); _ScrollbarStyle = (ScrollbarStyle) Value;
         }
+
+        // Version 8, v0.3.0.0
+        if (Version >= 8)
+        {
+            reader->read_object_t(_CallOnTimer, abortHandler);
+        }
+
+        // Version 9, v0.3.0.0
+        if (Version >= 9)
+        {
+            uint32_t Value;
+
+            reader->read_object_t(_SpectrumEnabled, abortHandler);
+            reader->read_object_t(_FFTSize, abortHandler);
+            reader->read_object_t(Value, abortHandler); _WindowFunction = (WindowFunction) Value;
+            reader->read_object_t(Value, abortHandler); _BandLayout = (BandLayout) Value;
+            reader->read_object_t(_BandCount, abortHandler);
+            reader->read_object_t(_MinFrequency, abortHandler);
+            reader->read_object_t(_MaxFrequency, abortHandler);
+            reader->read_object_t(Value, abortHandler); _AmplitudeScale = (AmplitudeScale) Value;
+        }
+
+        // Version 10, v0.3.0.0
+        if (Version >= 10)
+        {
+            uint32_t Value; reader->read_object_t(Value, abortHandler); _SampleFormat = (SampleFormat) Value;
+        }
+
+        // Version 11, v0.3.0.0
+        if (Version >= 11)
+        {
+            reader->read_object_t(_EnvelopeEnabled, abortHandler);
+            reader->read_object_t(_EnvelopeBucketCount, abortHandler);
+        }
+
+        // Version 12, v0.3.0.0
+        if (Version >= 12)
+        {
+            reader->read_object_t(_WaveformEnabled, abortHandler);
+        }
+
+        // Version 13, v0.3.0.0
+        if (Version >= 13)
+        {
+            reader->read_object_t(_FrameRate, abortHandler);
+        }
+
+        // Version 14, v0.3.0.0
+        if (Version >= 14)
+        {
+            reader->read_object_t(_LoudnessEnabled, abortHandler);
+        }
+
+        // Version 15, v0.3.0.0
+        if (Version >= 15)
+        {
+            reader->read_object_t(_LevelsEnabled, abortHandler);
+            reader->read_object_t(_MeterAttackTime, abortHandler);
+            reader->read_object_t(_MeterReleaseTime, abortHandler);
+            reader->read_object_t(_MeterPeakHoldTime, abortHandler);
+        }
+
+        // Version 16, v0.3.0.0
+        if (Version >= 16)
+        {
+            reader->read_object_t(_SpectrogramBudget, abortHandler);
+        }
+
+        // Version 17, v0.3.0.0
+        if (Version >= 17)
+        {
+            reader->read_object_t(_StereoEnabled, abortHandler);
+            uint32_t Value; reader->read_object_t(Value, abortHandler); _StereoMapping = (StereoMapping) Value;
+            reader->read_object_t(_StereoPointCount, abortHandler);
+        }
+
+        // Version 18, v0.3.0.0
+        if (Version >= 18)
+        {
+            reader->read_object_t(_OnsetsEnabled, abortHandler);
+        }
+
+        // Version 19, v0.3.0.0
+        if (Version >= 19)
+        {
+            reader->read_object_t(_WindowHop, abortHandler);
+        }
+
+        // Version 20, v0.3.0.0
+        if (Version >= 20)
+        {
+            reader->read_object_t(_SilenceThreshold, abortHandler);
+            reader->read_object_t(_SilenceDelay, abortHandler);
+        }
+
+        // Version 21, v0.3.0.0
+        if (Version >= 21)
+        {
+            reader->read_object_t(_EventLimit, abortHandler);
+        }
     }
     catch (exception & ex)
     {
@@ -200,9 +382,97 @@ void configuration_t::Write(stream_writer * writer, abort_callback & abortHandle
 
         // Version 7, v0.1.8.0
         Value = (uint32_t) _ScrollbarStyle; writer->write_object_t(Value, abortHandler);
+
+        // Version 8, v0.3.0.0
+        writer->write_object_t(_CallOnTimer, abortHandler);
+
+        // Version 9, v0.3.0.0
+        writer->write_object_t(_SpectrumEnabled, abortHandler);
+        writer->write_object_t(_FFTSize, abortHandler);
+        Value = (uint32_t) _WindowFunction; writer->write_object_t(Value, abortHandler);
+        Value = (uint32_t) _BandLayout;     writer->write_object_t(Value, abortHandler);
+        writer->write_object_t(_BandCount, abortHandler);
+        writer->write_object_t(_MinFrequency, abortHandler);
+        writer->write_object_t(_MaxFrequency, abortHandler);
+        Value = (uint32_t) _AmplitudeScale; writer->write_object_t(Value, abortHandler);
+
+        // Version 10, v0.3.0.0
+        Value = (uint32_t) _SampleFormat; writer->write_object_t(Value, abortHandler);
+
+        // Version 11, v0.3.0.0
+        writer->write_object_t(_EnvelopeEnabled, abortHandler);
+        writer->write_object_t(_EnvelopeBucketCount, abortHandler);
+
+        // Version 12, v0.3.0.0
+        writer->write_object_t(_WaveformEnabled, abortHandler);
+
+        // Version 13, v0.3.0.0
+        writer->write_object_t(_FrameRate, abortHandler);
+
+        // Version 14, v0.3.0.0
+        writer->write_object_t(_LoudnessEnabled, abortHandler);
+
+        // Version 15, v0.3.0.0
+        writer->write_object_t(_LevelsEnabled, abortHandler);
+        writer->write_object_t(_MeterAttackTime, abortHandler);
+        writer->write_object_t(_MeterReleaseTime, abortHandler);
+        writer->write_object_t(_MeterPeakHoldTime, abortHandler);
+
+        // Version 16, v0.3.0.0
+        writer->write_object_t(_SpectrogramBudget, abortHandler);
+
+        // Version 17, v0.3.0.0
+        writer->write_object_t(_StereoEnabled, abortHandler);
+        Value = (uint32_t) _StereoMapping; writer->write_object_t(Value, abortHandler);
+        writer->write_object_t(_StereoPointCount, abortHandler);
+
+        // Version 18, v0.3.0.0
+        writer->write_object_t(_OnsetsEnabled, abortHandler);
+
+        // Version 19, v0.3.0.0
+        writer->write_object_t(_WindowHop, abortHandler);
+
+        // Version 20, v0.3.0.0
+        writer->write_object_t(_SilenceThreshold, abortHandler);
+        writer->write_object_t(_SilenceDelay, abortHandler);
+
+        // Version 21, v0.3.0.0
+        writer->write_object_t(_EventLimit, abortHandler);
     }
     catch (exception & ex)
     {
         console::printf(STR_COMPONENT_BASENAME " failed to write configuration: %s", ex.what());
     }
 }
+
+/// <summary>
+/// Gets the settings of the spectrum analyzer.
+/// </summary>
+spectrum_settings_t configuration_t::GetSpectrumSettings() const noexcept
+{
+    spectrum_settings_t Settings;
+
+    Settings.FFTSize      = _FFTSize;
+    Settings.Window       = _WindowFunction;
+    Settings.Layout       = _BandLayout;
+    Settings.BandCount    = _BandCount;
+    Settings.MinFrequency = _MinFrequency;
+    Settings.MaxFrequency = _MaxFrequency;
+    Settings.Scale        = _AmplitudeScale;
+
+    return Settings;
+}
+
+/// <summary>
+/// Gets the ballistics of the level meter.
+/// </summary>
+level_meter_settings_t configuration_t::GetLevelMeterSettings() const noexcept
+{
+    level_meter_settings_t Settings;
+
+    Settings.AttackTime   = (double) _MeterAttackTime;
+    Settings.ReleaseTime  = (double) _MeterReleaseTime;
+    Settings.PeakHoldTime = (double) _MeterPeakHoldTime;
+
+    return Settings;
+}
@@ -1,10 +1,15 @@
 ﻿
-/** $VER: Configuration.h (2024.08.04) P. Stuer **/
+/** $VER: Configuration.h (2026.10.16) P. Stuer **/
 
 #pragma once
 
 #include "pch.h"
 
+#include "SampleConverter.h"
+#include "SpectrumAnalyzer.h"
+#include "LevelMeter.h"
+#include "StereoAnalyzer.h"
+
 enum WindowSizeUnit : uint32_t
 {
     Milliseconds = 0,
@@ -51,6 +56,9 @@ public:
     void Read(stream_reader * reader, size_t size, abort_callback & abortHandler = fb2k::noAbort, bool isPreset = false) noexcept;
     void Write(stream_writer * writer, abort_callback & abortHandler = fb2k::noAbort, bool isPreset = false) const noexcept;
 
+    spectrum_settings_t GetSpectrumSettings() const noexcept;
+    level_meter_settings_t GetLevelMeterSettings() const noexcept;
+
 public:
     std::wstring _Name;
     std::wstring _TemplateFilePath;
@@ -68,6 +76,46 @@ public:
     bool _InPrivateMode;
     ScrollbarStyle _ScrollbarStyle;
 
+    bool _CallOnTimer;                                              // Calls the onTimer() script function on every frame. Scripts can poll the frame header in the shared buffer instead.
+    uint32_t _FrameRate;                                            // Rate of the frame timer, in Hz. 0 = refresh rate of the display.
+    SampleFormat _SampleFormat;                                     // Format of the samples in the shared buffer
+
+    bool _SpectrumEnabled;                                          // Writes the spectrum of each frame to the shared buffer.
+    uint32_t _FFTSize;                                              // Power of 2
+    WindowFunction _WindowFunction;
+    BandLayout _BandLayout;
+    uint32_t _BandCount;
+    double _MinFrequency;                                           // Hz
+    double _MaxFrequency;                                           // Hz
+    AmplitudeScale _AmplitudeScale;
+
+    bool _EnvelopeEnabled;                                          // Writes the min/max/RMS envelope of each frame to the shared buffer instead of the samples.
+    uint32_t _EnvelopeBucketCount;                                  // Number of buckets per channel. 0 = width of the panel, in pixels.
+
+    bool _WaveformEnabled;                                          // Generates the waveform of the whole track in the background when a new track starts playing.
+
+    bool _LoudnessEnabled;                                          // Writes the EBU R128 loudness and the true peak to the shared buffer.
+
+    bool _LevelsEnabled;                                            // Writes the peak, RMS and VU level of each channel to the shared buffer instead of the samples.
+    uint32_t _MeterAttackTime;                                      // Time constant of a rising peak level, in ms. 0 = instantaneous.
+    uint32_t _MeterReleaseTime;                                     // Time constant of a falling peak level, in ms.
+    uint32_t _MeterPeakHoldTime;                                    // Time a peak is held, in ms.
+
+    uint32_t _SpectrogramBudget;                                    // Memory budget of the ring of spectrum frames, in MB. 0 = disabled.
+
+    bool _StereoEnabled;                                            // Writes the stereo correlation, balance and goniometer points to the shared buffer.
+    StereoMapping _StereoMapping;                                   // Channels that form the stereo pair
+    uint32_t _StereoPointCount;                                     // Number of goniometer points per frame
+
+    bool _OnsetsEnabled;                                            // Detects onsets and beats and posts them to the script as web messages.
+
+    uint32_t _WindowHop;                                            // Distance between two consecutive windows in the same unit as the window size. 0 = one window per frame, around the playback time.
+
+    int32_t _SilenceThreshold;                                      // Level below which the signal is considered silent, in dBFS.
+    uint32_t _SilenceDelay;                                         // Time the signal must be silent or playback must be paused before the frames are suppressed, in ms. 0 = never suppress frames.
+
+    uint32_t _EventLimit;                                           // Maximum number of events the script has not acknowledged yet before events are dropped or merged. 0 = unlimited.
+
 private:
-    const int32_t _CurrentVersion = 7;
+    const int32_t _CurrentVersion = 21;
 };
@@ -0,0 +1,154 @@
+
+/** $VER: EnvelopeDecimator.cpp (2026.10.16) P. Stuer - Reduces a chunk of samples to min/max/RMS buckets. Host-independent. **/
+
+#include "EnvelopeDecimator.h"
+#include "SampleConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_KERNELS
+
+#include <emmintrin.h>
+
+#if defined(_MSC_VER)
+#define TARGET_SSE2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#endif
+
+/// <summary>
+/// Accumulates the interleaved samples of one bucket.
+/// </summary>
+template<typename T>
+static void AccumulateScalar(const T * samples, size_t frameCount, uint32_t channelCount, float * min, float * max, double * sum) noexcept
+{
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        for (uint32_t Channel = 0; Channel < channelCount; ++Channel)
+        {
+            const float Value = (float) *samples++;
+
+            min[Channel] = std::min(min[Channel], Value);
+            max[Channel] = std::max(max[Channel], Value);
+            sum[Channel] += (double) Value * (double) Value;
+        }
+    }
+}
+
+#ifdef HAS_X86_KERNELS
+
+/// <summary>
+/// Accumulates the interleaved samples of one bucket using SSE2. Returns the number of frames processed. The channel count must be 1, 2 or 4 so each lane always contains the same channel.
+/// </summary>
+TARGET_SSE2
+static size_t AccumulateSSE2(const float * samples, size_t frameCount, uint32_t channelCount, float * min, float * max, double * sum) noexcept
+{
+    const size_t FramesPerVector = 4 / channelCount;
+    const size_t VectorCount = frameCount / FramesPerVector;
+
+    if (VectorCount == 0)
+        return 0;
+
+    __m128 Min = _mm_loadu_ps(samples);
+    __m128 Max = Min;
+    __m128 Sum = _mm_setzero_ps();
+
+    for (size_t i = 0; i < VectorCount; ++i, samples += 4)
+    {
+        const __m128 v = _mm_loadu_ps(samples);
+
+        Min = _mm_min_ps(Min, v);
+        Max = _mm_max_ps(Max, v);
+        Sum = _mm_add_ps(Sum, _mm_mul_ps(v, v));
+    }
+
+    alignas(16) float Mins[4], Maxs[4], Sums[4];
+
+    _mm_store_ps(Mins, Min);
+    _mm_store_ps(Maxs, Max);
+    _mm_store_ps(Sums, Sum);
+
+    for (uint32_t Lane = 0; Lane < 4; ++Lane)
+    {
+        const uint32_t Channel = Lane % channelCount;
+
+        min[Channel] = std::min(min[Channel], Mins[Lane]);
+        max[Channel] = std::max(max[Channel], Maxs[Lane]);
+        sum[Channel] += (double) Sums[Lane];
+    }
+
+    return VectorCount * FramesPerVector;
+}
+
+#endif
+
+/// <summary>
+/// Reduces the samples to the specified number of buckets per channel.
+/// </summary>
+template<typename T>
+static void ProcessInternal(const T * samples, size_t sampleCount, uint32_t channelCount, size_t bucketCount, envelope_t * envelopes) noexcept
+{
+    if ((sampleCount == 0) || (channelCount == 0) || (channelCount > EnvelopeDecimator::MaxChannels) || (bucketCount == 0))
+        return;
+
+    float Min[EnvelopeDecimator::MaxChannels];
+    float Max[EnvelopeDecimator::MaxChannels];
+    double Sum[EnvelopeDecimator::MaxChannels];
+
+    for (size_t Bucket = 0; Bucket < bucketCount; ++Bucket)
+    {
+        // Buckets that are smaller than a sample repeat the nearest sample.
+        const size_t Lo = (Bucket * sampleCount) / bucketCount;
+        const size_t Hi = std::max(((Bucket + 1) * sampleCount) / bucketCount, Lo + 1);
+
+        const size_t FrameCount = Hi - Lo;
+
+        std::fill_n(Min, channelCount, std::numeric_limits<float>::max());
+        std::fill_n(Max, channelCount, std::numeric_limits<float>::lowest());
+        std::fill_n(Sum, channelCount, 0.);
+
+        const T * p = samples + (Lo * channelCount);
+
+        size_t Done = 0;
+
+    #ifdef HAS_X86_KERNELS
+        if constexpr (std::is_same_v<T, float>)
+        {
+            if (((channelCount == 1) || (channelCount == 2) || (channelCount == 4)) && (SampleConverter::GetInstructionSet() >= InstructionSet::SSE2))
+                Done = AccumulateSSE2(p, FrameCount, channelCount, Min, Max, Sum);
+        }
+    #endif
+
+        AccumulateScalar(p + (Done * channelCount), FrameCount - Done, channelCount, Min, Max, Sum);
+
+        for (uint32_t Channel = 0; Channel < channelCount; ++Channel)
+        {
+            auto & Envelope = envelopes[(Channel * bucketCount) + Bucket];
+
+            Envelope.Min = Min[Channel];
+            Envelope.Max = Max[Channel];
+            Envelope.RMS = (float) std::sqrt(Sum[Channel] / (double) FrameCount);
+        }
+    }
+}
+
+/// <summary>
+/// Reduces a chunk of interleaved 32-bit samples to the specified number of buckets. The envelopes are stored channel by channel.
+/// </summary>
+void EnvelopeDecimator::Process(const float * samples, size_t sampleCount, uint32_t channelCount, size_t bucketCount, envelope_t * envelopes) noexcept
+{
+    ProcessInternal(samples, sampleCount, channelCount, bucketCount, envelopes);
+}
+
+/// <summary>
+/// Reduces a chunk of interleaved 64-bit samples to the specified number of buckets. The envelopes are stored channel by channel.
+/// </summary>
+void EnvelopeDecimator::Process(const double * samples, size_t sampleCount, uint32_t channelCount, size_t bucketCount, envelope_t * envelopes) noexcept
+{
+    ProcessInternal(samples, sampleCount, channelCount, bucketCount, envelopes);
+}
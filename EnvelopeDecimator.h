@@ -0,0 +1,29 @@
+
+/** $VER: EnvelopeDecimator.h (2026.10.16) P. Stuer - Reduces a chunk of samples to min/max/RMS buckets. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// Represents the envelope of the samples in a bucket.
+/// </summary>
+struct envelope_t
+{
+    float Min;
+    float Max;
+    float RMS;
+};
+
+/// <summary>
+/// Reduces a chunk of interleaved samples to a number of min/max/RMS buckets per channel f.e. to draw a waveform or oscilloscope with one bucket per pixel column.
+/// </summary>
+class EnvelopeDecimator
+{
+public:
+    static void Process(const float * samples, size_t sampleCount, uint32_t channelCount, size_t bucketCount, envelope_t * envelopes) noexcept;
+    static void Process(const double * samples, size_t sampleCount, uint32_t channelCount, size_t bucketCount, envelope_t * envelopes) noexcept;
+
+    static constexpr uint32_t MaxChannels = 32;
+};
@@ -0,0 +1,220 @@
+
+/** $VER: EventBus.cpp (2026.10.16) P. Stuer - Sends typed events to the script and limits the number of events the script has not processed yet. Host-independent. **/
+
+#include "EventBus.h"
+
+#include <cstdint>
+#include <cwchar>
+
+/// <summary>
+/// Initializes the bus with a table of event kinds. The table must outlive the bus. Events are identified by their index in the table.
+/// </summary>
+void EventBus::Initialize(const event_kind_t * kinds, size_t kindCount, SendCallback send)
+{
+    _Kinds     = kinds;
+    _KindCount = kindCount;
+    _Send      = send;
+
+    _HeldEvents.assign(kindCount, { false, 0, 0., std::wstring() });
+
+    Reset();
+}
+
+/// <summary>
+/// Discards the held events and restarts the sequence numbers f.e. when a new page is loaded. The counters are kept.
+/// </summary>
+void EventBus::Reset() noexcept
+{
+    _Sequence = 0;
+    _AcknowledgedSequence = 0;
+    _IsAcknowledging = false;
+
+    for (auto & Event : _HeldEvents)
+        Event.IsHeld = false;
+}
+
+/// <summary>
+/// Posts an event of the specified kind. The data is the JSON text of the payload. Returns false if the event could not be sent.
+/// Events that were dropped or held because the script is behind are not failures.
+/// </summary>
+bool EventBus::Post(size_t kind, double timestamp, const wchar_t * data)
+{
+    if (kind >= _KindCount)
+        return false;
+
+    ++_Statistics.PostedCount;
+
+    if (IsFull())
+    {
+        switch (_Kinds[kind].Policy)
+        {
+            case EventPolicy::Keep:
+                break;
+
+            case EventPolicy::Drop:
+                ++_Statistics.DroppedCount;
+                return true;
+
+            case EventPolicy::Merge:
+            {
+                auto & Event = _HeldEvents[kind];
+
+                if (Event.IsHeld)
+                    ++_Statistics.MergedCount;
+
+                Event.IsHeld    = true;
+                Event.Order     = _Statistics.PostedCount;
+                Event.Timestamp = timestamp;
+                Event.Data      = (data != nullptr) ? data : L"";
+
+                return true;
+            }
+        }
+    }
+
+    // A newer event replaces the held event of the same kind.
+    if (_HeldEvents[kind].IsHeld)
+    {
+        _HeldEvents[kind].IsHeld = false;
+
+        ++_Statistics.MergedCount;
+    }
+
+    // The held events are older than this event so they are sent first, even if that exceeds the limit.
+    if (!SendHeldEvents(true))
+        return false;
+
+    return Send(kind, timestamp, data);
+}
+
+/// <summary>
+/// Acknowledges all events up to and including the specified sequence number and sends the held events for which there is room again.
+/// Returns false if a held event could not be sent.
+/// </summary>
+bool EventBus::Acknowledge(uint64_t sequence)
+{
+    // Ignore stale acknowledgements and acknowledgements of events that were sent before a reset.
+    if ((sequence <= _AcknowledgedSequence) || (sequence > _Sequence))
+        return true;
+
+    _AcknowledgedSequence = sequence;
+    _IsAcknowledging = true;
+
+    return SendHeldEvents(false);
+}
+
+/// <summary>
+/// Encodes an event in its envelope. Reuses the storage of the message.
+/// </summary>
+void EventBus::Encode(std::wstring & message, const wchar_t * kind, uint64_t sequence, double timestamp, const wchar_t * data)
+{
+    wchar_t Text[64];
+
+    message.clear();
+
+    message += L"{\"Kind\":\"";
+    message += kind;
+
+    std::swprintf(Text, sizeof(Text) / sizeof(Text[0]), L"\",\"Sequence\":%llu,\"Timestamp\":%.3f,\"Data\":", (unsigned long long) sequence, timestamp);
+
+    message += Text;
+    message += ((data != nullptr) && (*data != L'\0')) ? data : L"{}";
+    message += L"}";
+}
+
+/// <summary>
+/// Decodes an acknowledgement. Only the exact message the event dispatcher script sends, {"Ack":sequence}, is accepted.
+/// </summary>
+bool EventBus::DecodeAcknowledgement(const wchar_t * message, uint64_t & sequence) noexcept
+{
+    static const wchar_t Prefix[] = L"{\"Ack\":";
+
+    const size_t PrefixLength = (sizeof(Prefix) / sizeof(Prefix[0])) - 1;
+
+    if ((message == nullptr) || (::wcsncmp(message, Prefix, PrefixLength) != 0))
+        return false;
+
+    const wchar_t * p = message + PrefixLength;
+
+    uint64_t Value = 0;
+    size_t DigitCount = 0;
+
+    for (; (*p >= L'0') && (*p <= L'9'); ++p, ++DigitCount)
+    {
+        const uint64_t Digit = (uint64_t) (*p - L'0');
+
+        if (Value > (UINT64_MAX - Digit) / 10)
+            return false;
+
+        Value = (Value * 10) + Digit;
+    }
+
+    if ((DigitCount == 0) || (p[0] != L'}') || (p[1] != L'\0'))
+        return false;
+
+    sequence = Value;
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if the number of events in flight has reached the limit.
+/// </summary>
+bool EventBus::IsFull() const noexcept
+{
+    return (_Limit != 0) && (GetInFlightCount() >= _Limit);
+}
+
+/// <summary>
+/// Sends an event with the next sequence number.
+/// </summary>
+bool EventBus::Send(size_t kind, double timestamp, const wchar_t * data)
+{
+    Encode(_Message, _Kinds[kind].Name, _Sequence + 1, timestamp, data);
+
+    if (!_Send || !_Send(_Message))
+        return false;
+
+    ++_Sequence;
+    ++_Statistics.SentCount;
+
+    const uint64_t InFlightCount = GetInFlightCount();
+
+    if (InFlightCount > _Statistics.MaxInFlightCount)
+        _Statistics.MaxInFlightCount = InFlightCount;
+
+    return true;
+}
+
+/// <summary>
+/// Sends the held events in the order they were posted, all of them or as long as there is room.
+/// </summary>
+bool EventBus::SendHeldEvents(bool all)
+{
+    while (all || !IsFull())
+    {
+        held_event_t * Oldest = nullptr;
+        size_t Kind = 0;
+
+        for (size_t i = 0; i < _KindCount; ++i)
+        {
+            auto & Event = _HeldEvents[i];
+
+            if (Event.IsHeld && ((Oldest == nullptr) || (Event.Order < Oldest->Order)))
+            {
+                Oldest = &Event;
+                Kind = i;
+            }
+        }
+
+        if (Oldest == nullptr)
+            break;
+
+        Oldest->IsHeld = false;
+
+        if (!Send(Kind, Oldest->Timestamp, Oldest->Data.c_str()))
+            return false;
+    }
+
+    return true;
+}
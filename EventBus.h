@@ -0,0 +1,123 @@
+
+/** $VER: EventBus.h (2026.10.16) P. Stuer - Sends typed events to the script and limits the number of events the script has not processed yet. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Determines what happens to an event of a kind when the number of events in flight has reached the limit.
+/// </summary>
+enum class EventPolicy : uint8_t
+{
+    Keep,       // The event is sent anyway f.e. a track change.
+    Drop,       // The event is discarded f.e. a frame notification.
+    Merge,      // Only the newest event is kept and sent when the script catches up f.e. the playback clock.
+};
+
+/// <summary>
+/// Describes a kind of event.
+/// </summary>
+struct event_kind_t
+{
+    const wchar_t * Name;
+    EventPolicy Policy;
+};
+
+/// <summary>
+/// Represents the counters of an event bus.
+/// </summary>
+struct event_bus_statistics_t
+{
+    uint64_t PostedCount;               // Number of events posted by the host
+    uint64_t SentCount;                 // Number of events sent to the script
+    uint64_t DroppedCount;              // Number of events that were discarded
+    uint64_t MergedCount;               // Number of events that replaced a held event of the same kind
+    uint64_t MaxInFlightCount;          // Highest number of events in flight
+};
+
+/// <summary>
+/// Sends events to the script in an envelope with the kind, a sequence number and a time stamp: {"Kind":"...","Sequence":n,"Timestamp":t,"Data":{...}}.
+/// The script acknowledges the highest sequence number it has processed. Once it does, the events that have been sent but not acknowledged are in flight and,
+/// when their number reaches the limit, new events are kept, dropped or merged according to the policy of their kind. Scripts that never acknowledge receive every event.
+/// Events are sent in the order they were posted: held events go out before a newer event of another kind is sent.
+/// Not thread-safe.
+/// </summary>
+class EventBus
+{
+public:
+    typedef std::function<bool(const std::wstring & message)> SendCallback;
+
+    EventBus() noexcept : _Kinds(), _KindCount(), _Limit(), _Sequence(), _AcknowledgedSequence(), _IsAcknowledging(), _Statistics() { }
+
+    void Initialize(const event_kind_t * kinds, size_t kindCount, SendCallback send);
+    void Reset() noexcept;
+
+    bool Post(size_t kind, double timestamp, const wchar_t * data);
+    bool Acknowledge(uint64_t sequence);
+
+    static void Encode(std::wstring & message, const wchar_t * kind, uint64_t sequence, double timestamp, const wchar_t * data);
+    static bool DecodeAcknowledgement(const wchar_t * message, uint64_t & sequence) noexcept;
+
+    /// <summary>
+    /// Sets the maximum number of events in flight. 0 = unlimited.
+    /// </summary>
+    void SetLimit(size_t limit) noexcept
+    {
+        _Limit = limit;
+    }
+
+    /// <summary>
+    /// Gets the number of events that have been sent but not acknowledged yet.
+    /// </summary>
+    uint64_t GetInFlightCount() const noexcept
+    {
+        return _IsAcknowledging ? _Sequence - _AcknowledgedSequence : 0;
+    }
+
+    /// <summary>
+    /// Gets the counters of the bus.
+    /// </summary>
+    const event_bus_statistics_t & GetStatistics() const noexcept
+    {
+        return _Statistics;
+    }
+
+private:
+    bool IsFull() const noexcept;
+    bool Send(size_t kind, double timestamp, const wchar_t * data);
+    bool SendHeldEvents(bool all);
+
+private:
+    /// <summary>
+    /// Represents the newest event of a kind with the merge policy that could not be sent yet.
+    /// </summary>
+    struct held_event_t
+    {
+        bool IsHeld;
+        uint64_t Order;                 // Number of the post, keeps the held events in the order they were posted
+        double Timestamp;
+        std::wstring Data;
+    };
+
+    const event_kind_t * _Kinds;
+    size_t _KindCount;
+
+    SendCallback _Send;
+
+    size_t _Limit;
+
+    uint64_t _Sequence;                 // Sequence number of the last event sent
+    uint64_t _AcknowledgedSequence;     // Sequence number of the last event the script acknowledged
+    bool _IsAcknowledging;              // Set when the script acknowledged the first event
+
+    std::vector<held_event_t> _HeldEvents;
+    std::wstring _Message;              // Reused so posting an event does not allocate memory once the message has reached its size.
+
+    event_bus_statistics_t _Statistics;
+};
@@ -0,0 +1,118 @@
+
+/** $VER: FFT.cpp (2026.10.16) P. Stuer - Implements a real-valued Fast Fourier Transform. Host-independent. **/
+
+#include "FFT.h"
+
+#include <cmath>
+#include <numbers>
+
+/// <summary>
+/// Initializes the transform for the specified size. Must be a power of 2.
+/// </summary>
+void FFT::Initialize(size_t size)
+{
+    if (!IsValidSize(size) || (size == _Size))
+        return;
+
+    _Size = size;
+
+    const size_t n = size / 2;
+
+    // Bit reversal permutation.
+    _BitReversal.resize(n);
+
+    size_t Bits = 0;
+
+    while (((size_t) 1 << Bits) < n)
+        ++Bits;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t r = 0;
+
+        for (size_t b = 0; b < Bits; ++b)
+            if (i & ((size_t) 1 << b))
+                r |= (uint32_t) 1 << (Bits - 1 - b);
+
+        _BitReversal[i] = r;
+    }
+
+    // Twiddle factors of the complex transform.
+    _Twiddles.resize(n / 2);
+
+    for (size_t i = 0; i < n / 2; ++i)
+    {
+        const double Phi = -2. * std::numbers::pi * (double) i / (double) n;
+
+        _Twiddles[i] = std::complex<float>((float) std::cos(Phi), (float) std::sin(Phi));
+    }
+
+    // Twiddle factors to recover the spectrum of the real input.
+    _RealTwiddles.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double Phi = -2. * std::numbers::pi * (double) i / (double) size;
+
+        _RealTwiddles[i] = std::complex<float>((float) std::cos(Phi), (float) std::sin(Phi));
+    }
+
+    _Scratch.resize(n);
+}
+
+/// <summary>
+/// Transforms the specified real-valued data. The result contains GetBinCount() bins.
+/// </summary>
+void FFT::Transform(const float * data, std::complex<float> * bins) noexcept
+{
+    const size_t n = _Size / 2;
+
+    if (n == 0)
+        return;
+
+    // Pack the even samples in the real part and the odd samples in the imaginary part, in bit-reversed order.
+    for (size_t i = 0; i < n; ++i)
+        _Scratch[_BitReversal[i]] = std::complex<float>(data[2 * i], data[2 * i + 1]);
+
+    TransformComplex(_Scratch.data());
+
+    // Split the result of the complex transform into the spectrum of the real input.
+    bins[0] = std::complex<float>(_Scratch[0].real() + _Scratch[0].imag(), 0.f);
+    bins[n] = std::complex<float>(_Scratch[0].real() - _Scratch[0].imag(), 0.f);
+
+    for (size_t k = 1; k < n; ++k)
+    {
+        const std::complex<float> a = _Scratch[k];
+        const std::complex<float> b = std::conj(_Scratch[n - k]);
+
+        const std::complex<float> Even = (a + b) * 0.5f;
+        const std::complex<float> Odd  = (a - b) * std::complex<float>(0.f, -0.5f);
+
+        bins[k] = Even + _RealTwiddles[k] * Odd;
+    }
+}
+
+/// <summary>
+/// Performs an in-place iterative radix-2 transform of data that is already in bit-reversed order.
+/// </summary>
+void FFT::TransformComplex(std::complex<float> * data) const noexcept
+{
+    const size_t n = _Size / 2;
+
+    for (size_t Length = 2; Length <= n; Length <<= 1)
+    {
+        const size_t Half = Length / 2;
+        const size_t Step = n / Length;
+
+        for (size_t i = 0; i < n; i += Length)
+        {
+            for (size_t j = 0; j < Half; ++j)
+            {
+                const std::complex<float> t = _Twiddles[j * Step] * data[i + j + Half];
+
+                data[i + j + Half] = data[i + j] - t;
+                data[i + j]       += t;
+            }
+        }
+    }
+}
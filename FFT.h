@@ -0,0 +1,57 @@
+
+/** $VER: FFT.h (2026.10.16) P. Stuer - Implements a real-valued Fast Fourier Transform. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <complex>
+#include <vector>
+
+/// <summary>
+/// Implements a radix-2 Fast Fourier Transform of real-valued input. A real FFT of size N is computed using a complex FFT of size N / 2.
+/// </summary>
+class FFT
+{
+public:
+    FFT() : _Size() { }
+
+    void Initialize(size_t size);
+
+    void Transform(const float * data, std::complex<float> * bins) noexcept;
+
+    /// <summary>
+    /// Gets the size of the transform.
+    /// </summary>
+    size_t GetSize() const noexcept
+    {
+        return _Size;
+    }
+
+    /// <summary>
+    /// Gets the number of bins produced by the transform (DC up to and including Nyquist).
+    /// </summary>
+    size_t GetBinCount() const noexcept
+    {
+        return (_Size / 2) + 1;
+    }
+
+    /// <summary>
+    /// Returns true if the specified size can be used with this implementation.
+    /// </summary>
+    static bool IsValidSize(size_t size) noexcept
+    {
+        return (size >= 4) && ((size & (size - 1)) == 0);
+    }
+
+private:
+    void TransformComplex(std::complex<float> * data) const noexcept;
+
+private:
+    size_t _Size;
+
+    std::vector<uint32_t> _BitReversal;             // Bit reversal permutation for the complex FFT of size N / 2.
+    std::vector<std::complex<float>> _Twiddles;     // Twiddle factors for the complex FFT of size N / 2.
+    std::vector<std::complex<float>> _RealTwiddles; // Twiddle factors to split the complex result into the real spectrum.
+    std::vector<std::complex<float>> _Scratch;
+};
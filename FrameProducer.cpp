@@ -0,0 +1,153 @@
+
+/** $VER: FrameProducer.cpp (2026.10.16) P. Stuer - Fetches the audio of the visualisation stream once for all panels. **/
+
+#include "pch.h"
+
+#include "FrameProducer.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Adds a panel. Creates the visualisation stream when the first panel subscribes. Must be called on the main thread.
+/// </summary>
+void FrameProducer::Subscribe(const void * subscriber) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    try
+    {
+        _Windows[subscriber] = { };
+
+        if (_Stream.is_valid())
+            return;
+
+        static_api_ptr_t<visualisation_manager> VisualisationManager;
+
+        VisualisationManager->create_stream(_Stream, visualisation_manager::KStreamFlagNewFFT);
+
+        _Stream->set_channel_mode(visualisation_stream_v2::channel_mode_default);
+    }
+    catch (std::exception &)
+    {
+        console::print(STR_COMPONENT_BASENAME " failed to create visualisation stream.");
+    }
+}
+
+/// <summary>
+/// Removes a panel. Releases the visualisation stream when the last panel unsubscribes. Must be called on the main thread.
+/// </summary>
+void FrameProducer::Unsubscribe(const void * subscriber) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    _Windows.erase(subscriber);
+
+    if (!_Windows.empty())
+        return;
+
+    _Chunk.reset();
+    _Stream.release();
+}
+
+/// <summary>
+/// Discards the shared window f.e. when a new track starts or the user seeks. The same playback time can refer to different audio afterwards.
+/// </summary>
+void FrameProducer::Invalidate() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    _Chunk.reset();
+}
+
+/// <summary>
+/// Gets the current playback time, in seconds.
+/// </summary>
+bool FrameProducer::GetAbsoluteTime(double & playbackTime) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    return _Stream.is_valid() && _Stream->get_absolute_time(playbackTime);
+}
+
+/// <summary>
+/// Gets the window of a panel. Slices it from the shared window if possible; fetches a new shared window that covers the most recent windows of all panels otherwise.
+/// </summary>
+bool FrameProducer::GetChunk(const void * subscriber, double playbackTime, double offset, double length, audio_chunk & chunk, bool & isShared) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    isShared = false;
+
+    if (!_Stream.is_valid() || (length <= 0.))
+        return false;
+
+    auto Window = _Windows.find(subscriber);
+
+    if (Window != _Windows.end())
+        Window->second = { playbackTime - offset, (offset + length) - playbackTime };
+
+    if (Slice(offset, length, chunk))
+    {
+        isShared = true;
+
+        return true;
+    }
+
+    double Before = playbackTime - offset;
+    double After  = (offset + length) - playbackTime;
+
+    for (const auto & [_, w] : _Windows)
+    {
+        Before = std::max(Before, w.Before);
+        After  = std::max(After,  w.After);
+    }
+
+    const double SharedOffset = playbackTime - Before;
+
+    if (_Stream->get_chunk_absolute(_Chunk, SharedOffset, Before + After + Lookahead))
+    {
+        _ChunkOffset = SharedOffset;
+
+        if (Slice(offset, length, chunk))
+            return true;
+    }
+    else
+        _Chunk.reset();
+
+    // The shared window can be incomplete f.e. when the audio after the playback time has not been decoded yet.
+    return _Stream->get_chunk_absolute(chunk, offset, length);
+}
+
+/// <summary>
+/// Gets the specified interval of the stream directly, f.e. for the meters that keep their own position in the stream.
+/// </summary>
+bool FrameProducer::GetChunkAbsolute(double offset, double length, audio_chunk & chunk) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    return _Stream.is_valid() && _Stream->get_chunk_absolute(chunk, offset, length);
+}
+
+/// <summary>
+/// Copies the specified interval from the shared window. Returns false if the shared window does not contain the complete interval.
+/// </summary>
+bool FrameProducer::Slice(double offset, double length, audio_chunk & chunk) const noexcept
+{
+    const uint32_t SampleRate = _Chunk.get_sample_rate();
+    const size_t SampleCount  = _Chunk.get_sample_count();
+
+    if ((SampleRate == 0) || (SampleCount == 0))
+        return false;
+
+    const int64_t First = std::llround((offset - _ChunkOffset) * (double) SampleRate);
+    const int64_t Count = std::llround(length * (double) SampleRate);
+
+    if ((First < 0) || (Count <= 0) || ((size_t) (First + Count) > SampleCount))
+        return false;
+
+    const uint32_t ChannelCount = _Chunk.get_channel_count();
+
+    chunk.set_data(_Chunk.get_data() + ((size_t) First * ChannelCount), (size_t) Count, ChannelCount, SampleRate, _Chunk.get_channel_config());
+
+    return true;
+}
@@ -0,0 +1,59 @@
+
+/** $VER: FrameProducer.h (2026.10.16) P. Stuer - Fetches the audio of the visualisation stream once for all panels. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include "PooledChunk.h"
+
+#include <SDK/vis.h>
+
+#include <mutex>
+#include <unordered_map>
+
+/// <summary>
+/// Owns the visualisation stream that is shared by all panels. Fetches one window that covers the windows of all subscribed panels and slices the window of each panel from it.
+/// The windows differ when the panels use a different window size or reaction alignment. All methods are thread-safe.
+/// </summary>
+class FrameProducer
+{
+public:
+    FrameProducer() : _ChunkOffset() { }
+
+    FrameProducer(const FrameProducer &) = delete;
+    FrameProducer & operator=(const FrameProducer &) = delete;
+    FrameProducer(FrameProducer &&) = delete;
+    FrameProducer & operator=(FrameProducer &&) = delete;
+
+    void Subscribe(const void * subscriber) noexcept;
+    void Unsubscribe(const void * subscriber) noexcept;
+    void Invalidate() noexcept;
+
+    bool GetAbsoluteTime(double & playbackTime) noexcept;
+    bool GetChunk(const void * subscriber, double playbackTime, double offset, double length, audio_chunk & chunk, bool & isShared) noexcept;
+    bool GetChunkAbsolute(double offset, double length, audio_chunk & chunk) noexcept;
+
+    static constexpr double Lookahead = 0.05;   // Extra audio fetched after the shared window so panels that tick a little later can be served from it, in seconds.
+
+private:
+    bool Slice(double offset, double length, audio_chunk & chunk) const noexcept;
+
+private:
+    /// <summary>
+    /// Describes the window of a panel relative to the playback time.
+    /// </summary>
+    struct window_t
+    {
+        double Before;                          // Part of the window before the playback time, in seconds. Negative if the window starts after the playback time.
+        double After;                           // Part of the window after the playback time, in seconds
+    };
+
+    std::mutex _Lock;
+
+    visualisation_stream_v2::ptr _Stream;
+    std::unordered_map<const void *, window_t> _Windows;
+
+    PooledChunk _Chunk;                         // Window that covers the windows of all panels
+    double _ChunkOffset;                        // Absolute playback time of the first sample of the shared window, in seconds
+};
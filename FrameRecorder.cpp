@@ -0,0 +1,268 @@
+
+/** $VER: FrameRecorder.cpp (2026.10.16) P. Stuer - Records the latency of the stages of the frame pipeline. Host-independent. **/
+
+#include "FrameRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+
+/// <summary>
+/// Gets the index of the bucket that counts the specified duration.
+/// </summary>
+static size_t GetBucketIndex(uint64_t microseconds) noexcept
+{
+    size_t Index = 0;
+
+    while ((microseconds != 0) && (Index < LatencyHistogram::BucketCount - 1))
+    {
+        microseconds >>= 1;
+        ++Index;
+    }
+
+    return Index;
+}
+
+/// <summary>
+/// Estimates a percentile from the bucket counts, in us. Interpolates linearly between the bounds of the bucket that contains the percentile.
+/// </summary>
+static double GetPercentile(const uint64_t * buckets, uint64_t count, double percentile, double max) noexcept
+{
+    if (count == 0)
+        return 0.;
+
+    const double Rank = percentile * (double) count;
+
+    uint64_t Total = 0;
+
+    for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i)
+    {
+        if (buckets[i] == 0)
+            continue;
+
+        if ((double) (Total + buckets[i]) >= Rank)
+        {
+            const double Lower = (i == 0) ? 0. : (double) (1ull << (i - 1));
+            const double Upper = (i == LatencyHistogram::BucketCount - 1) ? max : (double) (1ull << i);
+
+            const double Value = Lower + (Upper - Lower) * ((Rank - (double) Total) / (double) buckets[i]);
+
+            return std::min(Value, max);
+        }
+
+        Total += buckets[i];
+    }
+
+    return max;
+}
+
+/// <summary>
+/// Records a duration.
+/// </summary>
+void LatencyHistogram::Record(uint64_t microseconds) noexcept
+{
+    _Buckets[GetBucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    _Count.fetch_add(1, std::memory_order_relaxed);
+    _Sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+    uint64_t Max = _Max.load(std::memory_order_relaxed);
+
+    while ((microseconds > Max) && !_Max.compare_exchange_weak(Max, microseconds, std::memory_order_relaxed))
+        ;
+}
+
+/// <summary>
+/// Clears the histogram.
+/// </summary>
+void LatencyHistogram::Reset() noexcept
+{
+    for (auto & Bucket : _Buckets)
+        Bucket.store(0, std::memory_order_relaxed);
+
+    _Count.store(0, std::memory_order_relaxed);
+    _Sum.store(0, std::memory_order_relaxed);
+    _Max.store(0, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Gets a summary of the histogram.
+/// </summary>
+latency_summary_t LatencyHistogram::GetSummary() const noexcept
+{
+    uint64_t Buckets[BucketCount];
+    uint64_t Count = 0;
+
+    // Count the buckets instead of using _Count so the percentiles are consistent with a snapshot taken while recording is in progress.
+    for (size_t i = 0; i < BucketCount; ++i)
+    {
+        Buckets[i] = _Buckets[i].load(std::memory_order_relaxed);
+        Count += Buckets[i];
+    }
+
+    const double Sum = (double) _Sum.load(std::memory_order_relaxed);
+    const double Max = (double) _Max.load(std::memory_order_relaxed);
+
+    latency_summary_t Summary = { };
+
+    Summary.Count = Count;
+
+    if (Count == 0)
+        return Summary;
+
+    Summary.Mean = (Sum / (double) std::max(Count, _Count.load(std::memory_order_relaxed))) / 1000.;
+    Summary.Max  = Max / 1000.;
+
+    Summary.P50 = GetPercentile(Buckets, Count, 0.50, Max) / 1000.;
+    Summary.P90 = GetPercentile(Buckets, Count, 0.90, Max) / 1000.;
+    Summary.P99 = GetPercentile(Buckets, Count, 0.99, Max) / 1000.;
+
+    return Summary;
+}
+
+/// <summary>
+/// Clears all histograms and counters.
+/// </summary>
+void FrameRecorder::Reset() noexcept
+{
+    for (auto & Histogram : _Histograms)
+        Histogram.Reset();
+
+    for (auto & Counter : _Counters)
+        Counter.store(0, std::memory_order_relaxed);
+
+    _LastTick.store(0, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Sets the expected interval between two ticks, in us. Restarts the jitter measurement.
+/// </summary>
+void FrameRecorder::SetPeriod(uint64_t microseconds) noexcept
+{
+    _Period.store(microseconds, std::memory_order_relaxed);
+    _LastTick.store(0, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Records the timer jitter of a tick that occurred at the specified time, in us.
+/// </summary>
+void FrameRecorder::Tick(uint64_t now) noexcept
+{
+    const uint64_t LastTick = _LastTick.exchange(now, std::memory_order_relaxed);
+    const uint64_t Period = _Period.load(std::memory_order_relaxed);
+
+    if ((LastTick == 0) || (Period == 0) || (now < LastTick))
+        return;
+
+    const uint64_t Interval = now - LastTick;
+
+    Record(FrameStage::TimerJitter, (Interval > Period) ? Interval - Period : Period - Interval);
+}
+
+/// <summary>
+/// Gets the histograms and the counters as JSON. Times are in milliseconds. The bucket arrays contain the raw counts of the logarithmic buckets.
+/// </summary>
+std::string FrameRecorder::ToJSON() const
+{
+    std::string Text = "{\"stages\": {";
+
+    char Line[256];
+
+    for (size_t i = 0; i < (size_t) FrameStage::Count; ++i)
+    {
+        const auto & Histogram = _Histograms[i];
+        const auto s = Histogram.GetSummary();
+
+        ::snprintf(Line, sizeof(Line), "%s\"%s\": {\"count\": %llu, \"mean\": %.3f, \"max\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"buckets\": [",
+            (i != 0) ? ", " : "", GetName((FrameStage) i), (unsigned long long) s.Count, s.Mean, s.Max, s.P50, s.P90, s.P99);
+
+        Text += Line;
+
+        for (size_t j = 0; j < LatencyHistogram::BucketCount; ++j)
+        {
+            ::snprintf(Line, sizeof(Line), "%s%llu", (j != 0) ? ", " : "", (unsigned long long) Histogram.GetBucket(j));
+
+            Text += Line;
+        }
+
+        Text += "]}";
+    }
+
+    Text += "}, \"counters\": {";
+
+    for (size_t i = 0; i < (size_t) FrameEvent::Count; ++i)
+    {
+        ::snprintf(Line, sizeof(Line), "%s\"%s\": %llu", (i != 0) ? ", " : "", GetName((FrameEvent) i), (unsigned long long) GetCounter((FrameEvent) i));
+
+        Text += Line;
+    }
+
+    Text += "}}";
+
+    return Text;
+}
+
+/// <summary>
+/// Gets the histograms and the counters as a human-readable table.
+/// </summary>
+std::string FrameRecorder::ToString() const
+{
+    std::string Text;
+
+    char Line[256];
+
+    ::snprintf(Line, sizeof(Line), "%-24s %10s %10s %10s %10s %10s %10s\n", "Stage (ms)", "Count", "Mean", "P50", "P90", "P99", "Max");
+
+    Text += Line;
+
+    for (size_t i = 0; i < (size_t) FrameStage::Count; ++i)
+    {
+        const auto s = _Histograms[i].GetSummary();
+
+        ::snprintf(Line, sizeof(Line), "%-24s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f\n", GetName((FrameStage) i), (unsigned long long) s.Count, s.Mean, s.P50, s.P90, s.P99, s.Max);
+
+        Text += Line;
+    }
+
+    for (size_t i = 0; i < (size_t) FrameEvent::Count; ++i)
+    {
+        ::snprintf(Line, sizeof(Line), "%-24s %10llu\n", GetName((FrameEvent) i), (unsigned long long) GetCounter((FrameEvent) i));
+
+        Text += Line;
+    }
+
+    return Text;
+}
+
+/// <summary>
+/// Gets the current time of a monotonic clock, in us.
+/// </summary>
+uint64_t FrameRecorder::Now() noexcept
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// <summary>
+/// Gets the name of a stage.
+/// </summary>
+const char * FrameRecorder::GetName(FrameStage stage) noexcept
+{
+    static const char * const Names[] = { "timerJitter", "chunkFetch", "conversion", "scriptDispatch" };
+
+    static_assert(std::size(Names) == (size_t) FrameStage::Count, "Missing stage name");
+
+    return ((size_t) stage < (size_t) FrameStage::Count) ? Names[(size_t) stage] : "";
+}
+
+/// <summary>
+/// Gets the name of an event.
+/// </summary>
+const char * FrameRecorder::GetName(FrameEvent event) noexcept
+{
+    static const char * const Names[] = { "skippedTicks", "droppedFrames", "coalescedNotifications", "reallocations", "sharedChunks", "allocations", "suppressedFrames" };
+
+    static_assert(std::size(Names) == (size_t) FrameEvent::Count, "Missing event name");
+
+    return ((size_t) event < (size_t) FrameEvent::Count) ? Names[(size_t) event] : "";
+}
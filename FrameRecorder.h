@@ -0,0 +1,143 @@
+
+/** $VER: FrameRecorder.h (2026.10.16) P. Stuer - Records the latency of the stages of the frame pipeline. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <atomic>
+#include <string>
+
+/// <summary>
+/// Summarizes a latency histogram. All times are in milliseconds. The percentiles are interpolated within their bucket.
+/// </summary>
+struct latency_summary_t
+{
+    uint64_t Count;
+
+    double Mean;
+    double Max;
+
+    double P50;
+    double P90;
+    double P99;
+};
+
+/// <summary>
+/// Implements a lock-free histogram of durations with logarithmic buckets. Bucket 0 counts durations below 1us, bucket i counts durations from 2^(i-1) up to 2^i us. The last bucket also counts all longer durations.
+/// Recording never blocks so it can be done from the thread that renders the frames; reading is only approximately consistent while recording is in progress.
+/// </summary>
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() noexcept
+    {
+        Reset();
+    }
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram & operator=(const LatencyHistogram &) = delete;
+
+    void Record(uint64_t microseconds) noexcept;
+    void Reset() noexcept;
+
+    latency_summary_t GetSummary() const noexcept;
+
+    uint64_t GetBucket(size_t index) const noexcept
+    {
+        return (index < BucketCount) ? _Buckets[index].load(std::memory_order_relaxed) : 0;
+    }
+
+    static constexpr size_t BucketCount = 28; // Up to 2^27 us or about 134 s.
+
+private:
+    std::atomic<uint64_t> _Buckets[BucketCount];
+    std::atomic<uint64_t> _Count;
+    std::atomic<uint64_t> _Sum;     // in us
+    std::atomic<uint64_t> _Max;     // in us
+};
+
+/// <summary>
+/// Identifies a stage of the frame pipeline.
+/// </summary>
+enum class FrameStage : uint32_t
+{
+    TimerJitter = 0,            // Absolute deviation of the interval between two ticks from the period of the timer
+    ChunkFetch,                 // Time spent getting the playback time and the chunk from the visualisation stream
+    Conversion,                 // Time spent converting and analyzing the chunk into the shared buffer
+    ScriptDispatch,             // Time between the end of the conversion and the return of the call to onTimer() on the UI thread
+
+    Count
+};
+
+/// <summary>
+/// Identifies a counted event of the frame pipeline.
+/// </summary>
+enum class FrameEvent : uint32_t
+{
+    SkippedTick = 0,            // The tick produced no frame: the panel was hidden or frozen, playback didn't advance or no chunk was available.
+    DroppedFrame,               // The frame was dropped while the shared buffer was being (re)allocated.
+    CoalescedNotification,      // The onTimer() notification was merged with the one that was still pending.
+    Reallocation,               // The shared buffer was (re)allocated.
+    SharedChunk,                // The chunk was sliced from the window that was fetched for all panels instead of fetched from the visualisation stream.
+    Allocation,                 // A heap allocation was made by the frame pipeline. Stays 0 in steady state.
+    SuppressedFrame,            // The frame was not delivered because the signal was silent or playback was paused.
+
+    Count
+};
+
+/// <summary>
+/// Records the latency of each stage of the frame pipeline of a panel in a histogram and counts the pipeline events. All methods are lock-free.
+/// </summary>
+class FrameRecorder
+{
+public:
+    FrameRecorder() noexcept : _Period(0), _LastTick(0)
+    {
+        Reset();
+    }
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder & operator=(const FrameRecorder &) = delete;
+
+    void Reset() noexcept;
+
+    void SetPeriod(uint64_t microseconds) noexcept;
+    void Tick(uint64_t now) noexcept;
+
+    void Record(FrameStage stage, uint64_t microseconds) noexcept
+    {
+        _Histograms[(size_t) stage].Record(microseconds);
+    }
+
+    void Increment(FrameEvent event, uint64_t count = 1) noexcept
+    {
+        _Counters[(size_t) event].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    const LatencyHistogram & GetHistogram(FrameStage stage) const noexcept
+    {
+        return _Histograms[(size_t) stage];
+    }
+
+    uint64_t GetCounter(FrameEvent event) const noexcept
+    {
+        return _Counters[(size_t) event].load(std::memory_order_relaxed);
+    }
+
+    std::string ToJSON() const;
+    std::string ToString() const;
+
+    static uint64_t Now() noexcept;
+
+    static const char * GetName(FrameStage stage) noexcept;
+    static const char * GetName(FrameEvent event) noexcept;
+
+private:
+    LatencyHistogram _Histograms[(size_t) FrameStage::Count];
+    std::atomic<uint64_t> _Counters[(size_t) FrameEvent::Count];
+
+    std::atomic<uint64_t> _Period;      // in us
+    std::atomic<uint64_t> _LastTick;    // in us
+};
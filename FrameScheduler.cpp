@@ -0,0 +1,222 @@
+
+/** $VER: FrameScheduler.cpp (2026.10.16) P. Stuer - Implements a high-resolution frame timer on the thread pool. **/
+
+#include "pch.h"
+
+#include "FrameScheduler.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Starts calling the specified function at the specified rate, in Hz. The function is called on a thread pool thread and must not stop the scheduler itself.
+/// </summary>
+HRESULT FrameScheduler::Start(double frameRate, std::function<void()> callback) noexcept
+{
+    Stop();
+
+    if (frameRate <= 0.)
+        return E_INVALIDARG;
+
+    // Prefer a high-resolution timer (Windows 10 1803 and later). Regular timers are serviced at the resolution of the system clock, typically 15.6 ms.
+    _hTimer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+    if (_hTimer == NULL)
+        _hTimer = ::CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+
+    if (_hTimer == NULL)
+        return HRESULT_FROM_WIN32(::GetLastError());
+
+    _Wait = ::CreateThreadpoolWait(WaitCallback, this, nullptr);
+
+    if (_Wait == nullptr)
+    {
+        HRESULT hr = HRESULT_FROM_WIN32(::GetLastError());
+
+        ::CloseHandle(_hTimer);
+        _hTimer = NULL;
+
+        return hr;
+    }
+
+    LARGE_INTEGER Frequency;
+
+    ::QueryPerformanceFrequency(&Frequency);
+
+    _Frequency = Frequency.QuadPart;
+    _Period = (int64_t) ((double) _Frequency / frameRate);
+    _FrameRate = frameRate;
+
+    _Callback = std::move(callback);
+
+    ResetStatistics();
+
+    const int64_t Now = GetTime();
+
+    _LastTick = 0;
+    _NextDeadline = Now;
+
+    _IsRunning = true;
+
+    Schedule(Now);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Stops the scheduler and waits for the callback in progress, if any, to complete.
+/// </summary>
+void FrameScheduler::Stop() noexcept
+{
+    if (_Wait == nullptr)
+        return;
+
+    _IsRunning = false;
+
+    ::WaitForThreadpoolWaitCallbacks(_Wait, TRUE);
+
+    // A callback that was still running may have rearmed the wait.
+    ::SetThreadpoolWait(_Wait, nullptr, nullptr);
+    ::WaitForThreadpoolWaitCallbacks(_Wait, TRUE);
+
+    ::CloseThreadpoolWait(_Wait);
+    _Wait = nullptr;
+
+    ::CancelWaitableTimer(_hTimer);
+    ::CloseHandle(_hTimer);
+    _hTimer = NULL;
+
+    _Callback = nullptr;
+}
+
+/// <summary>
+/// Gets the timing statistics since the scheduler was started.
+/// </summary>
+frame_statistics_t FrameScheduler::GetStatistics() const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    frame_statistics_t Statistics = _Statistics;
+
+    const uint64_t IntervalCount = (Statistics.FrameCount > 0) ? Statistics.FrameCount - 1 : 0;
+
+    Statistics.FrameRate = _FrameRate;
+    Statistics.JitterDeviation = (IntervalCount > 1) ? std::sqrt(_JitterM2 / (double) (IntervalCount - 1)) : 0.;
+
+    return Statistics;
+}
+
+/// <summary>
+/// Resets the timing statistics.
+/// </summary>
+void FrameScheduler::ResetStatistics() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    _Statistics = { };
+    _JitterM2 = 0.;
+}
+
+/// <summary>
+/// Handles the expiration of the timer.
+/// </summary>
+void CALLBACK FrameScheduler::WaitCallback(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WAIT, TP_WAIT_RESULT) noexcept
+{
+    ((FrameScheduler *) context)->OnTick();
+}
+
+/// <summary>
+/// Calls the function and schedules the next tick.
+/// </summary>
+void FrameScheduler::OnTick() noexcept
+{
+    if (!_IsRunning)
+        return;
+
+    const int64_t Now = GetTime();
+    const int64_t Interval = (_LastTick != 0) ? Now - _LastTick : 0;
+
+    _LastTick = Now;
+
+    _Callback();
+
+    const int64_t End = GetTime();
+
+    UpdateStatistics(Interval, End - Now);
+
+    if (_IsRunning)
+        Schedule(End);
+}
+
+/// <summary>
+/// Arms the timer for the next deadline. Deadlines that have already passed are skipped instead of causing a burst of ticks.
+/// </summary>
+void FrameScheduler::Schedule(int64_t now) noexcept
+{
+    _NextDeadline += _Period;
+
+    if (_NextDeadline <= now)
+    {
+        const int64_t MissedFrameCount = ((now - _NextDeadline) / _Period) + 1;
+
+        _NextDeadline += MissedFrameCount * _Period;
+
+        std::lock_guard<std::mutex> Lock(_Lock);
+
+        _Statistics.MissedFrameCount += (uint64_t) MissedFrameCount;
+    }
+
+    LARGE_INTEGER DueTime;
+
+    DueTime.QuadPart = -std::max((LONGLONG) (((_NextDeadline - now) * 10'000'000) / _Frequency), (LONGLONG) 1); // Relative, in 100 ns units
+
+    ::SetWaitableTimerEx(_hTimer, &DueTime, 0, nullptr, nullptr, nullptr, 0);
+    ::SetThreadpoolWait(_Wait, _hTimer, nullptr);
+}
+
+/// <summary>
+/// Updates the timing statistics with the interval since the previous tick and the duration of the callback, in performance counter ticks.
+/// </summary>
+void FrameScheduler::UpdateStatistics(int64_t interval, int64_t duration) noexcept
+{
+    const double ToMilliseconds = 1000. / (double) _Frequency;
+
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    auto & s = _Statistics;
+
+    s.FrameCount++;
+
+    const double Duration = (double) duration * ToMilliseconds;
+
+    s.MeanDuration += (Duration - s.MeanDuration) / (double) s.FrameCount;
+    s.MaxDuration = std::max(s.MaxDuration, Duration);
+
+    // The first tick has no previous tick to measure the interval against.
+    if (interval == 0)
+        return;
+
+    const uint64_t IntervalCount = s.FrameCount - 1;
+
+    const double Interval = (double) interval * ToMilliseconds;
+    const double Jitter = std::abs(Interval - ((double) _Period * ToMilliseconds));
+
+    s.MeanInterval += (Interval - s.MeanInterval) / (double) IntervalCount;
+    s.MaxJitter = std::max(s.MaxJitter, Jitter);
+
+    const double Delta = Jitter - s.MeanJitter;
+
+    s.MeanJitter += Delta / (double) IntervalCount;
+    _JitterM2 += Delta * (Jitter - s.MeanJitter);
+}
+
+/// <summary>
+/// Gets the current value of the performance counter.
+/// </summary>
+int64_t FrameScheduler::GetTime() noexcept
+{
+    LARGE_INTEGER Counter;
+
+    ::QueryPerformanceCounter(&Counter);
+
+    return Counter.QuadPart;
+}
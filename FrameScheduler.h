@@ -0,0 +1,86 @@
+
+/** $VER: FrameScheduler.h (2026.10.16) P. Stuer - Implements a high-resolution frame timer on the thread pool. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+/// <summary>
+/// Represents the timing statistics of a frame scheduler. All times are in milliseconds.
+/// </summary>
+struct frame_statistics_t
+{
+    double FrameRate;                   // Requested rate, in Hz
+
+    uint64_t FrameCount;                // Number of ticks
+    uint64_t MissedFrameCount;          // Number of deadlines that passed before the previous tick completed
+
+    double MeanInterval;                // Mean time between two ticks
+    double MeanJitter;                  // Mean absolute deviation of the interval from the period
+    double MaxJitter;                   // Largest absolute deviation of the interval from the period
+    double JitterDeviation;             // Standard deviation of the jitter
+
+    double MeanDuration;                // Mean time spent in the callback
+    double MaxDuration;                 // Longest time spent in the callback
+};
+
+/// <summary>
+/// Calls a function at a fixed rate on a thread pool thread. Uses a high-resolution waitable timer when the OS supports it and schedules each tick against an absolute deadline so errors don't accumulate.
+/// </summary>
+class FrameScheduler
+{
+public:
+    FrameScheduler() : _hTimer(), _Wait(), _Frequency(), _Period(), _NextDeadline(), _LastTick(), _IsRunning(false), _FrameRate(), _Statistics(), _JitterM2() { }
+
+    FrameScheduler(const FrameScheduler &) = delete;
+    FrameScheduler & operator=(const FrameScheduler &) = delete;
+    FrameScheduler(FrameScheduler &&) = delete;
+    FrameScheduler & operator=(FrameScheduler &&) = delete;
+
+    virtual ~FrameScheduler()
+    {
+        Stop();
+    }
+
+    HRESULT Start(double frameRate, std::function<void()> callback) noexcept;
+    void Stop() noexcept;
+
+    bool IsRunning() const noexcept
+    {
+        return _IsRunning;
+    }
+
+    frame_statistics_t GetStatistics() const noexcept;
+    void ResetStatistics() noexcept;
+
+private:
+    static void CALLBACK WaitCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WAIT wait, TP_WAIT_RESULT waitResult) noexcept;
+
+    void OnTick() noexcept;
+    void Schedule(int64_t now) noexcept;
+    void UpdateStatistics(int64_t interval, int64_t duration) noexcept;
+
+    static int64_t GetTime() noexcept;
+
+private:
+    HANDLE _hTimer;
+    PTP_WAIT _Wait;
+
+    std::function<void()> _Callback;
+
+    int64_t _Frequency;                 // Performance counter ticks per second
+    int64_t _Period;                    // in performance counter ticks
+    int64_t _NextDeadline;              // in performance counter ticks
+    int64_t _LastTick;                  // in performance counter ticks
+
+    std::atomic<bool> _IsRunning;
+    double _FrameRate;
+
+    mutable std::mutex _Lock;
+    frame_statistics_t _Statistics;
+    double _JitterM2;                   // Sum of the squared differences from the mean jitter (Welford)
+};
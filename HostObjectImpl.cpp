@@ -1,5 +1,5 @@
 
-/** $VER: HostObjectImpl.cpp (2024.12.15) P. Stuer **/
+/** $VER: HostObjectImpl.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -15,6 +15,8 @@
 #include "Encoding.h"
 
 #include "ProcessLocationsHandler.h"
+#include "TrackAnalysis.h"
+#include "MaskEncoder.h"
 
 #include <SDK/titleformat.h>
 #include <SDK/playlist.h>
@@ -27,7 +29,7 @@
 /// <summary>
 /// Initializes a new instance
 /// </summary>
-HostObject::HostObject(HostObject::RunCallbackAsync runCallbackAsync) : _RunCallbackAsync(runCallbackAsync)
+HostObject::HostObject(HostObject::RunCallbackAsync runCallbackAsync, HostObject::RequestWaveformCallback requestWaveform, HostObject::GetFrameStatisticsCallback getFrameStatistics, HostObject::AnalyzeTrackCallback analyzeTrack, HostObject::SubscribePlaylistEventsCallback subscribePlaylistEvents) : _RunCallbackAsync(runCallbackAsync), _RequestWaveform(requestWaveform), _GetFrameStatistics(getFrameStatistics), _AnalyzeTrack(analyzeTrack), _SubscribePlaylistEvents(subscribePlaylistEvents)
 {
     _PlaybackControl = playback_control::get();
 }
@@ -509,6 +511,140 @@ STDMETHODIMP HostObject::put_playbackOrder(int playlistIndex)
 
 #pragma endregion
 
+#pragma region Visualisation
+
+/// <summary>
+/// Gets the number of envelope buckets per channel requested by the script (0 = use the configuration).
+/// </summary>
+STDMETHODIMP HostObject::get_envelopeBucketCount(int * count)
+{
+    if (count == nullptr)
+        return E_INVALIDARG;
+
+    *count = (int) _EnvelopeBucketCount.load();
+
+    return S_OK;
+}
+
+/// <summary>
+/// Sets the number of envelope buckets per channel f.e. to the number of pixel columns of a canvas (0 = use the configuration).
+/// </summary>
+STDMETHODIMP HostObject::put_envelopeBucketCount(int count)
+{
+    if (count < 0)
+        return E_INVALIDARG;
+
+    _EnvelopeBucketCount = (size_t) count;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Starts generating the waveform of the whole track in the background. The waveform is posted as a shared buffer with "Waveform" as type in its additional data.
+/// </summary>
+STDMETHODIMP HostObject::requestWaveform(BSTR filePath, int subsongIndex)
+{
+    if ((filePath == nullptr) || (subsongIndex < 0))
+        return E_INVALIDARG;
+
+    pfc::string8 Path;
+
+    try
+    {
+        filesystem::g_get_canonical_path(::WideToUTF8(filePath).c_str(), Path);
+    }
+    catch (const std::exception &)
+    {
+        return E_INVALIDARG;
+    }
+
+    _RequestWaveform(Path, (uint32_t) subsongIndex);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Gets the timing statistics of the frame timer as JSON: the requested rate, the number of ticks and missed deadlines, and the interval, jitter and callback duration in milliseconds.
+/// </summary>
+STDMETHODIMP HostObject::get_frameStatistics(BSTR * json)
+{
+    if (json == nullptr)
+        return E_INVALIDARG;
+
+    *json = ::SysAllocString(_GetFrameStatistics().c_str());
+
+    return S_OK;
+}
+
+/// <summary>
+/// Starts analyzing a track in the background. The features are a comma-separated list of "rms", "peak", "dr", "loudness" and "silence"; an empty list selects all features.
+/// The result is posted to the script as a "message" event with "Analysis" as type and the returned request id.
+/// </summary>
+STDMETHODIMP HostObject::analyzeTrack(BSTR filePath, int subsongIndex, BSTR features, int * requestId)
+{
+    if ((filePath == nullptr) || (subsongIndex < 0) || (features == nullptr) || (requestId == nullptr))
+        return E_INVALIDARG;
+
+    static const struct { const wchar_t * Name; TrackFeature Feature; } FeatureNames[] =
+    {
+        { L"rms",      TrackFeature::RMS },
+        { L"peak",     TrackFeature::Peak },
+        { L"dr",       TrackFeature::DynamicRange },
+        { L"loudness", TrackFeature::Loudness },
+        { L"silence",  TrackFeature::Silence },
+    };
+
+    uint32_t Features = 0;
+
+    for (const wchar_t * Name = features; *Name != L'\0';)
+    {
+        const wchar_t * End = ::wcschr(Name, L',');
+
+        const size_t Length = (End != nullptr) ? (size_t) (End - Name) : ::wcslen(Name);
+
+        auto Iter = std::find_if(std::begin(FeatureNames), std::end(FeatureNames), [Name, Length](const auto & item) { return (::wcslen(item.Name) == Length) && (::_wcsnicmp(item.Name, Name, Length) == 0); });
+
+        if (Iter == std::end(FeatureNames))
+            return E_INVALIDARG;
+
+        Features |= (uint32_t) Iter->Feature;
+
+        Name += Length + ((End != nullptr) ? 1 : 0);
+    }
+
+    if (Features == 0)
+        Features = (uint32_t) TrackFeature::All;
+
+    pfc::string8 Path;
+
+    try
+    {
+        filesystem::g_get_canonical_path(::WideToUTF8(filePath).c_str(), Path);
+    }
+    catch (const std::exception &)
+    {
+        return E_INVALIDARG;
+    }
+
+    *requestId = _AnalyzeTrack(Path, (uint32_t) subsongIndex, Features);
+
+    return (*requestId > 0) ? S_OK : E_FAIL;
+}
+
+/// <summary>
+/// Declares the playlist event handlers the script implements, f.e. "onPlaylistItemsAdded,onPlaylistActivated". "*" subscribes to all events, an empty list to none.
+/// Only the declared handlers are called. Without a declaration the handlers that are defined as window functions when the page has loaded are detected.
+/// </summary>
+STDMETHODIMP HostObject::subscribePlaylistEvents(BSTR handlerNames)
+{
+    if (handlerNames == nullptr)
+        return E_INVALIDARG;
+
+    return _SubscribePlaylistEvents(handlerNames) ? S_OK : E_INVALIDARG;
+}
+
+#pragma endregion
+
 #pragma region IDispatch
 
 /// <summary>
@@ -765,16 +901,24 @@ const std::wstring Stringify(const std::wstring & s)
 /// Converts a metadb handle list to a JSON string.
 /// </summary>
 std::wstring ToJSON(const metadb_handle_list & hItems)
+{
+    return ToJSON(hItems, 0, hItems.get_count());
+}
+
+/// <summary>
+/// Converts the specified range of a list of metadb handles to a JSON string.
+/// </summary>
+std::wstring ToJSON(const metadb_handle_list & hItems, t_size first, t_size count)
 {
     std::wstring Result = L"[";
     bool IsFirstItem = true;
 
-    for (const auto & hItem : hItems)
+    for (t_size i = first; (i < first + count) && (i < hItems.get_count()); ++i)
     {
         if (!IsFirstItem)
             Result.append(L",");
 
-        const playable_location & Location = hItem->get_location();
+        const playable_location & Location = hItems[i]->get_location();
 
         std::string Path = Stringify(Location.get_path());
 
@@ -789,26 +933,24 @@ std::wstring ToJSON(const metadb_handle_list & hItems)
 }
 
 /// <summary>
-/// Converts a bit array to a JSON string.
+/// Converts a bit array to a JSON string. The set items are encoded as runs or as a bit set, whichever is smaller. See MaskEncoder.
 /// </summary>
 std::wstring ToJSON(const bit_array & mask, t_size count)
 {
-    std::wstring Result = L"[";
-    bool IsFirstItem = true;
+    MaskEncoder Encoder;
+
+    Encoder.Reset(count);
 
-    for (t_size Iter = mask.find_first(true, 0, count); Iter < count; Iter = mask.find_next(true, Iter, count))
+    for (t_size Start = mask.find_first(true, 0, count); Start < count;)
     {
-        if (!IsFirstItem)
-            Result.append(L",");
+        const t_size End = mask.find_first(false, Start, count);
 
-        Result.append(::FormatText(LR"(%d)", Iter).c_str());
+        Encoder.AddRun(Start, End - Start);
 
-        IsFirstItem = false;
+        Start = (End < count) ? mask.find_first(true, End, count) : count;
     }
 
-    Result.append(L"]");
-
-    return Result;
+    return Encoder.Encode();
 }
 
 /// <summary>
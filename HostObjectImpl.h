@@ -1,10 +1,11 @@
 
-/** $VER: HostObjectImpl.h (2024.12.02) P. Stuer **/
+/** $VER: HostObjectImpl.h (2026.10.16) P. Stuer **/
 
 #pragma once
 
 #include "pch.h"
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <string>
@@ -35,8 +36,12 @@ public:
 
     typedef std::function<void(void)> Callback;
     typedef std::function<void(Callback)> RunCallbackAsync;
+    typedef std::function<void(const char * path, uint32_t subsongIndex)> RequestWaveformCallback;
+    typedef std::function<std::wstring(void)> GetFrameStatisticsCallback;
+    typedef std::function<int(const char * path, uint32_t subsongIndex, uint32_t features)> AnalyzeTrackCallback;
+    typedef std::function<bool(const wchar_t * handlerNames)> SubscribePlaylistEventsCallback;
 
-    HostObject(RunCallbackAsync runCallbackAsync);
+    HostObject(RunCallbackAsync runCallbackAsync, RequestWaveformCallback requestWaveform, GetFrameStatisticsCallback getFrameStatistics, AnalyzeTrackCallback analyzeTrack, SubscribePlaylistEventsCallback subscribePlaylistEvents);
 
     #pragma region IHostObject
 
@@ -141,8 +146,29 @@ public:
     STDMETHODIMP get_playbackOrder(int * playlistIndex) override;
     STDMETHODIMP put_playbackOrder(int playlistIndex) override;
 
+    /* Visualisation */
+
+    STDMETHODIMP get_envelopeBucketCount(int * count) override;
+    STDMETHODIMP put_envelopeBucketCount(int count) override;
+
+    STDMETHODIMP requestWaveform(BSTR filePath, int subsongIndex) override;
+
+    STDMETHODIMP get_frameStatistics(BSTR * json) override;
+
+    STDMETHODIMP analyzeTrack(BSTR filePath, int subsongIndex, BSTR features, int * requestId) override;
+
+    STDMETHODIMP subscribePlaylistEvents(BSTR handlerNames) override;
+
     #pragma endregion
 
+    /// <summary>
+    /// Gets the number of envelope buckets requested by the script. 0 if the script did not request a specific number.
+    /// </summary>
+    size_t GetEnvelopeBucketCount() const noexcept
+    {
+        return _EnvelopeBucketCount;
+    }
+
     #pragma region IDispatch
 
     STDMETHODIMP GetTypeInfoCount(UINT * typeInfoCount) override;
@@ -173,9 +199,15 @@ private:
 
     wil::com_ptr<IDispatch> _Callback;
     RunCallbackAsync _RunCallbackAsync;
+    RequestWaveformCallback _RequestWaveform;
+    GetFrameStatisticsCallback _GetFrameStatistics;
+    AnalyzeTrackCallback _AnalyzeTrack;
+    SubscribePlaylistEventsCallback _SubscribePlaylistEvents;
 
     service_ptr_t<playback_control> _PlaybackControl;
 
+    std::atomic<size_t> _EnvelopeBucketCount = 0; // Read by the frame scheduler on a thread pool thread.
+
     /// <summary>
     /// Represents an Album Art Manager configuration to allow overriding the default configuration in this component (see album_art_manager_v3::open_v3)
     /// </summary>
@@ -215,5 +247,6 @@ extern const std::string Stringify(const char * s);
 extern const std::wstring Stringify(const std::wstring & s);
 
 extern std::wstring ToJSON(const metadb_handle_list & hItems);
+extern std::wstring ToJSON(const metadb_handle_list & hItems, t_size first, t_size count);
 extern std::wstring ToJSON(const bit_array & mask, t_size count);
 extern std::wstring ToJSON(const t_size * array, t_size count);
@@ -0,0 +1,159 @@
+
+/** $VER: LevelMeter.cpp (2026.10.16) P. Stuer - Measures the peak, RMS and VU level of each channel with meter ballistics. Host-independent. **/
+
+#include "LevelMeter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double Pi = 3.14159265358979323846;
+
+// A critically damped VU movement would not overshoot. A damping ratio of 0.81 with a natural frequency of 2.136 Hz reaches 99% of the final value in 300 ms and overshoots by about 1.3%.
+static const double VUFrequency = 2.136;    // in Hz
+static const double VUDamping = 0.81;
+
+// Integration time of the RMS level, in ms. Asymmetric time constants would bias the mean square towards the peaks of the waveform.
+static const double RMSTime = 300.;
+
+// Converts the rectified mean of a sine wave to its RMS value.
+static const double VUCalibration = Pi / (2. * 1.4142135623730951);
+
+/// <summary>
+/// Initializes the meter. Resets the levels only when the stream format changes so the ballistics can be changed while playing.
+/// </summary>
+void LevelMeter::Initialize(const level_meter_settings_t & settings, uint32_t sampleRate, uint32_t channelCount) noexcept
+{
+    channelCount = std::min(channelCount, MaxChannels);
+
+    if ((sampleRate == _SampleRate) && (channelCount == _ChannelCount) && (settings == _Settings))
+        return;
+
+    const bool IsFormatChanged = (sampleRate != _SampleRate) || (channelCount != _ChannelCount);
+
+    _Settings = settings;
+    _SampleRate = sampleRate;
+    _ChannelCount = channelCount;
+
+    _AttackCoefficient  = GetCoefficient(settings.AttackTime, sampleRate);
+    _ReleaseCoefficient = GetCoefficient(settings.ReleaseTime, sampleRate);
+    _HoldSampleCount    = (size_t) std::max(settings.PeakHoldTime * (double) sampleRate / 1000., 0.);
+    _RMSCoefficient     = GetCoefficient(RMSTime, sampleRate);
+    _VUOmega            = (sampleRate != 0) ? 2. * Pi * VUFrequency / (double) sampleRate : 0.;
+
+    if (IsFormatChanged)
+        Reset();
+}
+
+/// <summary>
+/// Resets all levels to silence.
+/// </summary>
+void LevelMeter::Reset() noexcept
+{
+    for (auto & Channel : _Channels)
+        Channel = { };
+}
+
+/// <summary>
+/// Adds interleaved samples to the measurement.
+/// </summary>
+void LevelMeter::Process(const float * samples, size_t frameCount) noexcept
+{
+    ProcessSamples(samples, frameCount);
+}
+
+/// <summary>
+/// Adds interleaved samples to the measurement.
+/// </summary>
+void LevelMeter::Process(const double * samples, size_t frameCount) noexcept
+{
+    ProcessSamples(samples, frameCount);
+}
+
+/// <summary>
+/// Gets the levels of each channel, in dBFS.
+/// </summary>
+void LevelMeter::GetLevels(level_t * levels) const noexcept
+{
+    const auto ToDecibel = [](double value) noexcept -> float
+    {
+        return (value > 0.) ? (float) (20. * std::log10(value)) : -std::numeric_limits<float>::infinity();
+    };
+
+    for (uint32_t i = 0; i < _ChannelCount; ++i)
+    {
+        const auto & Channel = _Channels[i];
+
+        levels[i].Peak     = ToDecibel(Channel.Peak);
+        levels[i].RMS      = ToDecibel(std::sqrt(Channel.MeanSquare));
+        levels[i].VU       = ToDecibel(Channel.VU * VUCalibration);
+        levels[i].PeakHold = ToDecibel(Channel.PeakHold);
+    }
+}
+
+/// <summary>
+/// Adds interleaved samples to the measurement.
+/// </summary>
+template<typename T>
+void LevelMeter::ProcessSamples(const T * samples, size_t frameCount) noexcept
+{
+    if (_ChannelCount == 0)
+        return;
+
+    const double w = _VUOmega;
+    const double ww = w * w;
+    const double Damping = 2. * VUDamping * w;
+
+    for (uint32_t j = 0; j < _ChannelCount; ++j)
+    {
+        auto & c = _Channels[j];
+
+        const T * p = samples + j;
+
+        for (size_t i = 0; i < frameCount; ++i, p += _ChannelCount)
+        {
+            const double x = std::abs((double) *p);
+
+            // Peak
+            c.Peak = (x > c.Peak) ? x + _AttackCoefficient * (c.Peak - x) : c.Peak * _ReleaseCoefficient;
+
+            // RMS: one-pole integration of the mean square.
+            const double Square = x * x;
+
+            c.MeanSquare = Square + _RMSCoefficient * (c.MeanSquare - Square);
+
+            // VU: second-order low-pass of the rectified signal (semi-implicit Euler). The needle stops at 0.
+            c.VUVelocity += ww * (x - c.VU) - Damping * c.VUVelocity;
+            c.VU += c.VUVelocity;
+
+            if (c.VU < 0.)
+            {
+                c.VU = 0.;
+                c.VUVelocity = 0.;
+            }
+
+            // Peak hold
+            if (c.Peak >= c.PeakHold)
+            {
+                c.PeakHold = c.Peak;
+                c.HoldCounter = 0;
+            }
+            else
+            if (c.HoldCounter < _HoldSampleCount)
+                ++c.HoldCounter;
+            else
+                c.PeakHold = std::max(c.Peak, c.PeakHold * _ReleaseCoefficient);
+        }
+    }
+}
+
+/// <summary>
+/// Gets the coefficient of a one-pole filter with the specified time constant, in ms. A time constant of 0 follows the input immediately.
+/// </summary>
+double LevelMeter::GetCoefficient(double time, uint32_t sampleRate) noexcept
+{
+    if ((time <= 0.) || (sampleRate == 0))
+        return 0.;
+
+    return std::exp(-1000. / (time * (double) sampleRate));
+}
@@ -0,0 +1,91 @@
+
+/** $VER: LevelMeter.h (2026.10.16) P. Stuer - Measures the peak, RMS and VU level of each channel with meter ballistics. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// Represents the levels of a channel, in dBFS. Silence is -infinity.
+/// </summary>
+struct level_t
+{
+    float Peak;                 // Peak level with the attack and release time constants
+    float RMS;                  // RMS level, integrated over 300 ms
+    float VU;                   // Level with standard VU ballistics (99% in 300 ms, 1-1.5% overshoot), calibrated to read the RMS level of a sine wave
+    float PeakHold;             // Highest peak level during the hold time, released afterwards
+};
+
+/// <summary>
+/// Represents the ballistics of the level meter. All times are in milliseconds.
+/// </summary>
+struct level_meter_settings_t
+{
+    double AttackTime;          // Time constant of a rising peak level. 0 = instantaneous (sample peak meter), 5-10 = PPM
+    double ReleaseTime;         // Time constant of a falling peak and held peak level
+    double PeakHoldTime;        // Time a peak is held before it is released
+
+    bool operator==(const level_meter_settings_t & other) const noexcept
+    {
+        return (AttackTime == other.AttackTime) && (ReleaseTime == other.ReleaseTime) && (PeakHoldTime == other.PeakHoldTime);
+    }
+};
+
+/// <summary>
+/// Measures the levels of interleaved samples. The state is kept across calls so the samples must be fed without gaps or overlaps.
+/// </summary>
+class LevelMeter
+{
+public:
+    LevelMeter() noexcept : _Settings(), _SampleRate(), _ChannelCount(), _AttackCoefficient(), _ReleaseCoefficient(), _HoldSampleCount(), _RMSCoefficient(), _VUOmega(), _Channels() { }
+
+    void Initialize(const level_meter_settings_t & settings, uint32_t sampleRate, uint32_t channelCount) noexcept;
+    void Reset() noexcept;
+
+    void Process(const float * samples, size_t frameCount) noexcept;
+    void Process(const double * samples, size_t frameCount) noexcept;
+
+    void GetLevels(level_t * levels) const noexcept;
+
+    uint32_t GetChannelCount() const noexcept
+    {
+        return _ChannelCount;
+    }
+
+    static constexpr uint32_t MaxChannels = 32;
+
+private:
+    template<typename T> void ProcessSamples(const T * samples, size_t frameCount) noexcept;
+
+    static double GetCoefficient(double time, uint32_t sampleRate) noexcept;
+
+private:
+    /// <summary>
+    /// Represents the state of a channel. Levels are linear; the RMS state is a mean square.
+    /// </summary>
+    struct channel_t
+    {
+        double Peak;
+        double MeanSquare;
+
+        double VU;              // Output of the second-order VU filter
+        double VUVelocity;      // Derivative of the output of the VU filter
+
+        double PeakHold;
+        size_t HoldCounter;     // Number of samples since the held peak was set
+    };
+
+    level_meter_settings_t _Settings;
+
+    uint32_t _SampleRate;
+    uint32_t _ChannelCount;
+
+    double _AttackCoefficient;
+    double _ReleaseCoefficient;
+    size_t _HoldSampleCount;
+    double _RMSCoefficient;
+    double _VUOmega;            // Natural angular frequency of the VU filter times the sample period
+
+    channel_t _Channels[MaxChannels];
+};
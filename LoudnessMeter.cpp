@@ -0,0 +1,451 @@
+
+/** $VER: LoudnessMeter.cpp (2026.10.16) P. Stuer - Measures the loudness and true peak of a stream according to ITU-R BS.1770-4 and EBU R128. Host-independent. **/
+
+#include "LoudnessMeter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double Pi = 3.14159265358979323846;
+
+static const double AbsoluteGate = -70.;        // in LUFS
+static const double IntegratedRelativeGate = -10.; // in LU
+static const double RangeRelativeGate = -20.;   // in LU
+
+// The histograms cover -70 to +10 LUFS with a resolution of 0.1 LU.
+static const double HistogramMin = -70.;
+static const double HistogramMax = 10.;
+static const double HistogramStep = 0.1;
+static const size_t HistogramBinCount = (size_t) ((HistogramMax - HistogramMin) / HistogramStep);
+
+static const float NegativeInfinity = -std::numeric_limits<float>::infinity();
+
+/// <summary>
+/// Initializes the meter for the specified stream format and resets the measurement. The channel weights are 1.0 for the front channels, 1.41 for the surround channels and 0.0 for the LFE channel.
+/// </summary>
+void LoudnessMeter::Initialize(uint32_t sampleRate, uint32_t channelCount, const double * channelWeights)
+{
+    _SampleRate = sampleRate;
+    _ChannelCount = std::min(channelCount, MaxChannels);
+
+    for (uint32_t i = 0; i < _ChannelCount; ++i)
+        _ChannelWeights[i] = (channelWeights != nullptr) ? channelWeights[i] : 1.;
+
+    // K-weighting filter coefficients, derived from the analog prototypes of BS.1770 so they are valid for any sample rate.
+    {
+        const double f0 = 1681.974450955533;
+        const double G  = 3.999843853973347;
+        const double Q  = 0.7071752369554196;
+
+        const double K  = std::tan(Pi * f0 / (double) sampleRate);
+        const double Vh = std::pow(10., G / 20.);
+        const double Vb = std::pow(Vh, 0.4996667741545416);
+
+        const double a0 = 1. + K / Q + K * K;
+
+        const biquad_t Filter = { (Vh + Vb * K / Q + K * K) / a0, 2. * (K * K - Vh) / a0, (Vh - Vb * K / Q + K * K) / a0, 2. * (K * K - 1.) / a0, (1. - K / Q + K * K) / a0, 0., 0. };
+
+        for (auto & f : _PreFilter)
+            f = Filter;
+    }
+
+    {
+        const double f0 = 38.13547087602444;
+        const double Q  = 0.5003270373238773;
+
+        const double K  = std::tan(Pi * f0 / (double) sampleRate);
+
+        const double a0 = 1. + K / Q + K * K;
+
+        const biquad_t Filter = { 1., -2., 1., 2. * (K * K - 1.) / a0, (1. - K / Q + K * K) / a0, 0., 0. };
+
+        for (auto & f : _RLBFilter)
+            f = Filter;
+    }
+
+    _BlockSize = std::max((size_t) ((sampleRate + 5) / 10), (size_t) 1);
+
+    // True peak interpolator: a Hann-windowed sinc low-pass at the original Nyquist frequency, split into one phase per oversampled position.
+    {
+        const size_t TapCount = Oversampling * TapsPerPhase;
+        const double Center = (double) (TapCount - 1) / 2.;
+
+        for (size_t i = 0; i < TapCount; ++i)
+        {
+            const double x = ((double) i - Center) / (double) Oversampling;
+            const double Sinc = (x == 0.) ? 1. : std::sin(Pi * x) / (Pi * x);
+            const double Window = 0.5 - 0.5 * std::cos(2. * Pi * (double) (i + 1) / (double) (TapCount + 1));
+
+            _Coefficients[i % Oversampling][i / Oversampling] = Sinc * Window;
+        }
+
+        // Normalize each phase to unity gain at DC.
+        for (auto & Phase : _Coefficients)
+        {
+            double Sum = 0.;
+
+            for (double c : Phase)
+                Sum += c;
+
+            for (double & c : Phase)
+                c /= Sum;
+        }
+    }
+
+    _Integrated.Counts.assign(HistogramBinCount, 0);
+    _Integrated.Energies.assign(HistogramBinCount, 0.);
+
+    _ShortTerm.Counts.assign(HistogramBinCount, 0);
+    _ShortTerm.Energies.assign(HistogramBinCount, 0.);
+
+    Reset();
+}
+
+/// <summary>
+/// Resets the measurement and the state of the filters.
+/// </summary>
+void LoudnessMeter::Reset() noexcept
+{
+    for (auto & f : _PreFilter)
+        f.z1 = f.z2 = 0.;
+
+    for (auto & f : _RLBFilter)
+        f.z1 = f.z2 = 0.;
+
+    _BlockFrameCount = 0;
+    _BlockSum = 0.;
+    _BlockIndex = 0;
+    _BlockCount = 0;
+
+    for (double & Block : _Blocks)
+        Block = 0.;
+
+    _Integrated.Clear();
+    _ShortTerm.Clear();
+
+    for (auto & History : _History)
+        for (double & Sample : History)
+            Sample = 0.;
+
+    for (size_t & Index : _HistoryIndex)
+        Index = 0;
+
+    _TruePeak = 0.;
+
+    _Values = { NegativeInfinity, NegativeInfinity, NegativeInfinity, 0.f, NegativeInfinity, NegativeInfinity, NegativeInfinity, 0.f };
+    _IsDirty = false;
+}
+
+/// <summary>
+/// Returns true if the meter was initialized for the specified stream format.
+/// </summary>
+bool LoudnessMeter::IsInitialized(uint32_t sampleRate, uint32_t channelCount, const double * channelWeights) const noexcept
+{
+    if ((sampleRate != _SampleRate) || (std::min(channelCount, MaxChannels) != _ChannelCount))
+        return false;
+
+    for (uint32_t i = 0; i < _ChannelCount; ++i)
+    {
+        if (_ChannelWeights[i] != ((channelWeights != nullptr) ? channelWeights[i] : 1.))
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Adds interleaved samples to the measurement.
+/// </summary>
+void LoudnessMeter::Process(const float * samples, size_t frameCount) noexcept
+{
+    ProcessSamples(samples, frameCount);
+}
+
+/// <summary>
+/// Adds interleaved samples to the measurement.
+/// </summary>
+void LoudnessMeter::Process(const double * samples, size_t frameCount) noexcept
+{
+    ProcessSamples(samples, frameCount);
+}
+
+/// <summary>
+/// Gets the current values of the meter.
+/// </summary>
+const loudness_t & LoudnessMeter::GetValues() noexcept
+{
+    if (_IsDirty)
+    {
+        UpdateIntegrated();
+
+        _IsDirty = false;
+    }
+
+    return _Values;
+}
+
+/// <summary>
+/// Adds interleaved samples to the measurement.
+/// </summary>
+template<typename T>
+void LoudnessMeter::ProcessSamples(const T * samples, size_t frameCount) noexcept
+{
+    if ((_SampleRate == 0) || (_ChannelCount == 0))
+        return;
+
+    double TruePeak = _TruePeak;
+
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        double Sum = 0.;
+
+        for (uint32_t j = 0; j < _ChannelCount; ++j)
+        {
+            const double Sample = (double) samples[j];
+
+            TruePeak = std::max(TruePeak, ProcessTruePeak(j, Sample));
+
+            if (_ChannelWeights[j] == 0.)
+                continue;
+
+            const double y = _RLBFilter[j].Process(_PreFilter[j].Process(Sample));
+
+            Sum += _ChannelWeights[j] * y * y;
+        }
+
+        _BlockSum += Sum;
+
+        if (++_BlockFrameCount == _BlockSize)
+            CompleteBlock();
+
+        samples += _ChannelCount;
+    }
+
+    _TruePeak = TruePeak;
+
+    _Values.TruePeak = (TruePeak > 0.) ? (float) (20. * std::log10(TruePeak)) : NegativeInfinity;
+}
+
+/// <summary>
+/// Completes a sub-block of 100 ms and updates the momentary and short-term loudness.
+/// </summary>
+void LoudnessMeter::CompleteBlock() noexcept
+{
+    _Blocks[_BlockIndex] = _BlockSum / (double) _BlockFrameCount;
+    _BlockIndex = (_BlockIndex + 1) % ShortTermBlockCount;
+    ++_BlockCount;
+
+    _BlockSum = 0.;
+    _BlockFrameCount = 0;
+
+    _Values.Duration = (float) ((double) (_BlockCount * _BlockSize) / (double) _SampleRate);
+
+    // Momentary loudness: the mean of the last 4 sub-blocks.
+    if (_BlockCount >= MomentaryBlockCount)
+    {
+        double Energy = 0.;
+
+        for (size_t i = 1; i <= MomentaryBlockCount; ++i)
+            Energy += _Blocks[(_BlockIndex + ShortTermBlockCount - i) % ShortTermBlockCount];
+
+        Energy /= (double) MomentaryBlockCount;
+
+        const double Loudness = ToLoudness(Energy);
+
+        _Values.Momentary = (float) Loudness;
+        _Values.MaxMomentary = std::max(_Values.MaxMomentary, _Values.Momentary);
+
+        if (Loudness > AbsoluteGate)
+            _Integrated.Add(Energy);
+
+        _IsDirty = true;
+    }
+
+    // Short-term loudness: the mean of the last 30 sub-blocks.
+    if (_BlockCount >= ShortTermBlockCount)
+    {
+        double Energy = 0.;
+
+        for (double Block : _Blocks)
+            Energy += Block;
+
+        Energy /= (double) ShortTermBlockCount;
+
+        const double Loudness = ToLoudness(Energy);
+
+        _Values.ShortTerm = (float) Loudness;
+        _Values.MaxShortTerm = std::max(_Values.MaxShortTerm, _Values.ShortTerm);
+
+        if (Loudness > AbsoluteGate)
+            _ShortTerm.Add(Energy);
+
+        _IsDirty = true;
+    }
+}
+
+/// <summary>
+/// Recalculates the integrated loudness (EBU Tech 3341) and the loudness range (EBU Tech 3342) from the histograms.
+/// </summary>
+void LoudnessMeter::UpdateIntegrated() noexcept
+{
+    const double Integrated = _Integrated.GetGatedLoudness(IntegratedRelativeGate);
+
+    _Values.Integrated = std::isfinite(Integrated) ? (float) Integrated : NegativeInfinity;
+
+    const double Threshold = _ShortTerm.GetGatedLoudness(std::numeric_limits<double>::infinity()) + RangeRelativeGate;
+
+    if (std::isfinite(Threshold))
+    {
+        const double Low  = _ShortTerm.GetPercentile(Threshold, 0.10);
+        const double High = _ShortTerm.GetPercentile(Threshold, 0.95);
+
+        _Values.LoudnessRange = (float) std::max(High - Low, 0.);
+    }
+    else
+        _Values.LoudnessRange = 0.f;
+}
+
+/// <summary>
+/// Gets the largest absolute value of the oversampled signal since the previous sample.
+/// </summary>
+double LoudnessMeter::ProcessTruePeak(uint32_t channel, double sample) noexcept
+{
+    auto & History = _History[channel];
+    size_t & Index = _HistoryIndex[channel];
+
+    History[Index] = sample;
+
+    double Peak = 0.;
+
+    for (const auto & Phase : _Coefficients)
+    {
+        double Sum = 0.;
+
+        // The most recent sample is multiplied by the first coefficient of the phase.
+        size_t k = Index;
+
+        for (double c : Phase)
+        {
+            Sum += c * History[k];
+
+            k = (k == 0) ? TapsPerPhase - 1 : k - 1;
+        }
+
+        Peak = std::max(Peak, std::abs(Sum));
+    }
+
+    Index = (Index + 1) % TapsPerPhase;
+
+    return Peak;
+}
+
+/// <summary>
+/// Converts a mean square to a loudness in LUFS.
+/// </summary>
+double LoudnessMeter::ToLoudness(double energy) noexcept
+{
+    return (energy > 0.) ? -0.691 + 10. * std::log10(energy) : -std::numeric_limits<double>::infinity();
+}
+
+/// <summary>
+/// Gets the histogram bin of the specified loudness.
+/// </summary>
+size_t LoudnessMeter::GetBin(double loudness) noexcept
+{
+    const double Bin = std::floor((loudness - HistogramMin) / HistogramStep);
+
+    return (size_t) std::clamp(Bin, 0., (double) (HistogramBinCount - 1));
+}
+
+/// <summary>
+/// Gets the loudness at the center of the specified histogram bin.
+/// </summary>
+double LoudnessMeter::GetBinLoudness(size_t bin) noexcept
+{
+    return HistogramMin + ((double) bin + 0.5) * HistogramStep;
+}
+
+/// <summary>
+/// Adds the mean square of a block to the histogram.
+/// </summary>
+void LoudnessMeter::histogram_t::Add(double energy) noexcept
+{
+    const size_t Bin = GetBin(ToLoudness(energy));
+
+    Counts[Bin]++;
+    Energies[Bin] += energy;
+}
+
+/// <summary>
+/// Clears the histogram.
+/// </summary>
+void LoudnessMeter::histogram_t::Clear() noexcept
+{
+    std::fill(Counts.begin(), Counts.end(), 0);
+    std::fill(Energies.begin(), Energies.end(), 0.);
+}
+
+/// <summary>
+/// Gets the mean loudness of the blocks that are louder than the mean loudness of all blocks plus the specified relative gate, in LU. An infinite gate returns the ungated mean.
+/// </summary>
+double LoudnessMeter::histogram_t::GetGatedLoudness(double relativeGate) const noexcept
+{
+    uint64_t Count = 0;
+    double Energy = 0.;
+
+    for (size_t i = 0; i < Counts.size(); ++i)
+    {
+        Count  += Counts[i];
+        Energy += Energies[i];
+    }
+
+    if (Count == 0)
+        return -std::numeric_limits<double>::infinity();
+
+    if (std::isinf(relativeGate))
+        return ToLoudness(Energy / (double) Count);
+
+    const size_t FirstBin = GetBin(ToLoudness(Energy / (double) Count) + relativeGate);
+
+    Count = 0;
+    Energy = 0.;
+
+    for (size_t i = FirstBin; i < Counts.size(); ++i)
+    {
+        Count  += Counts[i];
+        Energy += Energies[i];
+    }
+
+    return (Count != 0) ? ToLoudness(Energy / (double) Count) : -std::numeric_limits<double>::infinity();
+}
+
+/// <summary>
+/// Gets the specified percentile of the loudness of the blocks that are louder than the threshold.
+/// </summary>
+double LoudnessMeter::histogram_t::GetPercentile(double threshold, double percentile) const noexcept
+{
+    const size_t FirstBin = GetBin(threshold);
+
+    uint64_t Count = 0;
+
+    for (size_t i = FirstBin; i < Counts.size(); ++i)
+        Count += Counts[i];
+
+    if (Count == 0)
+        return -std::numeric_limits<double>::infinity();
+
+    const uint64_t Rank = (uint64_t) std::llround((double) (Count - 1) * percentile);
+
+    uint64_t Total = 0;
+
+    for (size_t i = FirstBin; i < Counts.size(); ++i)
+    {
+        Total += Counts[i];
+
+        if (Total > Rank)
+            return GetBinLoudness(i);
+    }
+
+    return GetBinLoudness(Counts.size() - 1);
+}
@@ -0,0 +1,127 @@
+
+/** $VER: LoudnessMeter.h (2026.10.16) P. Stuer - Measures the loudness and true peak of a stream according to ITU-R BS.1770-4 and EBU R128. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <vector>
+
+/// <summary>
+/// Represents the values reported by the loudness meter. Loudness values are in LUFS, the loudness range in LU and the true peak in dBTP. Values that can not be determined yet are -infinity.
+/// </summary>
+struct loudness_t
+{
+    float Momentary;            // Mean loudness of the last 400 ms
+    float ShortTerm;            // Mean loudness of the last 3 s
+    float Integrated;           // Gated loudness since the last reset
+    float LoudnessRange;        // Loudness range (LRA) since the last reset, in LU
+
+    float TruePeak;             // Highest 4x oversampled peak of all channels since the last reset
+    float MaxMomentary;         // Highest momentary loudness since the last reset
+    float MaxShortTerm;         // Highest short-term loudness since the last reset
+    float Duration;             // Measured time since the last reset, in seconds
+};
+
+/// <summary>
+/// Measures the loudness of interleaved samples according to ITU-R BS.1770-4 and EBU Tech 3341/3342. The state is kept across calls so the samples must be fed without gaps or overlaps.
+/// </summary>
+class LoudnessMeter
+{
+public:
+    LoudnessMeter() noexcept : _SampleRate(), _ChannelCount(), _BlockSize(), _BlockFrameCount(), _BlockSum(), _BlockIndex(), _BlockCount(), _IsDirty(), _Values() { }
+
+    void Initialize(uint32_t sampleRate, uint32_t channelCount, const double * channelWeights);
+    void Reset() noexcept;
+
+    bool IsInitialized(uint32_t sampleRate, uint32_t channelCount, const double * channelWeights) const noexcept;
+
+    void Process(const float * samples, size_t frameCount) noexcept;
+    void Process(const double * samples, size_t frameCount) noexcept;
+
+    const loudness_t & GetValues() noexcept;
+
+    static constexpr uint32_t MaxChannels = 32;
+
+private:
+    template<typename T> void ProcessSamples(const T * samples, size_t frameCount) noexcept;
+
+    void CompleteBlock() noexcept;
+    void UpdateIntegrated() noexcept;
+
+    double ProcessTruePeak(uint32_t channel, double sample) noexcept;
+
+    /// <summary>
+    /// Implements a biquad filter in transposed direct form II.
+    /// </summary>
+    struct biquad_t
+    {
+        double b0, b1, b2, a1, a2;
+        double z1, z2;
+
+        double Process(double x) noexcept
+        {
+            const double y = b0 * x + z1;
+
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+
+            return y;
+        }
+    };
+
+    /// <summary>
+    /// Implements a histogram of block loudness values with a resolution of 0.1 LU. Keeps the sum of the energies of each bin to calculate the gated mean.
+    /// </summary>
+    struct histogram_t
+    {
+        std::vector<uint64_t> Counts;
+        std::vector<double> Energies;
+
+        void Add(double energy) noexcept;
+        void Clear() noexcept;
+
+        double GetGatedLoudness(double relativeGate) const noexcept;
+        double GetPercentile(double threshold, double percentile) const noexcept;
+    };
+
+    static double ToLoudness(double energy) noexcept;
+
+    static size_t GetBin(double loudness) noexcept;
+    static double GetBinLoudness(size_t bin) noexcept;
+
+private:
+    uint32_t _SampleRate;
+    uint32_t _ChannelCount;
+    double _ChannelWeights[MaxChannels];
+
+    biquad_t _PreFilter[MaxChannels];   // Stage 1 of the K-weighting filter: high-shelf that models the acoustic effect of the head
+    biquad_t _RLBFilter[MaxChannels];   // Stage 2 of the K-weighting filter: high-pass (revised low-frequency B-curve)
+
+    // Sub-blocks of 100 ms. A gating block of 400 ms consists of 4 sub-blocks, overlapping by 75%.
+    static const size_t ShortTermBlockCount = 30;
+    static const size_t MomentaryBlockCount = 4;
+
+    size_t _BlockSize;                  // in frames
+    size_t _BlockFrameCount;            // Number of frames in the current sub-block
+    double _BlockSum;                   // Weighted sum of the squared samples in the current sub-block
+    double _Blocks[ShortTermBlockCount];// Mean square of the last 30 sub-blocks
+    size_t _BlockIndex;                 // Index of the next sub-block in the ring
+    uint64_t _BlockCount;               // Number of completed sub-blocks since the last reset
+
+    histogram_t _Integrated;            // Momentary blocks, gated at -70 LUFS
+    histogram_t _ShortTerm;             // Short-term blocks, gated at -70 LUFS
+
+    // True peak: 4x oversampling with a polyphase FIR interpolator.
+    static const size_t Oversampling = 4;
+    static const size_t TapsPerPhase = 12;
+
+    double _Coefficients[Oversampling][TapsPerPhase];
+    double _History[MaxChannels][TapsPerPhase];
+    size_t _HistoryIndex[MaxChannels];
+    double _TruePeak;                   // Linear
+
+    bool _IsDirty;                      // The integrated loudness and loudness range must be recalculated.
+    loudness_t _Values;
+};
@@ -0,0 +1,150 @@
+
+/** $VER: MaskEncoder.cpp (2026.10.16) P. Stuer - Encodes item masks as runs or as a base64 bit set, whichever is smaller. Host-independent. **/
+
+#include "MaskEncoder.h"
+
+#include <algorithm>
+
+/// <summary>
+/// Removes all runs and sets the number of items in the mask.
+/// </summary>
+void MaskEncoder::Reset(size_t count) noexcept
+{
+    _Count = count;
+
+    _Runs.clear();
+}
+
+/// <summary>
+/// Sets a run of items. Runs must be added in ascending order; a run that starts where the previous run ends extends it.
+/// </summary>
+void MaskEncoder::AddRun(size_t start, size_t length)
+{
+    if (length == 0)
+        return;
+
+    if (!_Runs.empty() && (_Runs[_Runs.size() - 2] + _Runs.back() == start))
+    {
+        _Runs.back() += length;
+
+        return;
+    }
+
+    _Runs.push_back(start);
+    _Runs.push_back(length);
+}
+
+/// <summary>
+/// Encodes the mask using the smaller encoding. Runs are preferred when both encodings have the same size.
+/// </summary>
+std::wstring MaskEncoder::Encode() const
+{
+    return (GetRunsLength() <= GetBitsLength()) ? EncodeRuns() : EncodeBits();
+}
+
+/// <summary>
+/// Encodes the mask as runs.
+/// </summary>
+std::wstring MaskEncoder::EncodeRuns() const
+{
+    std::wstring Result;
+
+    Result.reserve(GetRunsLength() + 32);
+
+    Result += L"{\"Count\":";
+    Result += std::to_wstring(_Count);
+    Result += L",\"Runs\":[";
+
+    for (size_t i = 0; i < _Runs.size(); ++i)
+    {
+        if (i != 0)
+            Result += L',';
+
+        Result += std::to_wstring(_Runs[i]);
+    }
+
+    Result += L"]}";
+
+    return Result;
+}
+
+/// <summary>
+/// Encodes the mask as a base64 bit set.
+/// </summary>
+std::wstring MaskEncoder::EncodeBits() const
+{
+    std::vector<uint8_t> Bytes((_Count + 7) / 8, 0);
+
+    for (size_t i = 0; i < _Runs.size(); i += 2)
+    {
+        const size_t End = _Runs[i] + _Runs[i + 1];
+
+        for (size_t j = _Runs[i]; j < End; ++j)
+            Bytes[j >> 3] |= (uint8_t) (1 << (j & 7));
+    }
+
+    static const wchar_t Alphabet[] = L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::wstring Result;
+
+    Result.reserve(GetBitsLength() + 32);
+
+    Result += L"{\"Count\":";
+    Result += std::to_wstring(_Count);
+    Result += L",\"Bits\":\"";
+
+    for (size_t i = 0; i < Bytes.size(); i += 3)
+    {
+        const size_t Size = std::min<size_t>(Bytes.size() - i, 3);
+
+        const uint32_t Value = ((uint32_t) Bytes[i] << 16) | ((Size > 1) ? (uint32_t) Bytes[i + 1] << 8 : 0) | ((Size > 2) ? (uint32_t) Bytes[i + 2] : 0);
+
+        Result += Alphabet[(Value >> 18) & 0x3F];
+        Result += Alphabet[(Value >> 12) & 0x3F];
+        Result += (Size > 1) ? Alphabet[(Value >> 6) & 0x3F] : L'=';
+        Result += (Size > 2) ? Alphabet[ Value       & 0x3F] : L'=';
+    }
+
+    Result += L"\"}";
+
+    return Result;
+}
+
+/// <summary>
+/// Gets the number of characters of the runs, excluding the part that both encodings have in common.
+/// </summary>
+size_t MaskEncoder::GetRunsLength() const noexcept
+{
+    size_t Length = 2; // Brackets
+
+    for (size_t i = 0; i < _Runs.size(); ++i)
+        Length += GetDigitCount(_Runs[i]) + ((i != 0) ? 1 : 0);
+
+    return Length;
+}
+
+/// <summary>
+/// Gets the number of characters of the bit set, excluding the part that both encodings have in common.
+/// </summary>
+size_t MaskEncoder::GetBitsLength() const noexcept
+{
+    const size_t ByteCount = (_Count + 7) / 8;
+
+    return 2 + ((ByteCount + 2) / 3) * 4; // Quotes
+}
+
+/// <summary>
+/// Gets the number of decimal digits of a value.
+/// </summary>
+size_t MaskEncoder::GetDigitCount(size_t value) noexcept
+{
+    size_t Count = 1;
+
+    while (value >= 10)
+    {
+        value /= 10;
+        ++Count;
+    }
+
+    return Count;
+}
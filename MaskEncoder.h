@@ -0,0 +1,53 @@
+
+/** $VER: MaskEncoder.h (2026.10.16) P. Stuer - Encodes item masks as runs or as a base64 bit set, whichever is smaller. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Encodes a mask of items f.e. the selected items of a playlist as JSON. Sparse and clustered masks are encoded as sorted runs: {"Count":n,"Runs":[start,length,...]}.
+/// Dense, scattered masks are encoded as a bit set: {"Count":n,"Bits":"base64"} where item i is bit (i % 8) of byte (i / 8). The smaller encoding is used.
+/// </summary>
+class MaskEncoder
+{
+public:
+    MaskEncoder() noexcept : _Count() { }
+
+    void Reset(size_t count) noexcept;
+    void AddRun(size_t start, size_t length);
+
+    std::wstring Encode() const;
+    std::wstring EncodeRuns() const;
+    std::wstring EncodeBits() const;
+
+    size_t GetRunsLength() const noexcept;
+    size_t GetBitsLength() const noexcept;
+
+    /// <summary>
+    /// Sets a single item. Items must be set in ascending order.
+    /// </summary>
+    void Add(size_t index)
+    {
+        AddRun(index, 1);
+    }
+
+    /// <summary>
+    /// Gets the number of runs of set items.
+    /// </summary>
+    size_t GetRunCount() const noexcept
+    {
+        return _Runs.size() / 2;
+    }
+
+private:
+    static size_t GetDigitCount(size_t value) noexcept;
+
+private:
+    size_t _Count;                      // Number of items in the mask
+    std::vector<size_t> _Runs;          // Start and length of each run of set items, in ascending order
+};
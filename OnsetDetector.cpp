@@ -0,0 +1,421 @@
+
+/** $VER: OnsetDetector.cpp (2026.10.16) P. Stuer - Detects onsets with spectral flux and tracks the tempo and beat phase. Host-independent. **/
+
+#include "OnsetDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+static const double AnalysisTime      = 0.023;  // Length of an analysis frame, in seconds. Rounded to the nearest power of 2 samples.
+static const double Compression       = 100.;   // Factor of the logarithmic compression of the magnitudes: log(1 + Compression * |X|)
+
+static const double PreMaxTime        = 0.030;  // The detection function must be a local maximum over this interval, in seconds.
+static const double PreAvgTime        = 0.100;  // Interval of the moving average of the adaptive threshold, in seconds.
+static const double Delta             = 0.07;   // Offset of the adaptive threshold, relative to the peak of the detection function.
+static const double MinOnsetInterval  = 0.050;  // Minimum distance between two onsets, in seconds.
+static const double FluxPeakDecayTime = 4.;     // Time constant of the decay of the peak of the flux, in seconds.
+static const double MinFluxPeak       = 1.;     // Lower bound of the peak of the flux so noise in near silence is not amplified.
+
+static const double HistoryTime       = 8.;     // Length of the history of the detection function used by the tempo tracker, in seconds.
+static const double MinTempoTime      = 3.;     // Amount of history required for a tempo estimate, in seconds.
+static const double TempoInterval     = 0.5;    // Interval between two tempo estimates, in seconds.
+static const double PreferredTempo    = 120.;   // Center of the tempo prior, in BPM.
+static const double TempoDeviation    = 1.;     // Standard deviation of the tempo prior, in octaves.
+static const double MinTempoConfidence = 0.1;   // Beats are not predicted when the tempo confidence is lower.
+static const size_t MaxPhaseBeats     = 8;      // Number of past beats the comb filter uses to determine the phase.
+static const double BeatLead          = 2.;     // Beats are reported this many frames early, which compensates the delay of the frame center.
+
+/// <summary>
+/// Initializes the detector. The analysis frame scales with the sample rate so the time resolution is independent of it.
+/// </summary>
+void OnsetDetector::Initialize(uint32_t sampleRate, uint32_t channelCount)
+{
+    _SampleRate = sampleRate;
+    _ChannelCount = std::min(channelCount, MaxChannels);
+
+    _FrameSize = (size_t) 1 << (size_t) std::max(std::lround(std::log2(std::max((double) sampleRate, 1.) * AnalysisTime)), 8l);
+    _HopSize = _FrameSize / 2;
+
+    _FFT.Initialize(_FrameSize);
+
+    _Window.resize(_FrameSize);
+
+    for (size_t i = 0; i < _FrameSize; ++i)
+        _Window[i] = (float) (0.5 * (1. - std::cos(2. * std::numbers::pi * (double) i / (double) _FrameSize)));
+
+    _Input.assign(_FrameSize, 0.f);
+    _Frame.assign(_FrameSize, 0.f);
+    _Bins.assign(_FFT.GetBinCount(), { });
+    _Magnitudes.assign(_FFT.GetBinCount(), 0.f);
+
+    const double HopTime = (double) _HopSize / (double) std::max(sampleRate, 1u);
+
+    _History.assign((size_t) std::ceil(HistoryTime / HopTime), 0.);
+
+    Reset();
+}
+
+/// <summary>
+/// Resets the detector. Positions restart at 0.
+/// </summary>
+void OnsetDetector::Reset() noexcept
+{
+    std::fill(_Input.begin(), _Input.end(), 0.f);
+    std::fill(_Magnitudes.begin(), _Magnitudes.end(), 0.f);
+    std::fill(_History.begin(), _History.end(), 0.);
+
+    _InputIndex = 0;
+    _InputCount = 0;
+    _HopCount = 0;
+
+    _FrameIndex = 0;
+
+    _FluxPeak = MinFluxPeak;
+    _LastOnset = 0;
+
+    _HistoryIndex = 0;
+
+    _TempoCountdown = 0;
+    _Period = 0.;
+    _Tempo = 0.;
+    _TempoConfidence = 0.;
+    _NextBeat = 0.;
+    _LastBeat = -1.;
+    _BeatConfidence = 0.;
+}
+
+/// <summary>
+/// Adds interleaved samples and appends the detected onsets and predicted beats to the specified list.
+/// </summary>
+void OnsetDetector::Process(const float * samples, size_t frameCount, std::vector<onset_event_t> & events)
+{
+    ProcessSamples(samples, frameCount, events);
+}
+
+/// <summary>
+/// Adds interleaved samples and appends the detected onsets and predicted beats to the specified list.
+/// </summary>
+void OnsetDetector::Process(const double * samples, size_t frameCount, std::vector<onset_event_t> & events)
+{
+    ProcessSamples(samples, frameCount, events);
+}
+
+/// <summary>
+/// Mixes the samples to mono and analyzes a frame every hop.
+/// </summary>
+template<typename T>
+void OnsetDetector::ProcessSamples(const T * samples, size_t frameCount, std::vector<onset_event_t> & events)
+{
+    if ((_ChannelCount == 0) || _Input.empty())
+        return;
+
+    const double Gain = 1. / (double) _ChannelCount;
+
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        double Sum = 0.;
+
+        for (uint32_t j = 0; j < _ChannelCount; ++j)
+            Sum += (double) *samples++;
+
+        _Input[_InputIndex] = (float) (Sum * Gain);
+
+        _InputIndex = (_InputIndex + 1) % _FrameSize;
+
+        if (_InputCount < _FrameSize)
+            ++_InputCount;
+
+        if ((++_HopCount >= _HopSize) && (_InputCount == _FrameSize))
+        {
+            _HopCount = 0;
+
+            ProcessFrame(events);
+        }
+    }
+}
+
+/// <summary>
+/// Calculates the spectral flux of the most recent frame and updates the onset detection, tempo and beat tracking.
+/// </summary>
+void OnsetDetector::ProcessFrame(std::vector<onset_event_t> & events)
+{
+    // The oldest sample of the ring is at the write index.
+    for (size_t i = 0; i < _FrameSize; ++i)
+        _Frame[i] = _Input[(_InputIndex + i) % _FrameSize] * _Window[i];
+
+    _FFT.Transform(_Frame.data(), _Bins.data());
+
+    // Scale the magnitudes so a full-scale sine has a magnitude of 1 (the coherent gain of the Hann window is 0.5).
+    const float Scale = 4.f / (float) _FrameSize;
+
+    double Flux = 0.;
+
+    for (size_t i = 1; i < _Bins.size(); ++i)
+    {
+        const float Magnitude = (float) std::log1p(Compression * std::abs(_Bins[i]) * Scale);
+
+        Flux += std::max(Magnitude - _Magnitudes[i], 0.f);
+
+        _Magnitudes[i] = Magnitude;
+    }
+
+    const double HopTime = (double) _HopSize / (double) _SampleRate;
+
+    _FluxPeak = std::max({ Flux, _FluxPeak * std::exp(-HopTime / FluxPeakDecayTime), MinFluxPeak });
+
+    // The first frame has no predecessor.
+    const double Value = (_FrameIndex != 0) ? Flux / _FluxPeak : 0.;
+
+    PickOnset(Value, events);
+
+    _History[_HistoryIndex] = Value;
+    _HistoryIndex = (_HistoryIndex + 1) % _History.size();
+
+    ++_FrameIndex;
+
+    if ((double) _FrameIndex * HopTime >= MinTempoTime)
+    {
+        if (_TempoCountdown == 0)
+        {
+            EstimateTempo();
+            EstimatePhase();
+
+            _TempoCountdown = (size_t) std::ceil(TempoInterval / HopTime);
+        }
+        else
+            --_TempoCountdown;
+    }
+
+    PredictBeats(events);
+}
+
+/// <summary>
+/// Reports an onset if the detection function is a local maximum above the adaptive threshold. Must be called before the value is added to the history.
+/// </summary>
+void OnsetDetector::PickOnset(double value, std::vector<onset_event_t> & events)
+{
+    const double HopTime = (double) _HopSize / (double) _SampleRate;
+
+    const size_t PreMax = std::max((size_t) std::lround(PreMaxTime / HopTime), (size_t) 1);
+    const size_t PreAvg = std::max((size_t) std::lround(PreAvgTime / HopTime), (size_t) 1);
+
+    if (_FrameIndex < PreAvg)
+        return;
+
+    double Max = 0.;
+
+    for (size_t i = 0; i < PreMax; ++i)
+        Max = std::max(Max, GetHistory(i));
+
+    if (value < Max)
+        return;
+
+    double Sum = value;
+
+    for (size_t i = 0; i < PreAvg; ++i)
+        Sum += GetHistory(i);
+
+    const double Threshold = (Sum / (double) (PreAvg + 1)) + Delta;
+
+    if (value < Threshold)
+        return;
+
+    const uint64_t MinInterval = (uint64_t) std::lround(MinOnsetInterval / HopTime);
+
+    if ((_LastOnset != 0) && (_FrameIndex - _LastOnset < MinInterval))
+        return;
+
+    _LastOnset = _FrameIndex;
+
+    events.push_back({ OnsetType::Onset, GetPosition((double) _FrameIndex), (float) std::min(value, 1.), (float) std::clamp((value - Threshold) / value, 0., 1.), (float) _Tempo });
+}
+
+/// <summary>
+/// Estimates the tempo from the autocorrelation of the detection function, weighted with a log-Gaussian tempo prior.
+/// </summary>
+void OnsetDetector::EstimateTempo() noexcept
+{
+    const double HopTime = (double) _HopSize / (double) _SampleRate;
+
+    const size_t Count = (size_t) std::min((uint64_t) _History.size(), _FrameIndex);
+
+    const size_t MinLag = (size_t) std::floor(60. / (MaxTempo * HopTime));
+    const size_t MaxLag = (size_t) std::ceil (60. / (MinTempo * HopTime));
+
+    if ((MinLag < 2) || (MaxLag + 2 >= Count))
+        return;
+
+    double Mean = 0.;
+
+    for (size_t i = 0; i < Count; ++i)
+        Mean += GetHistory(i);
+
+    Mean /= (double) Count;
+
+    const auto GetCorrelation = [this, Count, Mean](size_t lag) noexcept -> double
+    {
+        double Sum = 0.;
+
+        for (size_t i = 0; i + lag < Count; ++i)
+            Sum += (GetHistory(i) - Mean) * (GetHistory(i + lag) - Mean);
+
+        return Sum / (double) (Count - lag);
+    };
+
+    const double Energy = GetCorrelation(0);
+
+    if (Energy <= 0.)
+        return;
+
+    // A period that falls between two lags splits its peak over both while its multiples may not, so each lag is scored with its neighbours.
+    double Correlations[3] = { 0., GetCorrelation(MinLag - 1), GetCorrelation(MinLag) };
+
+    size_t BestLag = 0;
+    double BestScore = 0.;
+
+    for (size_t Lag = MinLag; Lag <= MaxLag; ++Lag)
+    {
+        Correlations[0] = Correlations[1];
+        Correlations[1] = Correlations[2];
+        Correlations[2] = GetCorrelation(Lag + 1);
+
+        const double Tempo = 60. / ((double) Lag * HopTime);
+        const double Octaves = std::log2(Tempo / PreferredTempo) / TempoDeviation;
+
+        const double Score = (Correlations[0] + Correlations[1] + Correlations[2]) * std::exp(-0.5 * Octaves * Octaves);
+
+        if (Score > BestScore)
+        {
+            BestScore = Score;
+            BestLag = Lag;
+        }
+    }
+
+    if (BestLag == 0)
+    {
+        _TempoConfidence = 0.;
+
+        return;
+    }
+
+    // Refine the lag with a parabolic fit through the neighbouring values.
+    const double a = GetCorrelation(BestLag - 1);
+    const double b = GetCorrelation(BestLag);
+    const double c = GetCorrelation(BestLag + 1);
+
+    const double d = a - (2. * b) + c;
+
+    const double Period = (double) BestLag + ((d < 0.) ? std::clamp(0.5 * (a - c) / d, -0.5, 0.5) : 0.);
+
+    _TempoConfidence = std::clamp(b / Energy, 0., 1.);
+
+    // Follow small tempo changes smoothly. Jump to a new tempo otherwise.
+    if ((_Period != 0.) && (std::abs(Period - _Period) < 0.05 * _Period))
+        _Period = (0.7 * _Period) + (0.3 * Period);
+    else
+        _Period = Period;
+
+    _Tempo = 60. / (_Period * HopTime);
+}
+
+/// <summary>
+/// Estimates the phase of the beat with a comb filter over the history of the detection function and predicts the next beat.
+/// </summary>
+void OnsetDetector::EstimatePhase() noexcept
+{
+    if (_Period <= 0.)
+        return;
+
+    const size_t Count = (size_t) std::min((uint64_t) _History.size(), _FrameIndex);
+
+    const size_t BeatCount = std::min((size_t) ((double) Count / _Period), MaxPhaseBeats);
+    const size_t PhaseCount = (size_t) std::ceil(_Period);
+
+    if ((BeatCount < 2) || (PhaseCount == 0))
+        return;
+
+    double BestScore = 0.;
+    double TotalScore = 0.;
+    size_t BestPhase = 0;
+
+    for (size_t Phase = 0; Phase < PhaseCount; ++Phase)
+    {
+        double Score = 0.;
+
+        for (size_t i = 0; i < BeatCount; ++i)
+        {
+            const size_t Age = Phase + (size_t) std::lround((double) i * _Period);
+
+            if (Age < Count)
+                Score += GetHistory(Age);
+        }
+
+        TotalScore += Score;
+
+        if (Score > BestScore)
+        {
+            BestScore = Score;
+            BestPhase = Phase;
+        }
+    }
+
+    if (BestScore <= 0.)
+    {
+        _BeatConfidence = 0.;
+
+        return;
+    }
+
+    const double MeanScore = TotalScore / (double) PhaseCount;
+
+    _BeatConfidence = _TempoConfidence * std::clamp((BestScore - MeanScore) / BestScore, 0., 1.);
+
+    // The newest value in the history belongs to frame _FrameIndex - 1.
+    double NextBeat = (double) (_FrameIndex - 1 - BestPhase) + _Period;
+
+    // Don't report a beat twice when the phase estimate moves back a little.
+    while ((_LastBeat >= 0.) && (NextBeat - _LastBeat < 0.5 * _Period))
+        NextBeat += _Period;
+
+    _NextBeat = NextBeat;
+}
+
+/// <summary>
+/// Reports the predicted beats that are due.
+/// </summary>
+void OnsetDetector::PredictBeats(std::vector<onset_event_t> & events)
+{
+    if ((_Period <= 0.) || (_TempoConfidence < MinTempoConfidence))
+        return;
+
+    while ((double) _FrameIndex + BeatLead >= _NextBeat)
+    {
+        const double Age = (double) (_FrameIndex - 1) - _NextBeat;
+
+        const double Strength = ((Age >= 0.) && (Age < (double) _History.size())) ? GetHistory((size_t) std::lround(Age)) : 0.;
+
+        events.push_back({ OnsetType::Beat, GetPosition(_NextBeat), (float) std::min(Strength, 1.), (float) _BeatConfidence, (float) _Tempo });
+
+        _LastBeat = _NextBeat;
+        _NextBeat += _Period;
+    }
+}
+
+/// <summary>
+/// Gets a value of the detection function from the history. Age 0 is the newest value.
+/// </summary>
+double OnsetDetector::GetHistory(size_t age) const noexcept
+{
+    const size_t Size = _History.size();
+
+    return _History[(_HistoryIndex + Size - 1 - (age % Size)) % Size];
+}
+
+/// <summary>
+/// Converts a (fractional) frame index to a position in samples. An analysis frame represents the position of its center.
+/// </summary>
+uint64_t OnsetDetector::GetPosition(double frameIndex) const noexcept
+{
+    return (uint64_t) std::max(std::llround((frameIndex * (double) _HopSize) + (double) (_FrameSize / 2)), 0ll);
+}
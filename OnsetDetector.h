@@ -0,0 +1,122 @@
+
+/** $VER: OnsetDetector.h (2026.10.16) P. Stuer - Detects onsets with spectral flux and tracks the tempo and beat phase. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <complex>
+#include <vector>
+
+#include "FFT.h"
+
+/// <summary>
+/// Identifies the type of an onset event.
+/// </summary>
+enum class OnsetType : uint32_t
+{
+    Onset = 0,                  // A transient detected in the signal
+    Beat,                       // A beat predicted by the tempo tracker
+};
+
+/// <summary>
+/// Represents an onset or beat.
+/// </summary>
+struct onset_event_t
+{
+    OnsetType Type;
+    uint64_t Position;          // Position of the event, in frames since the last reset. Beats can be up to a few milliseconds ahead of the processed samples.
+    float Strength;             // Normalized onset detection function at the event, 0..1.
+    float Confidence;           // Onsets: margin above the adaptive threshold. Beats: product of the tempo and beat phase confidence. 0..1.
+    float Tempo;                // Estimated tempo at the event, in BPM. 0 if unknown.
+};
+
+/// <summary>
+/// Detects onsets in a stream of interleaved samples using the half-wave rectified, logarithmically compressed spectral flux and an adaptive threshold (online, no look-ahead).
+/// Estimates the tempo from the autocorrelation of the onset detection function and predicts the beats with a comb filter over the recent history.
+/// The state is kept across calls so the samples must be fed without gaps or overlaps.
+/// </summary>
+class OnsetDetector
+{
+public:
+    OnsetDetector() noexcept : _SampleRate(), _ChannelCount(), _FrameSize(), _HopSize(), _InputIndex(), _InputCount(), _HopCount(), _FrameIndex(), _FluxPeak(), _LastOnset(), _HistoryIndex(), _TempoCountdown(), _Period(), _Tempo(), _TempoConfidence(), _NextBeat(), _LastBeat(), _BeatConfidence() { }
+
+    void Initialize(uint32_t sampleRate, uint32_t channelCount);
+    void Reset() noexcept;
+
+    bool IsInitialized(uint32_t sampleRate, uint32_t channelCount) const noexcept
+    {
+        return (sampleRate == _SampleRate) && (channelCount == _ChannelCount);
+    }
+
+    void Process(const float * samples, size_t frameCount, std::vector<onset_event_t> & events);
+    void Process(const double * samples, size_t frameCount, std::vector<onset_event_t> & events);
+
+    /// <summary>
+    /// Gets the estimated tempo, in BPM. 0 if the tempo is unknown.
+    /// </summary>
+    double GetTempo() const noexcept
+    {
+        return _Tempo;
+    }
+
+    /// <summary>
+    /// Gets the confidence of the estimated tempo, 0..1.
+    /// </summary>
+    double GetTempoConfidence() const noexcept
+    {
+        return _TempoConfidence;
+    }
+
+    static constexpr uint32_t MaxChannels = 32;
+
+    static constexpr double MinTempo = 60.;     // in BPM
+    static constexpr double MaxTempo = 200.;    // in BPM
+
+private:
+    template<typename T> void ProcessSamples(const T * samples, size_t frameCount, std::vector<onset_event_t> & events);
+
+    void ProcessFrame(std::vector<onset_event_t> & events);
+    void PickOnset(double value, std::vector<onset_event_t> & events);
+    void EstimateTempo() noexcept;
+    void EstimatePhase() noexcept;
+    void PredictBeats(std::vector<onset_event_t> & events);
+
+    double GetHistory(size_t age) const noexcept;
+    uint64_t GetPosition(double frameIndex) const noexcept;
+
+private:
+    uint32_t _SampleRate;
+    uint32_t _ChannelCount;
+
+    size_t _FrameSize;                          // Size of the analysis frame and the FFT, in samples
+    size_t _HopSize;                            // Distance between two analysis frames, in samples
+
+    FFT _FFT;
+    std::vector<float> _Window;
+    std::vector<float> _Input;                  // Ring of the most recent mono samples
+    size_t _InputIndex;                         // Index of the next sample in the ring
+    size_t _InputCount;                         // Number of samples in the ring
+    size_t _HopCount;                           // Number of samples since the last analysis frame
+    std::vector<float> _Frame;
+    std::vector<std::complex<float>> _Bins;
+    std::vector<float> _Magnitudes;             // Compressed magnitudes of the previous frame
+
+    uint64_t _FrameIndex;                       // Number of analysis frames since the last reset
+
+    // Onset detection
+    double _FluxPeak;                           // Slowly decaying maximum of the flux, used to normalize the detection function
+    uint64_t _LastOnset;                        // Frame index of the last onset
+
+    std::vector<double> _History;               // Ring of the normalized onset detection function, used by the tempo tracker
+    size_t _HistoryIndex;                       // Index of the next value in the ring
+
+    // Tempo and beat tracking
+    size_t _TempoCountdown;                     // Number of frames until the next tempo estimate
+    double _Period;                             // Beat period, in frames. 0 = unknown.
+    double _Tempo;                              // in BPM
+    double _TempoConfidence;
+    double _NextBeat;                           // Frame index of the next predicted beat
+    double _LastBeat;                           // Frame index of the last reported beat
+    double _BeatConfidence;
+};
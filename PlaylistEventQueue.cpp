@@ -0,0 +1,289 @@
+
+/** $VER: PlaylistEventQueue.cpp (2026.10.16) P. Stuer - Coalesces playlist callbacks into one script call per frame. **/
+
+#include "pch.h"
+
+#include "PlaylistEventQueue.h"
+#include "HostObjectImpl.h"
+#include "MaskEncoder.h"
+#include "Encoding.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Adds a modification or selection event. The mask is merged with the queued event of the same type and playlist, if any.
+/// </summary>
+void PlaylistEventQueue::Add(PlaylistEventType type, t_size playlistIndex, const bit_array & mask, t_size itemCount)
+{
+    ++_Statistics.EventCount;
+
+    playlist_event_t * Event = Find(type, playlistIndex);
+
+    if (Event != nullptr)
+        ++_Statistics.MergedCount;
+    else
+    {
+        _Events.push_back({ type, playlistIndex });
+
+        Event = &_Events.back();
+    }
+
+    if (Event->Mask.size() < itemCount)
+        Event->Mask.resize(itemCount, false);
+
+    for (t_size i = mask.find_first(true, 0, itemCount); i < itemCount; i = mask.find_next(true, i, itemCount))
+        Event->Mask[i] = true;
+}
+
+/// <summary>
+/// Adds a focus change. A queued focus change of the same playlist keeps its old index and takes the new index.
+/// </summary>
+void PlaylistEventQueue::AddFocusChange(t_size playlistIndex, t_size fromIndex, t_size toIndex)
+{
+    ++_Statistics.EventCount;
+
+    playlist_event_t * Event = Find(PlaylistEventType::ItemFocusChange, playlistIndex);
+
+    if (Event != nullptr)
+    {
+        ++_Statistics.MergedCount;
+
+        Event->ToIndex = toIndex;
+
+        return;
+    }
+
+    playlist_event_t NewEvent = { PlaylistEventType::ItemFocusChange, playlistIndex };
+
+    NewEvent.FromIndex = fromIndex;
+    NewEvent.ToIndex   = toIndex;
+
+    _Events.push_back(std::move(NewEvent));
+}
+
+/// <summary>
+/// Adds a reorder. A queued reorder of the same playlist and item count is composed with the new order so the result maps the original positions to the final positions.
+/// </summary>
+void PlaylistEventQueue::AddReorder(t_size playlistIndex, const t_size * order, t_size itemCount)
+{
+    ++_Statistics.EventCount;
+
+    playlist_event_t * Event = Find(PlaylistEventType::ItemsReordered, playlistIndex);
+
+    if ((Event != nullptr) && (Event->Order.size() == itemCount))
+    {
+        ++_Statistics.MergedCount;
+
+        std::vector<t_size> Order(itemCount);
+
+        for (t_size i = 0; i < itemCount; ++i)
+            Order[i] = (order[i] < itemCount) ? Event->Order[order[i]] : order[i];
+
+        Event->Order.swap(Order);
+
+        return;
+    }
+
+    playlist_event_t NewEvent = { PlaylistEventType::ItemsReordered, playlistIndex };
+
+    NewEvent.Order.assign(order, order + itemCount);
+
+    _Events.push_back(std::move(NewEvent));
+}
+
+/// <summary>
+/// Adds a list of added items. The items are never merged; they are delivered in pages of at most ItemPageSize items.
+/// </summary>
+void PlaylistEventQueue::AddItems(t_size playlistIndex, t_size startIndex, metadb_handle_list_cref items)
+{
+    ++_Statistics.EventCount;
+
+    playlist_event_t NewEvent = { PlaylistEventType::ItemsAdded, playlistIndex };
+
+    NewEvent.Items      = items;
+    NewEvent.StartIndex = startIndex;
+
+    _Events.push_back(std::move(NewEvent));
+}
+
+/// <summary>
+/// Adds the call of the event handler of any other callback. The item and playlist indexes of the events before it may refer to an old state, so later events are not merged with them.
+/// </summary>
+void PlaylistEventQueue::AddScript(const std::wstring & script)
+{
+    ++_Statistics.EventCount;
+
+    playlist_event_t NewEvent = { PlaylistEventType::Script, ~(t_size) 0 };
+
+    NewEvent.Script = script;
+
+    _Events.push_back(std::move(NewEvent));
+}
+
+/// <summary>
+/// Converts the queued events into a single script that calls the event handler of each event, in the order the events were first queued, and removes them from the queue.
+/// Only one page of added items is converted per call; that event and the events after it stay queued until its last page has been converted. Handlers that are not defined by the script are skipped.
+/// </summary>
+std::wstring PlaylistEventQueue::ToScript()
+{
+    std::wstring Script;
+
+    size_t Count = 0; // Number of events that have been converted completely
+
+    for (auto & Event : _Events)
+    {
+        switch (Event.Type)
+        {
+            case PlaylistEventType::ItemsAdded:
+                if (!AppendItemsPage(Event, Script))
+                {
+                    _Events.erase(_Events.begin(), _Events.begin() + (ptrdiff_t) Count);
+
+                    ++_Statistics.BatchCount;
+
+                    return Script;
+                }
+                break;
+
+            case PlaylistEventType::ItemsModified:
+                Script += ::FormatText(L"(typeof onPlaylistItemsModified === \"function\") && onPlaylistItemsModified(%d, \"%s\");", (int) Event.PlaylistIndex, Stringify(ToJSON(Event.Mask)).c_str()).c_str();
+                break;
+
+            case PlaylistEventType::ItemsModifiedFromPlayback:
+                Script += ::FormatText(L"(typeof onPlaylistItemsModifiedFromPlayback === \"function\") && onPlaylistItemsModifiedFromPlayback(%d, \"%s\");", (int) Event.PlaylistIndex, Stringify(ToJSON(Event.Mask)).c_str()).c_str();
+                break;
+
+            case PlaylistEventType::ItemsSelectionChange:
+                Script += ::FormatText(L"(typeof onPlaylistSelectedItemsChanged === \"function\") && onPlaylistSelectedItemsChanged(%d, \"%s\");", (int) Event.PlaylistIndex, Stringify(ToJSON(Event.Mask)).c_str()).c_str();
+                break;
+
+            case PlaylistEventType::ItemFocusChange:
+                Script += ::FormatText(L"(typeof onPlaylistFocusedItemChanged === \"function\") && onPlaylistFocusedItemChanged(%d, %d, %d);", (int) Event.PlaylistIndex, (int) Event.FromIndex, (int) Event.ToIndex).c_str();
+                break;
+
+            case PlaylistEventType::ItemsReordered:
+                Script += ::FormatText(L"(typeof onPlaylistItemsReordered === \"function\") && onPlaylistItemsReordered(%d, \"%s\");", (int) Event.PlaylistIndex, ToJSON(Event.Order).c_str()).c_str();
+                break;
+
+            case PlaylistEventType::Script:
+                Script += Event.Script.c_str(); // Stops at the terminating zero FormatText() includes.
+                Script += L";";
+                break;
+        }
+
+        ++Count;
+    }
+
+    if (!_Events.empty())
+        ++_Statistics.BatchCount;
+
+    _Events.clear();
+
+    return Script;
+}
+
+/// <summary>
+/// Finds the queued event of the specified type and playlist that a new event can be merged with. Searches from the newest event and stops at a reorder or an addition of items of the same playlist, or at any script event.
+/// </summary>
+playlist_event_t * PlaylistEventQueue::Find(PlaylistEventType type, t_size playlistIndex) noexcept
+{
+    for (auto Event = _Events.rbegin(); Event != _Events.rend(); ++Event)
+    {
+        // Other callbacks f.e. removals change the item or playlist indexes.
+        if (Event->Type == PlaylistEventType::Script)
+            return nullptr;
+
+        if (Event->PlaylistIndex != playlistIndex)
+            continue;
+
+        if (Event->Type == type)
+            return &*Event;
+
+        // The item indexes of the events before a reorder or an addition refer to the old order.
+        if ((Event->Type == PlaylistEventType::ItemsReordered) || (Event->Type == PlaylistEventType::ItemsAdded) || (type == PlaylistEventType::ItemsReordered))
+            return nullptr;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Appends the call of the event handler for the next page of added items. Lists of more than one page are framed by calls of onPlaylistItemsAddedBegin() and onPlaylistItemsAddedEnd().
+/// Returns true if the last page has been appended.
+/// </summary>
+bool PlaylistEventQueue::AppendItemsPage(playlist_event_t & event, std::wstring & script)
+{
+    const t_size ItemCount = event.Items.get_count();
+    const t_size PageSize = std::min(ItemCount - event.DeliveredCount, ItemPageSize);
+    const bool IsPaged = (ItemCount > ItemPageSize);
+
+    if (IsPaged && (event.DeliveredCount == 0))
+        script += ::FormatText(L"(typeof onPlaylistItemsAddedBegin === \"function\") && onPlaylistItemsAddedBegin(%d, %d, %d);", (int) event.PlaylistIndex, (int) event.StartIndex, (int) ItemCount).c_str();
+
+    // Append the items directly instead of formatting a script that can be megabytes long.
+    script += ::FormatText(L"(typeof onPlaylistItemsAdded === \"function\") && onPlaylistItemsAdded(%d, %d, \"", (int) event.PlaylistIndex, (int) (event.StartIndex + event.DeliveredCount)).c_str();
+    script += Stringify(::ToJSON(event.Items, event.DeliveredCount, PageSize));
+    script += L"\");";
+
+    event.DeliveredCount += PageSize;
+
+    ++_Statistics.PageCount;
+
+    if (event.DeliveredCount < ItemCount)
+        return false;
+
+    if (IsPaged)
+        script += ::FormatText(L"(typeof onPlaylistItemsAddedEnd === \"function\") && onPlaylistItemsAddedEnd(%d, %d, %d);", (int) event.PlaylistIndex, (int) event.StartIndex, (int) ItemCount).c_str();
+
+    return true;
+}
+
+/// <summary>
+/// Converts a mask to JSON. The set items are encoded as runs or as a bit set, whichever is smaller. See MaskEncoder.
+/// </summary>
+std::wstring PlaylistEventQueue::ToJSON(const std::vector<bool> & mask)
+{
+    MaskEncoder Encoder;
+
+    Encoder.Reset(mask.size());
+
+    for (size_t i = 0; i < mask.size();)
+    {
+        if (!mask[i])
+        {
+            ++i;
+            continue;
+        }
+
+        size_t End = i + 1;
+
+        while ((End < mask.size()) && mask[End])
+            ++End;
+
+        Encoder.AddRun(i, End - i);
+
+        i = End;
+    }
+
+    return Encoder.Encode();
+}
+
+/// <summary>
+/// Converts an order to a JSON array.
+/// </summary>
+std::wstring PlaylistEventQueue::ToJSON(const std::vector<t_size> & order)
+{
+    std::wstring Result = L"[";
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (i != 0)
+            Result += L",";
+
+        Result += std::to_wstring(order[i]);
+    }
+
+    Result += L"]";
+
+    return Result;
+}
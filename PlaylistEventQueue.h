@@ -0,0 +1,114 @@
+
+/** $VER: PlaylistEventQueue.h (2026.10.16) P. Stuer - Coalesces playlist callbacks into one script call per frame. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <vector>
+
+/// <summary>
+/// Identifies a queued playlist callback.
+/// </summary>
+enum class PlaylistEventType : uint8_t
+{
+    ItemsAdded,
+    ItemsModified,
+    ItemsModifiedFromPlayback,
+    ItemsSelectionChange,
+    ItemFocusChange,
+    ItemsReordered,
+
+    Script,                             // Any other callback. Never merged.
+};
+
+/// <summary>
+/// Represents one or more merged playlist callbacks of the same type and playlist.
+/// </summary>
+struct playlist_event_t
+{
+    PlaylistEventType Type;
+    t_size PlaylistIndex;
+
+    std::vector<bool> Mask;             // Affected items. Modification and selection events only.
+    std::vector<t_size> Order;          // Old index of the item at each new position. Reorder events only.
+
+    metadb_handle_list Items;           // Added items. Add events only.
+    t_size StartIndex;                  // Index of the first added item in the playlist
+    t_size DeliveredCount;              // Number of added items that have been delivered to the script
+
+    t_size FromIndex;                   // Focus change events only
+    t_size ToIndex;
+
+    std::wstring Script;                // Call of the event handler. Script events only.
+};
+
+/// <summary>
+/// Represents the counters of a playlist event queue.
+/// </summary>
+struct playlist_event_statistics_t
+{
+    uint64_t EventCount;                // Number of callbacks added to the queue
+    uint64_t MergedCount;               // Number of callbacks that were merged with a queued event
+    uint64_t BatchCount;                // Number of times the queue was flushed
+    uint64_t PageCount;                 // Number of pages of added items that were delivered
+};
+
+/// <summary>
+/// Queues the playlist callbacks that arrive in storms during bulk operations f.e. sorting or mass tagging, and merges the compatible ones:
+/// the masks of modification and selection events are OR-ed, focus changes keep the first old and the last new index and consecutive reorders are composed.
+/// Events are never merged across a reorder or an addition of items to the same playlist because it changes the meaning of the item indexes.
+/// Large lists of added items are delivered in pages; the events that follow are held back until the last page has been delivered.
+/// The other callbacks are queued as script calls so they keep their place; no events are merged across them. Only used on the UI thread.
+/// </summary>
+class PlaylistEventQueue
+{
+public:
+    PlaylistEventQueue() : _Statistics() { }
+
+    void Add(PlaylistEventType type, t_size playlistIndex, const bit_array & mask, t_size itemCount);
+    void AddFocusChange(t_size playlistIndex, t_size fromIndex, t_size toIndex);
+    void AddReorder(t_size playlistIndex, const t_size * order, t_size itemCount);
+    void AddItems(t_size playlistIndex, t_size startIndex, metadb_handle_list_cref items);
+    void AddScript(const std::wstring & script);
+
+    std::wstring ToScript();
+
+    /// <summary>
+    /// Returns true if no events are queued.
+    /// </summary>
+    bool IsEmpty() const noexcept
+    {
+        return _Events.empty();
+    }
+
+    /// <summary>
+    /// Discards the queued events.
+    /// </summary>
+    void Clear() noexcept
+    {
+        _Events.clear();
+    }
+
+    /// <summary>
+    /// Gets the counters of the queue.
+    /// </summary>
+    const playlist_event_statistics_t & GetStatistics() const noexcept
+    {
+        return _Statistics;
+    }
+
+    static constexpr t_size ItemPageSize = 2000; // Maximum number of added items per script call
+
+private:
+    playlist_event_t * Find(PlaylistEventType type, t_size playlistIndex) noexcept;
+    bool AppendItemsPage(playlist_event_t & event, std::wstring & script);
+
+    static std::wstring ToJSON(const std::vector<bool> & mask);
+    static std::wstring ToJSON(const std::vector<t_size> & order);
+
+private:
+    std::vector<playlist_event_t> _Events;
+
+    playlist_event_statistics_t _Statistics;
+};
@@ -0,0 +1,60 @@
+
+/** $VER: PooledChunk.h (2026.10.16) P. Stuer - Implements an audio chunk with storage that is reused from frame to frame. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <vector>
+
+/// <summary>
+/// Implements an audio chunk whose storage only grows. An instance that is reused for every frame stops allocating as soon as its storage fits the largest chunk.
+/// </summary>
+class PooledChunk : public audio_chunk
+{
+public:
+    PooledChunk() noexcept : _Size(), _SampleRate(), _ChannelCount(), _ChannelConfig(), _SampleCount() { }
+
+    PooledChunk(const PooledChunk &) = delete;
+    PooledChunk & operator=(const PooledChunk &) = delete;
+    PooledChunk(PooledChunk &&) = delete;
+    PooledChunk & operator=(PooledChunk &&) = delete;
+
+    /// <summary>
+    /// Makes room for the specified number of samples, all channels included. Grows the storage with some headroom so small variations of the chunk size don't cause a reallocation.
+    /// </summary>
+    void Reserve(size_t size)
+    {
+        if (size > _Data.size())
+            _Data.resize(size + (size / 4));
+    }
+
+    #pragma region audio_chunk
+
+    audio_sample * get_data() override { return _Data.data(); }
+    const audio_sample * get_data() const override { return _Data.data(); }
+
+    t_size get_data_size() const override { return _Size; }
+    void set_data_size(t_size size) override { Reserve(size); _Size = size; }
+
+    unsigned get_srate() const override { return _SampleRate; }
+    void set_srate(unsigned sampleRate) override { _SampleRate = sampleRate; }
+
+    unsigned get_channels() const override { return _ChannelCount; }
+    unsigned get_channel_config() const override { return _ChannelConfig; }
+    void set_channels(unsigned channelCount, unsigned channelConfig) override { _ChannelCount = channelCount; _ChannelConfig = channelConfig; }
+
+    t_size get_sample_count() const override { return _SampleCount; }
+    void set_sample_count(t_size sampleCount) override { _SampleCount = sampleCount; }
+
+    #pragma endregion
+
+private:
+    std::vector<audio_sample> _Data;
+    size_t _Size;                               // Requested size of the data, in samples. The storage can be larger.
+
+    unsigned _SampleRate;
+    unsigned _ChannelCount;
+    unsigned _ChannelConfig;
+    size_t _SampleCount;                        // in frames
+};
@@ -1,5 +1,5 @@
 
-/** $VER: Preferences.cpp (2024.08.04) P. Stuer **/
+/** $VER: Preferences.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -104,11 +104,102 @@ public:
             _Configuration._ReactionAlignment = ::_wtof(Text);
         }
 
+        {
+            GetDlgItemTextW(IDC_WINDOW_HOP, Text, _countof(Text));
+
+            _Configuration._WindowHop = (uint32_t) std::max(::_wtoi(Text), 0);
+        }
+
         _Configuration._ClearOnStartup = (SendDlgItemMessageW(IDC_CLEAR_BROWSING_DATA, BM_GETCHECK) == BST_CHECKED) ? ClearOnStartup::All : ClearOnStartup::None;
 
         _Configuration._InPrivateMode = (SendDlgItemMessageW(IDC_IN_PRIVATE_MODE, BM_GETCHECK) == BST_CHECKED);
         _Configuration._ScrollbarStyle = (SendDlgItemMessageW(IDC_SCROLLBAR_STYLE, BM_GETCHECK) == BST_CHECKED) ? ScrollbarStyle::Fluent : ScrollbarStyle::Default;
 
+        _Configuration._CallOnTimer = (SendDlgItemMessageW(IDC_CALL_ON_TIMER, BM_GETCHECK) == BST_CHECKED);
+        _Configuration._FrameRate = GetFrameRate();
+
+        _Configuration._SampleFormat = (SampleFormat) ((CComboBox) GetDlgItem(IDC_SAMPLE_FORMAT)).GetCurSel();
+
+        _Configuration._EnvelopeEnabled = (SendDlgItemMessageW(IDC_ENVELOPE, BM_GETCHECK) == BST_CHECKED);
+        _Configuration._WaveformEnabled = (SendDlgItemMessageW(IDC_WAVEFORM, BM_GETCHECK) == BST_CHECKED);
+        _Configuration._LoudnessEnabled = (SendDlgItemMessageW(IDC_LOUDNESS, BM_GETCHECK) == BST_CHECKED);
+        _Configuration._LevelsEnabled = (SendDlgItemMessageW(IDC_LEVELS, BM_GETCHECK) == BST_CHECKED);
+        _Configuration._StereoEnabled = (SendDlgItemMessageW(IDC_STEREO, BM_GETCHECK) == BST_CHECKED);
+        _Configuration._StereoMapping = (StereoMapping) ((CComboBox) GetDlgItem(IDC_STEREO_MAPPING)).GetCurSel();
+
+        {
+            GetDlgItemTextW(IDC_STEREO_POINT_COUNT, Text, _countof(Text));
+
+            _Configuration._StereoPointCount = (uint32_t) std::clamp(::_wtoi(Text), 0, 4096);
+        }
+
+        _Configuration._OnsetsEnabled = (SendDlgItemMessageW(IDC_ONSETS, BM_GETCHECK) == BST_CHECKED);
+
+        {
+            GetDlgItemTextW(IDC_METER_ATTACK, Text, _countof(Text));
+
+            _Configuration._MeterAttackTime = (uint32_t) std::max(::_wtoi(Text), 0);
+
+            GetDlgItemTextW(IDC_METER_RELEASE, Text, _countof(Text));
+
+            _Configuration._MeterReleaseTime = (uint32_t) std::max(::_wtoi(Text), 0);
+
+            GetDlgItemTextW(IDC_METER_HOLD, Text, _countof(Text));
+
+            _Configuration._MeterPeakHoldTime = (uint32_t) std::max(::_wtoi(Text), 0);
+        }
+
+        {
+            GetDlgItemTextW(IDC_ENVELOPE_BUCKET_COUNT, Text, _countof(Text));
+
+            _Configuration._EnvelopeBucketCount = (uint32_t) std::max(::_wtoi(Text), 0);
+        }
+
+        {
+            GetDlgItemTextW(IDC_SILENCE_THRESHOLD, Text, _countof(Text));
+
+            _Configuration._SilenceThreshold = std::clamp(::_wtoi(Text), -200, 0);
+
+            GetDlgItemTextW(IDC_SILENCE_DELAY, Text, _countof(Text));
+
+            _Configuration._SilenceDelay = (uint32_t) std::max(::_wtoi(Text), 0);
+        }
+
+        {
+            GetDlgItemTextW(IDC_EVENT_LIMIT, Text, _countof(Text));
+
+            _Configuration._EventLimit = (uint32_t) std::max(::_wtoi(Text), 0);
+        }
+
+        _Configuration._SpectrumEnabled = (SendDlgItemMessageW(IDC_SPECTRUM, BM_GETCHECK) == BST_CHECKED);
+
+        _Configuration._FFTSize        = GetFFTSize();
+        _Configuration._WindowFunction = (WindowFunction) ((CComboBox) GetDlgItem(IDC_WINDOW_FUNCTION)).GetCurSel();
+        _Configuration._BandLayout     = (BandLayout) ((CComboBox) GetDlgItem(IDC_BAND_LAYOUT)).GetCurSel();
+        _Configuration._AmplitudeScale = (AmplitudeScale) ((CComboBox) GetDlgItem(IDC_AMPLITUDE_SCALE)).GetCurSel();
+
+        {
+            GetDlgItemTextW(IDC_BAND_COUNT, Text, _countof(Text));
+
+            _Configuration._BandCount = std::clamp((uint32_t) ::_wtoi(Text), 1u, 1024u);
+        }
+
+        {
+            GetDlgItemTextW(IDC_SPECTROGRAM_BUDGET, Text, _countof(Text));
+
+            _Configuration._SpectrogramBudget = (uint32_t) std::clamp(::_wtoi(Text), 0, 256);
+        }
+
+        {
+            GetDlgItemTextW(IDC_MIN_FREQUENCY, Text, _countof(Text));
+
+            _Configuration._MinFrequency = ::_wtof(Text);
+
+            GetDlgItemTextW(IDC_MAX_FREQUENCY, Text, _countof(Text));
+
+            _Configuration._MaxFrequency = ::_wtof(Text);
+        }
+
         UIElement * CurrentElement = _UIElementTracker.GetCurrentElement();
 
         if (CurrentElement != nullptr)
@@ -147,12 +238,33 @@ public:
         COMMAND_HANDLER_EX(IDC_CLEAR_BROWSING_DATA, BN_CLICKED, OnButtonClicked)
         COMMAND_HANDLER_EX(IDC_IN_PRIVATE_MODE, BN_CLICKED, OnButtonClicked)
         COMMAND_HANDLER_EX(IDC_SCROLLBAR_STYLE, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_CALL_ON_TIMER, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_SPECTRUM, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_ENVELOPE, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_WAVEFORM, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_LOUDNESS, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_LEVELS, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_STEREO, BN_CLICKED, OnButtonClicked)
+        COMMAND_HANDLER_EX(IDC_ONSETS, BN_CLICKED, OnButtonClicked)
 
         COMMAND_HANDLER_EX(IDC_FILE_PATH_SELECT, BN_CLICKED, OnButtonClicked)
         COMMAND_HANDLER_EX(IDC_FILE_PATH_EDIT, BN_CLICKED, OnButtonClicked)
 
         COMMAND_HANDLER_EX(IDC_WINDOW_SIZE, EN_CHANGE, OnEditChange)
         COMMAND_HANDLER_EX(IDC_REACTION_ALIGNMENT, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_WINDOW_HOP, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_BAND_COUNT, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_SPECTROGRAM_BUDGET, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_MIN_FREQUENCY, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_MAX_FREQUENCY, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_ENVELOPE_BUCKET_COUNT, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_SILENCE_THRESHOLD, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_SILENCE_DELAY, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_EVENT_LIMIT, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_METER_ATTACK, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_METER_RELEASE, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_METER_HOLD, EN_CHANGE, OnEditChange)
+        COMMAND_HANDLER_EX(IDC_STEREO_POINT_COUNT, EN_CHANGE, OnEditChange)
     END_MSG_MAP()
 
 private:
@@ -195,10 +307,176 @@ private:
         }
 
         SetDlgItemTextW(IDC_REACTION_ALIGNMENT, pfc::wideFromUTF8(pfc::format_float(_Configuration._ReactionAlignment, 0, 2)));
+        SetDlgItemTextW(IDC_WINDOW_HOP, pfc::wideFromUTF8(pfc::format_int(_Configuration._WindowHop)));
 
         SendDlgItemMessageW(IDC_CLEAR_BROWSING_DATA, BM_SETCHECK, (WPARAM) (_Configuration._ClearOnStartup == ClearOnStartup::All ? BST_CHECKED : BST_UNCHECKED));
         SendDlgItemMessageW(IDC_IN_PRIVATE_MODE, BM_SETCHECK, (WPARAM) (_Configuration._InPrivateMode ? BST_CHECKED : BST_UNCHECKED));
         SendDlgItemMessageW(IDC_SCROLLBAR_STYLE, BM_SETCHECK, (WPARAM) ((_Configuration._ScrollbarStyle == ScrollbarStyle::Fluent) ? BST_CHECKED : BST_UNCHECKED));
+        SendDlgItemMessageW(IDC_CALL_ON_TIMER, BM_SETCHECK, (WPARAM) (_Configuration._CallOnTimer ? BST_CHECKED : BST_UNCHECKED));
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_FRAME_RATE);
+
+            w.ResetContent();
+
+            int Selection = 0;
+
+            for (size_t i = 0; i < _countof(FrameRates); ++i)
+            {
+                w.AddString((FrameRates[i] != 0) ? ::FormatText(L"%u Hz", FrameRates[i]).c_str() : L"Display");
+
+                if (FrameRates[i] == _Configuration._FrameRate)
+                    Selection = (int) i;
+            }
+
+            w.SetCurSel(Selection);
+        }
+
+        SendDlgItemMessageW(IDC_SPECTRUM, BM_SETCHECK, (WPARAM) (_Configuration._SpectrumEnabled ? BST_CHECKED : BST_UNCHECKED));
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_FFT_SIZE);
+
+            w.ResetContent();
+
+            int Selection = 0;
+
+            for (uint32_t Size = MinFFTSize, i = 0; Size <= MaxFFTSize; Size *= 2, ++i)
+            {
+                w.AddString(pfc::wideFromUTF8(pfc::format_int(Size)));
+
+                if (Size == _Configuration._FFTSize)
+                    Selection = (int) i;
+            }
+
+            w.SetCurSel(Selection);
+        }
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_WINDOW_FUNCTION);
+
+            w.ResetContent();
+
+            const WCHAR * Labels[] = { L"Rectangular", L"Hann", L"Hamming", L"Blackman", L"Blackman-Harris", L"Flat top" };
+
+            assert(((size_t) WindowFunction::Count == _countof(Labels)));
+
+            for (auto Label : Labels)
+                w.AddString(Label);
+
+            w.SetCurSel((int) _Configuration._WindowFunction);
+        }
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_BAND_LAYOUT);
+
+            w.ResetContent();
+
+            const WCHAR * Labels[] = { L"Linear", L"Logarithmic", L"Bark" };
+
+            assert(((size_t) BandLayout::Count == _countof(Labels)));
+
+            for (auto Label : Labels)
+                w.AddString(Label);
+
+            w.SetCurSel((int) _Configuration._BandLayout);
+        }
+
+        SetDlgItemTextW(IDC_BAND_COUNT, pfc::wideFromUTF8(pfc::format_int(_Configuration._BandCount)));
+        SetDlgItemTextW(IDC_SPECTROGRAM_BUDGET, pfc::wideFromUTF8(pfc::format_int(_Configuration._SpectrogramBudget)));
+
+        SetDlgItemTextW(IDC_MIN_FREQUENCY, pfc::wideFromUTF8(pfc::format_float(_Configuration._MinFrequency, 0, 0)));
+        SetDlgItemTextW(IDC_MAX_FREQUENCY, pfc::wideFromUTF8(pfc::format_float(_Configuration._MaxFrequency, 0, 0)));
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_AMPLITUDE_SCALE);
+
+            w.ResetContent();
+
+            const WCHAR * Labels[] = { L"Linear", L"Decibel" };
+
+            assert(((size_t) AmplitudeScale::Count == _countof(Labels)));
+
+            for (auto Label : Labels)
+                w.AddString(Label);
+
+            w.SetCurSel((int) _Configuration._AmplitudeScale);
+        }
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_SAMPLE_FORMAT);
+
+            w.ResetContent();
+
+            const WCHAR * Labels[] = { L"64-bit float", L"32-bit float", L"32-bit float, planar", L"16-bit integer" };
+
+            assert(((size_t) SampleFormat::Count == _countof(Labels)));
+
+            for (auto Label : Labels)
+                w.AddString(Label);
+
+            w.SetCurSel((int) _Configuration._SampleFormat);
+        }
+
+        SendDlgItemMessageW(IDC_ENVELOPE, BM_SETCHECK, (WPARAM) (_Configuration._EnvelopeEnabled ? BST_CHECKED : BST_UNCHECKED));
+
+        SetDlgItemTextW(IDC_ENVELOPE_BUCKET_COUNT, pfc::wideFromUTF8(pfc::format_int(_Configuration._EnvelopeBucketCount)));
+
+        SetDlgItemTextW(IDC_SILENCE_THRESHOLD, pfc::wideFromUTF8(pfc::format_int(_Configuration._SilenceThreshold)));
+        SetDlgItemTextW(IDC_SILENCE_DELAY, pfc::wideFromUTF8(pfc::format_int(_Configuration._SilenceDelay)));
+
+        SetDlgItemTextW(IDC_EVENT_LIMIT, pfc::wideFromUTF8(pfc::format_int(_Configuration._EventLimit)));
+
+        SendDlgItemMessageW(IDC_WAVEFORM, BM_SETCHECK, (WPARAM) (_Configuration._WaveformEnabled ? BST_CHECKED : BST_UNCHECKED));
+
+        SendDlgItemMessageW(IDC_LOUDNESS, BM_SETCHECK, (WPARAM) (_Configuration._LoudnessEnabled ? BST_CHECKED : BST_UNCHECKED));
+
+        SendDlgItemMessageW(IDC_LEVELS, BM_SETCHECK, (WPARAM) (_Configuration._LevelsEnabled ? BST_CHECKED : BST_UNCHECKED));
+
+        SetDlgItemTextW(IDC_METER_ATTACK,  pfc::wideFromUTF8(pfc::format_int(_Configuration._MeterAttackTime)));
+        SetDlgItemTextW(IDC_METER_RELEASE, pfc::wideFromUTF8(pfc::format_int(_Configuration._MeterReleaseTime)));
+        SetDlgItemTextW(IDC_METER_HOLD,    pfc::wideFromUTF8(pfc::format_int(_Configuration._MeterPeakHoldTime)));
+
+        SendDlgItemMessageW(IDC_STEREO, BM_SETCHECK, (WPARAM) (_Configuration._StereoEnabled ? BST_CHECKED : BST_UNCHECKED));
+
+        {
+            auto w = (CComboBox) GetDlgItem(IDC_STEREO_MAPPING);
+
+            w.ResetContent();
+
+            const WCHAR * Labels[] = { L"Front", L"Back", L"Side", L"Downmix" };
+
+            assert(((size_t) StereoMapping::Count == _countof(Labels)));
+
+            for (auto Label : Labels)
+                w.AddString(Label);
+
+            w.SetCurSel((int) _Configuration._StereoMapping);
+        }
+
+        SetDlgItemTextW(IDC_STEREO_POINT_COUNT, pfc::wideFromUTF8(pfc::format_int(_Configuration._StereoPointCount)));
+
+        SendDlgItemMessageW(IDC_ONSETS, BM_SETCHECK, (WPARAM) (_Configuration._OnsetsEnabled ? BST_CHECKED : BST_UNCHECKED));
+    }
+
+    /// <summary>
+    /// Gets the FFT size selected in the combo box.
+    /// </summary>
+    uint32_t GetFFTSize() noexcept
+    {
+        const int Selection = ((CComboBox) GetDlgItem(IDC_FFT_SIZE)).GetCurSel();
+
+        return (Selection >= 0) ? MinFFTSize << Selection : _Configuration._FFTSize;
+    }
+
+    /// <summary>
+    /// Gets the frame rate selected in the combo box.
+    /// </summary>
+    uint32_t GetFrameRate() noexcept
+    {
+        const int Selection = ((CComboBox) GetDlgItem(IDC_FRAME_RATE)).GetCurSel();
+
+        return ((Selection >= 0) && (Selection < (int) _countof(FrameRates))) ? FrameRates[Selection] : _Configuration._FrameRate;
     }
 
     /// <summary>
@@ -327,6 +605,14 @@ private:
 
         SetDlgItemTextW(IDC_WINDOW_OFFSET, ::FormatText(Format, ::abs(WindowOffset), (WindowOffset > 0) ? L"behind" : L"ahead of").c_str());
 
+        GetDlgItemTextW(IDC_WINDOW_HOP, Text, _countof(Text));
+        int WindowHop = ::_wtoi(Text);
+
+        if ((WindowHop > 0) && (WindowSize != 0))
+            SetDlgItemTextW(IDC_WINDOW_OVERLAP, ::FormatText(L"%d%% overlap", std::max((int) ::lround(100. * (1. - ((double) WindowHop / (double) WindowSize))), 0)).c_str());
+        else
+            SetDlgItemTextW(IDC_WINDOW_OVERLAP, L"");
+
         _Callback->on_state_changed();
     }
 
@@ -369,6 +655,11 @@ private:
         if (_Configuration._ReactionAlignment != ::_wtof(Text))
             return true;
 
+        GetDlgItemTextW(IDC_WINDOW_HOP, Text, _countof(Text));
+
+        if (_Configuration._WindowHop != (uint32_t) ::_wtoi(Text))
+            return true;
+
         if (SendDlgItemMessageW(IDC_CLEAR_BROWSING_DATA, BM_GETCHECK) != (_Configuration._ClearOnStartup == ClearOnStartup::All ? BST_CHECKED : BST_UNCHECKED))
             return true;
 
@@ -378,10 +669,120 @@ private:
         if (SendDlgItemMessageW(IDC_SCROLLBAR_STYLE, BM_GETCHECK) != ((_Configuration._ScrollbarStyle == ScrollbarStyle::Fluent) ? BST_CHECKED : BST_UNCHECKED))
             return true;
 
+        if (SendDlgItemMessageW(IDC_CALL_ON_TIMER, BM_GETCHECK) != (_Configuration._CallOnTimer ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        if (_Configuration._FrameRate != GetFrameRate())
+            return true;
+
+        if (_Configuration._SampleFormat != (SampleFormat) ((CComboBox) GetDlgItem(IDC_SAMPLE_FORMAT)).GetCurSel())
+            return true;
+
+        if (SendDlgItemMessageW(IDC_ENVELOPE, BM_GETCHECK) != (_Configuration._EnvelopeEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        GetDlgItemTextW(IDC_ENVELOPE_BUCKET_COUNT, Text, _countof(Text));
+
+        if (_Configuration._EnvelopeBucketCount != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_SILENCE_THRESHOLD, Text, _countof(Text));
+
+        if (_Configuration._SilenceThreshold != ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_SILENCE_DELAY, Text, _countof(Text));
+
+        if (_Configuration._SilenceDelay != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_EVENT_LIMIT, Text, _countof(Text));
+
+        if (_Configuration._EventLimit != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        if (SendDlgItemMessageW(IDC_WAVEFORM, BM_GETCHECK) != (_Configuration._WaveformEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        if (SendDlgItemMessageW(IDC_LOUDNESS, BM_GETCHECK) != (_Configuration._LoudnessEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        if (SendDlgItemMessageW(IDC_LEVELS, BM_GETCHECK) != (_Configuration._LevelsEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        GetDlgItemTextW(IDC_METER_ATTACK, Text, _countof(Text));
+
+        if (_Configuration._MeterAttackTime != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_METER_RELEASE, Text, _countof(Text));
+
+        if (_Configuration._MeterReleaseTime != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_METER_HOLD, Text, _countof(Text));
+
+        if (_Configuration._MeterPeakHoldTime != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        if (SendDlgItemMessageW(IDC_STEREO, BM_GETCHECK) != (_Configuration._StereoEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        if (_Configuration._StereoMapping != (StereoMapping) ((CComboBox) GetDlgItem(IDC_STEREO_MAPPING)).GetCurSel())
+            return true;
+
+        GetDlgItemTextW(IDC_STEREO_POINT_COUNT, Text, _countof(Text));
+
+        if (_Configuration._StereoPointCount != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        if (SendDlgItemMessageW(IDC_ONSETS, BM_GETCHECK) != (_Configuration._OnsetsEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        if (SendDlgItemMessageW(IDC_SPECTRUM, BM_GETCHECK) != (_Configuration._SpectrumEnabled ? BST_CHECKED : BST_UNCHECKED))
+            return true;
+
+        if (_Configuration._FFTSize != GetFFTSize())
+            return true;
+
+        if (_Configuration._WindowFunction != (WindowFunction) ((CComboBox) GetDlgItem(IDC_WINDOW_FUNCTION)).GetCurSel())
+            return true;
+
+        if (_Configuration._BandLayout != (BandLayout) ((CComboBox) GetDlgItem(IDC_BAND_LAYOUT)).GetCurSel())
+            return true;
+
+        if (_Configuration._AmplitudeScale != (AmplitudeScale) ((CComboBox) GetDlgItem(IDC_AMPLITUDE_SCALE)).GetCurSel())
+            return true;
+
+        GetDlgItemTextW(IDC_BAND_COUNT, Text, _countof(Text));
+
+        if (_Configuration._BandCount != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_SPECTROGRAM_BUDGET, Text, _countof(Text));
+
+        if (_Configuration._SpectrogramBudget != (uint32_t) ::_wtoi(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_MIN_FREQUENCY, Text, _countof(Text));
+
+        if (_Configuration._MinFrequency != ::_wtof(Text))
+            return true;
+
+        GetDlgItemTextW(IDC_MAX_FREQUENCY, Text, _countof(Text));
+
+        if (_Configuration._MaxFrequency != ::_wtof(Text))
+            return true;
+
         return false;
     }
 
 private:
+    static const uint32_t MinFFTSize = 256;
+    static const uint32_t MaxFFTSize = 32768;
+
+    static constexpr uint32_t FrameRates[] = { 0, 30, 50, 60, 120, 144 }; // in Hz, 0 = refresh rate of the display
+
     const preferences_page_callback::ptr _Callback;
 
     fb2k::CDarkModeHooks _DarkModeHooks;
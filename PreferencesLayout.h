@@ -1,5 +1,5 @@
 
-/** $VER: PreferencesLayout.h (2024.08.04) **/
+/** $VER: PreferencesLayout.h (2026.10.16) **/
 
 #pragma once
 
@@ -131,6 +131,24 @@
 #define W_D25   100
 #define H_D25   H_LBL
 
+// Label
+#define X_D68   X_D25 + W_D25 + DX
+#define Y_D68   Y_D23
+#define W_D68   20
+#define H_D68   H_LBL
+
+// EditBox: Window hop
+#define X_D69   X_D68 + W_D68 + IX
+#define Y_D69   Y_D23
+#define W_D69   30
+#define H_D69   H_EBX
+
+// Label: Window overlap
+#define X_D70   X_D69 + W_D69 + IX
+#define Y_D70   Y_D23
+#define W_D70   50
+#define H_D70   H_LBL
+
 #pragma endregion
 
 // Checkbox: Clear browsing data on startup
@@ -139,6 +157,36 @@
 #define W_D26   160
 #define H_D26   H_LBL
 
+// Checkbox: Write the stereo correlation and goniometer points to the shared buffer
+#define X_D62   X_D26 + W_D26 + DX
+#define Y_D62   Y_D26
+#define W_D62   160
+#define H_D62   H_LBL
+
+// Label
+#define X_D63   X_D62
+#define Y_D63   Y_D27
+#define W_D63   36
+#define H_D63   H_LBL
+
+// ComboBox: Stereo channel mapping
+#define X_D64   X_D63 + W_D63 + IX
+#define Y_D64   Y_D27
+#define W_D64   60
+#define H_D64   H_CBX
+
+// Label
+#define X_D65   X_D64 + W_D64 + IX
+#define Y_D65   Y_D27
+#define W_D65   26
+#define H_D65   H_LBL
+
+// EditBox: Goniometer point count
+#define X_D66   X_D65 + W_D65 + IX
+#define Y_D66   Y_D27
+#define W_D66   30
+#define H_D66   H_EBX
+
 // Checkbox: In Private mode
 #define X_D27   0
 #define Y_D27   Y_D26 + H_D26 + IY
@@ -151,6 +199,256 @@
 #define W_D28   160
 #define H_D28   H_LBL
 
+// Checkbox: Post beat and onset events to the script
+#define X_D67   X_D28 + W_D28 + DX
+#define Y_D67   Y_D28
+#define W_D67   160
+#define H_D67   H_LBL
+
+// Checkbox: Call onTimer() on every frame
+#define X_D29   0
+#define Y_D29   Y_D28 + H_D28 + IY
+#define W_D29   160
+#define H_D29   H_LBL
+
+#pragma region Spectrum
+
+// Checkbox: Write the spectrum to the shared buffer
+#define X_D30   0
+#define Y_D30   Y_D29 + H_D29 + DY
+#define W_D30   160
+#define H_D30   H_LBL
+
+// Checkbox: Write the levels instead of the samples
+#define X_D54   X_D29 + W_D29 + DX
+#define Y_D54   Y_D29
+#define W_D54   160
+#define H_D54   H_LBL
+
+// Checkbox: Write the loudness to the shared buffer
+#define X_D53   X_D30 + W_D30 + DX
+#define Y_D53   Y_D30
+#define W_D53   160
+#define H_D53   H_LBL
+
+// Label
+#define X_D31   0
+#define Y_D31   Y_D30 + H_D30 + IY
+#define W_D31   76
+#define H_D31   H_LBL
+
+// ComboBox: FFT size
+#define X_D32   X_D31 + W_D31 + IX
+#define Y_D32   Y_D31
+#define W_D32   44
+#define H_D32   H_CBX
+
+// Label
+#define X_D33   X_D32 + W_D32 + IX
+#define Y_D33   Y_D31
+#define W_D33   50
+#define H_D33   H_LBL
+
+// ComboBox: Window function
+#define X_D34   X_D33 + W_D33 + IX
+#define Y_D34   Y_D31
+#define W_D34   70
+#define H_D34   H_CBX
+
+// Label
+#define X_D35   0
+#define Y_D35   Y_D32 + H_D32 + IY
+#define W_D35   76
+#define H_D35   H_LBL
+
+// ComboBox: Band layout
+#define X_D36   X_D35 + W_D35 + IX
+#define Y_D36   Y_D35
+#define W_D36   44
+#define H_D36   H_CBX
+
+// Label
+#define X_D37   X_D36 + W_D36 + IX
+#define Y_D37   Y_D35
+#define W_D37   50
+#define H_D37   H_LBL
+
+// EditBox: Band count
+#define X_D38   X_D37 + W_D37 + IX
+#define Y_D38   Y_D35
+#define W_D38   30
+#define H_D38   H_EBX
+
+// Label
+#define X_D60   X_D38 + W_D38 + DX
+#define Y_D60   Y_D35
+#define W_D60   66
+#define H_D60   H_LBL
+
+// EditBox: Spectrogram memory budget
+#define X_D61   X_D60 + W_D60 + IX
+#define Y_D61   Y_D35
+#define W_D61   30
+#define H_D61   H_EBX
+
+// Label
+#define X_D39   0
+#define Y_D39   Y_D36 + H_D36 + IY
+#define W_D39   76
+#define H_D39   H_LBL
+
+// EditBox: Min. frequency
+#define X_D40   X_D39 + W_D39 + IX
+#define Y_D40   Y_D39
+#define W_D40   30
+#define H_D40   H_EBX
+
+// EditBox: Max. frequency
+#define X_D41   X_D40 + W_D40 + IX
+#define Y_D41   Y_D39
+#define W_D41   30
+#define H_D41   H_EBX
+
+// Label
+#define X_D42   X_D33
+#define Y_D42   Y_D39
+#define W_D42   50
+#define H_D42   H_LBL
+
+// ComboBox: Amplitude scale
+#define X_D43   X_D34
+#define Y_D43   Y_D39
+#define W_D43   70
+#define H_D43   H_CBX
+
+#pragma endregion
+
+// Label
+#define X_D44   0
+#define Y_D44   Y_D43 + H_D43 + DY
+#define W_D44   76
+#define H_D44   H_LBL
+
+// ComboBox: Sample format
+#define X_D45   X_D44 + W_D44 + IX
+#define Y_D45   Y_D44
+#define W_D45   98
+#define H_D45   H_CBX
+
+// Label
+#define X_D51   X_D22 + W_D22 + DX
+#define Y_D51   Y_D20
+#define W_D51   40
+#define H_D51   H_LBL
+
+// ComboBox: Frame rate
+#define X_D52   X_D51 + W_D51 + IX
+#define Y_D52   Y_D20
+#define W_D52   60
+#define H_D52   H_CBX
+
+// Label
+#define X_D74   X_D52 + W_D52 + DX
+#define Y_D74   Y_D20
+#define W_D74   30
+#define H_D74   H_LBL
+
+// EditBox: Maximum number of events in flight
+#define X_D75   X_D74 + W_D74 + IX
+#define Y_D75   Y_D20
+#define W_D75   20
+#define H_D75   H_EBX
+
+// Checkbox: Generate the waveform of the whole track
+#define X_D50   X_D45 + W_D45 + DX
+#define Y_D50   Y_D45 + 3
+#define W_D50   140
+#define H_D50   H_LBL
+
+#pragma region Envelope
+
+// Checkbox: Write the envelope instead of the samples
+#define X_D46   0
+#define Y_D46   Y_D45 + H_D45 + IY
+#define W_D46   200
+#define H_D46   H_LBL
+
+// Label
+#define X_D47   0
+#define Y_D47   Y_D46 + H_D46 + IY
+#define W_D47   76
+#define H_D47   H_LBL
+
+// EditBox: Bucket count
+#define X_D48   X_D47 + W_D47 + IX
+#define Y_D48   Y_D47
+#define W_D48   30
+#define H_D48   H_EBX
+
+// Label
+#define X_D49   X_D48 + W_D48 + IX
+#define Y_D49   Y_D47
+#define W_D49   60
+#define H_D49   H_LBL
+
+#pragma endregion
+
+#pragma region Silence
+
+// Label
+#define X_D71   X_D49 + W_D49 + DX
+#define Y_D71   Y_D47
+#define W_D71   70
+#define H_D71   H_LBL
+
+// EditBox: Silence threshold
+#define X_D72   X_D71 + W_D71 + IX
+#define Y_D72   Y_D47
+#define W_D72   30
+#define H_D72   H_EBX
+
+// EditBox: Silence delay
+#define X_D73   X_D72 + W_D72 + IX
+#define Y_D73   Y_D47
+#define W_D73   30
+#define H_D73   H_EBX
+
+#pragma endregion
+
+#pragma region Level meter
+
+// Label
+#define X_D55   0
+#define Y_D55   Y_D48 + H_D48 + IY
+#define W_D55   76
+#define H_D55   H_LBL
+
+// EditBox: Attack time
+#define X_D56   X_D55 + W_D55 + IX
+#define Y_D56   Y_D55
+#define W_D56   30
+#define H_D56   H_EBX
+
+// EditBox: Release time
+#define X_D57   X_D56 + W_D56 + IX
+#define Y_D57   Y_D55
+#define W_D57   30
+#define H_D57   H_EBX
+
+// EditBox: Peak hold time
+#define X_D58   X_D57 + W_D57 + IX
+#define Y_D58   Y_D55
+#define W_D58   30
+#define H_D58   H_EBX
+
+// Label
+#define X_D59   X_D58 + W_D58 + IX
+#define Y_D59   Y_D55
+#define W_D59   120
+#define H_D59   H_LBL
+
+#pragma endregion
+
 // Warning
 #define X_D99   0
 #define Y_D99   H_A00 - H_LBL
@@ -0,0 +1,163 @@
+
+/** $VER: RegionLayout.cpp (2026.10.16) P. Stuer - Lays out named regions in a shared buffer and describes them in a binary table. Host-independent. **/
+
+#include "RegionLayout.h"
+
+#include <cstring>
+#include <limits>
+
+/// <summary>
+/// Removes all regions. The regions will follow a header of the specified size and the descriptor table.
+/// </summary>
+void RegionLayout::Reset(size_t headerSize) noexcept
+{
+    _HeaderSize = headerSize;
+    _Size = 0;
+
+    _Regions.clear();
+    _Alignments.clear();
+}
+
+/// <summary>
+/// Adds a region. Returns false if the name is empty, too long or already in use, if the alignment is not a power of 2 or if the size does not fit in 32 bits.
+/// </summary>
+bool RegionLayout::Add(uint8_t id, const char * name, uint8_t format, uint16_t flags, size_t size, size_t alignment)
+{
+    if ((name == nullptr) || (*name == '\0') || (::strlen(name) > MaxNameLength) || (Find(name) != nullptr))
+        return false;
+
+    if (size > std::numeric_limits<uint32_t>::max())
+        return false;
+
+    if ((alignment == 0) || ((alignment & (alignment - 1)) != 0))
+        return false;
+
+    region_t Region = { };
+
+    Region.Id     = id;
+    Region.Format = format;
+    Region.Flags  = flags;
+    Region.Size   = (uint32_t) size;
+
+    ::memcpy(Region.Name, name, ::strlen(name)); // The remainder of the name is zero.
+
+    _Regions.push_back(Region);
+    _Alignments.push_back(alignment);
+
+    _Size = 0;
+
+    return true;
+}
+
+/// <summary>
+/// Assigns the offsets of the regions in the order they were added. Returns the total size of the buffer or 0 if the regions do not fit in a buffer that can be addressed with 32-bit offsets.
+/// </summary>
+size_t RegionLayout::Finish() noexcept
+{
+    size_t Offset = _HeaderSize + GetTableSize();
+
+    for (size_t i = 0; i < _Regions.size(); ++i)
+    {
+        Offset = Align(Offset, _Alignments[i]);
+
+        _Regions[i].Offset = (uint32_t) Offset;
+
+        Offset += _Regions[i].Size;
+
+        if (Offset > std::numeric_limits<uint32_t>::max())
+            return _Size = 0;
+    }
+
+    _Size = Align(Offset, DefaultAlignment);
+
+    return _Size;
+}
+
+/// <summary>
+/// Writes the descriptor table to the specified buffer at the table offset.
+/// </summary>
+void RegionLayout::WriteTable(uint8_t * buffer) const noexcept
+{
+    if (!_Regions.empty())
+        ::memcpy(buffer + _HeaderSize, _Regions.data(), GetTableSize());
+}
+
+/// <summary>
+/// Sets the number of valid values of the region with the specified id. Returns false if there is no such region.
+/// </summary>
+bool RegionLayout::SetCount(uint8_t id, uint32_t count) noexcept
+{
+    for (auto & Region : _Regions)
+    {
+        if (Region.Id == id)
+        {
+            Region.Count = count;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Sets the flags of the region with the specified id. Returns false if there is no such region.
+/// </summary>
+bool RegionLayout::SetFlags(uint8_t id, uint16_t flags) noexcept
+{
+    for (auto & Region : _Regions)
+    {
+        if (Region.Id == id)
+        {
+            Region.Flags = flags;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Finds the region with the specified id.
+/// </summary>
+const region_t * RegionLayout::Find(uint8_t id) const noexcept
+{
+    for (const auto & Region : _Regions)
+    {
+        if (Region.Id == id)
+            return &Region;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Finds the region with the specified name.
+/// </summary>
+const region_t * RegionLayout::Find(const char * name) const noexcept
+{
+    for (const auto & Region : _Regions)
+    {
+        if (::strncmp(Region.Name, name, sizeof(Region.Name)) == 0)
+            return &Region;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Finds the region with the specified name in the descriptor table of a buffer, the way a reader of the buffer would.
+/// </summary>
+const region_t * RegionLayout::Find(const uint8_t * buffer, size_t tableOffset, size_t count, const char * name) noexcept
+{
+    const auto * Regions = (const region_t *) (buffer + tableOffset);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (::strncmp(Regions[i].Name, name, sizeof(Regions[i].Name)) == 0)
+            return &Regions[i];
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,105 @@
+
+/** $VER: RegionLayout.h (2026.10.16) P. Stuer - Lays out named regions in a shared buffer and describes them in a binary table. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <vector>
+
+#pragma pack(push, 8)
+
+/// <summary>
+/// Describes a region of a shared buffer. The descriptors are stored in a table so scripts can locate a region by id or by name.
+/// </summary>
+struct region_t
+{
+    uint8_t Id;
+    uint8_t Format;             // Format of the values in the region. Defined by the owner of the buffer.
+    uint16_t Flags;             // Defined by the owner of the buffer.
+
+    uint32_t Offset;            // Offset of the region from the start of the buffer, in bytes.
+    uint32_t Size;              // Size of the region, in bytes.
+    uint32_t Count;             // Number of valid values. Updated by the owner of the buffer.
+
+    char Name[16];              // ASCII name, padded with zeros. Always zero-terminated.
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(region_t) == 32, "Unexpected region size");
+
+/// <summary>
+/// Assigns offsets to a set of regions that follow a fixed header and the descriptor table, and writes the descriptor table.
+/// </summary>
+class RegionLayout
+{
+public:
+    RegionLayout() noexcept : _HeaderSize(), _Size() { }
+
+    void Reset(size_t headerSize) noexcept;
+    bool Add(uint8_t id, const char * name, uint8_t format, uint16_t flags, size_t size, size_t alignment = DefaultAlignment);
+    size_t Finish() noexcept;
+
+    void WriteTable(uint8_t * buffer) const noexcept;
+
+    bool SetCount(uint8_t id, uint32_t count) noexcept;
+    bool SetFlags(uint8_t id, uint16_t flags) noexcept;
+
+    const region_t * Find(uint8_t id) const noexcept;
+    const region_t * Find(const char * name) const noexcept;
+
+    static const region_t * Find(const uint8_t * buffer, size_t tableOffset, size_t count, const char * name) noexcept;
+
+    /// <summary>
+    /// Gets the regions in the order they were added.
+    /// </summary>
+    const std::vector<region_t> & GetRegions() const noexcept
+    {
+        return _Regions;
+    }
+
+    /// <summary>
+    /// Gets the offset of the descriptor table. The table immediately follows the header.
+    /// </summary>
+    size_t GetTableOffset() const noexcept
+    {
+        return _HeaderSize;
+    }
+
+    /// <summary>
+    /// Gets the size of the descriptor table, in bytes.
+    /// </summary>
+    size_t GetTableSize() const noexcept
+    {
+        return _Regions.size() * sizeof(region_t);
+    }
+
+    /// <summary>
+    /// Gets the total size of the buffer, in bytes. Only valid after Finish().
+    /// </summary>
+    size_t GetSize() const noexcept
+    {
+        return _Size;
+    }
+
+    static constexpr size_t DefaultAlignment = 16;
+    static constexpr size_t MaxNameLength = sizeof(region_t::Name) - 1;
+
+private:
+    /// <summary>
+    /// Rounds the specified offset up to a multiple of the alignment. The alignment must be a power of 2.
+    /// </summary>
+    static size_t Align(size_t offset, size_t alignment) noexcept
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+private:
+    size_t _HeaderSize;
+    size_t _Size;
+
+    std::vector<region_t> _Regions;
+    std::vector<size_t> _Alignments;
+};
@@ -1,95 +1,1100 @@
 
-/** $VER: Rendering.cpp (2024.07.03) P. Stuer **/
+/** $VER: Rendering.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
 #include "UIElement.h"
+#include "UIElementTracker.h"
 #include "Encoding.h"
 #include "Exceptions.h"
 #include "Support.h"
+#include "AllocationCounter.h"
 
 #pragma hdrstop
 
+static void GetStereoWeights(StereoMapping mapping, uint32_t channelConfig, uint32_t channelCount, double * left, double * right) noexcept;
+static bool IsSilent(const audio_sample * samples, size_t count, double threshold) noexcept;
+
 /// <summary>
 /// Starts the timer.
 /// </summary>
 void UIElement::StartTimer() noexcept
 {
-    ::SetTimer(m_hWnd, (UINT_PTR) this, 1000 / (DWORD) 50, (TIMERPROC) TimerCallback);
+    const double FrameRate = GetFrameRate();
+
+    _FrameRecorder.Reset();
+    _FrameRecorder.SetPeriod((uint64_t) (1'000'000. / FrameRate));
+
+    _SilenceStart = 0;
+    _IsIdle = false;
+
+    HRESULT hr = _FrameScheduler.Start(FrameRate, [this]() { OnTimer(); });
+
+    if (!SUCCEEDED(hr))
+        console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to start frame timer").c_str());
 }
 
 /// <summary>
-/// Stops the timer.
+/// Stops the timer. Waits for the tick in progress, if any, to complete.
 /// </summary>
 void UIElement::StopTimer() noexcept
 {
-    ::KillTimer(m_hWnd, (UINT_PTR) this);
+    _FrameScheduler.Stop();
+}
+
+/// <summary>
+/// Gets the rate of the frame timer, in Hz. Uses the refresh rate of the monitor that contains the panel if the configuration does not specify one.
+/// </summary>
+double UIElement::GetFrameRate() const noexcept
+{
+    if (_Configuration._FrameRate != 0)
+        return (double) _Configuration._FrameRate;
+
+    MONITORINFOEXW mi = { };
+
+    mi.cbSize = sizeof(mi);
+
+    DEVMODEW dm = { };
+
+    dm.dmSize = sizeof(dm);
+
+    // A display frequency of 0 or 1 represents the default rate of the hardware.
+    if (::GetMonitorInfoW(::MonitorFromWindow(m_hWnd, MONITOR_DEFAULTTONEAREST), &mi) && ::EnumDisplaySettingsW(mi.szDevice, ENUM_CURRENT_SETTINGS, &dm) && (dm.dmDisplayFrequency > 1))
+        return (double) dm.dmDisplayFrequency;
+
+    return 60.;
+}
+
+/// <summary>
+/// Gets the timing statistics of the frame timer as JSON.
+/// </summary>
+std::wstring UIElement::GetFrameStatistics() const noexcept
+{
+    const auto s = _FrameScheduler.GetStatistics();
+
+    uint64_t ReallocationCount;
+
+    {
+        std::lock_guard<std::mutex> Lock(_FrameLock);
+
+        ReallocationCount = _SharedBuffer.GetReallocationCount();
+    }
+
+    const auto & p = _PlaylistEvents.GetStatistics();
+    const auto & b = _EventBus.GetStatistics();
+
+    return ::FormatText(LR"({"frameRate": %.3f, "frameCount": %llu, "missedFrameCount": %llu, "meanInterval": %.3f, "meanJitter": %.3f, "maxJitter": %.3f, "jitterDeviation": %.3f, "meanDuration": %.3f, "maxDuration": %.3f, "reallocationCount": %llu, "pipeline": %s, "playlistEvents": {"eventCount": %llu, "mergedCount": %llu, "batchCount": %llu, "pageCount": %llu}, "events": {"postedCount": %llu, "sentCount": %llu, "droppedCount": %llu, "mergedCount": %llu, "inFlightCount": %llu, "maxInFlightCount": %llu}})",
+        s.FrameRate, s.FrameCount, s.MissedFrameCount, s.MeanInterval, s.MeanJitter, s.MaxJitter, s.JitterDeviation, s.MeanDuration, s.MaxDuration, ReallocationCount, ::UTF8ToWide(_FrameRecorder.ToJSON()).c_str(), p.EventCount, p.MergedCount, p.BatchCount, p.PageCount,
+        b.PostedCount, b.SentCount, b.DroppedCount, b.MergedCount, _EventBus.GetInFlightCount(), b.MaxInFlightCount);
 }
 
 /// <summary>
-/// Handles a timer tick.
+/// Writes the latency histograms of the frame pipeline to the console.
 /// </summary>
-void CALLBACK UIElement::TimerCallback(HWND hWnd, UINT msg, UINT_PTR timerId, DWORD time) noexcept
+void UIElement::DumpFrameStatistics() const noexcept
 {
-    ((UIElement *) timerId)->OnTimer();
+    try
+    {
+        const auto s = _FrameScheduler.GetStatistics();
+
+        const auto & p = _PlaylistEvents.GetStatistics();
+        const auto & b = _EventBus.GetStatistics();
+
+        console::printf(STR_COMPONENT_BASENAME " frame statistics: %.3f Hz, %llu frames, %llu missed\n%s\nplaylist events: %llu received, %llu merged, %llu batches, %llu pages\nevents: %llu posted, %llu sent, %llu dropped, %llu merged, %llu in flight (max. %llu)", s.FrameRate, s.FrameCount, s.MissedFrameCount, _FrameRecorder.ToString().c_str(), p.EventCount, p.MergedCount, p.BatchCount, p.PageCount,
+            b.PostedCount, b.SentCount, b.DroppedCount, b.MergedCount, _EventBus.GetInFlightCount(), b.MaxInFlightCount);
+    }
+    catch (const std::exception & e)
+    {
+        console::printf(STR_COMPONENT_BASENAME " failed to dump frame statistics: %s", e.what());
+    }
 }
 
 /// <summary>
-/// Handles a timer tick.
+/// Handles a timer tick. Runs on a thread pool thread. Counts the heap allocations of the frame; there should be none once the pools fit the frames.
 /// </summary>
 void UIElement::OnTimer() noexcept
 {
-    if (_IsFrozen || _IsHidden || ::IsIconic(core_api::get_main_window()) || (_WebView == nullptr) || !_IsNavigationCompleted)
+    const uint64_t AllocationCount = AllocationCounter::Get();
+
+    RenderFrame();
+
+    _FrameRecorder.Increment(FrameEvent::Allocation, AllocationCounter::Get() - AllocationCount);
+}
+
+/// <summary>
+/// Renders a frame: fetches and converts the chunk and only marshals the script notification to the UI thread.
+/// </summary>
+void UIElement::RenderFrame() noexcept
+{
+    const uint64_t TickTime = FrameRecorder::Now();
+
+    _FrameRecorder.Tick(TickTime);
+
+    // The audio after a seek does not continue the stream the meters and the onset detector have seen, even when the seek is shorter than MaxMeterGap.
+    if (_IsSeekPending.exchange(false))
+    {
+        _NextWindow = -1;
+        _MeterTime = 0.;
+    }
+
+    if (_IsFrozen || _IsHidden || ::IsIconic(core_api::get_main_window()) || !_IsNavigationCompleted)
+    {
+        _FrameRecorder.Increment(FrameEvent::SkippedTick);
+
         return;
+    }
+
+    FrameProducer & Producer = _UIElementTracker.GetFrameProducer();
 
     double PlaybackTime; // in seconds
 
-    if (!_VisualisationStream.is_valid() || !_VisualisationStream->get_absolute_time(PlaybackTime) || (PlaybackTime == _LastPlaybackTime))
+    if (!Producer.GetAbsoluteTime(PlaybackTime) || (PlaybackTime == _LastPlaybackTime))
+    {
+        // Playback is paused or stalled. Let the visualisation come to rest with a silent frame.
+        if (UpdateIdleState(TickTime, true))
+            PostIdleFrame(_LastPlaybackTime);
+
+        _FrameRecorder.Increment(FrameEvent::SkippedTick);
+
         return;
+    }
 
     _LastPlaybackTime = PlaybackTime;
 
-    audio_chunk_impl Chunk;
+    if (_Configuration._LoudnessEnabled || _Configuration._LevelsEnabled || _Configuration._OnsetsEnabled)
+        UpdateMeters(PlaybackTime);
 
     const double WindowSize = _Configuration._WindowSize / ((_Configuration._WindowSizeUnit == WindowSizeUnit::Milliseconds) ? 1000. : (double) _SampleRate); // in seconds
     const double WindoOffset = PlaybackTime - (WindowSize * (0.5 + _Configuration._ReactionAlignment)); // in seconds
 
-    if (!_VisualisationStream->get_chunk_absolute(Chunk, WindoOffset, WindowSize))
+    const uint32_t SampleRate = _SampleRate;
+
+    // Fetch all windows that started since the previous frame as one contiguous span when the windows overlap.
+    window_batch_t Batch = { };
+
+    double ChunkOffset = WindoOffset;   // in seconds
+    double ChunkSize   = WindowSize;    // in seconds
+
+    if (_Configuration._WindowHop != 0)
+    {
+        const double HopSize = _Configuration._WindowHop / ((_Configuration._WindowSizeUnit == WindowSizeUnit::Milliseconds) ? 1000. : (double) SampleRate); // in seconds
+
+        if (!GetWindowBatch(WindoOffset, WindowSize, HopSize, SampleRate, Batch))
+        {
+            _FrameRecorder.Increment(FrameEvent::SkippedTick);
+
+            return;
+        }
+
+        ChunkOffset = Batch.StartTime;
+        ChunkSize   = (((Batch.WindowCount - 1.) * Batch.HopSize) + Batch.WindowSize) / (double) SampleRate;
+    }
+
+    bool IsShared;
+
+    if (!Producer.GetChunk(this, PlaybackTime, ChunkOffset, ChunkSize, _FrameChunk, IsShared))
+    {
+        _FrameRecorder.Increment(FrameEvent::SkippedTick);
+
         return;
+    }
 
-    const audio_sample * Samples = Chunk.get_data();
-    size_t SampleCount = Chunk.get_sample_count();
-    _SampleRate = Chunk.get_sample_rate();
-    uint32_t ChannelCount = Chunk.get_channel_count();
-    uint32_t ChannelConfig = Chunk.get_channel_config();
+    if (IsShared)
+        _FrameRecorder.Increment(FrameEvent::SharedChunk);
 
-    HRESULT hr = PostChunk(Samples, SampleCount, _SampleRate, ChannelCount, ChannelConfig);
+    _FrameRecorder.Record(FrameStage::ChunkFetch, FrameRecorder::Now() - TickTime);
+
+    const audio_sample * Samples = _FrameChunk.get_data();
+    size_t SampleCount = _FrameChunk.get_sample_count();
+    _SampleRate = _FrameChunk.get_sample_rate();
+    uint32_t ChannelCount = _FrameChunk.get_channel_count();
+    uint32_t ChannelConfig = _FrameChunk.get_channel_config();
+
+    // Stop delivering frames while the signal is silent, after one final silent frame.
+    if (_Configuration._SilenceDelay != 0)
+    {
+        const bool IsSilentChunk = IsSilent(Samples, SampleCount * ChannelCount, std::pow(10., _Configuration._SilenceThreshold / 20.));
+
+        if (UpdateIdleState(TickTime, IsSilentChunk))
+        {
+            _LastPlaybackTime = PlaybackTime;
+
+            PostIdleFrame(PlaybackTime);
+
+            return;
+        }
+
+        if (_IsIdle)
+        {
+            _NextWindow = -1; // Start a new sequence of windows when the signal returns.
+
+            _FrameRecorder.Increment(FrameEvent::SuppressedFrame);
+
+            return;
+        }
+    }
+
+    if (_Configuration._WindowHop != 0)
+    {
+        // The window positions are only valid for the sample rate they were calculated with.
+        if (_SampleRate != SampleRate)
+        {
+            _NextWindow = -1;
+
+            _FrameRecorder.Increment(FrameEvent::SkippedTick);
+
+            return;
+        }
+
+        // The span can be shorter than requested f.e. at the end of the track. Only deliver the windows that are complete.
+        if (SampleCount < (size_t) Batch.WindowSize)
+        {
+            _FrameRecorder.Increment(FrameEvent::SkippedTick);
+
+            return;
+        }
+
+        Batch.WindowCount = std::min(Batch.WindowCount, std::floor((double) (SampleCount - (size_t) Batch.WindowSize) / Batch.HopSize) + 1.);
+
+        SampleCount = (size_t) (((Batch.WindowCount - 1.) * Batch.HopSize) + Batch.WindowSize);
+    }
+
+    HRESULT hr = PostChunk(Samples, SampleCount, _SampleRate, ChannelCount, ChannelConfig, PlaybackTime, (_Configuration._WindowHop != 0) ? &Batch : nullptr);
+
+    if (hr != S_OK)
+    {
+        _FrameRecorder.Increment(FrameEvent::DroppedFrame);
 
-    if (!SUCCEEDED(hr))
         return;
+    }
 
-    hr = _WebView->ExecuteScript(::FormatText(L"onTimer(%d, %d, %d, %d)", SampleCount, _SampleRate, ChannelCount, ChannelConfig).c_str(), nullptr); // Silently continue
+    if (_Configuration._WindowHop != 0)
+    {
+        _NextWindow   += (int64_t) Batch.WindowCount * (int64_t) Batch.HopSize;
+        _WindowNumber += (uint64_t) Batch.WindowCount;
+    }
 
-    if (!SUCCEEDED(hr))
+    PostFrameNotification();
+}
+
+/// <summary>
+/// Notifies the UI thread that a new frame is available in the shared buffer.
+/// </summary>
+void UIElement::PostFrameNotification() noexcept
+{
+    // Scripts can also poll the frame header in the shared buffer f.e. from requestAnimationFrame().
+    if (!_Configuration._CallOnTimer)
+        return;
+
+    // Post at most one notification at a time so the message queue doesn't fill up when the UI thread is busy.
+    _FrameReadyTime = FrameRecorder::Now();
+
+    if (!_IsFrameNotificationPending.exchange(true))
+        PostMessage(UM_FRAME_READY);
+    else
+        _FrameRecorder.Increment(FrameEvent::CoalescedNotification);
+}
+
+/// <summary>
+/// Tracks how long the signal has been silent or playback has been paused. Returns true when the panel becomes idle and the final silent frame has to be sent.
+/// </summary>
+bool UIElement::UpdateIdleState(uint64_t tickTime, bool isSilent) noexcept
+{
+    if (!isSilent || (_Configuration._SilenceDelay == 0))
     {
-        console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to call onTimer()").c_str());
+        _SilenceStart = 0;
+        _IsIdle = false;
+
+        return false;
+    }
+
+    if (_SilenceStart == 0)
+        _SilenceStart = tickTime;
+
+    if (_IsIdle || ((tickTime - _SilenceStart) < (uint64_t) _Configuration._SilenceDelay * 1000))
+        return false;
+
+    _IsIdle = true;
 
+    return true;
+}
+
+/// <summary>
+/// Writes a silent frame in the format of the previous frame so the visualisation comes to rest before the frames are suppressed.
+/// </summary>
+void UIElement::PostIdleFrame(double playbackTime) noexcept
+{
+    size_t SampleCount = _FrameChunk.get_sample_count();
+    const uint32_t ChannelCount = _FrameChunk.get_channel_count();
+
+    if ((SampleCount == 0) || (ChannelCount == 0))
+        return;
+
+    window_batch_t Batch = { };
+
+    if (_Configuration._WindowHop != 0)
+    {
+        // Send the silent frame as a single window that starts a new sequence.
+        if ((_WindowSamples <= 0) || (SampleCount < (size_t) _WindowSamples))
+            return;
+
+        SampleCount = (size_t) _WindowSamples;
+
+        Batch = { (double) _WindowNumber, 1., (double) _WindowSamples, (double) _HopSamples, playbackTime, window_batch_t::Discontinuity };
+
+        _NextWindow = -1;
+    }
+
+    std::fill_n(_FrameChunk.get_data(), SampleCount * ChannelCount, (audio_sample) 0.);
+
+    HRESULT hr = PostChunk(_FrameChunk.get_data(), SampleCount, _FrameChunk.get_sample_rate(), ChannelCount, _FrameChunk.get_channel_config(), playbackTime, (_Configuration._WindowHop != 0) ? &Batch : nullptr);
+
+    if (hr != S_OK)
+    {
+        _FrameRecorder.Increment(FrameEvent::DroppedFrame);
+
+        return;
+    }
+
+    PostFrameNotification();
+}
+
+/// <summary>
+/// Determines the overlapping windows that started since the previous frame, up to and including the current window. Returns false if no new window started yet.
+/// The window positions are kept in samples so consecutive batches line up exactly.
+/// </summary>
+bool UIElement::GetWindowBatch(double windowOffset, double windowSize, double hopSize, uint32_t sampleRate, window_batch_t & batch) noexcept
+{
+    const int64_t WindowSamples = std::max<int64_t>(std::llround(windowSize * (double) sampleRate), 1);
+    const int64_t HopSamples    = std::max<int64_t>(std::llround(hopSize    * (double) sampleRate), 1);
+    const int64_t Target        = std::llround(windowOffset * (double) sampleRate); // First sample of the current window
+
+    // Start a new sequence after a seek, a gap in playback or a change of the window layout.
+    bool IsDiscontinuous = (_NextWindow < 0) || (WindowSamples != _WindowSamples) || (HopSamples != _HopSamples) || (Target < _NextWindow - HopSamples) || (((Target - _NextWindow) / HopSamples) >= MaxWindowCount);
+
+    if (IsDiscontinuous)
+    {
+        _NextWindow    = std::max<int64_t>(Target, 0);
+        _WindowSamples = WindowSamples;
+        _HopSamples    = HopSamples;
+    }
+    else
+    if (Target < _NextWindow)
+        return false;
+
+    const int64_t WindowCount = (IsDiscontinuous ? 0 : (Target - _NextWindow) / HopSamples) + 1;
+
+    batch.FirstWindow = (double) _WindowNumber;
+    batch.WindowCount = (double) WindowCount;
+    batch.WindowSize  = (double) WindowSamples;
+    batch.HopSize     = (double) HopSamples;
+    batch.StartTime   = (double) _NextWindow / (double) sampleRate;
+    batch.Flags       = IsDiscontinuous ? window_batch_t::Discontinuity : 0.;
+
+    return true;
+}
+
+/// <summary>
+/// Notifies the script that a new frame is available. The notification is dropped when the script is behind. Runs on the UI thread.
+/// </summary>
+LRESULT UIElement::OnFrameReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    const uint64_t AllocationCount = AllocationCounter::Get();
+
+    _IsFrameNotificationPending = false;
+
+    if ((_WebView == nullptr) || !_FrameScheduler.IsRunning())
+        return 0;
+
+    frame_info_t FrameInfo;
+
+    {
+        std::lock_guard<std::mutex> Lock(_FrameLock);
+
+        FrameInfo = _FrameInfo;
+    }
+
+    // Format the event in a buffer of the panel instead of a temporary string.
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"SampleCount\":%d,\"SampleRate\":%d,\"ChannelCount\":%d,\"ChannelConfig\":%d}", (int) FrameInfo.SampleCount, (int) FrameInfo.SampleRate, (int) FrameInfo.ChannelCount, (int) FrameInfo.ChannelConfig);
+
+    const bool Success = PostEvent(ScriptEvent::Frame, _ScriptBuffer);
+
+    _FrameRecorder.Record(FrameStage::ScriptDispatch, FrameRecorder::Now() - _FrameReadyTime);
+    _FrameRecorder.Increment(FrameEvent::Allocation, AllocationCounter::Get() - AllocationCount);
+
+    if (!Success)
         StopTimer();
+
+    return 0;
+}
+
+/// <summary>
+/// Posts the pending onsets and beats to the script as a single event. Runs on the UI thread.
+/// </summary>
+LRESULT UIElement::OnOnsets(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    _IsOnsetNotificationPending = false;
+
+    // Swap the lists instead of moving the pending events so both keep their storage.
+    _PostedOnsets.clear();
+
+    {
+        std::lock_guard<std::mutex> Lock(_OnsetLock);
+
+        _PostedOnsets.swap(_PendingOnsets);
     }
+
+    if ((_WebView == nullptr) || !_IsNavigationCompleted || _PostedOnsets.empty())
+        return 0;
+
+    _OnsetMessage = L"{\"Events\":[";
+
+    for (const auto & Onset : _PostedOnsets)
+    {
+        ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"%s{\"Type\":\"%s\",\"Time\":%f,\"Strength\":%.3f,\"Confidence\":%.3f,\"Tempo\":%.2f}",
+            (&Onset != _PostedOnsets.data()) ? L"," : L"", (Onset.Type == OnsetType::Beat) ? L"Beat" : L"Onset", Onset.Time, (double) Onset.Strength, (double) Onset.Confidence, (double) Onset.Tempo);
+
+        _OnsetMessage += _ScriptBuffer;
+    }
+
+    _OnsetMessage += L"]}";
+
+    PostEvent(ScriptEvent::Onsets, _OnsetMessage.c_str());
+
+    return 0;
 }
 
 /// <summary>
-/// Posts a chunk to the script via a shared buffer.
+/// Initializes the spectrum and stereo analyzers for the specified format of the chunks. Runs on the frame scheduler thread when the format changes, or on the UI thread while the scheduler is stopped when the configuration changes.
 /// </summary>
-HRESULT UIElement::PostChunk(const audio_sample * samples, size_t sampleCount, uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig) noexcept
+void UIElement::InitializeAnalyzers(uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig) noexcept
 {
-    HRESULT hr = _SharedBuffer.Ensure(_Environment, _WebView, sampleCount, sampleRate, channelCount, channelConfig);
+    _AnalyzerFormat.SampleRate    = sampleRate;
+    _AnalyzerFormat.ChannelCount  = channelCount;
+    _AnalyzerFormat.ChannelConfig = channelConfig;
+
+    if (_Configuration._SpectrumEnabled)
+    {
+        try
+        {
+            _SpectrumAnalyzer.Initialize(_Configuration.GetSpectrumSettings(), sampleRate);
+        }
+        catch (const std::exception & e)
+        {
+            console::printf(STR_COMPONENT_BASENAME " failed to initialize spectrum analyzer: %s", e.what());
+        }
+    }
+
+    if (_Configuration._StereoEnabled && (channelCount <= StereoAnalyzer::MaxChannels))
+    {
+        double Left[StereoAnalyzer::MaxChannels];
+        double Right[StereoAnalyzer::MaxChannels];
+
+        GetStereoWeights(_Configuration._StereoMapping, channelConfig, channelCount, Left, Right);
+
+        _StereoAnalyzer.Initialize(Left, Right, channelCount);
+    }
+}
+
+/// <summary>
+/// Writes a chunk to the shared buffer. Returns S_FALSE if the frame was dropped because the buffer is being (re)allocated on the UI thread.
+/// </summary>
+HRESULT UIElement::PostChunk(const audio_sample * samples, size_t sampleCount, uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig, double playbackTime, const window_batch_t * batch) noexcept
+{
+    // The analyses use the most recent window of a batch. The samples section contains the complete span.
+    const audio_sample * Window = samples;
+    size_t WindowSampleCount = sampleCount;
+
+    if (batch != nullptr)
+    {
+        Window = samples + ((size_t) (batch->WindowCount - 1.) * (size_t) batch->HopSize * channelCount);
+        WindowSampleCount = (size_t) batch->WindowSize;
+    }
+
+    frame_layout_t Layout = { };
+
+    Layout.SampleCount   = sampleCount;
+    Layout.SampleRate    = sampleRate;
+    Layout.ChannelCount  = channelCount;
+    Layout.ChannelConfig = channelConfig;
+    Layout.HasSamples    = !_Configuration._EnvelopeEnabled && !_Configuration._LevelsEnabled; // The envelope and the levels replace the samples.
+    Layout.Format        = _Configuration._SampleFormat;
+
+    // The analyzers are only set up again when the format of the chunks changes f.e. after a track change. Configuration changes are applied by SetConfiguration().
+    if ((sampleRate != _AnalyzerFormat.SampleRate) || (channelCount != _AnalyzerFormat.ChannelCount) || (channelConfig != _AnalyzerFormat.ChannelConfig))
+        InitializeAnalyzers(sampleRate, channelCount, channelConfig);
+
+    if (_Configuration._SpectrumEnabled)
+        Layout.BandCount = (uint32_t) _SpectrumAnalyzer.GetBandCount();
+
+    if (_Configuration._EnvelopeEnabled)
+        Layout.BucketCount = GetEnvelopeBucketCount();
+
+    Layout.HasLoudness = _Configuration._LoudnessEnabled;
+    Layout.HasLevels   = _Configuration._LevelsEnabled;
+
+    if (_Configuration._StereoEnabled && (channelCount <= StereoAnalyzer::MaxChannels))
+    {
+        Layout.HasStereo        = true;
+        Layout.StereoPointCount = _Configuration._StereoPointCount;
+    }
+
+    Layout.HasWindows = (batch != nullptr);
+
+    std::lock_guard<std::mutex> Lock(_FrameLock);
+
+    if (!_SharedBuffer.Update(Layout))
+    {
+        // Creating and posting a shared buffer requires the UI thread. Drop the frame in the mean time.
+        if (!_IsBufferRequestPending.exchange(true))
+            RunAsync([this, Layout]() { EnsureSharedBuffer(Layout); });
+
+        return S_FALSE;
+    }
+
+    const uint64_t StartTime = FrameRecorder::Now();
+
+    _SharedBuffer.BeginFrame();
+
+    if (Layout.HasSamples)
+        _SharedBuffer.WriteSamples(samples, sampleCount);
+
+    if (Layout.BandCount != 0)
+    {
+        PostSpectrum(Window, WindowSampleCount, channelCount);
+
+        if (_Configuration._SpectrogramBudget != 0)
+            PostSpectrogram(sampleRate, channelCount, playbackTime);
+    }
+
+    if (Layout.BucketCount != 0)
+        _SharedBuffer.WriteEnvelope(Window, WindowSampleCount);
+
+    if (Layout.HasLoudness)
+        _SharedBuffer.WriteLoudness(_LoudnessMeter.GetValues());
+
+    if (Layout.HasLevels)
+        _SharedBuffer.WriteLevels(_LevelMeter);
+
+    if (Layout.HasStereo)
+        _SharedBuffer.WriteStereo(_StereoAnalyzer, Window, WindowSampleCount);
+
+    if (Layout.HasWindows)
+        _SharedBuffer.WriteWindows(*batch);
+
+    _SharedBuffer.WritePlayback(_PlaybackState);
+
+    _SharedBuffer.EndFrame(playbackTime);
+
+    _FrameInfo = { sampleCount, sampleRate, channelCount, channelConfig };
+
+    _FrameRecorder.Record(FrameStage::Conversion, FrameRecorder::Now() - StartTime);
+
+    return S_OK;
+}
+
+/// <summary>
+/// (Re)allocates the shared buffer for the specified layout. Runs on the UI thread.
+/// </summary>
+void UIElement::EnsureSharedBuffer(const frame_layout_t & layout) noexcept
+{
+    _IsBufferRequestPending = false;
+
+    if ((_Environment == nullptr) || (_WebView == nullptr))
+        return;
+
+    std::lock_guard<std::mutex> Lock(_FrameLock);
+
+    const uint64_t ReallocationCount = _SharedBuffer.GetReallocationCount();
+
+    HRESULT hr = _SharedBuffer.Ensure(_Environment, _WebView, layout);
 
     if (SUCCEEDED(hr))
-        if (audio_sample_size == 64)
-            _SharedBuffer.Copy((const BYTE *) samples, sizeof(audio_sample) * sampleCount * channelCount);
+        _SharedBuffer.UpdatePlayback(_PlaybackState);
+    else
+        console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to allocate shared buffer").c_str());
+
+    _FrameRecorder.Increment(FrameEvent::Reallocation, _SharedBuffer.GetReallocationCount() - ReallocationCount);
+}
+
+/// <summary>
+/// Gets the current state of the player with the current playback position. Runs on the UI thread.
+/// </summary>
+playback_state_t UIElement::GetPlaybackState() const noexcept
+{
+    playback_state_t State = _PlaybackState;
+
+    State.Position = playback_control::get()->playback_get_position();
+
+    return State;
+}
+
+/// <summary>
+/// Publishes the state of the player and anchors the playback clock at the position of the state, also when no frames are being written. Runs on the UI thread.
+/// </summary>
+void UIElement::PostPlaybackState(const playback_state_t & state) noexcept
+{
+    {
+        std::lock_guard<std::mutex> Lock(_FrameLock);
+
+        _PlaybackState = state;
+
+        _PlaybackState.Timestamp = ::GetTimestamp();
+        _PlaybackState.Rate      = (state.Flags & playback_state_t::Playing) ? 1.f : 0.f; // foobar2000 always plays at the nominal rate.
+
+        _SharedBuffer.UpdatePlayback(_PlaybackState);
+    }
+
+    PostPlaybackClock();
+}
+
+/// <summary>
+/// Posts the playback clock anchor to the script as an event so scripts can compute the playback position locally instead of polling the host object. Runs on the UI thread.
+/// </summary>
+void UIElement::PostPlaybackClock() noexcept
+{
+    if ((_WebView == nullptr) || !_IsNavigationCompleted)
+        return;
+
+    const auto & State = _PlaybackState;
+
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"Position\":%f,\"Timestamp\":%f,\"Rate\":%f,\"Length\":%f,\"Volume\":%f,\"IsPlaying\":%s,\"IsPaused\":%s}",
+        State.Position, State.Timestamp, (double) State.Rate, State.Length, (double) State.Volume,
+        ((State.Flags & playback_state_t::Playing) ? L"true" : L"false"), ((State.Flags & playback_state_t::Paused) ? L"true" : L"false"));
+
+    PostEvent(ScriptEvent::PlaybackClock, _ScriptBuffer);
+}
+
+/// <summary>
+/// (Re)allocates the spectrogram buffer for the specified layout. Runs on the UI thread.
+/// </summary>
+void UIElement::EnsureSpectrogramBuffer(const spectrogram_layout_t & layout) noexcept
+{
+    _IsSpectrogramRequestPending = false;
+
+    if ((_Environment == nullptr) || (_WebView == nullptr))
+        return;
+
+    std::lock_guard<std::mutex> Lock(_FrameLock);
+
+    HRESULT hr = _SpectrogramBuffer.Ensure(_Environment, _WebView, layout);
+
+    if (!SUCCEEDED(hr))
+        console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to allocate spectrogram buffer").c_str());
+}
+
+/// <summary>
+/// Writes the spectrum of the chunk to the shared buffer.
+/// </summary>
+void UIElement::PostSpectrum(const audio_sample * samples, size_t sampleCount, uint32_t channelCount) noexcept
+{
+    auto * Frequencies = (float *) _SharedBuffer.GetSection(FrameSection::Frequencies);
+    auto * Spectrum    = (float *) _SharedBuffer.GetSection(FrameSection::Spectrum);
+
+    if ((Frequencies == nullptr) || (Spectrum == nullptr))
+        return;
+
+    // The band layout can change without a reallocation of the buffer so the frequencies are rewritten with every frame.
+    for (size_t i = 0; i < _SpectrumAnalyzer.GetBandCount(); ++i)
+        Frequencies[i] = (float) _SpectrumAnalyzer.GetCenterFrequency(i);
+
+    _SpectrumAnalyzer.Process(samples, sampleCount, channelCount, Spectrum);
+
+    _SharedBuffer.SetSectionFlags(FrameSection::Spectrum, (_SpectrumAnalyzer.GetSettings().Scale == AmplitudeScale::Decibel) ? frame_section_t::Decibel : 0);
+}
+
+/// <summary>
+/// Adds the spectrum of the frame to the spectrogram ring. The ring is sized to fit the memory budget in the configuration.
+/// </summary>
+void UIElement::PostSpectrogram(uint32_t sampleRate, uint32_t channelCount, double playbackTime) noexcept
+{
+    const spectrogram_layout_t Layout = { (uint32_t) _SpectrumAnalyzer.GetBandCount(), channelCount, sampleRate, (size_t) _Configuration._SpectrogramBudget << 20 };
+
+    if (!_SpectrogramBuffer.Update(Layout))
+    {
+        // Creating and posting a shared buffer requires the UI thread. Skip the row in the mean time.
+        if ((SpectrogramRing::GetRowCount(Layout) >= SpectrogramRing::MinRowCount) && !_IsSpectrogramRequestPending.exchange(true))
+            RunAsync([this, Layout]() { EnsureSpectrogramBuffer(Layout); });
+
+        return;
+    }
+
+    const auto * Frequencies = (const float *) _SharedBuffer.GetSection(FrameSection::Frequencies);
+    const auto * Spectrum    = (const float *) _SharedBuffer.GetSection(FrameSection::Spectrum);
+
+    if ((Frequencies == nullptr) || (Spectrum == nullptr))
+        return;
+
+    _SpectrogramBuffer.WriteRow(Frequencies, Spectrum, (_SpectrumAnalyzer.GetSettings().Scale == AmplitudeScale::Decibel) ? frame_section_t::Decibel : 0, playbackTime);
+}
+
+/// <summary>
+/// Feeds the samples played since the previous frame to the loudness and level meters and the onset detector. Unlike the window of the frame, the meters need every sample exactly once so they keep their own position in the stream.
+/// </summary>
+void UIElement::UpdateMeters(double playbackTime) noexcept
+{
+    // Restart at the current position after a gap f.e. when the panel was hidden or at the start of playback.
+    if ((_MeterTime <= 0.) || (playbackTime < _MeterTime) || (playbackTime - _MeterTime > MaxMeterGap))
+    {
+        _MeterTime = playbackTime;
+        _OnsetTime = -1.;
+
+        return;
+    }
+
+    if (!_UIElementTracker.GetFrameProducer().GetChunkAbsolute(_MeterTime, playbackTime - _MeterTime, _MeterChunk))
+        return;
+
+    const uint32_t SampleRate    = _MeterChunk.get_sample_rate();
+    const uint32_t ChannelCount  = _MeterChunk.get_channel_count();
+    const uint32_t ChannelConfig = _MeterChunk.get_channel_config();
+    const size_t SampleCount     = _MeterChunk.get_sample_count();
+
+    if ((SampleRate == 0) || (SampleCount == 0) || (ChannelCount > LoudnessMeter::MaxChannels) || (ChannelCount > LevelMeter::MaxChannels) || (ChannelCount > OnsetDetector::MaxChannels))
+        return;
+
+    if (_Configuration._LoudnessEnabled)
+    {
+        double Weights[LoudnessMeter::MaxChannels];
+
+        GetLoudnessWeights(ChannelConfig, ChannelCount, Weights);
+
+        try
+        {
+            if (!_LoudnessMeter.IsInitialized(SampleRate, ChannelCount, Weights))
+                _LoudnessMeter.Initialize(SampleRate, ChannelCount, Weights);
+
+            _LoudnessMeter.Process(_MeterChunk.get_data(), SampleCount);
+        }
+        catch (const std::exception & e)
+        {
+            console::printf(STR_COMPONENT_BASENAME " failed to initialize loudness meter: %s", e.what());
+        }
+    }
+
+    if (_Configuration._LevelsEnabled)
+    {
+        _LevelMeter.Initialize(_Configuration.GetLevelMeterSettings(), SampleRate, ChannelCount);
+
+        _LevelMeter.Process(_MeterChunk.get_data(), SampleCount);
+    }
+
+    if (_Configuration._OnsetsEnabled)
+    {
+        try
+        {
+            // Restart the detection after a gap or a format change. The positions of the events are relative to the restart.
+            if (!_OnsetDetector.IsInitialized(SampleRate, ChannelCount))
+            {
+                _OnsetDetector.Initialize(SampleRate, ChannelCount);
+                _OnsetTime = _MeterTime;
+            }
+            else
+            if (_OnsetTime < 0.)
+            {
+                _OnsetDetector.Reset();
+                _OnsetTime = _MeterTime;
+            }
+
+            _OnsetEvents.clear();
+
+            _OnsetDetector.Process(_MeterChunk.get_data(), SampleCount, _OnsetEvents);
+
+            if (!_OnsetEvents.empty())
+                PostOnsets(SampleRate);
+        }
+        catch (const std::exception & e)
+        {
+            console::printf(STR_COMPONENT_BASENAME " failed to detect onsets: %s", e.what());
+        }
+    }
+    else
+        _OnsetTime = -1.;
+
+    _MeterTime += (double) SampleCount / (double) SampleRate;
+}
+
+/// <summary>
+/// Queues the onsets and beats of the current chunk for the UI thread. Only one notification is posted at a time; the events are delivered in batches.
+/// </summary>
+void UIElement::PostOnsets(uint32_t sampleRate)
+{
+    {
+        std::lock_guard<std::mutex> Lock(_OnsetLock);
+
+        for (const auto & Event : _OnsetEvents)
+            _PendingOnsets.push_back({ Event.Type, _OnsetTime + ((double) Event.Position / (double) sampleRate), Event.Strength, Event.Confidence, Event.Tempo });
+
+        if (_PendingOnsets.size() > MaxPendingOnsets)
+            _PendingOnsets.erase(_PendingOnsets.begin(), _PendingOnsets.end() - MaxPendingOnsets);
+    }
+
+    if (!_IsOnsetNotificationPending.exchange(true))
+        PostMessage(UM_ONSETS);
+}
+
+/// <summary>
+/// Gets the weight of each channel in the left and right side of the stereo pair. Falls back to the first two channels when the channel layout does not contain the selected pair.
+/// </summary>
+static void GetStereoWeights(StereoMapping mapping, uint32_t channelConfig, uint32_t channelCount, double * left, double * right) noexcept
+{
+    std::fill_n(left,  channelCount, 0.);
+    std::fill_n(right, channelCount, 0.);
+
+    if (channelCount == 0)
+        return;
+
+    if (channelCount == 1)
+    {
+        left[0] = right[0] = 1.;
+
+        return;
+    }
+
+    if (mapping == StereoMapping::Downmix)
+    {
+        const uint32_t LeftChannels   = audio_chunk::channel_front_left  | audio_chunk::channel_back_left  | audio_chunk::channel_side_left  | audio_chunk::channel_front_center_left  | audio_chunk::channel_top_front_left  | audio_chunk::channel_top_back_left;
+        const uint32_t RightChannels  = audio_chunk::channel_front_right | audio_chunk::channel_back_right | audio_chunk::channel_side_right | audio_chunk::channel_front_center_right | audio_chunk::channel_top_front_right | audio_chunk::channel_top_back_right;
+        const uint32_t FrontChannels  = audio_chunk::channel_front_left  | audio_chunk::channel_front_right;
+
+        bool HasPair = false;
+
+        for (uint32_t i = 0; i < channelCount; ++i)
+        {
+            const uint32_t Channel = audio_chunk::g_extract_channel_flag(channelConfig, i);
+
+            if (Channel == audio_chunk::channel_lfe)
+                continue;
+
+            // ITU-R BS.775 downmix: the front channels at 0 dB, all other channels at -3 dB.
+            const double Weight = (Channel & FrontChannels) ? 1. : 0.7071;
+
+            if (Channel & LeftChannels)
+            {
+                left[i] = Weight;
+                HasPair = true;
+            }
+            else
+            if (Channel & RightChannels)
+            {
+                right[i] = Weight;
+                HasPair = true;
+            }
+            else
+                left[i] = right[i] = Weight;
+        }
+
+        if (HasPair)
+            return;
+
+        std::fill_n(left,  channelCount, 0.);
+        std::fill_n(right, channelCount, 0.);
+    }
+    else
+    {
+        uint32_t LeftFlag  = audio_chunk::channel_front_left;
+        uint32_t RightFlag = audio_chunk::channel_front_right;
+
+        if (mapping == StereoMapping::Back)
+        {
+            LeftFlag  = audio_chunk::channel_back_left;
+            RightFlag = audio_chunk::channel_back_right;
+        }
         else
-            _SharedBuffer.Convert((const float *) samples, sampleCount);
+        if (mapping == StereoMapping::Side)
+        {
+            LeftFlag  = audio_chunk::channel_side_left;
+            RightFlag = audio_chunk::channel_side_right;
+        }
 
-    return S_OK;
+        const int LeftIndex  = audio_chunk::g_find_channel_idx(channelConfig, LeftFlag);
+        const int RightIndex = audio_chunk::g_find_channel_idx(channelConfig, RightFlag);
+
+        if ((LeftIndex >= 0) && (RightIndex >= 0) && ((uint32_t) LeftIndex < channelCount) && ((uint32_t) RightIndex < channelCount))
+        {
+            left[LeftIndex]   = 1.;
+            right[RightIndex] = 1.;
+
+            return;
+        }
+    }
+
+    left[0]  = 1.;
+    right[1] = 1.;
+}
+
+/// <summary>
+/// Returns true if none of the samples exceeds the threshold.
+/// </summary>
+static bool IsSilent(const audio_sample * samples, size_t count, double threshold) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (std::abs((double) samples[i]) > threshold)
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Gets the number of envelope buckets per channel. A value set by the script takes precedence over the configuration. Uses the width of the panel, in pixels, when neither specifies one.
+/// Called by the frame scheduler on a thread pool thread.
+/// </summary>
+size_t UIElement::GetEnvelopeBucketCount() const noexcept
+{
+    size_t BucketCount = _HostObject->GetEnvelopeBucketCount();
+
+    if (BucketCount == 0)
+        BucketCount = _Configuration._EnvelopeBucketCount;
+
+    if (BucketCount == 0)
+        BucketCount = (size_t) std::max(_ClientWidth.load(), 1u);
+
+    return std::min(BucketCount, MaxEnvelopeBuckets);
+}
+
+/// <summary>
+/// Starts generating the waveform of the specified track in the background. Cancels the previous request, if any.
+/// </summary>
+void UIElement::RequestWaveform(const char * path, uint32_t subsongIndex) noexcept
+{
+    try
+    {
+        _WaveformGenerator.Start(m_hWnd, path, subsongIndex, WaveformBucketCount, GetCacheDirectoryPath("waveforms"));
+    }
+    catch (const std::exception & e)
+    {
+        console::printf(STR_COMPONENT_BASENAME " failed to request waveform: %s", e.what());
+    }
+}
+
+/// <summary>
+/// Posts a waveform to the script via a separate, read-only shared buffer. The buffer contains the min/max/RMS envelope of each bucket, channel by channel. Its arrival signals the completion of the request.
+/// </summary>
+void UIElement::PostWaveform(const waveform_result_t & result) noexcept
+{
+    if ((_Environment == nullptr) || (_WebView == nullptr) || !_IsNavigationCompleted)
+        return;
+
+    auto Environment12 = _Environment.try_query<ICoreWebView2Environment12>();
+    auto WebView17 = _WebView.try_query<ICoreWebView2_17>();
+
+    if ((Environment12 == nullptr) || (WebView17 == nullptr))
+        return;
+
+    const auto & Waveform = result.Waveform;
+
+    const UINT64 Size = Waveform.Envelopes.size() * sizeof(envelope_t);
+
+    wil::com_ptr<ICoreWebView2SharedBuffer> Buffer;
+
+    HRESULT hr = Environment12->CreateSharedBuffer(Size, &Buffer);
+
+    if (SUCCEEDED(hr))
+    {
+        BYTE * Data = nullptr;
+
+        hr = Buffer->get_Buffer(&Data);
+
+        if (SUCCEEDED(hr))
+        {
+            ::memcpy(Data, Waveform.Envelopes.data(), (size_t) Size);
+
+            const std::wstring AdditionalDataAsJson = ::FormatText(L"{\"Type\":\"Waveform\",\"Path\":\"%s\",\"SubsongIndex\":%u,\"ChannelCount\":%u,\"BucketCount\":%u,\"SampleRate\":%u,\"Duration\":%f,\"IsCached\":%s}",
+                ::UTF8ToWide(Stringify(result.Path)).c_str(), result.SubsongIndex, Waveform.ChannelCount, Waveform.BucketCount, Waveform.SampleRate, Waveform.Duration, (result.IsCached ? L"true" : L"false"));
+
+            hr = WebView17->PostSharedBufferToScript(Buffer.get(), COREWEBVIEW2_SHARED_BUFFER_ACCESS_READ_ONLY, AdditionalDataAsJson.c_str());
+        }
+    }
+
+    if (!SUCCEEDED(hr))
+        console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to post waveform").c_str());
+}
+
+/// <summary>
+/// Starts analyzing the specified track in the background. Returns the id of the request or -1 if the request could not be queued.
+/// </summary>
+int UIElement::AnalyzeTrack(const char * path, uint32_t subsongIndex, uint32_t features) noexcept
+{
+    try
+    {
+        const int Id = ++_AnalysisId;
+
+        _UIElementTracker.GetTrackAnalysisPool().Submit({ m_hWnd, (uint32_t) Id, path, subsongIndex, features, GetCacheDirectoryPath("analyses") });
+
+        return Id;
+    }
+    catch (const std::exception & e)
+    {
+        console::printf(STR_COMPONENT_BASENAME " failed to request track analysis: %s", e.what());
+
+        return -1;
+    }
+}
+
+/// <summary>
+/// Posts the result of a track analysis to the script as an event. Only the requested features are included; values that could not be determined are null.
+/// </summary>
+void UIElement::PostAnalysis(const analysis_result_t & result) noexcept
+{
+    if ((_WebView == nullptr) || !_IsNavigationCompleted)
+        return;
+
+    std::wstring Message = ::FormatText(L"{\"Id\":%u,\"Path\":\"%s\",\"SubsongIndex\":%u", result.Id, ::UTF8ToWide(Stringify(result.Path)).c_str(), result.SubsongIndex).c_str(); // FormatText() includes the terminating zero.
+
+    if (!result.ErrorMessage.empty())
+        Message += ::FormatText(L",\"Error\":\"%s\"}", ::UTF8ToWide(Stringify(result.ErrorMessage.c_str())).c_str()).c_str();
+    else
+    {
+        const auto & Analysis = result.Analysis;
+
+        Message += ::FormatText(L",\"IsCached\":%s,\"ChannelCount\":%u,\"SampleRate\":%u,\"Duration\":%f", (result.IsCached ? L"true" : L"false"), Analysis.ChannelCount, Analysis.SampleRate, Analysis.Duration).c_str();
+
+        const auto AddValue = [&Message](const wchar_t * name, double value)
+        {
+            Message += (std::isfinite(value) ? ::FormatText(L",\"%s\":%.2f", name, value) : ::FormatText(L",\"%s\":null", name)).c_str();
+        };
+
+        if (Analysis.Features & (uint32_t) TrackFeature::RMS)
+            AddValue(L"RMS", Analysis.RMS);
+
+        if (Analysis.Features & (uint32_t) TrackFeature::Peak)
+            AddValue(L"Peak", Analysis.Peak);
+
+        if (Analysis.Features & (uint32_t) TrackFeature::DynamicRange)
+            AddValue(L"DR", Analysis.DynamicRange);
+
+        if (Analysis.Features & (uint32_t) TrackFeature::Loudness)
+        {
+            AddValue(L"IntegratedLoudness", Analysis.IntegratedLoudness);
+            AddValue(L"LoudnessRange", Analysis.LoudnessRange);
+            AddValue(L"TruePeak", Analysis.TruePeak);
+        }
+
+        if (Analysis.Features & (uint32_t) TrackFeature::Silence)
+        {
+            AddValue(L"LeadingSilence", Analysis.LeadingSilence);
+            AddValue(L"TrailingSilence", Analysis.TrailingSilence);
+        }
+
+        Message += L"}";
+    }
+
+    PostEvent(ScriptEvent::Analysis, Message.c_str());
+}
+
+/// <summary>
+/// Gets the path of the specified cache directory in the profile folder.
+/// </summary>
+std::wstring UIElement::GetCacheDirectoryPath(const char * directoryName) const noexcept
+{
+    pfc::string8 Path = pfc::io::path::combine(core_api::get_profile_path(), STR_COMPONENT_BASENAME);
+
+    if (::_strnicmp(Path, "file://", 7) == 0)
+        Path = Path.subString(7);
+
+    Path = pfc::io::path::combine(Path, directoryName);
+
+    return ::UTF8ToWide(Path.c_str());
 }
@@ -1,5 +1,5 @@
 
-/** $VER: Resources.h (2024.12.15) P. Stuer **/
+/** $VER: Resources.h (2026.10.16) P. Stuer **/
 
 #pragma once
 
@@ -59,6 +59,10 @@
 #define UM_TEMPLATE_CHANGED     WM_USER + 100
 #define UM_WEB_VIEW_READY       WM_USER + 101
 #define UM_ASYNC                WM_USER + 102
+#define UM_WAVEFORM_READY       WM_USER + 103
+#define UM_FRAME_READY          WM_USER + 104
+#define UM_ONSETS               WM_USER + 105
+#define UM_ANALYSIS_READY       WM_USER + 106
 
 /** Configuration **/
 
@@ -78,11 +82,53 @@
 
 #define IDC_REACTION_ALIGNMENT              1030
 #define IDC_WINDOW_OFFSET                   1032
+#define IDC_WINDOW_HOP                      1034
+#define IDC_WINDOW_OVERLAP                  1036
 
 #define IDC_CLEAR_BROWSING_DATA             1040
 #define IDC_IN_PRIVATE_MODE                 1042
 #define IDC_SCROLLBAR_STYLE                 1044
 
+#define IDC_CALL_ON_TIMER                   1050
+
+#define IDC_SPECTRUM                        1060
+#define IDC_FFT_SIZE                        1062
+#define IDC_WINDOW_FUNCTION                 1064
+#define IDC_BAND_LAYOUT                     1066
+#define IDC_BAND_COUNT                      1068
+#define IDC_MIN_FREQUENCY                   1070
+#define IDC_MAX_FREQUENCY                   1072
+#define IDC_AMPLITUDE_SCALE                 1074
+
+#define IDC_SAMPLE_FORMAT                   1080
+
+#define IDC_ENVELOPE                        1090
+#define IDC_ENVELOPE_BUCKET_COUNT           1092
+
+#define IDC_WAVEFORM                        1100
+
+#define IDC_FRAME_RATE                      1110
+
+#define IDC_LOUDNESS                        1120
+
+#define IDC_LEVELS                          1130
+#define IDC_METER_ATTACK                    1132
+#define IDC_METER_RELEASE                   1134
+#define IDC_METER_HOLD                      1136
+
+#define IDC_SPECTROGRAM_BUDGET              1140
+
+#define IDC_STEREO                          1150
+#define IDC_STEREO_MAPPING                  1152
+#define IDC_STEREO_POINT_COUNT              1154
+
+#define IDC_ONSETS                          1160
+
+#define IDC_SILENCE_THRESHOLD               1170
+#define IDC_SILENCE_DELAY                   1172
+
+#define IDC_EVENT_LIMIT                     1180
+
 #define IDC_WARNING                         9999
 
 #define IDR_CONTEXT_MENU_ICON               2000
@@ -0,0 +1,375 @@
+
+/** $VER: SampleConverter.cpp (2026.10.16) P. Stuer - Converts interleaved samples to the export formats of the shared buffer. Host-independent. **/
+
+#include "SampleConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_KERNELS
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+InstructionSet SampleConverter::_InstructionSet = SampleConverter::DetectInstructionSet();
+
+#pragma region Scalar
+
+/// <summary>
+/// Converts a 32-bit floating point sample to a 16-bit signed integer sample.
+/// </summary>
+static inline int16_t ToInt16(float sample) noexcept
+{
+    return (int16_t) std::lrint(std::clamp(sample, -1.f, 1.f) * 32767.f);
+}
+
+template<typename T>
+static void ToFloat64Scalar(const T * samples, size_t count, double * data) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        data[i] = (double) samples[i];
+}
+
+template<typename T>
+static void ToFloat32Scalar(const T * samples, size_t count, float * data) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        data[i] = (float) samples[i];
+}
+
+template<typename T>
+static void ToInt16Scalar(const T * samples, size_t count, int16_t * data) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        data[i] = ToInt16((float) samples[i]);
+}
+
+template<typename T>
+static void DeinterleaveScalar(const T * samples, size_t sampleCount, uint32_t channelCount, size_t stride, float * data) noexcept
+{
+    for (uint32_t Channel = 0; Channel < channelCount; ++Channel)
+    {
+        const T * p = samples + Channel;
+        float * q = data + (Channel * stride);
+
+        for (size_t i = 0; i < sampleCount; ++i, p += channelCount)
+            *q++ = (float) *p;
+    }
+}
+
+#pragma endregion
+
+#ifdef HAS_X86_KERNELS
+
+#pragma region SSE2
+
+TARGET_SSE2
+static void ToFloat64SSE2(const float * samples, size_t count, double * data) noexcept
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 v = _mm_loadu_ps(samples + i);
+
+        _mm_storeu_pd(data + i,     _mm_cvtps_pd(v));
+        _mm_storeu_pd(data + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+
+    ToFloat64Scalar(samples + i, count - i, data + i);
+}
+
+TARGET_SSE2
+static void ToInt16SSE2(const float * samples, size_t count, int16_t * data) noexcept
+{
+    const __m128 Min   = _mm_set1_ps(-1.f);
+    const __m128 Max   = _mm_set1_ps( 1.f);
+    const __m128 Scale = _mm_set1_ps(32767.f);
+
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i),     Min), Max), Scale);
+        const __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i + 4), Min), Max), Scale);
+
+        _mm_storeu_si128((__m128i *) (data + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+
+    ToInt16Scalar(samples + i, count - i, data + i);
+}
+
+TARGET_SSE2
+static void DeinterleaveStereoSSE2(const float * samples, size_t sampleCount, float * l, float * r) noexcept
+{
+    size_t i = 0;
+
+    for (; i + 4 <= sampleCount; i += 4)
+    {
+        const __m128 a = _mm_loadu_ps(samples + (i * 2));
+        const __m128 b = _mm_loadu_ps(samples + (i * 2) + 4);
+
+        _mm_storeu_ps(l + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(r + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    for (; i < sampleCount; ++i)
+    {
+        l[i] = samples[(i * 2)];
+        r[i] = samples[(i * 2) + 1];
+    }
+}
+
+#pragma endregion
+
+#pragma region AVX2
+
+TARGET_AVX2
+static void ToFloat64AVX2(const float * samples, size_t count, double * data) noexcept
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_pd(data + i,     _mm256_cvtps_pd(_mm_loadu_ps(samples + i)));
+        _mm256_storeu_pd(data + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(samples + i + 4)));
+    }
+
+    ToFloat64Scalar(samples + i, count - i, data + i);
+}
+
+TARGET_AVX2
+static void ToInt16AVX2(const float * samples, size_t count, int16_t * data) noexcept
+{
+    const __m256 Min   = _mm256_set1_ps(-1.f);
+    const __m256 Max   = _mm256_set1_ps( 1.f);
+    const __m256 Scale = _mm256_set1_ps(32767.f);
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256 a = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(samples + i),     Min), Max), Scale);
+        const __m256 b = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(samples + i + 8), Min), Max), Scale);
+
+        // The pack operates on each 128-bit lane separately so the 64-bit quarters have to be put back in order.
+        const __m256i v = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+
+        _mm256_storeu_si256((__m256i *) (data + i), _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    ToInt16Scalar(samples + i, count - i, data + i);
+}
+
+TARGET_AVX2
+static void DeinterleaveStereoAVX2(const float * samples, size_t sampleCount, float * l, float * r) noexcept
+{
+    size_t i = 0;
+
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        const __m256 a = _mm256_loadu_ps(samples + (i * 2));
+        const __m256 b = _mm256_loadu_ps(samples + (i * 2) + 8);
+
+        // The shuffle operates on each 128-bit lane separately so the 64-bit quarters have to be put back in order.
+        const __m256 L = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 R = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+        _mm256_storeu_ps(l + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(L), _MM_SHUFFLE(3, 1, 2, 0))));
+        _mm256_storeu_ps(r + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(R), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+
+    DeinterleaveStereoSSE2(samples + (i * 2), sampleCount - i, l + i, r + i);
+}
+
+#pragma endregion
+
+#endif
+
+/// <summary>
+/// Converts 32-bit floating point samples to the specified format. Planar formats use the stride (in samples) as the distance between the channels.
+/// </summary>
+void SampleConverter::Convert(const float * samples, size_t sampleCount, uint32_t channelCount, SampleFormat format, size_t stride, void * data) noexcept
+{
+    const size_t Count = sampleCount * channelCount;
+
+    const InstructionSet Set = _InstructionSet;
+
+    switch (format)
+    {
+        case SampleFormat::Float64:
+        {
+        #ifdef HAS_X86_KERNELS
+            if (Set == InstructionSet::AVX2)
+                ToFloat64AVX2(samples, Count, (double *) data);
+            else if (Set == InstructionSet::SSE2)
+                ToFloat64SSE2(samples, Count, (double *) data);
+            else
+        #endif
+                ToFloat64Scalar(samples, Count, (double *) data);
+            break;
+        }
+
+        case SampleFormat::Float32:
+        {
+            ::memcpy(data, samples, sizeof(float) * Count);
+            break;
+        }
+
+        case SampleFormat::Float32Planar:
+        {
+            auto * p = (float *) data;
+
+        #ifdef HAS_X86_KERNELS
+            if ((channelCount == 2) && (Set == InstructionSet::AVX2))
+                DeinterleaveStereoAVX2(samples, sampleCount, p, p + stride);
+            else if ((channelCount == 2) && (Set == InstructionSet::SSE2))
+                DeinterleaveStereoSSE2(samples, sampleCount, p, p + stride);
+            else
+        #endif
+                DeinterleaveScalar(samples, sampleCount, channelCount, stride, p);
+            break;
+        }
+
+        case SampleFormat::Int16:
+        {
+        #ifdef HAS_X86_KERNELS
+            if (Set == InstructionSet::AVX2)
+                ToInt16AVX2(samples, Count, (int16_t *) data);
+            else if (Set == InstructionSet::SSE2)
+                ToInt16SSE2(samples, Count, (int16_t *) data);
+            else
+        #endif
+                ToInt16Scalar(samples, Count, (int16_t *) data);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/// <summary>
+/// Converts 64-bit floating point samples to the specified format. Planar formats use the stride (in samples) as the distance between the channels.
+/// </summary>
+void SampleConverter::Convert(const double * samples, size_t sampleCount, uint32_t channelCount, SampleFormat format, size_t stride, void * data) noexcept
+{
+    const size_t Count = sampleCount * channelCount;
+
+    switch (format)
+    {
+        case SampleFormat::Float64:
+        {
+            ::memcpy(data, samples, sizeof(double) * Count);
+            break;
+        }
+
+        case SampleFormat::Float32:
+        {
+            ToFloat32Scalar(samples, Count, (float *) data);
+            break;
+        }
+
+        case SampleFormat::Float32Planar:
+        {
+            DeinterleaveScalar(samples, sampleCount, channelCount, stride, (float *) data);
+            break;
+        }
+
+        case SampleFormat::Int16:
+        {
+            ToInt16Scalar(samples, Count, (int16_t *) data);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/// <summary>
+/// Gets the size of a sample in the specified format, in bytes.
+/// </summary>
+size_t SampleConverter::GetSampleSize(SampleFormat format) noexcept
+{
+    switch (format)
+    {
+        default:
+        case SampleFormat::Float64:       return sizeof(double);
+        case SampleFormat::Float32:       return sizeof(float);
+        case SampleFormat::Float32Planar: return sizeof(float);
+        case SampleFormat::Int16:         return sizeof(int16_t);
+    }
+}
+
+/// <summary>
+/// Gets the instruction set used by the conversion kernels.
+/// </summary>
+InstructionSet SampleConverter::GetInstructionSet() noexcept
+{
+    return _InstructionSet;
+}
+
+/// <summary>
+/// Forces the conversion kernels to use the specified instruction set f.e. to compare their performance. Instruction sets the CPU does not support are ignored.
+/// </summary>
+void SampleConverter::SetInstructionSet(InstructionSet instructionSet) noexcept
+{
+    _InstructionSet = std::min(instructionSet, DetectInstructionSet());
+}
+
+/// <summary>
+/// Detects the best instruction set supported by the CPU and the operating system.
+/// </summary>
+InstructionSet SampleConverter::DetectInstructionSet() noexcept
+{
+#if defined(HAS_X86_KERNELS) && defined(_MSC_VER)
+    int Registers[4];
+
+    ::__cpuid(Registers, 0);
+
+    const int MaxFunction = Registers[0];
+
+    ::__cpuid(Registers, 1);
+
+    const bool HasSSE2    = (Registers[3] & (1 << 26)) != 0;
+    const bool HasOSXSAVE = (Registers[2] & (1 << 27)) != 0;
+    const bool HasAVX     = (Registers[2] & (1 << 28)) != 0;
+
+    bool HasAVX2 = false;
+
+    if ((MaxFunction >= 7) && HasOSXSAVE && HasAVX && ((::_xgetbv(0) & 0x6) == 0x6)) // The OS saves the XMM and YMM registers.
+    {
+        ::__cpuidex(Registers, 7, 0);
+
+        HasAVX2 = (Registers[1] & (1 << 5)) != 0;
+    }
+
+    if (HasAVX2)
+        return InstructionSet::AVX2;
+
+    if (HasSSE2)
+        return InstructionSet::SSE2;
+#elif defined(HAS_X86_KERNELS)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return InstructionSet::AVX2;
+
+    if (__builtin_cpu_supports("sse2"))
+        return InstructionSet::SSE2;
+#endif
+
+    return InstructionSet::Scalar;
+}
@@ -0,0 +1,44 @@
+
+/** $VER: SampleConverter.h (2026.10.16) P. Stuer - Converts interleaved samples to the export formats of the shared buffer. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+enum class SampleFormat : uint32_t
+{
+    Float64 = 0,            // Interleaved 64-bit floating point
+    Float32,                // Interleaved 32-bit floating point
+    Float32Planar,          // 32-bit floating point, channel by channel
+    Int16,                  // Interleaved 16-bit signed integer
+
+    Count
+};
+
+enum class InstructionSet : uint32_t
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,
+};
+
+/// <summary>
+/// Converts interleaved samples to one of the export formats. Uses SSE2 or AVX2 kernels when the CPU supports them.
+/// </summary>
+class SampleConverter
+{
+public:
+    static void Convert(const float * samples, size_t sampleCount, uint32_t channelCount, SampleFormat format, size_t stride, void * data) noexcept;
+    static void Convert(const double * samples, size_t sampleCount, uint32_t channelCount, SampleFormat format, size_t stride, void * data) noexcept;
+
+    static size_t GetSampleSize(SampleFormat format) noexcept;
+
+    static InstructionSet GetInstructionSet() noexcept;
+    static void SetInstructionSet(InstructionSet instructionSet) noexcept;
+
+private:
+    static InstructionSet DetectInstructionSet() noexcept;
+
+    static InstructionSet _InstructionSet;
+};
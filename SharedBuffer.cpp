@@ -1,5 +1,5 @@
 
-/** $VER: SharedBuffer.cpp (2024.07.03) P. Stuer **/
+/** $VER: SharedBuffer.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -12,13 +12,16 @@
 using namespace Microsoft::WRL;
 
 /// <summary>
-/// Ensures that a buffer of the correct size is posted to the WebView.
+/// Ensures that a buffer large enough to hold the sections of the specified layout is posted to the WebView. Must be called on the UI thread.
 /// </summary>
-HRESULT SharedBuffer::Ensure(wil::com_ptr<ICoreWebView2Environment> & environment, wil::com_ptr<ICoreWebView2> & webView, size_t sampleCount, uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig) noexcept
+HRESULT SharedBuffer::Ensure(wil::com_ptr<ICoreWebView2Environment> & environment, wil::com_ptr<ICoreWebView2> & webView, const frame_layout_t & layout) noexcept
 {
-    if ((_Buffer != nullptr) && (_SampleCount == sampleCount) && (_SampleRate == sampleRate) && (_ChannelCount == channelCount) && (_ChannelConfig == channelConfig))
+    if (Update(layout))
         return S_OK;
 
+    const size_t Capacity       = std::max(GetCapacity(layout.SampleCount), _Capacity);
+    const size_t BucketCapacity = (layout.BucketCount != 0) ? std::max(GetBucketCapacity(layout.BucketCount), _BucketCapacity) : 0;
+
     Release();
 
     HRESULT hr = environment->QueryInterface(IID_PPV_ARGS(&_Environment12));
@@ -31,7 +34,45 @@ HRESULT SharedBuffer::Ensure(wil::com_ptr<ICoreWebView2Environment> & environmen
     if (_WebView17 == nullptr)
         return E_NOINTERFACE;
 
-    _Size = sizeof(double) * sampleCount * channelCount; // Don't use audio_sample.
+    // Lay out the sections. The section table follows the header, the sections follow the section table.
+    const size_t SamplesSize     = layout.HasSamples ? SampleConverter::GetSampleSize(layout.Format) * Capacity * layout.ChannelCount : 0;
+    const size_t FrequenciesSize = sizeof(float) * layout.BandCount;
+    const size_t SpectrumSize    = sizeof(float) * layout.BandCount * layout.ChannelCount;
+    const size_t EnvelopeSize    = sizeof(envelope_t) * BucketCapacity * layout.ChannelCount;
+    const size_t StereoSize      = sizeof(stereo_t) + (sizeof(stereo_point_t) * layout.StereoPointCount);
+
+    _Regions.Reset(sizeof(frame_header_t));
+
+    if (layout.HasSamples)
+        _Regions.Add((uint8_t) FrameSection::Samples, "Samples", (uint8_t) GetFrameFormat(layout.Format), (uint16_t) ((layout.Format == SampleFormat::Float32Planar) ? frame_section_t::Planar : 0), SamplesSize);
+
+    if (layout.BandCount != 0)
+    {
+        _Regions.Add((uint8_t) FrameSection::Frequencies, "Frequencies", (uint8_t) FrameFormat::Float32, 0, FrequenciesSize);
+        _Regions.Add((uint8_t) FrameSection::Spectrum,    "Spectrum",    (uint8_t) FrameFormat::Float32, 0, SpectrumSize);
+    }
+
+    if (BucketCapacity != 0)
+        _Regions.Add((uint8_t) FrameSection::Envelope, "Envelope", (uint8_t) FrameFormat::Float32, 0, EnvelopeSize);
+
+    if (layout.HasLoudness)
+        _Regions.Add((uint8_t) FrameSection::Loudness, "Loudness", (uint8_t) FrameFormat::Float32, 0, sizeof(loudness_t));
+
+    if (layout.HasLevels)
+        _Regions.Add((uint8_t) FrameSection::Levels, "Levels", (uint8_t) FrameFormat::Float32, 0, sizeof(level_t) * layout.ChannelCount);
+
+    if (layout.HasStereo)
+        _Regions.Add((uint8_t) FrameSection::Stereo, "Stereo", (uint8_t) FrameFormat::Float32, 0, StereoSize);
+
+    if (layout.HasWindows)
+        _Regions.Add((uint8_t) FrameSection::Windows, "Windows", (uint8_t) FrameFormat::Float64, 0, sizeof(window_batch_t));
+
+    _Regions.Add((uint8_t) FrameSection::Playback, "Playback", (uint8_t) FrameFormat::Float64, 0, sizeof(playback_state_t));
+
+    _Size = _Regions.Finish();
+
+    if (_Size == 0)
+        return E_OUTOFMEMORY;
 
     hr = _Environment12->CreateSharedBuffer(_Size, &_SharedBuffer);
 
@@ -43,31 +84,67 @@ HRESULT SharedBuffer::Ensure(wil::com_ptr<ICoreWebView2Environment> & environmen
     if (!SUCCEEDED(hr))
         return hr;
 
-    std::wstring AdditionalDataAsJson = ::FormatText(L"{\"SampleCount\":%d,\"SampleRate\":%d,\"ChannelCount\":%d,\"ChannelConfig\":%d}", (int) sampleCount, (int) sampleRate, (int) channelCount, (int) channelConfig);
+    ++_ReallocationCount;
+
+    auto Header = GetHeader();
 
-    hr = _WebView17->PostSharedBufferToScript(_SharedBuffer.get(), COREWEBVIEW2_SHARED_BUFFER_ACCESS_READ_WRITE, AdditionalDataAsJson.c_str());
+    Header->Magic         = frame_header_t::CurrentMagic;
+    Header->Version       = frame_header_t::CurrentVersion;
+    Header->Size          = (uint16_t) (_Regions.GetTableOffset() + _Regions.GetTableSize());
+    Header->Sequence      = _Sequence;
+    Header->SampleCount   = 0;
+    Header->PlaybackTime  = 0.;
+    Header->SampleRate    = layout.SampleRate;
+    Header->ChannelCount  = layout.ChannelCount;
+    Header->ChannelConfig = layout.ChannelConfig;
+    Header->Capacity      = (uint32_t) Capacity;
+    Header->SectionCount  = (uint32_t) _Regions.GetRegions().size();
+    Header->TableOffset   = (uint32_t) _Regions.GetTableOffset();
+    Header->EntrySize     = (uint32_t) sizeof(frame_section_t);
+
+    _Regions.WriteTable(_Buffer);
+
+    std::wstring AdditionalDataAsJson = ::FormatText(L"{\"SampleCount\":%d,\"SampleRate\":%d,\"ChannelCount\":%d,\"ChannelConfig\":%d,\"Capacity\":%d,\"SampleFormat\":%d,\"BandCount\":%d,\"BucketCapacity\":%d,\"HeaderVersion\":%d,\"HeaderSize\":%d,\"ReallocationCount\":%d}",
+        (int) layout.SampleCount, (int) layout.SampleRate, (int) layout.ChannelCount, (int) layout.ChannelConfig, (int) Capacity, (int) layout.Format, (int) layout.BandCount, (int) BucketCapacity,
+        (int) frame_header_t::CurrentVersion, (int) (_Regions.GetTableOffset() + _Regions.GetTableSize()), (int) _ReallocationCount);
+
+    hr = _WebView17->PostSharedBufferToScript(_SharedBuffer.get(), COREWEBVIEW2_SHARED_BUFFER_ACCESS_READ_ONLY, AdditionalDataAsJson.c_str());
 
     if (!SUCCEEDED(hr))
         return hr;
 
-    _SampleCount = sampleCount;
-    _SampleRate = sampleRate;
-    _ChannelCount = channelCount;
-    _ChannelConfig = channelConfig;
+    _Layout = layout;
+    _Capacity = Capacity;
+    _BucketCapacity = BucketCapacity;
 
     return S_OK;
 }
 
+/// <summary>
+/// Reuses the existing buffer for the specified layout as long as the format remains the same and the sections fit. Returns false if the buffer must be (re)allocated. Unlike Ensure(), can be called from any thread.
+/// </summary>
+bool SharedBuffer::Update(const frame_layout_t & layout) noexcept
+{
+    if ((_Buffer == nullptr) || !_Layout.IsCompatible(layout) || (layout.SampleCount > _Capacity) || (layout.BucketCount > _BucketCapacity))
+        return false;
+
+    _Layout.SampleCount = layout.SampleCount;
+    _Layout.BucketCount = layout.BucketCount;
+
+    return true;
+}
+
 /// <summary>
 /// Releases the resources of this instance.
 /// </summary>
 void SharedBuffer::Release() noexcept
 {
-    _ChannelConfig = 0;
-    _ChannelCount = 0;
-    _SampleRate = 0;
-    _SampleCount = 0;
+    _Layout = { };
+    _Regions.Reset(0);
+    _Capacity = 0;
+    _BucketCapacity = 0;
 
+    _Size = 0;
     _Buffer = nullptr;
     _SharedBuffer = nullptr;
     _WebView17 = nullptr;
@@ -75,37 +152,238 @@ void SharedBuffer::Release() noexcept
 }
 
 /// <summary>
-/// Copies data to the buffer.
+/// Marks the start of a frame update. Scripts that see an odd sequence number should skip the frame.
 /// </summary>
-void SharedBuffer::Copy(const BYTE * data, size_t size) noexcept
+void SharedBuffer::BeginFrame() noexcept
 {
     if (_Buffer == nullptr)
         return;
 
-    if (_Size < size)
-        size = (size_t) _Size;
+    _Sequence |= 1;
 
-    ::memcpy(_Buffer, data, size);
+    GetHeader()->Sequence = _Sequence;
+
+    std::atomic_thread_fence(std::memory_order_release);
 }
 
 /// <summary>
-/// Fills the buffer with samples converted from 32-bit to 64-floats.
+/// Marks the end of a frame update and publishes the frame information in the header.
 /// </summary>
-void SharedBuffer::Convert(const float * sampleData, size_t sampleCount) noexcept
+void SharedBuffer::EndFrame(double playbackTime) noexcept
 {
     if (_Buffer == nullptr)
         return;
 
-    size_t Size = sizeof(double) * sampleCount * _ChannelCount;
+    auto Header = GetHeader();
+
+    Header->SampleCount   = (uint32_t) _Layout.SampleCount;
+    Header->PlaybackTime  = playbackTime;
+    Header->SampleRate    = _Layout.SampleRate;
+    Header->ChannelCount  = _Layout.ChannelCount;
+    Header->ChannelConfig = _Layout.ChannelConfig;
+
+    for (const auto & Region : _Regions.GetRegions())
+    {
+        uint32_t Count = 0;
+
+        switch ((FrameSection) Region.Id)
+        {
+            case FrameSection::Samples:     Count = (uint32_t) _Layout.SampleCount; break;
+            case FrameSection::Frequencies:
+            case FrameSection::Spectrum:    Count = _Layout.BandCount; break;
+            case FrameSection::Envelope:    Count = (uint32_t) _Layout.BucketCount; break;
+            case FrameSection::Loudness:
+            case FrameSection::Levels:
+            case FrameSection::Windows:
+            case FrameSection::Playback:    Count = 1; break;
+            case FrameSection::Stereo:      Count = (uint32_t) _Layout.StereoPointCount; break;
+            default:                        break;
+        }
+
+        _Regions.SetCount(Region.Id, Count);
+    }
+
+    _Regions.WriteTable(_Buffer);
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _Sequence += 1;
+
+    Header->Sequence = _Sequence;
+}
+
+/// <summary>
+/// Writes the samples to the buffer in the selected sample format.
+/// </summary>
+void SharedBuffer::WriteSamples(const audio_sample * samples, size_t sampleCount) noexcept
+{
+    BYTE * Data = GetSection(FrameSection::Samples);
+
+    if (Data == nullptr)
+        return;
+
+    if (sampleCount > _Capacity)
+        sampleCount = _Capacity;
 
-    if (_Size < Size)
-        sampleCount = _SampleCount;
+    SampleConverter::Convert(samples, sampleCount, _Layout.ChannelCount, _Layout.Format, _Capacity, Data);
+}
 
-    const float * p = sampleData;
-    double * q = (double *) _Buffer;
+/// <summary>
+/// Writes the min/max/RMS envelope of the samples to the buffer.
+/// </summary>
+void SharedBuffer::WriteEnvelope(const audio_sample * samples, size_t sampleCount) noexcept
+{
+    auto * Data = (envelope_t *) GetSection(FrameSection::Envelope);
+
+    if (Data == nullptr)
+        return;
+
+    EnvelopeDecimator::Process(samples, sampleCount, _Layout.ChannelCount, _Layout.BucketCount, Data);
+}
+
+/// <summary>
+/// Writes the values of the loudness meter to the buffer.
+/// </summary>
+void SharedBuffer::WriteLoudness(const loudness_t & loudness) noexcept
+{
+    auto * Data = (loudness_t *) GetSection(FrameSection::Loudness);
+
+    if (Data == nullptr)
+        return;
+
+    *Data = loudness;
+}
+
+/// <summary>
+/// Writes the levels of each channel to the buffer. Writes nothing if the meter has not seen the current channel layout yet.
+/// </summary>
+void SharedBuffer::WriteLevels(const LevelMeter & levelMeter) noexcept
+{
+    auto * Data = (level_t *) GetSection(FrameSection::Levels);
+
+    if ((Data == nullptr) || (levelMeter.GetChannelCount() != _Layout.ChannelCount))
+        return;
+
+    levelMeter.GetLevels(Data);
+}
+
+/// <summary>
+/// Writes the stereo correlation and balance of the samples to the buffer, followed by the goniometer points.
+/// </summary>
+void SharedBuffer::WriteStereo(const StereoAnalyzer & stereoAnalyzer, const audio_sample * samples, size_t sampleCount) noexcept
+{
+    BYTE * Data = GetSection(FrameSection::Stereo);
+
+    if (Data == nullptr)
+        return;
+
+    stereoAnalyzer.Process(samples, sampleCount, *(stereo_t *) Data, (stereo_point_t *) (Data + sizeof(stereo_t)), _Layout.StereoPointCount);
+}
+
+/// <summary>
+/// Writes the description of the batch of overlapping windows in the samples to the buffer.
+/// </summary>
+void SharedBuffer::WriteWindows(const window_batch_t & batch) noexcept
+{
+    auto * Data = (window_batch_t *) GetSection(FrameSection::Windows);
+
+    if (Data == nullptr)
+        return;
+
+    *Data = batch;
+}
+
+/// <summary>
+/// Writes the state of the player to the buffer.
+/// </summary>
+void SharedBuffer::WritePlayback(const playback_state_t & state) noexcept
+{
+    auto * Data = (playback_state_t *) GetSection(FrameSection::Playback);
+
+    if (Data == nullptr)
+        return;
+
+    *Data = state;
+}
+
+/// <summary>
+/// Writes the state of the player to the buffer outside of a frame update f.e. when playback is paused and no frames are written.
+/// </summary>
+void SharedBuffer::UpdatePlayback(const playback_state_t & state) noexcept
+{
+    if (_Buffer == nullptr)
+        return;
+
+    BeginFrame();
+
+    WritePlayback(state);
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _Sequence += 1;
+
+    GetHeader()->Sequence = _Sequence;
+}
+
+/// <summary>
+/// Gets a pointer to the data of the specified section or nullptr if the buffer does not contain the section. The offset comes from the native section table, never from the buffer.
+/// </summary>
+BYTE * SharedBuffer::GetSection(FrameSection id) const noexcept
+{
+    if (_Buffer == nullptr)
+        return nullptr;
+
+    const auto * Region = _Regions.Find((uint8_t) id);
+
+    return (Region != nullptr) ? _Buffer + Region->Offset : nullptr;
+}
+
+/// <summary>
+/// Sets the flags of the specified section.
+/// </summary>
+void SharedBuffer::SetSectionFlags(FrameSection id, uint16_t flags) noexcept
+{
+    if ((_Buffer == nullptr) || !_Regions.SetFlags((uint8_t) id, flags))
+        return;
+
+    _Regions.WriteTable(_Buffer);
+}
+
+/// <summary>
+/// Gets the format of the values in the sample section.
+/// </summary>
+FrameFormat SharedBuffer::GetFrameFormat(SampleFormat sampleFormat) noexcept
+{
+    switch (sampleFormat)
+    {
+        default:
+        case SampleFormat::Float64:       return FrameFormat::Float64;
+        case SampleFormat::Float32:       return FrameFormat::Float32;
+        case SampleFormat::Float32Planar: return FrameFormat::Float32;
+        case SampleFormat::Int16:         return FrameFormat::Int16;
+    }
+}
+
+/// <summary>
+/// Gets the capacity, in samples per channel, to allocate for the specified number of samples. Adds 25% headroom and rounds up to a multiple of 1024 samples so that small variations in chunk size don't cause a reallocation.
+/// </summary>
+size_t SharedBuffer::GetCapacity(size_t sampleCount) noexcept
+{
+    const size_t Granularity = 1024;
+
+    const size_t Capacity = sampleCount + (sampleCount / 4);
+
+    return ((Capacity + Granularity - 1) / Granularity) * Granularity;
+}
+
+/// <summary>
+/// Gets the capacity, in buckets per channel, to allocate for the specified number of buckets. Rounds up to a multiple of 256 buckets so that resizing the panel doesn't cause a reallocation on every step.
+/// </summary>
+size_t SharedBuffer::GetBucketCapacity(size_t bucketCount) noexcept
+{
+    const size_t Granularity = 256;
 
-    for (size_t i = 0; i < sampleCount * _ChannelCount; ++i)
-        *q++ = (double) *p++;
+    return ((bucketCount + Granularity - 1) / Granularity) * Granularity;
 }
 
 /// <summary>
@@ -1,5 +1,5 @@
 
-/** $VER: SharedBuffer.h (2024.06.26) P. Stuer - Implements a buffer shared by the component and WebView. **/
+/** $VER: SharedBuffer.h (2026.10.16) P. Stuer - Implements a buffer shared by the component and WebView. **/
 
 #pragma once
 
@@ -10,27 +10,232 @@
 
 #include <WebView2.h>
 
+#include <atomic>
+
+#include "SampleConverter.h"
+#include "EnvelopeDecimator.h"
+#include "LoudnessMeter.h"
+#include "LevelMeter.h"
+#include "StereoAnalyzer.h"
+#include "RegionLayout.h"
+
+#pragma pack(push, 8)
+
+/// <summary>
+/// Identifies a section of the shared buffer.
+/// </summary>
+enum class FrameSection : uint8_t
+{
+    None = 0,
+
+    Samples,                    // Interleaved samples
+    Frequencies,                // Center frequency of each spectrum band, in Hz
+    Spectrum,                   // Magnitude of each spectrum band, channel by channel
+    Envelope,                   // Min, max and RMS of each bucket, channel by channel
+    Loudness,                   // Loudness and true peak, see loudness_t
+    Levels,                     // Peak, RMS, VU and held peak level of each channel, see level_t
+    Stereo,                     // Stereo correlation and balance, see stereo_t, followed by the goniometer points, see stereo_point_t
+    Windows,                    // Describes the overlapping windows in the samples, see window_batch_t
+    Playback,                   // State of the player, see playback_state_t
+
+    Count
+};
+
+/// <summary>
+/// Identifies the format of the values in a section.
+/// </summary>
+enum class FrameFormat : uint8_t
+{
+    Float64 = 0,
+    Float32,
+    Int16,
+};
+
+/// <summary>
+/// Describes a section of the shared buffer. Binary compatible with region_t.
+/// </summary>
+struct frame_section_t
+{
+    FrameSection Id;
+    FrameFormat Format;
+    uint16_t Flags;             // See frame_section_t::Decibel and frame_section_t::Planar.
+
+    uint32_t Offset;            // Offset of the section from the start of the buffer, in bytes. Aligned on a 16-byte boundary.
+    uint32_t Size;              // Size of the section, in bytes.
+    uint32_t Count;             // Number of valid values per channel.
+
+    char Name[16];              // Name of the section f.e. "Spectrum". Scripts can locate the sections by name instead of by id.
+
+    static const uint16_t Decibel = 0x0001; // The spectrum contains dBFS values instead of linear magnitudes.
+    static const uint16_t Planar  = 0x0002; // The samples are stored channel by channel, Capacity samples apart, instead of interleaved.
+};
+
+/// <summary>
+/// Represents the binary header at the start of the shared buffer. The section table follows the header, the sections follow the section table.
+/// </summary>
+struct frame_header_t
+{
+    uint32_t Magic;             // 'FBVS'
+    uint16_t Version;           // Version of the header layout.
+    uint16_t Size;              // Size of the header, in bytes, including the section table.
+
+    uint32_t Sequence;          // Incremented before and after each update. An odd value indicates that the frame is being written.
+    uint32_t SampleCount;       // Number of valid samples per channel in the buffer.
+
+    double PlaybackTime;        // Playback time of the frame, in seconds.
+
+    uint32_t SampleRate;        // Sample rate, in Hz.
+    uint32_t ChannelCount;      // Number of channels.
+    uint32_t ChannelConfig;     // Channel configuration, see audio_chunk::channel_config_*.
+    uint32_t Capacity;          // Maximum number of samples per channel the buffer can hold.
+
+    uint32_t SectionCount;      // Number of entries in the section table.
+    uint32_t TableOffset;       // Offset of the section table from the start of the buffer, in bytes.
+    uint32_t EntrySize;         // Size of an entry of the section table, in bytes.
+    uint32_t Reserved[3];       // Pads the header to 64 bytes.
+
+    static const uint32_t CurrentMagic = 0x53564246; // 'FBVS' in little-endian byte order.
+    static const uint16_t CurrentVersion = 3;
+};
+
+/// <summary>
+/// Represents the state of the player.
+/// </summary>
+struct playback_state_t
+{
+    double Length;              // Length of the current track, in seconds. 0 if unknown.
+    float Volume;               // Volume, in dB
+    uint32_t Flags;             // See playback_state_t::Playing and playback_state_t::Paused.
+
+    // Clock anchor: the playback position at the time stamp. While playing and not paused the current position is Position + ((Now - Timestamp) / 1000.) * Rate.
+    double Position;            // in seconds
+    double Timestamp;           // in ms, on the time line of performance.timeOrigin + performance.now() in scripts. See GetTimestamp().
+    float Rate;                 // Playback rate. 1.0 while playing, 0.0 while stopped.
+    uint32_t Reserved;
+
+    static const uint32_t Playing = 0x0001;
+    static const uint32_t Paused  = 0x0002;
+};
+
+/// <summary>
+/// Describes a batch of overlapping windows. Window i of the batch starts at sample i * HopSize of the samples section and is WindowSize samples long.
+/// All values are doubles so scripts can read them with a Float64Array. The integer values are exact.
+/// </summary>
+struct window_batch_t
+{
+    double FirstWindow;         // Number of the first window of the batch. Consecutive batches continue the count so scripts can detect skipped frames.
+    double WindowCount;         // Number of windows in the batch
+    double WindowSize;          // Size of a window, in samples per channel
+    double HopSize;             // Distance between the start of two consecutive windows, in samples per channel
+    double StartTime;           // Playback time of the first sample of the first window, in seconds
+    double Flags;               // See window_batch_t::Discontinuity.
+
+    static constexpr double Discontinuity = 1.; // The first window does not follow the last window of the previous batch f.e. after a seek, a gap in playback or a change of the window layout.
+};
+
+#pragma pack(pop)
+
+static_assert((sizeof(frame_section_t) == sizeof(region_t)) && (offsetof(frame_section_t, Name) == offsetof(region_t, Name)), "Unexpected frame section size");
+static_assert(sizeof(frame_header_t) == 64, "Unexpected frame header size");
+static_assert(sizeof(playback_state_t) == 40, "Unexpected playback state size");
+static_assert(sizeof(envelope_t) == 12, "Unexpected envelope size");
+static_assert(sizeof(loudness_t) == 32, "Unexpected loudness size");
+static_assert(sizeof(level_t) == 16, "Unexpected level size");
+static_assert(sizeof(stereo_t) == 32, "Unexpected stereo size");
+static_assert(sizeof(stereo_point_t) == 8, "Unexpected stereo point size");
+static_assert(sizeof(window_batch_t) == 48, "Unexpected window batch size");
+
+/// <summary>
+/// Describes the content of the shared buffer.
+/// </summary>
+struct frame_layout_t
+{
+    size_t SampleCount;         // Number of samples per channel
+    uint32_t SampleRate;
+    uint32_t ChannelCount;
+    uint32_t ChannelConfig;
+
+    bool HasSamples;
+    SampleFormat Format;
+
+    uint32_t BandCount;         // Number of spectrum bands per channel. 0 if the spectrum is disabled.
+    size_t BucketCount;         // Number of envelope buckets per channel. 0 if the envelope is disabled.
+
+    bool HasLoudness;
+    bool HasLevels;
+
+    bool HasStereo;
+    size_t StereoPointCount;    // Number of goniometer points.
+
+    bool HasWindows;            // The samples contain a batch of overlapping windows.
+
+    /// <summary>
+    /// Returns true if the specified layout can reuse a buffer allocated for this layout, provided the samples and buckets fit.
+    /// </summary>
+    bool IsCompatible(const frame_layout_t & other) const noexcept
+    {
+        return (SampleRate == other.SampleRate) && (ChannelCount == other.ChannelCount) && (ChannelConfig == other.ChannelConfig) && (HasSamples == other.HasSamples) && (Format == other.Format)
+            && (BandCount == other.BandCount) && ((BucketCount != 0) == (other.BucketCount != 0)) && (HasLoudness == other.HasLoudness) && (HasLevels == other.HasLevels)
+            && (HasStereo == other.HasStereo) && (StereoPointCount == other.StereoPointCount) && (HasWindows == other.HasWindows);
+    }
+};
+
 /// <summary>
 /// Implements a buffer shared between the component and the WebView2 control.
 /// </summary>
 class SharedBuffer
 {
 public:
-    SharedBuffer() : _SampleCount(), _SampleRate(), _ChannelCount(), _ChannelConfig() { }
+    SharedBuffer() : _Layout(), _Capacity(), _BucketCapacity(), _Sequence(), _ReallocationCount(), _Size(), _Buffer() { }
 
     virtual ~SharedBuffer();
 
-    HRESULT Ensure(wil::com_ptr<ICoreWebView2Environment> & environment, wil::com_ptr<ICoreWebView2> & webView, size_t sampleCount, uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig) noexcept;
+    HRESULT Ensure(wil::com_ptr<ICoreWebView2Environment> & environment, wil::com_ptr<ICoreWebView2> & webView, const frame_layout_t & layout) noexcept;
+    bool Update(const frame_layout_t & layout) noexcept;
     void Release() noexcept;
 
-    void Copy(const BYTE * data, size_t size) noexcept;
-    void Convert(const float * sampleData, size_t sampleCount) noexcept;
+    void BeginFrame() noexcept;
+    void EndFrame(double playbackTime) noexcept;
+
+    void WriteSamples(const audio_sample * samples, size_t sampleCount) noexcept;
+    void WriteEnvelope(const audio_sample * samples, size_t sampleCount) noexcept;
+    void WriteLoudness(const loudness_t & loudness) noexcept;
+    void WriteLevels(const LevelMeter & levelMeter) noexcept;
+    void WriteStereo(const StereoAnalyzer & stereoAnalyzer, const audio_sample * samples, size_t sampleCount) noexcept;
+    void WriteWindows(const window_batch_t & batch) noexcept;
+    void WritePlayback(const playback_state_t & state) noexcept;
+
+    void UpdatePlayback(const playback_state_t & state) noexcept;
+
+    BYTE * GetSection(FrameSection id) const noexcept;
+    void SetSectionFlags(FrameSection id, uint16_t flags) noexcept;
+
+    /// <summary>
+    /// Gets the number of times the buffer had to be reallocated and reposted to the script.
+    /// </summary>
+    uint64_t GetReallocationCount() const noexcept
+    {
+        return _ReallocationCount;
+    }
 
 private:
-    size_t _SampleCount;
-    uint32_t _SampleRate;
-    uint32_t _ChannelCount;
-    uint32_t _ChannelConfig;
+    static size_t GetCapacity(size_t sampleCount) noexcept;
+    static size_t GetBucketCapacity(size_t bucketCount) noexcept;
+    static FrameFormat GetFrameFormat(SampleFormat sampleFormat) noexcept;
+
+    frame_header_t * GetHeader() const noexcept
+    {
+        return (frame_header_t *) _Buffer;
+    }
+
+private:
+    frame_layout_t _Layout;
+    RegionLayout _Regions;      // The section table. The copy in the buffer is only written, never read back.
+    size_t _Capacity;
+    size_t _BucketCapacity;
+
+    uint32_t _Sequence;
+    uint64_t _ReallocationCount;
 
     wil::com_ptr<ICoreWebView2Environment12> _Environment12;
     wil::com_ptr<ICoreWebView2_17> _WebView17;
@@ -0,0 +1,98 @@
+
+/** $VER: SpectrogramBuffer.cpp (2026.10.16) P. Stuer **/
+
+#include "pch.h"
+
+#include "SpectrogramBuffer.h"
+
+#include "Encoding.h"
+
+#pragma hdrstop
+
+/// <summary>
+/// Ensures that a ring for the specified layout is posted to the WebView. Must be called on the UI thread.
+/// </summary>
+HRESULT SpectrogramBuffer::Ensure(wil::com_ptr<ICoreWebView2Environment> & environment, wil::com_ptr<ICoreWebView2> & webView, const spectrogram_layout_t & layout) noexcept
+{
+    if (Update(layout))
+        return S_OK;
+
+    Release();
+
+    if (SpectrogramRing::GetRowCount(layout) < SpectrogramRing::MinRowCount)
+        return E_INVALIDARG;
+
+    auto Environment12 = environment.try_query<ICoreWebView2Environment12>();
+    auto WebView17 = webView.try_query<ICoreWebView2_17>();
+
+    if ((Environment12 == nullptr) || (WebView17 == nullptr))
+        return E_NOINTERFACE;
+
+    _Size = SpectrogramRing::GetSize(layout);
+
+    HRESULT hr = Environment12->CreateSharedBuffer(_Size, &_SharedBuffer);
+
+    if (!SUCCEEDED(hr))
+        return hr;
+
+    hr = _SharedBuffer->get_Buffer(&_Buffer);
+
+    if (!SUCCEEDED(hr))
+    {
+        Release();
+
+        return hr;
+    }
+
+    _Ring.Initialize(layout, _Buffer);
+
+    const std::wstring AdditionalDataAsJson = ::FormatText(L"{\"Type\":\"Spectrogram\",\"HeaderSize\":%d,\"RowCount\":%d,\"RowSize\":%d,\"BandCount\":%d,\"ChannelCount\":%d,\"SampleRate\":%d,\"FrequenciesOffset\":%d,\"RowsOffset\":%d}",
+        (int) sizeof(spectrogram_header_t), (int) _Ring.GetRowCount(), (int) _Ring.GetRowSize(), (int) layout.BandCount, (int) layout.ChannelCount, (int) layout.SampleRate, (int) sizeof(spectrogram_header_t), (int) _Ring.GetRowsOffset());
+
+    hr = WebView17->PostSharedBufferToScript(_SharedBuffer.get(), COREWEBVIEW2_SHARED_BUFFER_ACCESS_READ_ONLY, AdditionalDataAsJson.c_str());
+
+    if (!SUCCEEDED(hr))
+    {
+        Release();
+
+        return hr;
+    }
+
+    return S_OK;
+}
+
+/// <summary>
+/// Returns true if the ring can be used for the specified layout. Returns false if the ring must be (re)allocated. Unlike Ensure(), can be called from any thread.
+/// </summary>
+bool SpectrogramBuffer::Update(const spectrogram_layout_t & layout) const noexcept
+{
+    return (_Buffer != nullptr) && (_Ring.GetLayout() == layout);
+}
+
+/// <summary>
+/// Releases the resources of this instance.
+/// </summary>
+void SpectrogramBuffer::Release() noexcept
+{
+    _Ring.Reset();
+
+    _Size = 0;
+    _Buffer = nullptr;
+    _SharedBuffer = nullptr;
+}
+
+/// <summary>
+/// Adds a spectrum frame to the ring, overwriting the oldest row when the ring is full. The spectrum contains the magnitudes of the bands, channel by channel.
+/// </summary>
+void SpectrogramBuffer::WriteRow(const float * frequencies, const float * spectrum, uint16_t flags, double playbackTime) noexcept
+{
+    _Ring.WriteRow(frequencies, spectrum, flags, playbackTime);
+}
+
+/// <summary>
+/// Deletes this instance.
+/// </summary>
+SpectrogramBuffer::~SpectrogramBuffer()
+{
+    Release();
+}
@@ -0,0 +1,37 @@
+
+/** $VER: SpectrogramBuffer.h (2026.10.16) P. Stuer - Implements a ring of spectrum frames shared by the component and WebView. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <wrl.h>
+#include <wil/com.h>
+
+#include <WebView2.h>
+
+#include "SpectrogramRing.h"
+
+/// <summary>
+/// Implements a ring of the most recent spectrum frames in a buffer shared between the component and the WebView2 control. Scripts only have to process the rows that were added since the previous frame.
+/// </summary>
+class SpectrogramBuffer
+{
+public:
+    SpectrogramBuffer() : _Size(), _Buffer() { }
+
+    virtual ~SpectrogramBuffer();
+
+    HRESULT Ensure(wil::com_ptr<ICoreWebView2Environment> & environment, wil::com_ptr<ICoreWebView2> & webView, const spectrogram_layout_t & layout) noexcept;
+    bool Update(const spectrogram_layout_t & layout) const noexcept;
+    void Release() noexcept;
+
+    void WriteRow(const float * frequencies, const float * spectrum, uint16_t flags, double playbackTime) noexcept;
+
+private:
+    SpectrogramRing _Ring;      // Lays out the buffer and keeps the state of the ring. The state is only mirrored in the header, never read back from the buffer.
+
+    wil::com_ptr<ICoreWebView2SharedBuffer> _SharedBuffer;
+    UINT64 _Size;
+    BYTE * _Buffer;
+};
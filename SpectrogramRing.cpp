@@ -0,0 +1,141 @@
+
+/** $VER: SpectrogramRing.cpp (2026.10.17) P. Stuer - Lays out a ring of spectrum frames in a buffer and writes its rows. Host-independent. **/
+
+#include "SpectrogramRing.h"
+
+#include <atomic>
+#include <cstring>
+
+/// <summary>
+/// Initializes the ring for the specified layout and writes the header to the buffer. The buffer must be at least GetSize(layout) bytes. Returns false if the layout has less than MinRowCount rows.
+/// </summary>
+bool SpectrogramRing::Initialize(const spectrogram_layout_t & layout, uint8_t * buffer) noexcept
+{
+    Reset();
+
+    const size_t RowCount = GetRowCount(layout);
+
+    if ((RowCount < MinRowCount) || (buffer == nullptr))
+        return false;
+
+    _Layout     = layout;
+    _RowCount   = RowCount;
+    _RowSize    = GetRowSize(layout);
+    _RowsOffset = GetRowsOffset(layout);
+    _Buffer     = buffer;
+
+    auto Header = GetHeader();
+
+    Header->Magic             = spectrogram_header_t::CurrentMagic;
+    Header->Version           = spectrogram_header_t::CurrentVersion;
+    Header->Size              = (uint16_t) sizeof(spectrogram_header_t);
+    Header->Sequence          = _Sequence;
+    Header->WriteIndex        = 0;
+    Header->RowsWritten       = 0;
+    Header->RowCount          = (uint32_t) _RowCount;
+    Header->BandCount         = layout.BandCount;
+    Header->ChannelCount      = layout.ChannelCount;
+    Header->RowSize           = (uint32_t) _RowSize;
+    Header->FrequenciesOffset = (uint32_t) sizeof(spectrogram_header_t);
+    Header->RowsOffset        = (uint32_t) _RowsOffset;
+    Header->Flags             = 0;
+    Header->SampleRate        = layout.SampleRate;
+
+    return true;
+}
+
+/// <summary>
+/// Detaches the ring from its buffer.
+/// </summary>
+void SpectrogramRing::Reset() noexcept
+{
+    _Layout = { };
+    _RowCount = 0;
+    _RowSize = 0;
+    _RowsOffset = 0;
+
+    _WriteIndex = 0;
+    _RowsWritten = 0;
+
+    _Buffer = nullptr;
+}
+
+/// <summary>
+/// Adds a spectrum frame to the ring, overwriting the oldest row when the ring is full. The spectrum contains the magnitudes of the bands, channel by channel.
+/// </summary>
+void SpectrogramRing::WriteRow(const float * frequencies, const float * spectrum, uint16_t flags, double playbackTime) noexcept
+{
+    if (_Buffer == nullptr)
+        return;
+
+    auto Header = GetHeader();
+
+    _Sequence |= 1;
+
+    Header->Sequence = _Sequence;
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // The band layout can change without a reallocation of the ring so the frequencies are rewritten with every row.
+    ::memcpy(_Buffer + sizeof(spectrogram_header_t), frequencies, sizeof(float) * _Layout.BandCount);
+
+    auto * Row = (spectrogram_row_t *) (_Buffer + _RowsOffset + (_WriteIndex * _RowSize));
+
+    Row->PlaybackTime = playbackTime;
+    Row->RowNumber    = _RowsWritten;
+
+    ::memcpy(Row + 1, spectrum, sizeof(float) * _Layout.BandCount * _Layout.ChannelCount);
+
+    _WriteIndex = (_WriteIndex + 1) % _RowCount;
+    _RowsWritten += 1;
+
+    Header->Flags       = flags;
+    Header->WriteIndex  = (uint32_t) _WriteIndex;
+    Header->RowsWritten = _RowsWritten;
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _Sequence += 1;
+
+    Header->Sequence = _Sequence;
+}
+
+/// <summary>
+/// Gets the number of rows of the specified layout that fit in the memory budget.
+/// </summary>
+size_t SpectrogramRing::GetRowCount(const spectrogram_layout_t & layout) noexcept
+{
+    if ((layout.BandCount == 0) || (layout.ChannelCount == 0))
+        return 0;
+
+    const size_t RowsOffset = GetRowsOffset(layout);
+
+    if (layout.MemoryBudget <= RowsOffset)
+        return 0;
+
+    return (layout.MemoryBudget - RowsOffset) / GetRowSize(layout);
+}
+
+/// <summary>
+/// Gets the size of a row, including its header, in bytes.
+/// </summary>
+size_t SpectrogramRing::GetRowSize(const spectrogram_layout_t & layout) noexcept
+{
+    return sizeof(spectrogram_row_t) + Align(sizeof(float) * layout.BandCount * layout.ChannelCount);
+}
+
+/// <summary>
+/// Gets the offset of the first row, in bytes. The rows follow the header and the center frequencies.
+/// </summary>
+size_t SpectrogramRing::GetRowsOffset(const spectrogram_layout_t & layout) noexcept
+{
+    return sizeof(spectrogram_header_t) + Align(sizeof(float) * layout.BandCount);
+}
+
+/// <summary>
+/// Gets the size of the buffer of the specified layout, in bytes.
+/// </summary>
+size_t SpectrogramRing::GetSize(const spectrogram_layout_t & layout) noexcept
+{
+    return GetRowsOffset(layout) + (GetRowCount(layout) * GetRowSize(layout));
+}
@@ -0,0 +1,130 @@
+
+/** $VER: SpectrogramRing.h (2026.10.17) P. Stuer - Lays out a ring of spectrum frames in a buffer and writes its rows. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#pragma pack(push, 8)
+
+/// <summary>
+/// Represents the binary header at the start of the spectrogram buffer. The center frequencies of the bands and the ring of rows follow the header.
+/// </summary>
+struct spectrogram_header_t
+{
+    uint32_t Magic;             // 'FBSG'
+    uint16_t Version;           // Version of the header layout.
+    uint16_t Size;              // Size of the header, in bytes.
+
+    uint32_t Sequence;          // Incremented before and after each update. An odd value indicates that a row is being written.
+    uint32_t WriteIndex;        // Index of the row that will be written next. The newest row is at WriteIndex - 1, modulo RowCount.
+
+    uint64_t RowsWritten;       // Number of rows written since the buffer was allocated. min(RowsWritten, RowCount) rows are valid.
+
+    uint32_t RowCount;          // Number of rows in the ring.
+    uint32_t BandCount;         // Number of spectrum bands per channel.
+    uint32_t ChannelCount;      // Number of channels.
+    uint32_t RowSize;           // Distance between two rows, in bytes. A multiple of 16.
+
+    uint32_t FrequenciesOffset; // Offset of the center frequency of each band, in bytes.
+    uint32_t RowsOffset;        // Offset of the first row, in bytes.
+
+    uint16_t Flags;             // See frame_section_t::Decibel.
+    uint16_t Reserved1;
+    uint32_t SampleRate;        // Sample rate, in Hz.
+
+    uint32_t Reserved2[2];      // Pads the header to 64 bytes.
+
+    static constexpr uint32_t CurrentMagic = 0x47534246; // 'FBSG' in little-endian byte order.
+    static constexpr uint16_t CurrentVersion = 1;
+};
+
+/// <summary>
+/// Represents the header of a row. The magnitudes of the bands follow the header, channel by channel.
+/// </summary>
+struct spectrogram_row_t
+{
+    double PlaybackTime;        // Playback time of the frame the spectrum was calculated from, in seconds.
+    uint64_t RowNumber;         // Value of RowsWritten before the row was written. Lets scripts detect rows that were overwritten while they were reading.
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(spectrogram_header_t) == 64, "Unexpected spectrogram header size");
+static_assert(sizeof(spectrogram_row_t) == 16, "Unexpected spectrogram row size");
+
+/// <summary>
+/// Describes the content of the spectrogram buffer.
+/// </summary>
+struct spectrogram_layout_t
+{
+    uint32_t BandCount;
+    uint32_t ChannelCount;
+    uint32_t SampleRate;
+    size_t MemoryBudget;        // Maximum size of the buffer, in bytes.
+
+    bool operator==(const spectrogram_layout_t & other) const noexcept
+    {
+        return (BandCount == other.BandCount) && (ChannelCount == other.ChannelCount) && (SampleRate == other.SampleRate) && (MemoryBudget == other.MemoryBudget);
+    }
+};
+
+/// <summary>
+/// Writes a ring of the most recent spectrum frames to a buffer. The state of the ring is kept here and only mirrored in the header of the buffer so the buffer can be shared with a script that may write to it.
+/// </summary>
+class SpectrogramRing
+{
+public:
+    SpectrogramRing() noexcept : _Layout(), _RowCount(), _RowSize(), _RowsOffset(), _WriteIndex(), _RowsWritten(), _Sequence(), _Buffer() { }
+
+    bool Initialize(const spectrogram_layout_t & layout, uint8_t * buffer) noexcept;
+    void Reset() noexcept;
+
+    void WriteRow(const float * frequencies, const float * spectrum, uint16_t flags, double playbackTime) noexcept;
+
+    static size_t GetRowCount(const spectrogram_layout_t & layout) noexcept;
+    static size_t GetRowSize(const spectrogram_layout_t & layout) noexcept;
+    static size_t GetRowsOffset(const spectrogram_layout_t & layout) noexcept;
+    static size_t GetSize(const spectrogram_layout_t & layout) noexcept;
+
+    const spectrogram_layout_t & GetLayout() const noexcept { return _Layout; }
+
+    size_t GetRowCount() const noexcept { return _RowCount; }
+    size_t GetRowSize() const noexcept { return _RowSize; }
+    size_t GetRowsOffset() const noexcept { return _RowsOffset; }
+
+    size_t GetWriteIndex() const noexcept { return _WriteIndex; }
+    uint64_t GetRowsWritten() const noexcept { return _RowsWritten; }
+
+    /// <summary>
+    /// Smallest useful number of rows. Budgets that can not hold this many rows disable the ring.
+    /// </summary>
+    static constexpr size_t MinRowCount = 2;
+
+private:
+    /// <summary>
+    /// Rounds the specified size up to a multiple of 16 bytes.
+    /// </summary>
+    static size_t Align(size_t size) noexcept
+    {
+        return (size + 15) & ~(size_t) 15;
+    }
+
+    spectrogram_header_t * GetHeader() const noexcept
+    {
+        return (spectrogram_header_t *) _Buffer;
+    }
+
+private:
+    spectrogram_layout_t _Layout;
+    size_t _RowCount;
+    size_t _RowSize;
+    size_t _RowsOffset;
+
+    size_t _WriteIndex;
+    uint64_t _RowsWritten;
+    uint32_t _Sequence;         // Kept when the ring is reinitialized so a script never sees the sequence number go back.
+
+    uint8_t * _Buffer;
+};
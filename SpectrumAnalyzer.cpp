@@ -0,0 +1,230 @@
+
+/** $VER: SpectrumAnalyzer.cpp (2026.10.16) P. Stuer - Implements a spectrum analyzer. Host-independent. **/
+
+#include "SpectrumAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+const float SpectrumAnalyzer::MinDecibel = -144.f;
+
+/// <summary>
+/// Initializes the analyzer. Only reallocates its buffers when the settings or the sample rate change.
+/// </summary>
+void SpectrumAnalyzer::Initialize(const spectrum_settings_t & settings, uint32_t sampleRate)
+{
+    if ((settings == _Settings) && (sampleRate == _SampleRate) && !_Bands.empty())
+        return;
+
+    _Settings = settings;
+    _SampleRate = sampleRate;
+
+    if (!FFT::IsValidSize(_Settings.FFTSize))
+        _Settings.FFTSize = 4096;
+
+    if (_Settings.BandCount == 0)
+        _Settings.BandCount = 1;
+
+    _FFT.Initialize(_Settings.FFTSize);
+
+    _Input.resize(_Settings.FFTSize);
+    _Bins.resize(_FFT.GetBinCount());
+    _Magnitudes.resize(_FFT.GetBinCount());
+
+    InitializeWindow();
+    InitializeBands();
+}
+
+/// <summary>
+/// Processes a chunk of interleaved samples. The bands receive GetBandCount() values per channel, channel by channel.
+/// </summary>
+void SpectrumAnalyzer::Process(const float * samples, size_t sampleCount, uint32_t channelCount, float * bands) noexcept
+{
+    ProcessInternal(samples, sampleCount, channelCount, bands);
+}
+
+/// <summary>
+/// Processes a chunk of interleaved samples. The bands receive GetBandCount() values per channel, channel by channel.
+/// </summary>
+void SpectrumAnalyzer::Process(const double * samples, size_t sampleCount, uint32_t channelCount, float * bands) noexcept
+{
+    ProcessInternal(samples, sampleCount, channelCount, bands);
+}
+
+/// <summary>
+/// Processes a chunk of interleaved samples. The FFT is applied to the samples at the center of the chunk. Shorter chunks are zero-padded.
+/// </summary>
+template<typename T>
+void SpectrumAnalyzer::ProcessInternal(const T * samples, size_t sampleCount, uint32_t channelCount, float * bands) noexcept
+{
+    if (_Bands.empty() || (channelCount == 0))
+        return;
+
+    const size_t FFTSize = _Settings.FFTSize;
+
+    const size_t Count  = std::min(sampleCount, FFTSize);
+    const size_t Offset = (sampleCount - Count) / 2;    // First sample in the chunk
+    const size_t Start  = (FFTSize - Count) / 2;        // First sample in the FFT input
+
+    for (uint32_t Channel = 0; Channel < channelCount; ++Channel)
+    {
+        std::fill(_Input.begin(), _Input.end(), 0.f);
+
+        const T * p = samples + (Offset * channelCount) + Channel;
+
+        for (size_t i = 0; i < Count; ++i, p += channelCount)
+            _Input[Start + i] = (float) *p * _Window[Start + i];
+
+        _FFT.Transform(_Input.data(), _Bins.data());
+
+        const float Scale = 2.f / _WindowGain;
+
+        for (size_t i = 0; i < _Bins.size(); ++i)
+            _Magnitudes[i] = std::abs(_Bins[i]) * Scale;
+
+        MapBins(bands + (Channel * _Bands.size()));
+    }
+}
+
+/// <summary>
+/// Maps the magnitude of the bins to the bands.
+/// </summary>
+void SpectrumAnalyzer::MapBins(float * bands) const noexcept
+{
+    const size_t LastBin = _Magnitudes.size() - 1;
+
+    for (const auto & Band : _Bands)
+    {
+        float Value = 0.f;
+
+        if (Band.HiBin > Band.LoBin)
+        {
+            // The band spans multiple bins: use the peak.
+            for (size_t i = Band.LoBin; i <= Band.HiBin; ++i)
+                Value = std::max(Value, _Magnitudes[i]);
+        }
+        else
+        {
+            // The band is narrower than a bin: interpolate between the two nearest bins.
+            const size_t i = std::min((size_t) Band.CenterBin, LastBin);
+            const size_t j = std::min(i + 1, LastBin);
+            const float t = (float) (Band.CenterBin - (double) i);
+
+            Value = _Magnitudes[i] + (_Magnitudes[j] - _Magnitudes[i]) * t;
+        }
+
+        if (_Settings.Scale == AmplitudeScale::Decibel)
+            Value = (Value > 0.f) ? std::max(20.f * std::log10(Value), MinDecibel) : MinDecibel;
+
+        *bands++ = Value;
+    }
+}
+
+/// <summary>
+/// Initializes the coefficients of the window function.
+/// </summary>
+void SpectrumAnalyzer::InitializeWindow()
+{
+    const size_t n = _Settings.FFTSize;
+
+    _Window.resize(n);
+
+    double Sum = 0.;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double x = 2. * std::numbers::pi * (double) i / (double) (n - 1);
+
+        double w = 1.;
+
+        switch (_Settings.Window)
+        {
+            default:
+            case WindowFunction::Rectangular:    w = 1.; break;
+            case WindowFunction::Hann:           w = 0.5 - 0.5 * std::cos(x); break;
+            case WindowFunction::Hamming:        w = 0.54 - 0.46 * std::cos(x); break;
+            case WindowFunction::Blackman:       w = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2. * x); break;
+            case WindowFunction::BlackmanHarris: w = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2. * x) - 0.01168 * std::cos(3. * x); break;
+            case WindowFunction::FlatTop:        w = 0.21557895 - 0.41663158 * std::cos(x) + 0.277263158 * std::cos(2. * x) - 0.083578947 * std::cos(3. * x) + 0.006947368 * std::cos(4. * x); break;
+        }
+
+        _Window[i] = (float) w;
+
+        Sum += w;
+    }
+
+    _WindowGain = (float) Sum; // Coherent gain, used to normalize the magnitudes so a full-scale sine reads 1.0 (0 dBFS).
+}
+
+/// <summary>
+/// Initializes the frequency bands.
+/// </summary>
+void SpectrumAnalyzer::InitializeBands()
+{
+    const size_t n = _Settings.BandCount;
+
+    const double Nyquist = (double) _SampleRate / 2.;
+
+    const double MinFrequency = std::clamp(_Settings.MinFrequency, 1., Nyquist);
+    const double MaxFrequency = std::clamp(_Settings.MaxFrequency, MinFrequency, Nyquist);
+
+    _Bands.resize(n);
+
+    // Calculates the frequency at the specified position (0.0 - 1.0) on the selected scale.
+    auto Frequency = [this, MinFrequency, MaxFrequency](double t) -> double
+    {
+        switch (_Settings.Layout)
+        {
+            default:
+            case BandLayout::Linear:
+                return MinFrequency + (MaxFrequency - MinFrequency) * t;
+
+            case BandLayout::Logarithmic:
+                return MinFrequency * std::pow(MaxFrequency / MinFrequency, t);
+
+            case BandLayout::Bark:
+            {
+                const double Lo = ToBark(MinFrequency);
+                const double Hi = ToBark(MaxFrequency);
+
+                return FromBark(Lo + (Hi - Lo) * t);
+            }
+        }
+    };
+
+    const size_t LastBin = _FFT.GetBinCount() - 1;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        auto & Band = _Bands[i];
+
+        Band.Lo     = Frequency(((double) i)        / (double) n);
+        Band.Center = Frequency(((double) i + 0.5)  / (double) n);
+        Band.Hi     = Frequency(((double) i + 1.)   / (double) n);
+
+        Band.LoBin = std::min((size_t) std::ceil (FrequencyToBin(Band.Lo)), LastBin);
+        Band.HiBin = std::min((size_t) std::floor(FrequencyToBin(Band.Hi)), LastBin);
+
+        if (Band.HiBin < Band.LoBin)
+            Band.HiBin = Band.LoBin;
+
+        Band.CenterBin = std::min(FrequencyToBin(Band.Center), (double) LastBin);
+    }
+}
+
+/// <summary>
+/// Converts a frequency to the Bark scale (Traunmueller, 1990).
+/// </summary>
+double SpectrumAnalyzer::ToBark(double frequency) noexcept
+{
+    return ((26.81 * frequency) / (1960. + frequency)) - 0.53;
+}
+
+/// <summary>
+/// Converts a value on the Bark scale to a frequency (Traunmueller, 1990).
+/// </summary>
+double SpectrumAnalyzer::FromBark(double bark) noexcept
+{
+    return 1960. * (bark + 0.53) / (26.28 - bark);
+}
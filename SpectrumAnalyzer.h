@@ -0,0 +1,138 @@
+
+/** $VER: SpectrumAnalyzer.h (2026.10.16) P. Stuer - Implements a spectrum analyzer. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <complex>
+#include <vector>
+
+#include "FFT.h"
+
+enum class WindowFunction : uint32_t
+{
+    Rectangular = 0,
+    Hann,
+    Hamming,
+    Blackman,
+    BlackmanHarris,
+    FlatTop,
+
+    Count
+};
+
+enum class BandLayout : uint32_t
+{
+    Linear = 0,
+    Logarithmic,
+    Bark,
+
+    Count
+};
+
+enum class AmplitudeScale : uint32_t
+{
+    Linear = 0,
+    Decibel,
+
+    Count
+};
+
+/// <summary>
+/// Represents the settings of the spectrum analyzer.
+/// </summary>
+struct spectrum_settings_t
+{
+    uint32_t FFTSize = 4096;
+    WindowFunction Window = WindowFunction::Hann;
+    BandLayout Layout = BandLayout::Logarithmic;
+    uint32_t BandCount = 64;
+    double MinFrequency = 20.;                  // in Hz
+    double MaxFrequency = 20000.;               // in Hz
+    AmplitudeScale Scale = AmplitudeScale::Decibel;
+
+    bool operator==(const spectrum_settings_t & other) const noexcept = default;
+};
+
+/// <summary>
+/// Implements a spectrum analyzer that maps the magnitude of the FFT bins to a number of frequency bands per channel.
+/// </summary>
+class SpectrumAnalyzer
+{
+public:
+    SpectrumAnalyzer() : _SampleRate(), _WindowGain(1.f) { }
+
+    void Initialize(const spectrum_settings_t & settings, uint32_t sampleRate);
+
+    void Process(const float * samples, size_t sampleCount, uint32_t channelCount, float * bands) noexcept;
+    void Process(const double * samples, size_t sampleCount, uint32_t channelCount, float * bands) noexcept;
+
+    /// <summary>
+    /// Gets the settings of the analyzer.
+    /// </summary>
+    const spectrum_settings_t & GetSettings() const noexcept
+    {
+        return _Settings;
+    }
+
+    /// <summary>
+    /// Gets the number of bands produced per channel.
+    /// </summary>
+    size_t GetBandCount() const noexcept
+    {
+        return _Bands.size();
+    }
+
+    /// <summary>
+    /// Gets the center frequency of the specified band, in Hz.
+    /// </summary>
+    double GetCenterFrequency(size_t bandIndex) const noexcept
+    {
+        return (bandIndex < _Bands.size()) ? _Bands[bandIndex].Center : 0.;
+    }
+
+    static const float MinDecibel;
+
+    static double ToBark(double frequency) noexcept;
+    static double FromBark(double bark) noexcept;
+
+private:
+    template<typename T> void ProcessInternal(const T * samples, size_t sampleCount, uint32_t channelCount, float * bands) noexcept;
+
+    void InitializeWindow();
+    void InitializeBands();
+
+    void MapBins(float * bands) const noexcept;
+
+    double FrequencyToBin(double frequency) const noexcept
+    {
+        return frequency * (double) _Settings.FFTSize / (double) _SampleRate;
+    }
+
+private:
+    struct band_t
+    {
+        double Lo;          // in Hz
+        double Center;      // in Hz
+        double Hi;          // in Hz
+
+        size_t LoBin;       // First bin of the band
+        size_t HiBin;       // Last bin of the band
+        double CenterBin;   // Fractional bin index of the center frequency. Used when the band is narrower than a bin.
+    };
+
+    spectrum_settings_t _Settings;
+    uint32_t _SampleRate;
+
+    FFT _FFT;
+
+    std::vector<float> _Window;
+    float _WindowGain;
+
+    std::vector<band_t> _Bands;
+
+    std::vector<float> _Input;
+    std::vector<std::complex<float>> _Bins;
+    std::vector<float> _Magnitudes;
+};
@@ -0,0 +1,248 @@
+
+/** $VER: StereoAnalyzer.cpp (2026.10.16) P. Stuer - Calculates the stereo correlation, balance and goniometer points of a chunk of samples. Host-independent. **/
+
+#include "StereoAnalyzer.h"
+#include "SampleConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_KERNELS
+
+#include <emmintrin.h>
+
+#if defined(_MSC_VER)
+#define TARGET_SSE2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#endif
+
+/// <summary>
+/// Represents the sums of the squares and the products of the left and right channel.
+/// </summary>
+struct stereo_sums_t
+{
+    double LL;
+    double RR;
+    double LR;
+};
+
+#ifdef HAS_X86_KERNELS
+
+/// <summary>
+/// Accumulates the sums of interleaved stereo samples using SSE2, two frames per iteration. Returns the number of frames processed.
+/// </summary>
+template<typename T>
+TARGET_SSE2
+static size_t AccumulateSSE2(const T * samples, size_t frameCount, stereo_sums_t & sums) noexcept
+{
+    const size_t VectorCount = frameCount / 2;
+
+    __m128d LL = _mm_setzero_pd();
+    __m128d RR = _mm_setzero_pd();
+    __m128d LR = _mm_setzero_pd();
+
+    for (size_t i = 0; i < VectorCount; ++i, samples += 4)
+    {
+        __m128d Lo, Hi; // L0 R0, L1 R1
+
+        if constexpr (std::is_same_v<T, float>)
+        {
+            const __m128 v = _mm_loadu_ps(samples);
+
+            Lo = _mm_cvtps_pd(v);
+            Hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        }
+        else
+        {
+            Lo = _mm_loadu_pd(samples);
+            Hi = _mm_loadu_pd(samples + 2);
+        }
+
+        const __m128d L = _mm_unpacklo_pd(Lo, Hi);
+        const __m128d R = _mm_unpackhi_pd(Lo, Hi);
+
+        LL = _mm_add_pd(LL, _mm_mul_pd(L, L));
+        RR = _mm_add_pd(RR, _mm_mul_pd(R, R));
+        LR = _mm_add_pd(LR, _mm_mul_pd(L, R));
+    }
+
+    alignas(16) double Sums[3][2];
+
+    _mm_store_pd(Sums[0], LL);
+    _mm_store_pd(Sums[1], RR);
+    _mm_store_pd(Sums[2], LR);
+
+    sums.LL += Sums[0][0] + Sums[0][1];
+    sums.RR += Sums[1][0] + Sums[1][1];
+    sums.LR += Sums[2][0] + Sums[2][1];
+
+    return VectorCount * 2;
+}
+
+#endif
+
+/// <summary>
+/// Initializes the analyzer. The left and right side of the stereo pair are the weighted sums of the channels.
+/// </summary>
+void StereoAnalyzer::Initialize(const double * leftWeights, const double * rightWeights, uint32_t channelCount) noexcept
+{
+    _ChannelCount = std::min(channelCount, MaxChannels);
+
+    std::copy_n(leftWeights,  _ChannelCount, _LeftWeights);
+    std::copy_n(rightWeights, _ChannelCount, _RightWeights);
+
+    // Use a single channel directly when its weight is 1 and all others are 0, the common case.
+    const auto GetChannel = [this](const double * weights) noexcept -> int
+    {
+        int Channel = -1;
+
+        for (uint32_t i = 0; i < _ChannelCount; ++i)
+        {
+            if (weights[i] == 0.)
+                continue;
+
+            if ((weights[i] != 1.) || (Channel != -1))
+                return -1;
+
+            Channel = (int) i;
+        }
+
+        return Channel;
+    };
+
+    _LeftChannel  = GetChannel(_LeftWeights);
+    _RightChannel = GetChannel(_RightWeights);
+}
+
+/// <summary>
+/// Analyzes interleaved 32-bit samples. Stores the requested number of goniometer points evenly spread over the chunk.
+/// </summary>
+void StereoAnalyzer::Process(const float * samples, size_t frameCount, stereo_t & values, stereo_point_t * points, size_t pointCount) const noexcept
+{
+    ProcessSamples(samples, frameCount, values, points, pointCount);
+}
+
+/// <summary>
+/// Analyzes interleaved 64-bit samples. Stores the requested number of goniometer points evenly spread over the chunk.
+/// </summary>
+void StereoAnalyzer::Process(const double * samples, size_t frameCount, stereo_t & values, stereo_point_t * points, size_t pointCount) const noexcept
+{
+    ProcessSamples(samples, frameCount, values, points, pointCount);
+}
+
+/// <summary>
+/// Analyzes interleaved samples.
+/// </summary>
+template<typename T>
+void StereoAnalyzer::ProcessSamples(const T * samples, size_t frameCount, stereo_t & values, stereo_point_t * points, size_t pointCount) const noexcept
+{
+    values = { };
+
+    if ((frameCount == 0) || (_ChannelCount == 0))
+    {
+        std::fill_n(points, pointCount, stereo_point_t());
+
+        return;
+    }
+
+    stereo_sums_t Sums = { };
+
+    size_t Done = 0;
+
+#ifdef HAS_X86_KERNELS
+    if ((_ChannelCount == 2) && (_LeftChannel == 0) && (_RightChannel == 1) && (SampleConverter::GetInstructionSet() >= InstructionSet::SSE2))
+        Done = AccumulateSSE2(samples, frameCount, Sums);
+#endif
+
+    if ((_LeftChannel >= 0) && (_RightChannel >= 0))
+    {
+        const T * p = samples + (Done * _ChannelCount);
+
+        for (size_t i = Done; i < frameCount; ++i, p += _ChannelCount)
+        {
+            const double L = (double) p[_LeftChannel];
+            const double R = (double) p[_RightChannel];
+
+            Sums.LL += L * L;
+            Sums.RR += R * R;
+            Sums.LR += L * R;
+        }
+    }
+    else
+    {
+        const T * p = samples;
+
+        for (size_t i = 0; i < frameCount; ++i, p += _ChannelCount)
+        {
+            double L, R;
+
+            GetPair(p, L, R);
+
+            Sums.LL += L * L;
+            Sums.RR += R * R;
+            Sums.LR += L * R;
+        }
+    }
+
+    // The mid and side sums follow from the left and right sums: M = (L + R) / 2, S = (L - R) / 2.
+    const double MM = (Sums.LL + 2. * Sums.LR + Sums.RR) / 4.;
+    const double SS = std::max((Sums.LL - 2. * Sums.LR + Sums.RR) / 4., 0.);
+
+    const double n = (double) frameCount;
+
+    const double LeftRMS  = std::sqrt(Sums.LL / n);
+    const double RightRMS = std::sqrt(Sums.RR / n);
+    const double MidRMS   = std::sqrt(MM / n);
+    const double SideRMS  = std::sqrt(SS / n);
+
+    const double Energy = Sums.LL * Sums.RR;
+
+    values.Correlation = (Energy > 0.) ? (float) std::clamp(Sums.LR / std::sqrt(Energy), -1., 1.) : 0.f;
+    values.Balance     = (LeftRMS + RightRMS > 0.) ? (float) ((RightRMS - LeftRMS) / (LeftRMS + RightRMS)) : 0.f;
+    values.Width       = (MidRMS + SideRMS > 0.) ? (float) (SideRMS / (MidRMS + SideRMS)) : 0.f;
+
+    values.LeftRMS  = (float) LeftRMS;
+    values.RightRMS = (float) RightRMS;
+    values.MidRMS   = (float) MidRMS;
+    values.SideRMS  = (float) SideRMS;
+
+    // Points that are closer together than a frame repeat the nearest frame.
+    for (size_t i = 0; i < pointCount; ++i)
+    {
+        const size_t Frame = (i * frameCount) / pointCount;
+
+        double L, R;
+
+        GetPair(samples + (Frame * _ChannelCount), L, R);
+
+        points[i].Side = (float) ((L - R) * 0.5);
+        points[i].Mid  = (float) ((L + R) * 0.5);
+    }
+}
+
+/// <summary>
+/// Gets the left and right side of the stereo pair of a frame.
+/// </summary>
+template<typename T>
+void StereoAnalyzer::GetPair(const T * frame, double & left, double & right) const noexcept
+{
+    if ((_LeftChannel >= 0) && (_RightChannel >= 0))
+    {
+        left  = (double) frame[_LeftChannel];
+        right = (double) frame[_RightChannel];
+
+        return;
+    }
+
+    left = right = 0.;
+
+    for (uint32_t i = 0; i < _ChannelCount; ++i)
+    {
+        left  += _LeftWeights[i]  * (double) frame[i];
+        right += _RightWeights[i] * (double) frame[i];
+    }
+}
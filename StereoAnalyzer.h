@@ -0,0 +1,75 @@
+
+/** $VER: StereoAnalyzer.h (2026.10.16) P. Stuer - Calculates the stereo correlation, balance and goniometer points of a chunk of samples. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// Selects the channels that form the stereo pair.
+/// </summary>
+enum class StereoMapping : uint32_t
+{
+    Front = 0,                  // Front left and right
+    Back,                       // Back left and right
+    Side,                       // Side left and right
+    Downmix,                    // All left and all right channels. The center channels are added to both sides at -3 dB, the LFE channel is ignored.
+
+    Count
+};
+
+/// <summary>
+/// Represents the stereo image of a chunk of samples. The levels are linear.
+/// </summary>
+struct stereo_t
+{
+    float Correlation;          // Correlation coefficient of the left and right channel: +1 = mono, 0 = uncorrelated, -1 = out of phase
+    float Balance;              // -1 = left only, 0 = centered, +1 = right only
+    float Width;                // Side level relative to the sum of the mid and side level: 0 = mono, 0.5 = uncorrelated, 1 = out of phase
+    float Reserved;
+
+    float LeftRMS;
+    float RightRMS;
+    float MidRMS;               // RMS of (L + R) / 2
+    float SideRMS;              // RMS of (L - R) / 2
+};
+
+/// <summary>
+/// Represents a point of the goniometer (phase scope). Plot the side value on the horizontal and the mid value on the vertical axis.
+/// </summary>
+struct stereo_point_t
+{
+    float Side;                 // (L - R) / 2
+    float Mid;                  // (L + R) / 2
+};
+
+/// <summary>
+/// Reduces interleaved samples to a stereo pair and calculates its correlation, balance and a decimated mid/side point cloud.
+/// </summary>
+class StereoAnalyzer
+{
+public:
+    StereoAnalyzer() noexcept : _ChannelCount(), _LeftWeights(), _RightWeights(), _LeftChannel(-1), _RightChannel(-1) { }
+
+    void Initialize(const double * leftWeights, const double * rightWeights, uint32_t channelCount) noexcept;
+
+    void Process(const float * samples, size_t frameCount, stereo_t & values, stereo_point_t * points, size_t pointCount) const noexcept;
+    void Process(const double * samples, size_t frameCount, stereo_t & values, stereo_point_t * points, size_t pointCount) const noexcept;
+
+    static constexpr uint32_t MaxChannels = 32;
+
+private:
+    template<typename T> void ProcessSamples(const T * samples, size_t frameCount, stereo_t & values, stereo_point_t * points, size_t pointCount) const noexcept;
+
+    template<typename T> void GetPair(const T * frame, double & left, double & right) const noexcept;
+
+private:
+    uint32_t _ChannelCount;
+    double _LeftWeights[MaxChannels];
+    double _RightWeights[MaxChannels];
+
+    // Index of the channel that forms the left and right side on its own, or -1 if the side is a weighted sum of channels.
+    int _LeftChannel;
+    int _RightChannel;
+};
@@ -1,5 +1,5 @@
 
-/** $VER: Support.cpp (2024.05.28) P. Stuer **/
+/** $VER: Support.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -14,3 +14,54 @@ HMODULE GetCurrentModule() noexcept
 
     return hModule;
 }
+
+/// <summary>
+/// Gets the BS.1770 channel weights of the specified channel configuration: the surround channels are weighted +1.5 dB, the LFE channel is ignored.
+/// </summary>
+void GetLoudnessWeights(uint32_t channelConfig, uint32_t channelCount, double * weights) noexcept
+{
+    for (uint32_t i = 0; i < channelCount; ++i)
+    {
+        const uint32_t Channel = audio_chunk::g_extract_channel_flag(channelConfig, i);
+
+        if (Channel == audio_chunk::channel_lfe)
+            weights[i] = 0.;
+        else
+        if (Channel & (audio_chunk::channel_back_left | audio_chunk::channel_back_right | audio_chunk::channel_side_left | audio_chunk::channel_side_right))
+            weights[i] = 1.41;
+        else
+            weights[i] = 1.;
+    }
+}
+
+/// <summary>
+/// Gets a monotonic time stamp in ms since the Unix epoch, comparable with performance.timeOrigin + performance.now() in scripts. The offset to the system time is determined once so the time stamp does not jump when the system time is adjusted.
+/// </summary>
+double GetTimestamp() noexcept
+{
+    static const struct origin_t
+    {
+        origin_t() noexcept
+        {
+            FILETIME FileTime;
+
+            ::GetSystemTimePreciseAsFileTime(&FileTime);
+            ::QueryPerformanceCounter(&Counter);
+            ::QueryPerformanceFrequency(&Frequency);
+
+            const uint64_t Time = ((uint64_t) FileTime.dwHighDateTime << 32) | FileTime.dwLowDateTime;
+
+            UnixTime = (double) (Time - 116444736000000000ULL) / 10000.; // 100ns units since 1601-01-01 to ms since 1970-01-01
+        }
+
+        LARGE_INTEGER Counter;
+        LARGE_INTEGER Frequency;
+        double UnixTime;
+    } Origin;
+
+    LARGE_INTEGER Counter;
+
+    ::QueryPerformanceCounter(&Counter);
+
+    return Origin.UnixTime + ((double) (Counter.QuadPart - Origin.Counter.QuadPart) * 1000. / (double) Origin.Frequency.QuadPart);
+}
@@ -1,8 +1,10 @@
 
-/** $VER: Support.h (2024.05.28) P. Stuer **/
+/** $VER: Support.h (2026.10.16) P. Stuer **/
 
 #pragma once
 
 #include "pch.h"
 
 extern HMODULE GetCurrentModule() noexcept;
+extern void GetLoudnessWeights(uint32_t channelConfig, uint32_t channelCount, double * weights) noexcept;
+extern double GetTimestamp() noexcept;
@@ -0,0 +1,96 @@
+
+/** $VER: AllocationTests.cpp (2026.10.17) P. Stuer - Tests the allocation counter. **/
+
+#include "Test.h"
+
+#include "AllocationCounter.h"
+
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+// The compiler may omit a pair of new and delete expressions when the pointer does not escape.
+static void * volatile Sink;
+
+template<typename T> static T * Escape(T * p)
+{
+    Sink = (void *) p;
+
+    return p;
+}
+
+TEST(AllVariantsOfNewAreCounted)
+{
+    struct alignas(64) aligned_t { char Data[64]; };
+
+    const uint64_t Count = AllocationCounter::Get();
+
+    auto * p1 = Escape(new int(1));
+    auto * p2 = Escape(new int[10]);
+    auto * p3 = Escape(new (std::nothrow) int(3));
+    auto * p4 = Escape(new (std::nothrow) int[10]);
+    auto * p5 = Escape(new aligned_t);
+    auto * p6 = Escape(new aligned_t[3]);
+    auto * p7 = Escape(new (std::nothrow) aligned_t);
+    auto * p8 = Escape(new (std::nothrow) aligned_t[3]);
+
+    CHECK(AllocationCounter::Get() - Count == 8);
+
+    CHECK(((uintptr_t) p5 % 64) == 0);
+    CHECK(((uintptr_t) p6 % 64) == 0);
+    CHECK(((uintptr_t) p7 % 64) == 0);
+    CHECK(((uintptr_t) p8 % 64) == 0);
+
+    delete p1;
+    delete[] p2;
+    delete p3;
+    delete[] p4;
+    delete p5;
+    delete[] p6;
+    delete p7;
+    delete[] p8;
+
+    // Freeing memory is not an allocation.
+    CHECK(AllocationCounter::Get() - Count == 8);
+}
+
+TEST(LibraryAllocationsAreCounted)
+{
+    const uint64_t Count = AllocationCounter::Get();
+
+    {
+        auto p = std::make_unique<std::string>(100, 'x');
+    }
+
+    CHECK(AllocationCounter::Get() - Count >= 2); // The object and the characters. Debug builds of some libraries allocate more.
+}
+
+TEST(CountsArePerThread)
+{
+    const uint64_t Count = AllocationCounter::Get();
+
+    uint64_t ThreadCount = 0;
+
+    std::thread Thread([&ThreadCount]()
+    {
+        const uint64_t Start = AllocationCounter::Get();
+
+        delete Escape(new int(0));
+
+        ThreadCount = AllocationCounter::Get() - Start;
+    });
+
+    const uint64_t AfterStart = AllocationCounter::Get(); // Starting the thread may allocate on this thread.
+
+    Thread.join();
+
+    CHECK(ThreadCount == 1);
+    CHECK(AllocationCounter::Get() == AfterStart);
+    CHECK(AfterStart >= Count);
+}
+
+int main()
+{
+    return RunTests();
+}
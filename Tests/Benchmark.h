@@ -0,0 +1,46 @@
+
+/** $VER: Benchmark.h (2026.10.17) P. Stuer - Minimal micro-benchmark support for the host-independent sources. **/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+// The compiler may omit work whose result is never used.
+inline const void * volatile BenchmarkSink;
+
+/// <summary>
+/// Keeps the compiler from omitting the computation of the data the pointer points to.
+/// </summary>
+inline void Escape(const void * p) noexcept
+{
+    BenchmarkSink = p;
+}
+
+/// <summary>
+/// Measures the average duration of a call of the function, in microseconds. Returns the fastest of several rounds so interruptions by the operating system do not count.
+/// </summary>
+template<typename F>
+double Measure(F f, size_t iterationCount = 1000, size_t roundCount = 5)
+{
+    using Clock = std::chrono::steady_clock;
+
+    f(); // Warm up the caches.
+
+    double Best = 1e300;
+
+    for (size_t Round = 0; Round < roundCount; ++Round)
+    {
+        const auto Start = Clock::now();
+
+        for (size_t i = 0; i < iterationCount; ++i)
+            f();
+
+        const std::chrono::duration<double, std::micro> Duration = Clock::now() - Start;
+
+        Best = std::min(Best, Duration.count() / (double) iterationCount);
+    }
+
+    return Best;
+}
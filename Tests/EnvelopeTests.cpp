@@ -0,0 +1,135 @@
+
+/** $VER: EnvelopeTests.cpp (2026.10.17) P. Stuer - Tests the envelope decimator. **/
+
+#include "Test.h"
+
+#include "EnvelopeDecimator.h"
+
+#include <algorithm>
+#include <random>
+
+/// <summary>
+/// Computes the envelopes of interleaved samples the straightforward way.
+/// </summary>
+static std::vector<envelope_t> Reference(const std::vector<double> & samples, uint32_t channelCount, size_t bucketCount)
+{
+    const size_t SampleCount = samples.size() / channelCount;
+
+    std::vector<envelope_t> Envelopes(channelCount * bucketCount);
+
+    for (uint32_t Channel = 0; Channel < channelCount; ++Channel)
+    {
+        for (size_t Bucket = 0; Bucket < bucketCount; ++Bucket)
+        {
+            const size_t Lo = (Bucket * SampleCount) / bucketCount;
+            const size_t Hi = std::max(((Bucket + 1) * SampleCount) / bucketCount, Lo + 1);
+
+            double Min = 1e9, Max = -1e9, Sum = 0.;
+
+            for (size_t i = Lo; i < Hi; ++i)
+            {
+                const double Value = samples[(i * channelCount) + Channel];
+
+                Min = std::min(Min, Value);
+                Max = std::max(Max, Value);
+                Sum += Value * Value;
+            }
+
+            Envelopes[(Channel * bucketCount) + Bucket] = { (float) Min, (float) Max, (float) std::sqrt(Sum / (double) (Hi - Lo)) };
+        }
+    }
+
+    return Envelopes;
+}
+
+TEST(MatchesReference)
+{
+    std::mt19937 Generator(5);
+    std::uniform_real_distribution<double> Distribution(-1., 1.);
+
+    for (uint32_t ChannelCount : { 1u, 2u, 3u, 4u, 6u })
+    {
+        for (size_t BucketCount : { 1, 7, 64, 500 })
+        {
+            const size_t SampleCount = 4410;
+
+            std::vector<double> Doubles(SampleCount * ChannelCount);
+
+            for (auto & Value : Doubles)
+                Value = (double) (float) Distribution(Generator); // Representable as a float so both paths see the same values.
+
+            std::vector<float> Floats(Doubles.begin(), Doubles.end());
+
+            const auto Expected = Reference(Doubles, ChannelCount, BucketCount);
+
+            std::vector<envelope_t> FromFloats(Expected.size());
+            std::vector<envelope_t> FromDoubles(Expected.size());
+
+            EnvelopeDecimator::Process(Floats.data(),  SampleCount, ChannelCount, BucketCount, FromFloats.data());
+            EnvelopeDecimator::Process(Doubles.data(), SampleCount, ChannelCount, BucketCount, FromDoubles.data());
+
+            for (size_t i = 0; i < Expected.size(); ++i)
+            {
+                CHECK(FromFloats[i].Min == Expected[i].Min);
+                CHECK(FromFloats[i].Max == Expected[i].Max);
+                CHECK_NEAR(FromFloats[i].RMS, Expected[i].RMS, 1e-5);
+
+                CHECK(FromDoubles[i].Min == Expected[i].Min);
+                CHECK(FromDoubles[i].Max == Expected[i].Max);
+                CHECK_NEAR(FromDoubles[i].RMS, Expected[i].RMS, 1e-6);
+            }
+        }
+    }
+}
+
+TEST(ConstantSignal)
+{
+    const std::vector<float> Samples(1000, -0.25f);
+
+    envelope_t Envelopes[10];
+
+    EnvelopeDecimator::Process(Samples.data(), Samples.size(), 1, std::size(Envelopes), Envelopes);
+
+    for (const auto & Envelope : Envelopes)
+    {
+        CHECK(Envelope.Min == -0.25f);
+        CHECK(Envelope.Max == -0.25f);
+        CHECK_NEAR(Envelope.RMS, 0.25, 1e-6);
+    }
+}
+
+TEST(MoreBucketsThanSamples)
+{
+    const float Samples[] = { 0.1f, 0.2f, 0.3f };
+
+    envelope_t Envelopes[9];
+
+    EnvelopeDecimator::Process(Samples, std::size(Samples), 1, std::size(Envelopes), Envelopes);
+
+    // Each bucket repeats the nearest sample.
+    for (size_t i = 0; i < std::size(Envelopes); ++i)
+    {
+        CHECK(Envelopes[i].Min == Samples[i / 3]);
+        CHECK(Envelopes[i].Max == Samples[i / 3]);
+    }
+}
+
+TEST(InvalidArgumentsLeaveOutputAlone)
+{
+    const float Samples[] = { 0.5f, 0.5f };
+
+    envelope_t Envelope = { 9.f, 9.f, 9.f };
+
+    EnvelopeDecimator::Process(Samples, 0, 1, 1, &Envelope);
+    EnvelopeDecimator::Process(Samples, 2, 0, 1, &Envelope);
+    EnvelopeDecimator::Process(Samples, 1, EnvelopeDecimator::MaxChannels + 1, 1, &Envelope);
+
+    CHECK(Envelope.Min == 9.f);
+    CHECK(Envelope.Max == 9.f);
+    CHECK(Envelope.RMS == 9.f);
+}
+
+int main()
+{
+    return RunTests();
+}
@@ -0,0 +1,247 @@
+
+/** $VER: EventBusTests.cpp (2026.10.17) P. Stuer - Tests the event bus. **/
+
+#include "Test.h"
+
+#include "EventBus.h"
+
+#include <string>
+#include <vector>
+
+enum Kinds { Frame, PlaybackStop, PlaybackTime, VolumeChange };
+
+static const event_kind_t EventKinds[] =
+{
+    { L"Frame",        EventPolicy::Drop  },
+    { L"PlaybackStop", EventPolicy::Keep  },
+    { L"PlaybackTime", EventPolicy::Merge },
+    { L"VolumeChange", EventPolicy::Merge },
+};
+
+/// <summary>
+/// Records the messages sent by a bus.
+/// </summary>
+struct Recorder
+{
+    Recorder(EventBus & bus, size_t limit)
+    {
+        bus.Initialize(EventKinds, sizeof(EventKinds) / sizeof(EventKinds[0]), [this](const std::wstring & message) { Messages.push_back(message); return true; });
+        bus.SetLimit(limit);
+    }
+
+    /// <summary>
+    /// Gets the kind of the n-th message.
+    /// </summary>
+    std::wstring Kind(size_t n) const
+    {
+        const auto & Message = Messages[n];
+
+        const size_t Begin = Message.find(L"\"Kind\":\"") + 8;
+
+        return Message.substr(Begin, Message.find(L'"', Begin) - Begin);
+    }
+
+    /// <summary>
+    /// Gets the data of the n-th message.
+    /// </summary>
+    std::wstring Data(size_t n) const
+    {
+        const auto & Message = Messages[n];
+
+        const size_t Begin = Message.find(L"\"Data\":") + 7;
+
+        return Message.substr(Begin, Message.size() - Begin - 1);
+    }
+
+    std::vector<std::wstring> Messages;
+};
+
+TEST(Envelope)
+{
+    std::wstring Message;
+
+    EventBus::Encode(Message, L"PlaybackTime", 42, 1.5, L"{\"Time\":3}");
+
+    CHECK(Message == L"{\"Kind\":\"PlaybackTime\",\"Sequence\":42,\"Timestamp\":1.500,\"Data\":{\"Time\":3}}");
+
+    EventBus::Encode(Message, L"PlaybackEdited", 1, 0., nullptr);
+
+    CHECK(Message == L"{\"Kind\":\"PlaybackEdited\",\"Sequence\":1,\"Timestamp\":0.000,\"Data\":{}}");
+}
+
+TEST(SendsEverythingUntilTheScriptAcknowledges)
+{
+    EventBus Bus;
+    Recorder Recorder(Bus, 2);
+
+    for (int i = 0; i < 10; ++i)
+        CHECK(Bus.Post(Frame, 0., L"{}"));
+
+    CHECK(Recorder.Messages.size() == 10);
+    CHECK(Bus.GetInFlightCount() == 0);
+    CHECK(Bus.GetStatistics().DroppedCount == 0);
+}
+
+TEST(Policies)
+{
+    EventBus Bus;
+    Recorder Recorder(Bus, 2);
+
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Acknowledge(1);
+
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Post(Frame, 0., L"{}");
+
+    CHECK(Bus.GetInFlightCount() == 2);
+
+    // Full: frames are dropped, the playback time is merged and a stop is sent anyway.
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Post(PlaybackTime, 1., L"{\"Time\":1}");
+    Bus.Post(PlaybackTime, 2., L"{\"Time\":2}");
+
+    CHECK(Recorder.Messages.size() == 3);
+    CHECK(Bus.GetStatistics().DroppedCount == 1);
+    CHECK(Bus.GetStatistics().MergedCount == 1);
+
+    Bus.Acknowledge(3);
+
+    // Only the newest playback time is sent once the script catches up.
+    CHECK(Recorder.Messages.size() == 4);
+    CHECK(Recorder.Kind(3) == L"PlaybackTime");
+    CHECK(Recorder.Data(3) == L"{\"Time\":2}");
+
+    const auto & Statistics = Bus.GetStatistics();
+
+    CHECK(Statistics.PostedCount == 6);
+    CHECK(Statistics.SentCount == 4);
+    CHECK(Statistics.MaxInFlightCount == 2);
+}
+
+TEST(HeldEventsPrecedeNewerEvents)
+{
+    EventBus Bus;
+    Recorder Recorder(Bus, 1);
+
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Acknowledge(1);
+    Bus.Post(Frame, 0., L"{}");
+
+    // Full: both merge kinds are held, the volume first.
+    Bus.Post(VolumeChange, 1., L"{\"Volume\":-3}");
+    Bus.Post(PlaybackTime, 2., L"{\"Time\":9}");
+
+    // The stop is sent anyway but after the held events that were posted before it.
+    CHECK(Bus.Post(PlaybackStop, 3., L"{\"Reason\":0}"));
+
+    CHECK(Recorder.Messages.size() == 5);
+    CHECK(Recorder.Kind(2) == L"VolumeChange");
+    CHECK(Recorder.Kind(3) == L"PlaybackTime");
+    CHECK(Recorder.Kind(4) == L"PlaybackStop");
+
+    // Nothing is left to send later.
+    Bus.Acknowledge(5);
+
+    CHECK(Recorder.Messages.size() == 5);
+}
+
+TEST(HeldEventsAreSentInPostOrder)
+{
+    EventBus Bus;
+    Recorder Recorder(Bus, 1);
+
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Acknowledge(1);
+    Bus.Post(Frame, 0., L"{}");
+
+    // The kinds are held in the opposite order of their index.
+    Bus.Post(VolumeChange, 1., L"{\"Volume\":-3}");
+    Bus.Post(PlaybackTime, 2., L"{\"Time\":9}");
+
+    // There is room for one event per acknowledgement.
+    Bus.Acknowledge(2);
+
+    CHECK(Recorder.Messages.size() == 3);
+    CHECK(Recorder.Kind(2) == L"VolumeChange");
+
+    Bus.Acknowledge(3);
+
+    CHECK(Recorder.Messages.size() == 4);
+    CHECK(Recorder.Kind(3) == L"PlaybackTime");
+}
+
+TEST(MergedEventWithoutData)
+{
+    EventBus Bus;
+    Recorder Recorder(Bus, 1);
+
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Acknowledge(1);
+    Bus.Post(Frame, 0., L"{}");
+
+    CHECK(Bus.Post(PlaybackTime, 1., nullptr));
+
+    Bus.Acknowledge(2);
+
+    CHECK(Recorder.Messages.size() == 3);
+    CHECK(Recorder.Data(2) == L"{}");
+}
+
+TEST(IgnoresStaleAcknowledgements)
+{
+    EventBus Bus;
+    Recorder Recorder(Bus, 2);
+
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Post(Frame, 0., L"{}");
+
+    Bus.Acknowledge(2);
+    Bus.Acknowledge(1);
+    Bus.Acknowledge(7); // Not sent yet
+
+    CHECK(Bus.GetInFlightCount() == 0);
+
+    // After a reset the sequence restarts and the held events are discarded.
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Post(Frame, 0., L"{}");
+    Bus.Post(PlaybackTime, 1., L"{}");
+
+    Bus.Reset();
+
+    CHECK(Bus.GetInFlightCount() == 0);
+
+    Bus.Post(Frame, 0., L"{}");
+
+    CHECK(Recorder.Messages.back().find(L"\"Sequence\":1,") != std::wstring::npos);
+
+    Bus.Acknowledge(1);
+
+    CHECK(Recorder.Messages.size() == 5);
+}
+
+TEST(DecodeAcknowledgement)
+{
+    uint64_t Sequence = 0;
+
+    CHECK(EventBus::DecodeAcknowledgement(L"{\"Ack\":0}", Sequence) && (Sequence == 0));
+    CHECK(EventBus::DecodeAcknowledgement(L"{\"Ack\":12345}", Sequence) && (Sequence == 12345));
+    CHECK(EventBus::DecodeAcknowledgement(L"{\"Ack\":18446744073709551615}", Sequence) && (Sequence == UINT64_MAX));
+
+    Sequence = 99;
+
+    CHECK(!EventBus::DecodeAcknowledgement(nullptr, Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Ack\":}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Ack\":-1}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Ack\":1.5}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Ack\":18446744073709551616}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Ack\":5,\"Other\":1}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Ack\":5} ", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Name\":\"x\",\"Ack\":5}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"{\"Data\":{\"Ack\":5}}", Sequence));
+    CHECK(!EventBus::DecodeAcknowledgement(L"\"{\\\"Ack\\\":5}\"", Sequence));
+
+    CHECK(Sequence == 99);
+}
+
+int main() { return RunTests(); }
@@ -0,0 +1,176 @@
+
+/** $VER: FrameRecorderTests.cpp (2026.10.17) P. Stuer - Tests the latency histograms and the frame recorder. **/
+
+#include "Test.h"
+
+#include "FrameRecorder.h"
+
+#include <string>
+#include <thread>
+
+TEST(DurationsAreCountedInLogarithmicBuckets)
+{
+    LatencyHistogram Histogram;
+
+    Histogram.Record(0);        // Bucket 0
+    Histogram.Record(1);        // Bucket 1: [1, 2)
+    Histogram.Record(3);        // Bucket 2: [2, 4)
+    Histogram.Record(4);        // Bucket 3: [4, 8)
+    Histogram.Record(7);        // Bucket 3
+    Histogram.Record(1ull << 40); // Last bucket
+
+    CHECK(Histogram.GetBucket(0) == 1);
+    CHECK(Histogram.GetBucket(1) == 1);
+    CHECK(Histogram.GetBucket(2) == 1);
+    CHECK(Histogram.GetBucket(3) == 2);
+    CHECK(Histogram.GetBucket(LatencyHistogram::BucketCount - 1) == 1);
+    CHECK(Histogram.GetBucket(LatencyHistogram::BucketCount) == 0);
+}
+
+TEST(SummaryOfUniformDurations)
+{
+    LatencyHistogram Histogram;
+
+    for (uint64_t i = 1; i <= 1000; ++i)
+        Histogram.Record(i);
+
+    const auto Summary = Histogram.GetSummary();
+
+    CHECK(Summary.Count == 1000);
+    CHECK_NEAR(Summary.Mean, 0.5005, 1e-9);
+    CHECK_NEAR(Summary.Max, 1., 1e-9);
+
+    // The percentiles are interpolated within a bucket so they are accurate to a factor of 2.
+    CHECK((Summary.P50 >= 0.25) && (Summary.P50 <= 1.));
+    CHECK((Summary.P90 >= 0.45) && (Summary.P90 <= 1.));
+    CHECK((Summary.P99 >= 0.495) && (Summary.P99 <= 1.));
+    CHECK((Summary.P50 <= Summary.P90) && (Summary.P90 <= Summary.P99) && (Summary.P99 <= Summary.Max));
+}
+
+TEST(SummaryOfConstantDurations)
+{
+    LatencyHistogram Histogram;
+
+    for (int i = 0; i < 100; ++i)
+        Histogram.Record(500);
+
+    const auto Summary = Histogram.GetSummary();
+
+    CHECK_NEAR(Summary.Mean, 0.5, 1e-9);
+
+    // The percentiles never exceed the maximum.
+    CHECK(Summary.P50 <= 0.5);
+    CHECK(Summary.P99 <= 0.5);
+    CHECK(Summary.P50 >= 0.256);
+}
+
+TEST(ResetClearsTheHistogram)
+{
+    LatencyHistogram Histogram;
+
+    Histogram.Record(10);
+    Histogram.Reset();
+
+    const auto Summary = Histogram.GetSummary();
+
+    CHECK(Summary.Count == 0);
+    CHECK(Summary.Max == 0.);
+    CHECK(Histogram.GetBucket(4) == 0);
+}
+
+TEST(ConcurrentRecordingLosesNothing)
+{
+    LatencyHistogram Histogram;
+
+    auto Record = [&Histogram]()
+    {
+        for (uint64_t i = 0; i < 100000; ++i)
+            Histogram.Record(i & 1023);
+    };
+
+    std::thread Thread1(Record);
+    std::thread Thread2(Record);
+
+    Thread1.join();
+    Thread2.join();
+
+    const auto Summary = Histogram.GetSummary();
+
+    CHECK(Summary.Count == 200000);
+    CHECK_NEAR(Summary.Max, 1.023, 1e-9);
+}
+
+TEST(TicksMeasureJitter)
+{
+    FrameRecorder Recorder;
+
+    Recorder.SetPeriod(10000);
+
+    Recorder.Tick(1000000);     // First tick: nothing to compare with.
+    Recorder.Tick(1010000);     // On time
+    Recorder.Tick(1021000);     // 1 ms late
+    Recorder.Tick(1030000);     // 1 ms early
+
+    const auto Summary = Recorder.GetHistogram(FrameStage::TimerJitter).GetSummary();
+
+    CHECK(Summary.Count == 3);
+    CHECK_NEAR(Summary.Max, 1., 1e-9);
+    CHECK_NEAR(Summary.Mean, 2. / 3., 1e-9);
+
+    // Changing the period restarts the measurement.
+    Recorder.SetPeriod(20000);
+    Recorder.Tick(2000000);
+
+    CHECK(Recorder.GetHistogram(FrameStage::TimerJitter).GetSummary().Count == 3);
+}
+
+TEST(ToJSONContainsEveryStageAndCounter)
+{
+    FrameRecorder Recorder;
+
+    Recorder.Record(FrameStage::Conversion, 3);
+    Recorder.Record(FrameStage::Conversion, 5);
+    Recorder.Increment(FrameEvent::DroppedFrame);
+    Recorder.Increment(FrameEvent::Allocation, 42);
+
+    CHECK(Recorder.GetCounter(FrameEvent::Allocation) == 42);
+
+    const std::string JSON = Recorder.ToJSON();
+
+    for (size_t i = 0; i < (size_t) FrameStage::Count; ++i)
+        CHECK(JSON.find(std::string("\"") + FrameRecorder::GetName((FrameStage) i) + "\": {") != std::string::npos);
+
+    for (size_t i = 0; i < (size_t) FrameEvent::Count; ++i)
+        CHECK(JSON.find(std::string("\"") + FrameRecorder::GetName((FrameEvent) i) + "\": ") != std::string::npos);
+
+    CHECK(JSON.find("\"conversion\": {\"count\": 2, \"mean\": 0.004, \"max\": 0.005,") != std::string::npos);
+    CHECK(JSON.find("\"buckets\": [0, 0, 1, 1, 0,") != std::string::npos);
+    CHECK(JSON.find("\"droppedFrames\": 1") != std::string::npos);
+    CHECK(JSON.find("\"allocations\": 42") != std::string::npos);
+
+    // The braces and brackets are balanced.
+    int Depth = 0;
+
+    for (char c : JSON)
+    {
+        if ((c == '{') || (c == '[')) ++Depth;
+        if ((c == '}') || (c == ']')) --Depth;
+
+        CHECK(Depth >= 0);
+    }
+
+    CHECK(Depth == 0);
+}
+
+TEST(NowIsMonotonic)
+{
+    const uint64_t t1 = FrameRecorder::Now();
+    const uint64_t t2 = FrameRecorder::Now();
+
+    CHECK(t2 >= t1);
+}
+
+int main()
+{
+    return RunTests();
+}
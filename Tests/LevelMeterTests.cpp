@@ -0,0 +1,218 @@
+
+/** $VER: LevelMeterTests.cpp (2026.10.17) P. Stuer - Tests the level meter. **/
+
+#include "Test.h"
+
+#include "LevelMeter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const double Pi = 3.14159265358979323846;
+
+static const uint32_t SampleRate = 48000;
+
+/// <summary>
+/// Converts a linear level to dB.
+/// </summary>
+static double ToDecibel(double value)
+{
+    return 20. * std::log10(value);
+}
+
+/// <summary>
+/// Feeds the specified number of milliseconds of a constant mono signal to the meter.
+/// </summary>
+static void Feed(LevelMeter & meter, float value, double duration)
+{
+    const std::vector<float> Samples((size_t) (duration * SampleRate / 1000.), value);
+
+    meter.Process(Samples.data(), Samples.size());
+}
+
+/// <summary>
+/// Gets the levels of the first channel.
+/// </summary>
+static level_t GetLevels(const LevelMeter & meter)
+{
+    level_t Levels[LevelMeter::MaxChannels];
+
+    meter.GetLevels(Levels);
+
+    return Levels[0];
+}
+
+TEST(Silence)
+{
+    LevelMeter Meter;
+
+    Meter.Initialize({ 0., 300., 1000. }, SampleRate, 1);
+
+    Feed(Meter, 0.f, 10.);
+
+    const level_t Levels = GetLevels(Meter);
+
+    CHECK(std::isinf(Levels.Peak) && (Levels.Peak < 0.f));
+    CHECK(std::isinf(Levels.RMS) && (Levels.RMS < 0.f));
+    CHECK(std::isinf(Levels.VU) && (Levels.VU < 0.f));
+    CHECK(std::isinf(Levels.PeakHold) && (Levels.PeakHold < 0.f));
+}
+
+TEST(Attack)
+{
+    LevelMeter Meter;
+
+    // A sample peak meter follows a rising level immediately.
+    Meter.Initialize({ 0., 300., 0. }, SampleRate, 1);
+
+    Feed(Meter, 0.5f, 1000. / SampleRate);
+
+    CHECK_NEAR(GetLevels(Meter).Peak, ToDecibel(0.5), 1e-5);
+
+    // A PPM reaches 1 - 1/e of a step after one time constant.
+    Meter.Initialize({ 10., 300., 0. }, SampleRate, 1);
+    Meter.Reset();
+
+    Feed(Meter, 1.f, 10.);
+
+    CHECK_NEAR(GetLevels(Meter).Peak, ToDecibel(1. - std::exp(-1.)), 0.01);
+
+    Feed(Meter, 1.f, 90.);
+
+    CHECK_NEAR(GetLevels(Meter).Peak, 0., 0.01);
+}
+
+TEST(Release)
+{
+    LevelMeter Meter;
+
+    Meter.Initialize({ 0., 300., 0. }, SampleRate, 1);
+
+    Feed(Meter, 1.f, 10.);
+    Feed(Meter, 0.f, 300.);
+
+    // The level falls to 1/e (-8.69 dB) in one time constant.
+    CHECK_NEAR(GetLevels(Meter).Peak, ToDecibel(std::exp(-1.)), 0.01);
+
+    Feed(Meter, 0.f, 300.);
+
+    CHECK_NEAR(GetLevels(Meter).Peak, ToDecibel(std::exp(-2.)), 0.01);
+}
+
+TEST(PeakHold)
+{
+    LevelMeter Meter;
+
+    Meter.Initialize({ 0., 100., 500. }, SampleRate, 1);
+
+    Feed(Meter, 1.f, 1000. / SampleRate);
+    Feed(Meter, 0.f, 490.);
+
+    // The held peak stays while the peak itself has fallen.
+    level_t Levels = GetLevels(Meter);
+
+    CHECK(Levels.PeakHold == 0.f);
+    CHECK(Levels.Peak < -40.f);
+
+    // After the hold time the held peak is released with the release time constant.
+    Feed(Meter, 0.f, 10. + 100.);
+
+    Levels = GetLevels(Meter);
+
+    CHECK_NEAR(Levels.PeakHold, ToDecibel(std::exp(-1.)), 0.05);
+
+    // A new, lower peak is not held above the falling held peak.
+    Feed(Meter, 0.1f, 1000. / SampleRate);
+
+    CHECK_NEAR(GetLevels(Meter).PeakHold, ToDecibel(std::exp(-1.)), 0.05);
+}
+
+TEST(VUCalibration)
+{
+    // The VU level of a sine reads its RMS level, independent of the frequency.
+    for (double Frequency : { 100., 1000., 5000. })
+    {
+        for (double Amplitude : { 1., 0.1 })
+        {
+            LevelMeter Meter;
+
+            Meter.Initialize({ 0., 300., 0. }, SampleRate, 1);
+
+            std::vector<float> Samples(SampleRate * 3);
+
+            for (size_t i = 0; i < Samples.size(); ++i)
+                Samples[i] = (float) (Amplitude * std::sin(2. * Pi * Frequency * (double) i / SampleRate));
+
+            Meter.Process(Samples.data(), Samples.size());
+
+            const level_t Levels = GetLevels(Meter);
+
+            const double RMS = ToDecibel(Amplitude / std::sqrt(2.));
+
+            CHECK_NEAR(Levels.VU, RMS, 0.1);
+            CHECK_NEAR(Levels.RMS, RMS, 0.1);
+            CHECK(Levels.Peak <= ToDecibel(Amplitude));
+            CHECK(Levels.Peak > ToDecibel(Amplitude) - 0.5); // The peak is released between the sampled crests.
+        }
+    }
+}
+
+TEST(VUBallistics)
+{
+    LevelMeter Meter;
+
+    Meter.Initialize({ 0., 300., 0. }, SampleRate, 1);
+
+    // The VU reading of a constant level is the level times the calibration factor of a rectified sine.
+    const double Final = ToDecibel(Pi / (2. * std::sqrt(2.)));
+
+    const double StepTime = 1.; // ms
+
+    double Time = 0., Rise = 0., Max = -1e9;
+
+    for (; Time < 2000.; Time += StepTime)
+    {
+        Feed(Meter, 1.f, StepTime);
+
+        const double VU = GetLevels(Meter).VU;
+
+        if ((Rise == 0.) && (VU >= Final + ToDecibel(0.99)))
+            Rise = Time + StepTime;
+
+        Max = std::max(Max, VU);
+    }
+
+    // 99% of the final value in 300 ms with an overshoot of 1 to 1.5%.
+    CHECK_NEAR(Rise, 300., 15.);
+    CHECK(Max >= Final + ToDecibel(1.01));
+    CHECK(Max <= Final + ToDecibel(1.015));
+
+    CHECK_NEAR(GetLevels(Meter).VU, Final, 0.01);
+}
+
+TEST(Reset)
+{
+    LevelMeter Meter;
+
+    Meter.Initialize({ 0., 300., 1000. }, SampleRate, 1);
+
+    Feed(Meter, 1.f, 100.);
+
+    // Changing the ballistics keeps the levels, changing the format resets them.
+    Meter.Initialize({ 5., 300., 1000. }, SampleRate, 1);
+
+    CHECK(GetLevels(Meter).PeakHold == 0.f);
+
+    Meter.Initialize({ 5., 300., 1000. }, SampleRate, 2);
+
+    CHECK(std::isinf(GetLevels(Meter).PeakHold));
+
+    CHECK(Meter.GetChannelCount() == 2);
+
+    Meter.Initialize({ 5., 300., 1000. }, SampleRate, 100);
+
+    CHECK(Meter.GetChannelCount() == LevelMeter::MaxChannels);
+}
+
+int main() { return RunTests(); }
@@ -0,0 +1,188 @@
+
+/** $VER: LoudnessTests.cpp (2026.10.17) P. Stuer - Tests the loudness meter with the synthetic test signals of EBU Tech 3341 and 3342. **/
+
+#include "Test.h"
+
+#include "LoudnessMeter.h"
+
+#include <numbers>
+
+/// <summary>
+/// Represents a segment of a test signal: a 1 kHz stereo sine with the specified peak level.
+/// </summary>
+struct segment_t
+{
+    double Level;       // in dBFS
+    double Duration;    // in seconds
+};
+
+/// <summary>
+/// Feeds a sequence of 1 kHz stereo sine segments to the meter, in chunks of 10 ms.
+/// </summary>
+static const loudness_t & Measure(LoudnessMeter & meter, std::initializer_list<segment_t> segments, uint32_t sampleRate = 48000)
+{
+    const double Weights[] = { 1., 1. };
+
+    meter.Initialize(sampleRate, 2, Weights);
+
+    const size_t ChunkSize = sampleRate / 100;
+
+    std::vector<float> Chunk(ChunkSize * 2);
+
+    uint64_t Frame = 0;
+
+    for (const auto & Segment : segments)
+    {
+        const double Amplitude = std::pow(10., Segment.Level / 20.);
+        const uint64_t FrameCount = (uint64_t) (Segment.Duration * sampleRate + 0.5);
+
+        for (uint64_t Done = 0; Done < FrameCount; )
+        {
+            const size_t n = (size_t) std::min<uint64_t>(ChunkSize, FrameCount - Done);
+
+            for (size_t i = 0; i < n; ++i, ++Frame)
+            {
+                const float Value = (float) (Amplitude * std::sin(2. * std::numbers::pi * 1000. * (double) Frame / (double) sampleRate));
+
+                Chunk[i * 2] = Value;
+                Chunk[i * 2 + 1] = Value;
+            }
+
+            meter.Process(Chunk.data(), n);
+
+            Done += n;
+        }
+    }
+
+    return meter.GetValues();
+}
+
+// EBU Tech 3341, test cases 1 to 5. The integrated loudness must be within 0.1 LU.
+
+TEST(Tech3341Case1)
+{
+    LoudnessMeter Meter;
+
+    const auto & Values = Measure(Meter, { { -23., 20. } });
+
+    CHECK_NEAR(Values.Integrated, -23., 0.1);
+    CHECK_NEAR(Values.Momentary,  -23., 0.1);
+    CHECK_NEAR(Values.ShortTerm,  -23., 0.1);
+    CHECK_NEAR(Values.Duration,    20., 0.1);
+}
+
+TEST(Tech3341Case2)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -33., 20. } }).Integrated, -33., 0.1);
+}
+
+TEST(Tech3341Case3)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -36., 10. }, { -23., 60. }, { -36., 10. } }).Integrated, -23., 0.1);
+}
+
+TEST(Tech3341Case4)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -72., 10. }, { -36., 10. }, { -23., 60. }, { -36., 10. }, { -72., 10. } }).Integrated, -23., 0.1);
+}
+
+TEST(Tech3341Case5)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -26., 20. }, { -20., 20.1 }, { -26., 20. } }).Integrated, -23., 0.1);
+}
+
+TEST(Tech3341OtherSampleRate)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -23., 20. } }, 44100).Integrated, -23., 0.1);
+}
+
+// EBU Tech 3342, test cases 1 to 4. The loudness range must be within 1 LU.
+
+TEST(Tech3342Case1)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -20., 20. }, { -30., 20. } }).LoudnessRange, 10., 1.);
+}
+
+TEST(Tech3342Case2)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -20., 20. }, { -15., 20. } }).LoudnessRange, 5., 1.);
+}
+
+TEST(Tech3342Case3)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -40., 20. }, { -20., 20. } }).LoudnessRange, 20., 1.);
+}
+
+TEST(Tech3342Case4)
+{
+    LoudnessMeter Meter;
+
+    CHECK_NEAR(Measure(Meter, { { -50., 20. }, { -35., 20. }, { -20., 20. }, { -35., 20. }, { -50., 20. } }).LoudnessRange, 15., 1.);
+}
+
+TEST(TruePeakBetweenSamples)
+{
+    // A sine at a quarter of the sample rate with a phase of 45 degrees: every sample is 3 dB below the peak of the signal.
+    const uint32_t SampleRate = 48000;
+    const double Amplitude = 0.5; // -6.02 dBTP
+
+    std::vector<float> Samples(SampleRate * 2);
+
+    for (size_t i = 0; i < SampleRate; ++i)
+        Samples[i * 2] = Samples[i * 2 + 1] = (float) (Amplitude * std::sin((std::numbers::pi / 2.) * (double) i + (std::numbers::pi / 4.)));
+
+    const double Weights[] = { 1., 1. };
+
+    LoudnessMeter Meter;
+
+    Meter.Initialize(SampleRate, 2, Weights);
+    Meter.Process(Samples.data(), SampleRate);
+
+    // EBU Tech 3341 allows +0.2 / -0.4 dB.
+    const double Expected = 20. * std::log10(Amplitude);
+
+    CHECK((Meter.GetValues().TruePeak <= Expected + 0.2) && (Meter.GetValues().TruePeak >= Expected - 0.4));
+}
+
+TEST(SilenceIsGated)
+{
+    LoudnessMeter Meter;
+
+    const auto & Values = Measure(Meter, { { -100., 5. } });
+
+    CHECK(std::isinf(Values.Integrated) && (Values.Integrated < 0.f));
+    CHECK(Values.LoudnessRange == 0.f);
+}
+
+TEST(ResetRestartsTheMeasurement)
+{
+    LoudnessMeter Meter;
+
+    Measure(Meter, { { -20., 5. } });
+
+    Meter.Reset();
+
+    CHECK(Meter.GetValues().Duration == 0.f);
+    CHECK(std::isinf(Meter.GetValues().Integrated));
+}
+
+int main()
+{
+    return RunTests();
+}
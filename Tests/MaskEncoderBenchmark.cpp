@@ -0,0 +1,119 @@
+
+/** $VER: MaskEncoderBenchmark.cpp (2026.10.17) P. Stuer - Compares the size and speed of the mask encoder with the index array it replaced. **/
+
+#include "Benchmark.h"
+
+#include "MaskEncoder.h"
+
+#include <cstdio>
+#include <cwchar>
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Encodes a mask as a JSON array of the indexes of the set items, the format used before MaskEncoder. FormatText() is Windows-only so each index is formatted with swprintf() into a string of its own, which does the same work.
+/// </summary>
+static std::wstring EncodeIndexes(const std::vector<bool> & mask)
+{
+    std::wstring Result = L"[";
+
+    for (size_t i = 0; i < mask.size(); ++i)
+    {
+        if (!mask[i])
+            continue;
+
+        if (Result.size() > 1)
+            Result += L",";
+
+        wchar_t Text[32];
+
+        std::swprintf(Text, std::size(Text), L"%d", (int) i);
+
+        Result += std::wstring(Text);
+    }
+
+    Result += L"]";
+
+    return Result;
+}
+
+/// <summary>
+/// Encodes a mask with the mask encoder the way PlaylistEventQueue does.
+/// </summary>
+static std::wstring EncodeRuns(const std::vector<bool> & mask)
+{
+    MaskEncoder Encoder;
+
+    Encoder.Reset(mask.size());
+
+    for (size_t i = 0; i < mask.size();)
+    {
+        if (!mask[i])
+        {
+            ++i;
+            continue;
+        }
+
+        const size_t Start = i;
+
+        while ((i < mask.size()) && mask[i])
+            ++i;
+
+        Encoder.AddRun(Start, i - Start);
+    }
+
+    return Encoder.Encode();
+}
+
+int main()
+{
+    const size_t ItemCount = 200000;
+    const size_t IterationCount = 20;
+
+    std::mt19937 Generator(1);
+
+    std::vector<bool> Sparse(ItemCount), All(ItemCount, true), Alternating(ItemCount), Random(ItemCount), Clustered(ItemCount);
+
+    for (size_t i = 0; i < ItemCount; ++i)
+    {
+        Sparse[i]      = (i % 1000) == 0;
+        Alternating[i] = (i % 2) == 0;
+        Random[i]      = (Generator() & 1) != 0;
+    }
+
+    // Runs of 1 to 500 set items separated by gaps of 1 to 500 items.
+    for (size_t i = 0; i < ItemCount;)
+    {
+        const size_t Length = 1 + (Generator() % 500);
+
+        for (size_t j = i; (j < i + Length) && (j < ItemCount); ++j)
+            Clustered[j] = true;
+
+        i += Length + 1 + (Generator() % 500);
+    }
+
+    const struct { const char * Name; const std::vector<bool> & Mask; } Masks[] =
+    {
+        { "sparse 1/1000", Sparse },
+        { "all set",       All },
+        { "alternating",   Alternating },
+        { "random 50%",    Random },
+        { "clustered",     Clustered },
+    };
+
+    std::printf("%zu items, characters and ms per encode\n\n%-16s%10s%10s%10s%10s  %s\n", ItemCount, "mask", "old size", "old time", "new size", "new time", "encoding");
+
+    for (const auto & Item : Masks)
+    {
+        const std::wstring Old = EncodeIndexes(Item.Mask);
+        const std::wstring New = EncodeRuns(Item.Mask);
+
+        const double OldTime = Measure([&]() { Escape(EncodeIndexes(Item.Mask).data()); }, IterationCount) / 1000.;
+        const double NewTime = Measure([&]() { Escape(EncodeRuns(Item.Mask).data()); }, IterationCount) / 1000.;
+
+        std::printf("%-16s%10zu%10.2f%10zu%10.2f  %s\n", Item.Name, Old.size(), OldTime, New.size(), NewTime, (New.find(L"\"Runs\"") != std::wstring::npos) ? "runs" : "bits");
+    }
+
+    return 0;
+}
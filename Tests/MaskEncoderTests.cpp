@@ -0,0 +1,228 @@
+
+/** $VER: MaskEncoderTests.cpp (2026.10.17) P. Stuer - Tests the mask encoder. **/
+
+#include "Test.h"
+
+#include "MaskEncoder.h"
+
+#include <cwchar>
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Decodes a mask the way a script does. Returns an empty mask if the text is not a valid encoding.
+/// </summary>
+static std::vector<bool> Decode(const std::wstring & text)
+{
+    size_t Count = 0;
+    int Length = 0;
+
+    if ((std::swscanf(text.c_str(), L"{\"Count\":%zu,%n", &Count, &Length) != 1) || (Length == 0))
+        return { };
+
+    std::vector<bool> Mask(Count, false);
+
+    const std::wstring Rest = text.substr((size_t) Length);
+
+    if (Rest.compare(0, 8, L"\"Runs\":[") == 0)
+    {
+        const wchar_t * p = Rest.c_str() + 8;
+
+        while (*p != L']')
+        {
+            wchar_t * End;
+
+            const size_t Start = (size_t) std::wcstoull(p, &End, 10);
+
+            if (*End != L',')
+                return { };
+
+            const size_t RunLength = (size_t) std::wcstoull(End + 1, &End, 10);
+
+            if ((RunLength == 0) || (Start + RunLength > Count))
+                return { };
+
+            for (size_t i = Start; i < Start + RunLength; ++i)
+                Mask[i] = true;
+
+            p = (*End == L',') ? End + 1 : End;
+        }
+
+        return (std::wcscmp(p, L"]}") == 0) ? Mask : std::vector<bool>();
+    }
+
+    if (Rest.compare(0, 8, L"\"Bits\":\"") == 0)
+    {
+        static const std::wstring Alphabet = L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        const size_t End = Rest.find(L'"', 8);
+
+        if ((End == std::wstring::npos) || (Rest.substr(End) != L"\"}"))
+            return { };
+
+        const std::wstring Text = Rest.substr(8, End - 8);
+
+        if ((Text.size() % 4) != 0)
+            return { };
+
+        std::vector<uint8_t> Bytes;
+
+        for (size_t i = 0; i < Text.size(); i += 4)
+        {
+            uint32_t Value = 0;
+            size_t Padding = 0;
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                size_t Index = 0;
+
+                if (Text[i + j] == L'=')
+                    ++Padding;
+                else
+                {
+                    Index = Alphabet.find(Text[i + j]);
+
+                    if (Index == std::wstring::npos)
+                        return { };
+                }
+
+                Value = (Value << 6) | (uint32_t) Index;
+            }
+
+            Bytes.push_back((uint8_t) (Value >> 16));
+
+            if (Padding < 2)
+                Bytes.push_back((uint8_t) (Value >> 8));
+
+            if (Padding < 1)
+                Bytes.push_back((uint8_t) Value);
+        }
+
+        if (Bytes.size() != (Count + 7) / 8)
+            return { };
+
+        for (size_t i = 0; i < Count; ++i)
+            Mask[i] = (Bytes[i / 8] >> (i % 8)) & 1;
+
+        return Mask;
+    }
+
+    return { };
+}
+
+/// <summary>
+/// Encodes a mask the way the playlist event queue does.
+/// </summary>
+static void Encode(const std::vector<bool> & mask, MaskEncoder & encoder)
+{
+    encoder.Reset(mask.size());
+
+    for (size_t i = 0; i < mask.size(); ++i)
+    {
+        if (mask[i])
+            encoder.Add(i);
+    }
+}
+
+TEST(RoundTrip)
+{
+    std::mt19937 Generator(25);
+
+    for (size_t Count : { 1, 7, 8, 9, 23, 24, 25, 1000, 12345 })
+    {
+        for (double Density : { 0., 0.001, 0.1, 0.5, 0.9, 1. })
+        {
+            std::bernoulli_distribution Distribution(Density);
+
+            std::vector<bool> Mask(Count);
+
+            for (size_t i = 0; i < Count; ++i)
+                Mask[i] = Distribution(Generator);
+
+            MaskEncoder Encoder;
+
+            Encode(Mask, Encoder);
+
+            CHECK(Decode(Encoder.EncodeRuns()) == Mask);
+            CHECK(Decode(Encoder.EncodeBits()) == Mask);
+            CHECK(Decode(Encoder.Encode()) == Mask);
+        }
+    }
+}
+
+TEST(ChoosesTheSmallerEncoding)
+{
+    std::mt19937 Generator(3);
+
+    size_t RunsCount = 0, BitsCount = 0;
+
+    for (double Density : { 0.001, 0.01, 0.1, 0.3, 0.5, 0.99 })
+    {
+        std::bernoulli_distribution Distribution(Density);
+
+        std::vector<bool> Mask(5000);
+
+        for (size_t i = 0; i < Mask.size(); ++i)
+            Mask[i] = Distribution(Generator);
+
+        MaskEncoder Encoder;
+
+        Encode(Mask, Encoder);
+
+        const std::wstring Runs = Encoder.EncodeRuns();
+        const std::wstring Bits = Encoder.EncodeBits();
+        const std::wstring Text = Encoder.Encode();
+
+        // The estimated lengths differ by the same amount as the actual encodings.
+        CHECK((ptrdiff_t) Encoder.GetRunsLength() - (ptrdiff_t) Encoder.GetBitsLength() == (ptrdiff_t) Runs.size() - (ptrdiff_t) Bits.size());
+
+        CHECK(Text.size() == std::min(Runs.size(), Bits.size()));
+
+        if (Text == Runs)
+            ++RunsCount;
+        else
+            ++BitsCount;
+    }
+
+    // Sparse and nearly full masks use runs, scattered masks use bits.
+    CHECK((RunsCount != 0) && (BitsCount != 0));
+}
+
+TEST(MergesAdjacentRuns)
+{
+    MaskEncoder Encoder;
+
+    Encoder.Reset(100);
+
+    Encoder.AddRun(10, 5);
+    Encoder.AddRun(15, 5);
+    Encoder.Add(20);
+    Encoder.AddRun(30, 0);
+    Encoder.Add(40);
+
+    CHECK(Encoder.GetRunCount() == 2);
+    CHECK(Encoder.EncodeRuns() == L"{\"Count\":100,\"Runs\":[10,11,40,1]}");
+}
+
+TEST(KnownEncodings)
+{
+    MaskEncoder Encoder;
+
+    Encoder.Reset(0);
+
+    CHECK(Encoder.EncodeRuns() == L"{\"Count\":0,\"Runs\":[]}");
+    CHECK(Encoder.EncodeBits() == L"{\"Count\":0,\"Bits\":\"\"}");
+    CHECK(Encoder.Encode() == L"{\"Count\":0,\"Runs\":[]}"); // Runs win a tie.
+
+    // Items 0, 2 and 9: bytes 0x05 0x02
+    Encoder.Reset(16);
+
+    Encoder.Add(0);
+    Encoder.Add(2);
+    Encoder.Add(9);
+
+    CHECK(Encoder.EncodeBits() == L"{\"Count\":16,\"Bits\":\"BQI=\"}");
+}
+
+int main() { return RunTests(); }
@@ -0,0 +1,222 @@
+
+/** $VER: OnsetTests.cpp (2026.10.17) P. Stuer - Tests the onset detector and the tempo tracker. **/
+
+#include "Test.h"
+
+#include "OnsetDetector.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+static const uint32_t SampleRate = 44100;
+
+/// <summary>
+/// Creates a stereo click train: short bursts of noise at the specified tempo on a quiet noise floor.
+/// </summary>
+static std::vector<float> ClickTrain(double tempo, double duration, size_t & interval)
+{
+    std::mt19937 Generator(7);
+    std::uniform_real_distribution<float> Distribution(-1.f, 1.f);
+
+    const size_t FrameCount = (size_t) (duration * SampleRate);
+    const size_t BurstSize = SampleRate / 100; // 10 ms
+
+    interval = (size_t) std::lround(60. * SampleRate / tempo);
+
+    std::vector<float> Samples(FrameCount * 2);
+
+    for (size_t i = 0; i < FrameCount; ++i)
+    {
+        const float Level = ((i % interval) < BurstSize) ? 0.8f : 0.001f;
+
+        Samples[(i * 2) + 0] = Samples[(i * 2) + 1] = Level * Distribution(Generator);
+    }
+
+    return Samples;
+}
+
+/// <summary>
+/// Feeds the samples in chunks of varying size, the way the visualization receives them.
+/// </summary>
+template<typename T>
+static std::vector<onset_event_t> Detect(OnsetDetector & detector, const std::vector<T> & samples, uint32_t channelCount)
+{
+    std::vector<onset_event_t> Events;
+
+    const size_t FrameCount = samples.size() / channelCount;
+
+    for (size_t i = 0, n = 0; i < FrameCount; ++n)
+    {
+        const size_t Count = std::min((size_t) 700 + (n % 5) * 311, FrameCount - i);
+
+        detector.Process(samples.data() + (i * channelCount), Count, Events);
+
+        i += Count;
+    }
+
+    return Events;
+}
+
+TEST(DetectsClicks)
+{
+    size_t Interval;
+
+    const auto Samples = ClickTrain(120., 10., Interval);
+
+    OnsetDetector Detector;
+
+    Detector.Initialize(SampleRate, 2);
+
+    const auto Events = Detect(Detector, Samples, 2);
+
+    size_t OnsetCount = 0;
+
+    for (const auto & Event : Events)
+    {
+        if (Event.Type != OnsetType::Onset)
+            continue;
+
+        ++OnsetCount;
+
+        // Each onset is reported within an analysis frame of the start of a click.
+        const size_t Offset = (size_t) (Event.Position % Interval);
+
+        CHECK((Offset < 2048) || (Interval - Offset < 1024));
+        CHECK((Event.Strength > 0.f) && (Event.Strength <= 1.f));
+        CHECK((Event.Confidence >= 0.f) && (Event.Confidence <= 1.f));
+    }
+
+    // The first click falls before the adaptive threshold has enough history.
+    CHECK((OnsetCount >= 18) && (OnsetCount <= 20));
+}
+
+TEST(TracksTempo)
+{
+    for (double Tempo : { 70., 90., 100., 120., 135., 150., 160. })
+    {
+        size_t Interval;
+
+        const auto Samples = ClickTrain(Tempo, 12., Interval);
+
+        OnsetDetector Detector;
+
+        Detector.Initialize(SampleRate, 2);
+
+        const auto Events = Detect(Detector, Samples, 2);
+
+        CHECK_NEAR(Detector.GetTempo(), Tempo, Tempo * 0.03);
+        CHECK(Detector.GetTempoConfidence() > 0.1);
+
+        // Once the tempo is known the beats follow the clicks.
+        size_t BeatCount = 0;
+
+        for (const auto & Event : Events)
+        {
+            if ((Event.Type != OnsetType::Beat) || (Event.Position < 6 * SampleRate))
+                continue;
+
+            ++BeatCount;
+
+            const size_t Offset = (size_t) (Event.Position % Interval);
+            const size_t Distance = std::min(Offset, Interval - Offset);
+
+            CHECK(Distance < 2048);
+            CHECK_NEAR(Event.Tempo, Tempo, Tempo * 0.03);
+        }
+
+        const size_t Expected = (size_t) (6. * Tempo / 60.);
+
+        CHECK((BeatCount + 2 >= Expected) && (BeatCount <= Expected + 2));
+    }
+}
+
+TEST(PrefersTheTempoClosestTo120)
+{
+    // A click train is periodic at every multiple of its period. Above 120 * sqrt(2) BPM the prior prefers half the tempo.
+    size_t Interval;
+
+    const auto Samples = ClickTrain(190., 12., Interval);
+
+    OnsetDetector Detector;
+
+    Detector.Initialize(SampleRate, 2);
+
+    Detect(Detector, Samples, 2);
+
+    CHECK_NEAR(Detector.GetTempo(), 95., 95. * 0.03);
+}
+
+TEST(SilenceHasNoEvents)
+{
+    const std::vector<float> Samples(SampleRate * 2 * 5);
+
+    OnsetDetector Detector;
+
+    Detector.Initialize(SampleRate, 2);
+
+    const auto Events = Detect(Detector, Samples, 2);
+
+    CHECK(Events.empty());
+    CHECK(Detector.GetTempo() == 0.);
+}
+
+TEST(DoubleSamplesMatchFloatSamples)
+{
+    size_t Interval;
+
+    const auto Floats = ClickTrain(120., 5., Interval);
+    const std::vector<double> Doubles(Floats.begin(), Floats.end());
+
+    OnsetDetector a, b;
+
+    a.Initialize(SampleRate, 2);
+    b.Initialize(SampleRate, 2);
+
+    const auto EventsA = Detect(a, Floats, 2);
+    const auto EventsB = Detect(b, Doubles, 2);
+
+    CHECK(EventsA.size() == EventsB.size());
+
+    for (size_t i = 0; i < std::min(EventsA.size(), EventsB.size()); ++i)
+        CHECK((EventsA[i].Type == EventsB[i].Type) && (EventsA[i].Position == EventsB[i].Position));
+}
+
+TEST(ResetRestartsTheStream)
+{
+    size_t Interval;
+
+    const auto Samples = ClickTrain(120., 5., Interval);
+
+    OnsetDetector Detector;
+
+    Detector.Initialize(SampleRate, 2);
+
+    const auto First = Detect(Detector, Samples, 2);
+
+    Detector.Reset();
+
+    CHECK(Detector.GetTempo() == 0.);
+
+    const auto Second = Detect(Detector, Samples, 2);
+
+    CHECK(First.size() == Second.size());
+
+    for (size_t i = 0; i < std::min(First.size(), Second.size()); ++i)
+        CHECK(First[i].Position == Second[i].Position);
+}
+
+TEST(IsInitialized)
+{
+    OnsetDetector Detector;
+
+    CHECK(!Detector.IsInitialized(SampleRate, 2));
+
+    Detector.Initialize(SampleRate, 2);
+
+    CHECK(Detector.IsInitialized(SampleRate, 2));
+    CHECK(!Detector.IsInitialized(48000, 2));
+    CHECK(!Detector.IsInitialized(SampleRate, 1));
+}
+
+int main() { return RunTests(); }
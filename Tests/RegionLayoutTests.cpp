@@ -0,0 +1,221 @@
+
+/** $VER: RegionLayoutTests.cpp (2026.10.17) P. Stuer - Tests the region layout and its descriptor table. **/
+
+#include "Test.h"
+
+#include "RegionLayout.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Reads a little-endian value from a buffer, the way a script reads the descriptor table with a DataView.
+/// </summary>
+template<typename T>
+static T Read(const std::vector<uint8_t> & buffer, size_t offset)
+{
+    T Value = 0;
+
+    for (size_t i = 0; i < sizeof(T); ++i)
+        Value |= (T) ((T) buffer[offset + i] << (8 * i));
+
+    return Value;
+}
+
+/// <summary>
+/// Creates a layout with a few typical regions.
+/// </summary>
+static void CreateLayout(RegionLayout & layout)
+{
+    layout.Reset(40);
+
+    CHECK(layout.Add(1, "Samples",  1, 0x0001, 4096 * 8));
+    CHECK(layout.Add(2, "Spectrum", 2, 0x0000, 100 * 4, 4));
+    CHECK(layout.Add(3, "Loudness", 3, 0x8000, 52, 8));
+    CHECK(layout.Add(4, "Exactly15Chars_", 4, 0x0000, 1, 64));
+}
+
+TEST(AssignsAlignedOffsets)
+{
+    RegionLayout Layout;
+
+    CreateLayout(Layout);
+
+    const size_t Size = Layout.Finish();
+
+    CHECK(Layout.GetTableOffset() == 40);
+    CHECK(Layout.GetTableSize() == 4 * sizeof(region_t));
+    CHECK(Size == Layout.GetSize());
+    CHECK((Size % RegionLayout::DefaultAlignment) == 0);
+
+    const auto & Regions = Layout.GetRegions();
+
+    // The first region follows the header and the table.
+    CHECK(Regions[0].Offset == 176);
+    CHECK((Regions[1].Offset % 4) == 0);
+    CHECK((Regions[2].Offset % 8) == 0);
+    CHECK((Regions[3].Offset % 64) == 0);
+
+    // The regions don't overlap and fit in the buffer.
+    for (size_t i = 1; i < Regions.size(); ++i)
+        CHECK(Regions[i].Offset >= Regions[i - 1].Offset + Regions[i - 1].Size);
+
+    CHECK(Regions.back().Offset + Regions.back().Size <= Size);
+}
+
+TEST(TableRoundTrip)
+{
+    RegionLayout Layout;
+
+    CreateLayout(Layout);
+
+    std::vector<uint8_t> Buffer(Layout.Finish(), 0xCD);
+
+    Layout.WriteTable(Buffer.data());
+
+    // The bytes before the table are left alone.
+    CHECK(Buffer[39] == 0xCD);
+
+    for (size_t i = 0; i < Layout.GetRegions().size(); ++i)
+    {
+        const auto & Region = Layout.GetRegions()[i];
+
+        const size_t Offset = Layout.GetTableOffset() + (i * sizeof(region_t));
+
+        CHECK(Read<uint8_t> (Buffer, Offset +  0) == Region.Id);
+        CHECK(Read<uint8_t> (Buffer, Offset +  1) == Region.Format);
+        CHECK(Read<uint16_t>(Buffer, Offset +  2) == Region.Flags);
+        CHECK(Read<uint32_t>(Buffer, Offset +  4) == Region.Offset);
+        CHECK(Read<uint32_t>(Buffer, Offset +  8) == Region.Size);
+        CHECK(Read<uint32_t>(Buffer, Offset + 12) == Region.Count);
+
+        // The name is zero-padded and zero-terminated.
+        const std::string Name((const char *) &Buffer[Offset + 16]);
+
+        CHECK(Name == Region.Name);
+
+        for (size_t j = Name.size(); j < 16; ++j)
+            CHECK(Buffer[Offset + 16 + j] == 0);
+    }
+
+    // A reader of the buffer finds the same regions by name.
+    for (const auto & Region : Layout.GetRegions())
+    {
+        const region_t * Found = RegionLayout::Find(Buffer.data(), Layout.GetTableOffset(), Layout.GetRegions().size(), Region.Name);
+
+        CHECK((Found != nullptr) && (::memcmp(Found, &Region, sizeof(region_t)) == 0));
+    }
+
+    CHECK(RegionLayout::Find(Buffer.data(), Layout.GetTableOffset(), Layout.GetRegions().size(), "Stereo") == nullptr);
+}
+
+TEST(Find)
+{
+    RegionLayout Layout;
+
+    CreateLayout(Layout);
+    Layout.Finish();
+
+    CHECK((Layout.Find((uint8_t) 2) != nullptr) && (::strcmp(Layout.Find((uint8_t) 2)->Name, "Spectrum") == 0));
+    CHECK((Layout.Find("Loudness") != nullptr) && (Layout.Find("Loudness")->Id == 3));
+    CHECK(Layout.Find((uint8_t) 9) == nullptr);
+    CHECK(Layout.Find("Spectrum2") == nullptr);
+    CHECK(Layout.Find("Spec") == nullptr);
+}
+
+TEST(SetCountAndFlags)
+{
+    RegionLayout Layout;
+
+    CreateLayout(Layout);
+
+    std::vector<uint8_t> Buffer(Layout.Finish(), 0);
+
+    CHECK(Layout.SetCount(2, 100));
+    CHECK(Layout.SetFlags(2, 0x0001));
+    CHECK(!Layout.SetCount(9, 1));
+    CHECK(!Layout.SetFlags(9, 1));
+
+    // The offsets are not affected.
+    const uint32_t Offset = Layout.Find((uint8_t) 2)->Offset;
+
+    CHECK((Layout.Find((uint8_t) 2)->Count == 100) && (Layout.Find((uint8_t) 2)->Flags == 0x0001) && (Layout.Find((uint8_t) 2)->Offset == Offset));
+
+    // The table in the buffer is a mirror: overwriting it does not change the layout and the next write restores it.
+    Layout.WriteTable(Buffer.data());
+
+    const size_t Entry = Layout.GetTableOffset() + sizeof(region_t);
+
+    CHECK(Read<uint32_t>(Buffer, Entry + 12) == 100);
+
+    ::memset(Buffer.data() + Layout.GetTableOffset(), 0xFF, Layout.GetTableSize());
+
+    CHECK(Layout.Find((uint8_t) 2)->Offset == Offset);
+
+    Layout.WriteTable(Buffer.data());
+
+    CHECK(Read<uint32_t>(Buffer, Entry + 4) == Offset);
+}
+
+TEST(RejectsInvalidRegions)
+{
+    RegionLayout Layout;
+
+    Layout.Reset(0);
+
+    CHECK(!Layout.Add(1, nullptr, 0, 0, 16));
+    CHECK(!Layout.Add(1, "", 0, 0, 16));
+    CHECK(!Layout.Add(1, "SixteenCharsLong", 0, 0, 16));
+    CHECK(!Layout.Add(1, "Odd", 0, 0, 16, 0));
+    CHECK(!Layout.Add(1, "Odd", 0, 0, 16, 12));
+
+    CHECK(Layout.Add(1, "Samples", 0, 0, 16));
+    CHECK(!Layout.Add(2, "Samples", 0, 0, 16));
+
+    if constexpr (sizeof(size_t) > sizeof(uint32_t))
+        CHECK(!Layout.Add(3, "Huge", 0, 0, (size_t) std::numeric_limits<uint32_t>::max() + 17));
+
+    CHECK(Layout.GetRegions().size() == 1);
+}
+
+TEST(RejectsLayoutsBeyond32Bits)
+{
+    RegionLayout Layout;
+
+    Layout.Reset(0);
+
+    CHECK(Layout.Add(1, "First",  0, 0, 0xC0000000u));
+    CHECK(Layout.Add(2, "Second", 0, 0, 0x40000000u));
+
+    CHECK(Layout.Finish() == 0);
+    CHECK(Layout.GetSize() == 0);
+}
+
+TEST(ResetAndAddInvalidateTheSize)
+{
+    RegionLayout Layout;
+
+    CreateLayout(Layout);
+
+    CHECK(Layout.Finish() != 0);
+
+    CHECK(Layout.Add(5, "Stereo", 0, 0, 32));
+    CHECK(Layout.GetSize() == 0);
+
+    // Adding a region moves the others because the table grows.
+    const uint32_t Offset = Layout.GetRegions()[0].Offset;
+
+    Layout.Finish();
+
+    CHECK(Layout.GetRegions()[0].Offset == Offset + sizeof(region_t));
+
+    Layout.Reset(8);
+
+    CHECK(Layout.GetRegions().empty());
+    CHECK(Layout.GetSize() == 0);
+    CHECK(Layout.Finish() == 16);
+}
+
+int main() { return RunTests(); }
@@ -0,0 +1,76 @@
+
+/** $VER: SampleConverterBenchmark.cpp (2026.10.17) P. Stuer - Compares the conversion kernels of the sample converter. **/
+
+#include "Benchmark.h"
+
+#include "SampleConverter.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+int main()
+{
+    const size_t SampleCount = 4096; // About 85 ms at 48 kHz, a typical chunk of the visualisation stream.
+    const uint32_t ChannelCount = 2;
+
+    std::mt19937 Generator(1);
+    std::uniform_real_distribution<float> Distribution(-1.f, 1.f);
+
+    std::vector<float> Samples(SampleCount * ChannelCount);
+
+    for (auto & Sample : Samples)
+        Sample = Distribution(Generator);
+
+    std::vector<uint8_t> Data(SampleCount * ChannelCount * sizeof(double));
+
+    const struct { SampleFormat Format; const char * Name; } Formats[] =
+    {
+        { SampleFormat::Float64,       "float64" },
+        { SampleFormat::Float32,       "float32" },
+        { SampleFormat::Float32Planar, "float32 planar" },
+        { SampleFormat::Int16,         "int16" },
+    };
+
+    const struct { InstructionSet Set; const char * Name; } InstructionSets[] =
+    {
+        { InstructionSet::Scalar, "Scalar" },
+        { InstructionSet::SSE2,   "SSE2" },
+        { InstructionSet::AVX2,   "AVX2" },
+    };
+
+    std::printf("%zu stereo samples, us per conversion\n\n%-16s", SampleCount, "format");
+
+    for (const auto & Item : InstructionSets)
+        std::printf("%10s", Item.Name);
+
+    std::printf("\n");
+
+    for (const auto & Format : Formats)
+    {
+        std::printf("%-16s", Format.Name);
+
+        for (const auto & Item : InstructionSets)
+        {
+            SampleConverter::SetInstructionSet(Item.Set);
+
+            if (SampleConverter::GetInstructionSet() != Item.Set)
+            {
+                std::printf("%10s", "n/a");
+                continue;
+            }
+
+            const double Time = Measure([&]()
+            {
+                SampleConverter::Convert(Samples.data(), SampleCount, ChannelCount, Format.Format, SampleCount, Data.data());
+                Escape(Data.data());
+            });
+
+            std::printf("%10.2f", Time);
+        }
+
+        std::printf("\n");
+    }
+
+    return 0;
+}
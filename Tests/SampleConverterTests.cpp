@@ -0,0 +1,192 @@
+
+/** $VER: SampleConverterTests.cpp (2026.10.17) P. Stuer - Tests the sample converter. **/
+
+#include "Test.h"
+
+#include "SampleConverter.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const SampleFormat Formats[] = { SampleFormat::Float64, SampleFormat::Float32, SampleFormat::Float32Planar, SampleFormat::Int16 };
+
+// Odd lengths and lengths just below and above the 4, 8 and 16 sample blocks of the kernels so every tail is exercised.
+static const size_t SampleCounts[] = { 0, 1, 2, 3, 5, 7, 9, 15, 17, 31, 33, 1023 };
+
+static const uint8_t Guard = 0xA5;
+static const size_t GuardSize = 64;
+
+/// <summary>
+/// Creates interleaved samples that include out-of-range values, the clipping boundaries and values halfway between two int16 steps.
+/// </summary>
+static std::vector<float> Generate(size_t count, uint32_t seed)
+{
+    std::mt19937 Generator(seed);
+    std::uniform_real_distribution<float> Distribution(-1.5f, 1.5f);
+
+    const float Specials[] = { 0.f, -0.f, 1.f, -1.f, 2.f, -2.f, 0.5f, -0.5f, 1.5f / 32767.f, -2.5f / 32767.f };
+
+    std::vector<float> Samples(count);
+
+    for (size_t i = 0; i < count; ++i)
+        Samples[i] = ((i % 5) == 0) ? Specials[(i / 5) % std::size(Specials)] : Distribution(Generator);
+
+    return Samples;
+}
+
+/// <summary>
+/// Converts the samples with the specified instruction set. The output is followed by guard bytes to detect overruns.
+/// </summary>
+template<typename T>
+static std::vector<uint8_t> Convert(InstructionSet instructionSet, const std::vector<T> & samples, uint32_t channelCount, SampleFormat format, size_t stride)
+{
+    SampleConverter::SetInstructionSet(instructionSet);
+
+    const size_t SampleCount = samples.size() / channelCount;
+    const size_t Size = SampleConverter::GetSampleSize(format) * ((format == SampleFormat::Float32Planar) ? stride * channelCount : samples.size());
+
+    std::vector<uint8_t> Data(Size + GuardSize, Guard);
+
+    SampleConverter::Convert(samples.data(), SampleCount, channelCount, format, stride, Data.data());
+
+    return Data;
+}
+
+/// <summary>
+/// Gets the instruction sets supported by this CPU.
+/// </summary>
+static std::vector<InstructionSet> GetInstructionSets()
+{
+    const InstructionSet Best = SampleConverter::GetInstructionSet();
+
+    std::vector<InstructionSet> InstructionSets;
+
+    for (InstructionSet Set : { InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2 })
+    {
+        SampleConverter::SetInstructionSet(Set);
+
+        if (SampleConverter::GetInstructionSet() == Set)
+            InstructionSets.push_back(Set);
+    }
+
+    SampleConverter::SetInstructionSet(Best);
+
+    return InstructionSets;
+}
+
+TEST(ScalarValues)
+{
+    const std::vector<float> Samples = { 0.f, 1.f, -1.f, 2.f, -2.f, 0.5f, -0.25f };
+
+    auto Data = Convert(InstructionSet::Scalar, Samples, 1, SampleFormat::Int16, 0);
+
+    int16_t Values[7];
+
+    std::memcpy(Values, Data.data(), sizeof(Values));
+
+    CHECK(Values[0] == 0);
+    CHECK(Values[1] == 32767);
+    CHECK(Values[2] == -32767);
+    CHECK(Values[3] == 32767);
+    CHECK(Values[4] == -32767);
+    CHECK(Values[5] == 16384); // 16383.5 rounds to even.
+    CHECK(Values[6] == -8192); // -8191.75
+
+    Data = Convert(InstructionSet::Scalar, Samples, 1, SampleFormat::Float64, 0);
+
+    double Doubles[7];
+
+    std::memcpy(Doubles, Data.data(), sizeof(Doubles));
+
+    for (size_t i = 0; i < std::size(Doubles); ++i)
+        CHECK(Doubles[i] == (double) Samples[i]);
+
+    CHECK(Data[sizeof(Doubles)] == Guard);
+}
+
+TEST(Planar)
+{
+    const std::vector<float> Samples = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f }; // 3 samples, 3 channels
+
+    const size_t Stride = 5;
+
+    for (InstructionSet Set : GetInstructionSets())
+    {
+        const auto Data = Convert(Set, Samples, 3, SampleFormat::Float32Planar, Stride);
+
+        const float * p = (const float *) Data.data();
+
+        for (size_t Channel = 0; Channel < 3; ++Channel)
+            for (size_t i = 0; i < 3; ++i)
+                CHECK(p[(Channel * Stride) + i] == Samples[(i * 3) + Channel]);
+
+        // The gap between the channels is not written.
+        CHECK(Data[(3 * sizeof(float))] == Guard);
+        CHECK(Data[(Stride + 3) * sizeof(float)] == Guard);
+    }
+}
+
+TEST(KernelsMatchScalar)
+{
+    const auto InstructionSets = GetInstructionSets();
+
+    std::printf("  Instruction sets:");
+
+    for (InstructionSet Set : InstructionSets)
+        std::printf(" %s", (Set == InstructionSet::AVX2) ? "AVX2" : (Set == InstructionSet::SSE2) ? "SSE2" : "Scalar");
+
+    std::printf("\n");
+
+    for (uint32_t ChannelCount : { 1u, 2u, 3u, 6u })
+    {
+        for (size_t SampleCount : SampleCounts)
+        {
+            const auto Samples = Generate(SampleCount * ChannelCount, (uint32_t) (SampleCount * 10 + ChannelCount));
+
+            const size_t Stride = SampleCount + 3;
+
+            for (SampleFormat Format : Formats)
+            {
+                const auto Expected = Convert(InstructionSet::Scalar, Samples, ChannelCount, Format, Stride);
+
+                for (InstructionSet Set : InstructionSets)
+                {
+                    const auto Data = Convert(Set, Samples, ChannelCount, Format, Stride);
+
+                    const bool IsEqual = (Data == Expected);
+
+                    if (!IsEqual)
+                        std::printf("  Instruction set %u, format %u, %u channels, %zu samples\n", (uint32_t) Set, (uint32_t) Format, ChannelCount, SampleCount);
+
+                    CHECK(IsEqual);
+                }
+            }
+        }
+    }
+
+    SampleConverter::SetInstructionSet(InstructionSets.back());
+}
+
+TEST(DoubleSamples)
+{
+    for (size_t SampleCount : SampleCounts)
+    {
+        const auto Floats = Generate(SampleCount * 2, (uint32_t) SampleCount);
+
+        const std::vector<double> Doubles(Floats.begin(), Floats.end());
+
+        for (SampleFormat Format : Formats)
+        {
+            // The float samples are exact copies so both overloads have to produce the same output.
+            const auto Expected = Convert(InstructionSet::Scalar, Floats, 2, Format, SampleCount);
+            const auto Data     = Convert(InstructionSet::Scalar, Doubles, 2, Format, SampleCount);
+
+            CHECK(Data == Expected);
+        }
+    }
+
+    SampleConverter::SetInstructionSet(InstructionSet::AVX2);
+}
+
+int main() { return RunTests(); }
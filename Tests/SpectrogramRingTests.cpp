@@ -0,0 +1,234 @@
+
+/** $VER: SpectrogramRingTests.cpp (2026.10.17) P. Stuer - Tests the spectrogram ring. **/
+
+#include "Test.h"
+
+#include "SpectrogramRing.h"
+
+#include <cstring>
+#include <vector>
+
+static const uint8_t Guard = 0xA5;
+static const size_t GuardSize = 256;
+
+/// <summary>
+/// Gets a row of the ring in the buffer.
+/// </summary>
+static const spectrogram_row_t * GetRow(const std::vector<uint8_t> & buffer, const SpectrogramRing & ring, size_t index)
+{
+    return (const spectrogram_row_t *) (buffer.data() + ring.GetRowsOffset() + (index * ring.GetRowSize()));
+}
+
+TEST(RowCountFromBudget)
+{
+    // 100 bands, 2 channels: 64 + 400 bytes before the rows, 16 + 800 bytes per row.
+    spectrogram_layout_t Layout = { 100, 2, 48000, 1 << 20 };
+
+    CHECK(SpectrogramRing::GetRowsOffset(Layout) == 464);
+    CHECK(SpectrogramRing::GetRowSize(Layout) == 816);
+    CHECK(SpectrogramRing::GetRowCount(Layout) == ((1 << 20) - 464) / 816);
+    CHECK(SpectrogramRing::GetSize(Layout) <= Layout.MemoryBudget);
+
+    // Rows and the frequencies are padded to 16 bytes.
+    Layout = { 3, 1, 48000, 1 << 20 };
+
+    CHECK(SpectrogramRing::GetRowsOffset(Layout) == 64 + 16);
+    CHECK(SpectrogramRing::GetRowSize(Layout) == 16 + 16);
+
+    // A budget that holds exactly two rows.
+    Layout = { 100, 2, 48000, 464 + (2 * 816) };
+
+    CHECK(SpectrogramRing::GetRowCount(Layout) == 2);
+    CHECK(SpectrogramRing::GetSize(Layout) == Layout.MemoryBudget);
+
+    Layout.MemoryBudget -= 1;
+
+    CHECK(SpectrogramRing::GetRowCount(Layout) == 1);
+
+    // Budgets smaller than the header and empty layouts have no rows.
+    Layout = { 100, 2, 48000, 100 };
+
+    CHECK(SpectrogramRing::GetRowCount(Layout) == 0);
+
+    Layout = { 0, 2, 48000, 1 << 20 };
+
+    CHECK(SpectrogramRing::GetRowCount(Layout) == 0);
+
+    Layout = { 100, 0, 48000, 1 << 20 };
+
+    CHECK(SpectrogramRing::GetRowCount(Layout) == 0);
+}
+
+TEST(Initialize)
+{
+    const spectrogram_layout_t Layout = { 10, 2, 44100, 64 + 48 + (3 * (16 + 80)) };
+
+    std::vector<uint8_t> Buffer(SpectrogramRing::GetSize(Layout));
+
+    SpectrogramRing Ring;
+
+    CHECK(Ring.Initialize(Layout, Buffer.data()));
+
+    const auto * Header = (const spectrogram_header_t *) Buffer.data();
+
+    CHECK(Header->Magic == spectrogram_header_t::CurrentMagic);
+    CHECK(Header->Version == spectrogram_header_t::CurrentVersion);
+    CHECK(Header->Size == sizeof(spectrogram_header_t));
+    CHECK(Header->RowCount == 3);
+    CHECK(Header->BandCount == 10);
+    CHECK(Header->ChannelCount == 2);
+    CHECK(Header->RowSize == 16 + 80);
+    CHECK(Header->FrequenciesOffset == sizeof(spectrogram_header_t));
+    CHECK(Header->RowsOffset == 64 + 48);
+    CHECK(Header->SampleRate == 44100);
+    CHECK(Header->WriteIndex == 0);
+    CHECK(Header->RowsWritten == 0);
+    CHECK((Header->RowSize % 16) == 0);
+
+    CHECK(Ring.GetLayout() == Layout);
+
+    // Budgets with less than two rows are rejected.
+    SpectrogramRing Small;
+
+    CHECK(!Small.Initialize({ 10, 2, 44100, 64 + 48 + 16 + 80 }, Buffer.data()));
+    CHECK(Small.GetRowCount() == 0);
+}
+
+TEST(Wrap)
+{
+    const spectrogram_layout_t Layout = { 5, 2, 48000, 4096 };
+
+    const size_t RowCount = SpectrogramRing::GetRowCount(Layout);
+    const size_t Size = SpectrogramRing::GetSize(Layout);
+
+    std::vector<uint8_t> Buffer(Size + GuardSize, Guard);
+
+    SpectrogramRing Ring;
+
+    CHECK(Ring.Initialize(Layout, Buffer.data()));
+    CHECK(Ring.GetRowCount() == RowCount);
+
+    const float Frequencies[5] = { 100.f, 200.f, 400.f, 800.f, 1600.f };
+
+    const auto * Header = (const spectrogram_header_t *) Buffer.data();
+
+    const size_t WriteCount = (RowCount * 2) + 3;
+
+    for (size_t i = 0; i < WriteCount; ++i)
+    {
+        float Spectrum[10];
+
+        for (size_t j = 0; j < std::size(Spectrum); ++j)
+            Spectrum[j] = (float) ((i * 100) + j);
+
+        const uint32_t Sequence = Header->Sequence;
+
+        Ring.WriteRow(Frequencies, Spectrum, (uint16_t) (i & 1), (double) i * 0.01);
+
+        // The sequence number is even between updates and advances by 2 per row.
+        CHECK(Header->Sequence == Sequence + 2);
+        CHECK((Header->Sequence & 1) == 0);
+
+        CHECK(Header->WriteIndex == (i + 1) % RowCount);
+        CHECK(Header->RowsWritten == i + 1);
+        CHECK(Header->Flags == (i & 1));
+    }
+
+    CHECK(Ring.GetWriteIndex() == WriteCount % RowCount);
+    CHECK(Ring.GetRowsWritten() == WriteCount);
+
+    // Every row holds one of the last RowCount frames, the newest just before the write index.
+    for (size_t Index = 0; Index < RowCount; ++Index)
+    {
+        const auto * Row = GetRow(Buffer, Ring, Index);
+
+        const size_t Age = (Ring.GetWriteIndex() + RowCount - 1 - Index) % RowCount;
+        const size_t RowNumber = WriteCount - 1 - Age;
+
+        CHECK(Row->RowNumber == RowNumber);
+        CHECK(Row->PlaybackTime == (double) RowNumber * 0.01);
+
+        const auto * Magnitudes = (const float *) (Row + 1);
+
+        CHECK(Magnitudes[0] == (float) (RowNumber * 100));
+        CHECK(Magnitudes[9] == (float) ((RowNumber * 100) + 9));
+    }
+
+    CHECK(std::memcmp(Buffer.data() + sizeof(spectrogram_header_t), Frequencies, sizeof(Frequencies)) == 0);
+
+    for (size_t i = Size; i < Buffer.size(); ++i)
+        CHECK(Buffer[i] == Guard);
+}
+
+TEST(IgnoresHeaderWrites)
+{
+    // A script that writes to the header can not move the rows outside the buffer.
+    const spectrogram_layout_t Layout = { 5, 2, 48000, 1024 };
+
+    const size_t Size = SpectrogramRing::GetSize(Layout);
+
+    std::vector<uint8_t> Buffer(Size + GuardSize, Guard);
+
+    SpectrogramRing Ring;
+
+    CHECK(Ring.Initialize(Layout, Buffer.data()));
+
+    const float Frequencies[5] = { };
+    const float Spectrum[10] = { };
+
+    auto * Header = (spectrogram_header_t *) Buffer.data();
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        Header->WriteIndex  = 0xFFFFFFFF;
+        Header->RowsOffset  = 0xFFFFFFF0;
+        Header->RowSize     = 0xFFFF;
+        Header->RowsWritten = 0;
+
+        Ring.WriteRow(Frequencies, Spectrum, 0, 0.);
+
+        CHECK(Header->WriteIndex == Ring.GetWriteIndex());
+        CHECK(Header->RowsWritten == i + 1);
+    }
+
+    for (size_t i = Size; i < Buffer.size(); ++i)
+        CHECK(Buffer[i] == Guard);
+}
+
+TEST(Reinitialize)
+{
+    const spectrogram_layout_t Layout = { 5, 2, 48000, 1024 };
+
+    std::vector<uint8_t> Buffer(SpectrogramRing::GetSize(Layout));
+
+    SpectrogramRing Ring;
+
+    Ring.Initialize(Layout, Buffer.data());
+
+    const float Frequencies[5] = { };
+    const float Spectrum[10] = { };
+
+    Ring.WriteRow(Frequencies, Spectrum, 0, 0.);
+    Ring.WriteRow(Frequencies, Spectrum, 0, 0.);
+
+    const uint32_t Sequence = ((const spectrogram_header_t *) Buffer.data())->Sequence;
+
+    // A new ring starts empty but the sequence number keeps counting.
+    std::vector<uint8_t> NewBuffer(SpectrogramRing::GetSize(Layout));
+
+    Ring.Initialize(Layout, NewBuffer.data());
+
+    const auto * Header = (const spectrogram_header_t *) NewBuffer.data();
+
+    CHECK(Header->Sequence == Sequence);
+    CHECK(Header->RowsWritten == 0);
+    CHECK(Ring.GetWriteIndex() == 0);
+
+    // A ring without a buffer ignores rows.
+    Ring.Reset();
+    Ring.WriteRow(Frequencies, Spectrum, 0, 0.);
+
+    CHECK(Ring.GetRowsWritten() == 0);
+}
+
+int main() { return RunTests(); }
@@ -0,0 +1,219 @@
+
+/** $VER: SpectrumTests.cpp (2026.10.17) P. Stuer - Tests the FFT and the spectrum analyzer. **/
+
+#include "Test.h"
+
+#include "FFT.h"
+#include "SpectrumAnalyzer.h"
+
+#include <algorithm>
+#include <numbers>
+#include <random>
+
+/// <summary>
+/// Computes the spectrum of real-valued data with a naive DFT.
+/// </summary>
+static std::vector<std::complex<double>> DFT(const std::vector<float> & data)
+{
+    const size_t n = data.size();
+
+    std::vector<std::complex<double>> Bins((n / 2) + 1);
+
+    for (size_t k = 0; k < Bins.size(); ++k)
+    {
+        std::complex<double> Sum;
+
+        for (size_t i = 0; i < n; ++i)
+            Sum += (double) data[i] * std::polar(1., -2. * std::numbers::pi * (double) (k * i % n) / (double) n);
+
+        Bins[k] = Sum;
+    }
+
+    return Bins;
+}
+
+/// <summary>
+/// Creates a sine with the specified amplitude and frequency.
+/// </summary>
+static std::vector<float> Sine(size_t sampleCount, double amplitude, double frequency, uint32_t sampleRate)
+{
+    std::vector<float> Samples(sampleCount);
+
+    for (size_t i = 0; i < sampleCount; ++i)
+        Samples[i] = (float) (amplitude * std::sin(2. * std::numbers::pi * frequency * (double) i / (double) sampleRate));
+
+    return Samples;
+}
+
+TEST(ValidSizes)
+{
+    CHECK(!FFT::IsValidSize(0));
+    CHECK(!FFT::IsValidSize(2));
+    CHECK(!FFT::IsValidSize(100));
+    CHECK( FFT::IsValidSize(4));
+    CHECK( FFT::IsValidSize(4096));
+}
+
+TEST(TransformMatchesDFT)
+{
+    std::mt19937 Generator(1);
+    std::uniform_real_distribution<float> Distribution(-1.f, 1.f);
+
+    for (size_t Size : { 4, 8, 64, 1024 })
+    {
+        std::vector<float> Data(Size);
+
+        for (auto & Value : Data)
+            Value = Distribution(Generator);
+
+        FFT Transform;
+
+        Transform.Initialize(Size);
+
+        CHECK(Transform.GetSize() == Size);
+        CHECK(Transform.GetBinCount() == (Size / 2) + 1);
+
+        std::vector<std::complex<float>> Bins(Transform.GetBinCount());
+
+        Transform.Transform(Data.data(), Bins.data());
+
+        const auto Expected = DFT(Data);
+
+        double MaxError = 0.;
+
+        for (size_t k = 0; k < Bins.size(); ++k)
+            MaxError = std::max(MaxError, std::abs(std::complex<double>(Bins[k]) - Expected[k]));
+
+        // The error of a float FFT grows with log2(n) and the magnitude of the bins grows with sqrt(n).
+        CHECK_NEAR(MaxError, 0., 1e-4 * std::sqrt((double) Size));
+    }
+}
+
+TEST(InvalidSizeIsIgnored)
+{
+    FFT Transform;
+
+    Transform.Initialize(1000);
+
+    CHECK(Transform.GetSize() == 0);
+
+    Transform.Initialize(256);
+    Transform.Initialize(1000);
+
+    CHECK(Transform.GetSize() == 256);
+}
+
+TEST(FullScaleSineReadsZeroDecibel)
+{
+    const uint32_t SampleRate = 48000;
+
+    for (auto Window : { WindowFunction::Rectangular, WindowFunction::Hann, WindowFunction::BlackmanHarris, WindowFunction::FlatTop })
+    {
+        spectrum_settings_t Settings;
+
+        Settings.Window = Window;
+
+        SpectrumAnalyzer Analyzer;
+
+        Analyzer.Initialize(Settings, SampleRate);
+
+        CHECK(Analyzer.GetBandCount() == Settings.BandCount);
+
+        // The frequency of bin 256 so there is no leakage into the neighbouring bins.
+        const double Frequency = 256. * SampleRate / Settings.FFTSize;
+
+        const auto Samples = Sine(Settings.FFTSize, 1., Frequency, SampleRate);
+
+        std::vector<float> Bands(Analyzer.GetBandCount());
+
+        Analyzer.Process(Samples.data(), Samples.size(), 1, Bands.data());
+
+        const size_t Peak = (size_t) (std::max_element(Bands.begin(), Bands.end()) - Bands.begin());
+
+        CHECK_NEAR(Bands[Peak], 0., 0.1);
+
+        // The band with the peak is the band around the frequency of the sine.
+        CHECK(std::fabs(std::log2(Analyzer.GetCenterFrequency(Peak) / Frequency)) < 0.1);
+    }
+}
+
+TEST(LinearScaleReadsAmplitude)
+{
+    spectrum_settings_t Settings;
+
+    Settings.Layout = BandLayout::Linear;
+    Settings.Scale  = AmplitudeScale::Linear;
+
+    SpectrumAnalyzer Analyzer;
+
+    Analyzer.Initialize(Settings, 44100);
+
+    const double Frequency = 100. * 44100. / Settings.FFTSize;
+
+    const auto Samples = Sine(Settings.FFTSize, 0.5, Frequency, 44100);
+
+    std::vector<float> Bands(Analyzer.GetBandCount());
+
+    Analyzer.Process(Samples.data(), Samples.size(), 1, Bands.data());
+
+    CHECK_NEAR(*std::max_element(Bands.begin(), Bands.end()), 0.5, 0.005);
+}
+
+TEST(ChannelsAreAnalyzedSeparately)
+{
+    spectrum_settings_t Settings;
+
+    Settings.FFTSize = 1024;
+
+    SpectrumAnalyzer Analyzer;
+
+    Analyzer.Initialize(Settings, 48000);
+
+    // Left channel: sine, right channel: silence.
+    const auto Sine1 = Sine(Settings.FFTSize, 1., 64. * 48000. / Settings.FFTSize, 48000);
+
+    std::vector<double> Samples(Sine1.size() * 2);
+
+    for (size_t i = 0; i < Sine1.size(); ++i)
+        Samples[i * 2] = Sine1[i];
+
+    const size_t BandCount = Analyzer.GetBandCount();
+
+    std::vector<float> Bands(BandCount * 2);
+
+    Analyzer.Process(Samples.data(), Sine1.size(), 2, Bands.data());
+
+    CHECK_NEAR(*std::max_element(Bands.begin(), Bands.begin() + (ptrdiff_t) BandCount), 0., 0.1);
+    CHECK(*std::max_element(Bands.begin() + (ptrdiff_t) BandCount, Bands.end()) == SpectrumAnalyzer::MinDecibel);
+}
+
+TEST(BarkRoundTrip)
+{
+    for (double Frequency : { 20., 100., 1000., 8000., 20000. })
+        CHECK_NEAR(SpectrumAnalyzer::FromBark(SpectrumAnalyzer::ToBark(Frequency)), Frequency, Frequency * 1e-9);
+}
+
+TEST(BandsAreAscending)
+{
+    for (auto Layout : { BandLayout::Linear, BandLayout::Logarithmic, BandLayout::Bark })
+    {
+        spectrum_settings_t Settings;
+
+        Settings.Layout = Layout;
+
+        SpectrumAnalyzer Analyzer;
+
+        Analyzer.Initialize(Settings, 48000);
+
+        for (size_t i = 1; i < Analyzer.GetBandCount(); ++i)
+            CHECK(Analyzer.GetCenterFrequency(i) > Analyzer.GetCenterFrequency(i - 1));
+
+        CHECK(Analyzer.GetCenterFrequency(0) >= Settings.MinFrequency);
+        CHECK(Analyzer.GetCenterFrequency(Analyzer.GetBandCount() - 1) <= Settings.MaxFrequency);
+    }
+}
+
+int main()
+{
+    return RunTests();
+}
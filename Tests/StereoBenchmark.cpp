@@ -0,0 +1,70 @@
+
+/** $VER: StereoBenchmark.cpp (2026.10.17) P. Stuer - Times the stereo analyzer on a window of stereo samples. **/
+
+#include "Benchmark.h"
+
+#include "StereoAnalyzer.h"
+#include "SampleConverter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+int main()
+{
+    const double WindowDuration = 0.05; // 50 ms
+    const size_t PointCount = 512;
+
+    const double Left[2]  = { 1., 0. };
+    const double Right[2] = { 0., 1. };
+
+    StereoAnalyzer Analyzer;
+
+    Analyzer.Initialize(Left, Right, 2);
+
+    std::vector<stereo_point_t> Points(PointCount);
+
+    std::mt19937 Generator(1);
+    std::uniform_real_distribution<float> Distribution(-1.f, 1.f);
+
+    std::printf("%.0f ms windows, %zu points, us per window\n\n%-12s%10s%10s\n", WindowDuration * 1000., PointCount, "sample rate", "Scalar", "SSE2");
+
+    for (uint32_t SampleRate : { 48000u, 192000u })
+    {
+        const size_t FrameCount = (size_t) (SampleRate * WindowDuration);
+
+        std::vector<float> Samples(FrameCount * 2);
+
+        for (auto & Sample : Samples)
+            Sample = Distribution(Generator);
+
+        std::printf("%-12u", SampleRate);
+
+        for (InstructionSet Set : { InstructionSet::Scalar, InstructionSet::SSE2 })
+        {
+            SampleConverter::SetInstructionSet(Set);
+
+            if (SampleConverter::GetInstructionSet() != Set)
+            {
+                std::printf("%10s", "n/a");
+                continue;
+            }
+
+            stereo_t Values;
+
+            const double Time = Measure([&]()
+            {
+                Analyzer.Process(Samples.data(), FrameCount, Values, Points.data(), PointCount);
+                Escape(&Values);
+                Escape(Points.data());
+            });
+
+            std::printf("%10.2f", Time);
+        }
+
+        std::printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+
+/** $VER: StereoTests.cpp (2026.10.17) P. Stuer - Tests the stereo analyzer. **/
+
+#include "Test.h"
+
+#include "StereoAnalyzer.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+static const double Pi = 3.14159265358979323846;
+
+/// <summary>
+/// Creates interleaved stereo samples from a function that returns the left and right value of a frame.
+/// </summary>
+template<typename F>
+static std::vector<float> Generate(size_t frameCount, F f)
+{
+    std::vector<float> Samples(frameCount * 2);
+
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        double L, R;
+
+        f(i, L, R);
+
+        Samples[(i * 2) + 0] = (float) L;
+        Samples[(i * 2) + 1] = (float) R;
+    }
+
+    return Samples;
+}
+
+/// <summary>
+/// Initializes the analyzer for a plain stereo signal.
+/// </summary>
+static void InitializeStereo(StereoAnalyzer & analyzer)
+{
+    const double Left[2]  = { 1., 0. };
+    const double Right[2] = { 0., 1. };
+
+    analyzer.Initialize(Left, Right, 2);
+}
+
+static double Sine(size_t i) { return 0.5 * std::sin(2. * Pi * 1000. * (double) i / 48000.); }
+
+TEST(MonoSignal)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    const auto Samples = Generate(4800, [](size_t i, double & L, double & R) { L = R = Sine(i); });
+
+    stereo_t Values;
+
+    Analyzer.Process(Samples.data(), 4800, Values, nullptr, 0);
+
+    CHECK_NEAR(Values.Correlation, 1., 1e-6);
+    CHECK_NEAR(Values.Balance, 0., 1e-6);
+    CHECK_NEAR(Values.Width, 0., 1e-6);
+    CHECK_NEAR(Values.LeftRMS, 0.5 / std::sqrt(2.), 1e-4);
+    CHECK_NEAR(Values.MidRMS, Values.LeftRMS, 1e-6);
+    CHECK_NEAR(Values.SideRMS, 0., 1e-6);
+}
+
+TEST(OutOfPhaseSignal)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    const auto Samples = Generate(4800, [](size_t i, double & L, double & R) { L = Sine(i); R = -L; });
+
+    stereo_t Values;
+
+    Analyzer.Process(Samples.data(), 4800, Values, nullptr, 0);
+
+    CHECK_NEAR(Values.Correlation, -1., 1e-6);
+    CHECK_NEAR(Values.Balance, 0., 1e-6);
+    CHECK_NEAR(Values.Width, 1., 1e-6);
+    CHECK_NEAR(Values.MidRMS, 0., 1e-6);
+}
+
+TEST(UncorrelatedSignal)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    std::mt19937 Generator(12);
+    std::uniform_real_distribution<double> Distribution(-1., 1.);
+
+    const auto Samples = Generate(48000, [&](size_t, double & L, double & R) { L = Distribution(Generator); R = Distribution(Generator); });
+
+    stereo_t Values;
+
+    Analyzer.Process(Samples.data(), 48000, Values, nullptr, 0);
+
+    CHECK_NEAR(Values.Correlation, 0., 0.02);
+    CHECK_NEAR(Values.Width, 0.5, 0.01);
+    CHECK_NEAR(Values.Balance, 0., 0.01);
+}
+
+TEST(Balance)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    stereo_t Values;
+
+    const auto Left = Generate(4800, [](size_t i, double & L, double & R) { L = Sine(i); R = 0.; });
+
+    Analyzer.Process(Left.data(), 4800, Values, nullptr, 0);
+
+    CHECK_NEAR(Values.Balance, -1., 1e-6);
+    CHECK_NEAR(Values.Correlation, 0., 1e-6);
+
+    // Right at half the level of the left: (0.5 - 1) / (0.5 + 1)
+    const auto Mixed = Generate(4800, [](size_t i, double & L, double & R) { L = Sine(i); R = 0.5 * L; });
+
+    Analyzer.Process(Mixed.data(), 4800, Values, nullptr, 0);
+
+    CHECK_NEAR(Values.Balance, -1. / 3., 1e-5);
+    CHECK_NEAR(Values.Correlation, 1., 1e-6);
+}
+
+TEST(DoubleSamplesMatchFloatSamples)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    std::mt19937 Generator(3);
+    std::uniform_real_distribution<double> Distribution(-1., 1.);
+
+    // An odd frame count leaves a frame for the scalar tail of the vector kernel.
+    const size_t FrameCount = 1001;
+
+    const auto Floats = Generate(FrameCount, [&](size_t, double & L, double & R) { L = Distribution(Generator); R = 0.3 * L + 0.7 * Distribution(Generator); });
+    const std::vector<double> Doubles(Floats.begin(), Floats.end());
+
+    stereo_t a, b;
+
+    Analyzer.Process(Floats.data(),  FrameCount, a, nullptr, 0);
+    Analyzer.Process(Doubles.data(), FrameCount, b, nullptr, 0);
+
+    CHECK_NEAR(a.Correlation, b.Correlation, 1e-6);
+    CHECK_NEAR(a.Balance, b.Balance, 1e-6);
+    CHECK_NEAR(a.Width, b.Width, 1e-6);
+    CHECK_NEAR(a.SideRMS, b.SideRMS, 1e-6);
+}
+
+TEST(GoniometerPoints)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    const auto Samples = Generate(8, [](size_t i, double & L, double & R) { L = 0.1 * (double) i; R = -0.05 * (double) i; });
+
+    stereo_t Values;
+    stereo_point_t Points[4];
+
+    Analyzer.Process(Samples.data(), 8, Values, Points, 4);
+
+    // The points are spread evenly over the chunk: frames 0, 2, 4 and 6.
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const double L = 0.1 * (double) (i * 2), R = -0.05 * (double) (i * 2);
+
+        CHECK_NEAR(Points[i].Side, (L - R) * 0.5, 1e-6);
+        CHECK_NEAR(Points[i].Mid,  (L + R) * 0.5, 1e-6);
+    }
+}
+
+TEST(WeightedDownmix)
+{
+    // 3 channels: left, right and center. The center is added to both sides at -3 dB.
+    const double c = std::sqrt(0.5);
+    const double Left[3]  = { 1., 0., c };
+    const double Right[3] = { 0., 1., c };
+
+    StereoAnalyzer Analyzer;
+
+    Analyzer.Initialize(Left, Right, 3);
+
+    // A center-only signal is mono.
+    std::vector<float> Samples(4800 * 3);
+
+    for (size_t i = 0; i < 4800; ++i)
+        Samples[(i * 3) + 2] = (float) Sine(i);
+
+    stereo_t Values;
+    stereo_point_t Point;
+
+    Analyzer.Process(Samples.data(), 4800, Values, &Point, 1);
+
+    CHECK_NEAR(Values.Correlation, 1., 1e-6);
+    CHECK_NEAR(Values.Width, 0., 1e-6);
+    CHECK_NEAR(Values.LeftRMS, c * 0.5 / std::sqrt(2.), 1e-4);
+    CHECK_NEAR(Point.Side, 0., 1e-6);
+}
+
+TEST(EmptyInput)
+{
+    StereoAnalyzer Analyzer; InitializeStereo(Analyzer);
+
+    stereo_t Values;
+    stereo_point_t Points[2] = { { 1.f, 1.f }, { 1.f, 1.f } };
+
+    Analyzer.Process((const float *) nullptr, 0, Values, Points, 2);
+
+    CHECK(Values.Correlation == 0.f);
+    CHECK(Values.LeftRMS == 0.f);
+    CHECK((Points[0].Side == 0.f) && (Points[1].Mid == 0.f));
+
+    // Silence has no defined correlation or balance.
+    const std::vector<float> Silence(200);
+
+    Analyzer.Process(Silence.data(), 100, Values, nullptr, 0);
+
+    CHECK(Values.Correlation == 0.f);
+    CHECK(Values.Balance == 0.f);
+    CHECK(Values.Width == 0.f);
+}
+
+int main() { return RunTests(); }
@@ -0,0 +1,86 @@
+
+/** $VER: Test.h (2026.10.17) P. Stuer - Minimal unit test support for the host-independent sources. **/
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/// <summary>
+/// Represents a registered test.
+/// </summary>
+struct test_t
+{
+    const char * Name;
+    void (* Function)();
+};
+
+/// <summary>
+/// Gets the registered tests.
+/// </summary>
+inline std::vector<test_t> & GetTests()
+{
+    static std::vector<test_t> Tests;
+
+    return Tests;
+}
+
+/// <summary>
+/// Gets the number of failed checks.
+/// </summary>
+inline int & GetFailureCount()
+{
+    static int FailureCount = 0;
+
+    return FailureCount;
+}
+
+/// <summary>
+/// Registers a test.
+/// </summary>
+struct test_registrar_t
+{
+    test_registrar_t(const char * name, void (* function)())
+    {
+        GetTests().push_back({ name, function });
+    }
+};
+
+/// <summary>
+/// Reports a failed check.
+/// </summary>
+inline void ReportFailure(const char * fileName, int lineNumber, const char * expression)
+{
+    std::printf("%s(%d): Check failed: %s\n", fileName, lineNumber, expression);
+
+    ++GetFailureCount();
+}
+
+/// <summary>
+/// Runs all registered tests. Returns the exit code of the test program.
+/// </summary>
+inline int RunTests()
+{
+    for (const auto & Test : GetTests())
+    {
+        const int FailureCount = GetFailureCount();
+
+        Test.Function();
+
+        std::printf("%s %s\n", (GetFailureCount() == FailureCount) ? "Passed" : "FAILED", Test.Name);
+    }
+
+    return (GetFailureCount() == 0) ? 0 : 1;
+}
+
+#define TEST(name) \
+    static void name(); \
+    static test_registrar_t name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) ReportFailure(__FILE__, __LINE__, #expression); } while (false)
+
+#define CHECK_NEAR(value, expected, tolerance) \
+    do { if (!(std::fabs((double) (value) - (double) (expected)) <= (double) (tolerance))) { std::printf("  %s = %g, expected %g\n", #value, (double) (value), (double) (expected)); ReportFailure(__FILE__, __LINE__, #value " ~ " #expected); } } while (false)
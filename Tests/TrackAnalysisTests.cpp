@@ -0,0 +1,257 @@
+
+/** $VER: TrackAnalysisTests.cpp (2026.10.17) P. Stuer - Tests the track analyzer and the analysis cache. **/
+
+#include "Test.h"
+
+#include "TrackAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+static const double Pi = 3.14159265358979323846;
+
+static const uint32_t SampleRate = 48000;
+
+static const double StereoWeights[2] = { 1., 1. };
+
+/// <summary>
+/// Creates interleaved stereo samples: silence, a 1 kHz sine with the specified amplitude, and silence again. The durations are in seconds.
+/// </summary>
+static std::vector<float> Generate(double leadingSilence, double duration, double trailingSilence, double amplitude)
+{
+    const size_t Lead  = (size_t) (leadingSilence * SampleRate);
+    const size_t Sound = (size_t) (duration * SampleRate);
+    const size_t Trail = (size_t) (trailingSilence * SampleRate);
+
+    std::vector<float> Samples((Lead + Sound + Trail) * 2, 0.f);
+
+    for (size_t i = 0; i < Sound; ++i)
+    {
+        const float Sample = (float) (amplitude * std::sin(2. * Pi * 1000. * ((double) i + 0.5) / SampleRate));
+
+        Samples[((Lead + i) * 2) + 0] = Sample;
+        Samples[((Lead + i) * 2) + 1] = Sample;
+    }
+
+    return Samples;
+}
+
+/// <summary>
+/// Analyzes the samples in chunks of 4096 frames.
+/// </summary>
+static track_analysis_t Analyze(uint32_t features, const std::vector<float> & samples)
+{
+    TrackAnalyzer Analyzer;
+
+    Analyzer.Initialize(features, 2, SampleRate, StereoWeights);
+
+    const size_t FrameCount = samples.size() / 2;
+
+    for (size_t i = 0; i < FrameCount; i += 4096)
+        Analyzer.Process(samples.data() + (i * 2), std::min(FrameCount - i, (size_t) 4096), 2);
+
+    track_analysis_t Analysis;
+
+    Analyzer.Finish(Analysis);
+
+    return Analysis;
+}
+
+TEST(AllFeatures)
+{
+    const auto Samples = Generate(0.5, 9., 0.25, 1.);
+
+    const track_analysis_t Analysis = Analyze((uint32_t) TrackFeature::All, Samples);
+
+    CHECK(Analysis.Features == (uint32_t) TrackFeature::All);
+    CHECK(Analysis.ChannelCount == 2);
+    CHECK(Analysis.SampleRate == SampleRate);
+    CHECK_NEAR(Analysis.Duration, 9.75, 1e-9);
+
+    // The RMS includes the silences.
+    CHECK_NEAR(Analysis.RMS, 10. * std::log10(0.5 * 9. / 9.75), 0.01);
+    CHECK_NEAR(Analysis.Peak, 0., 0.05); // The samples miss the crests by half a sample.
+
+    // A sine has no dynamics.
+    CHECK(Analysis.DynamicRange == 0.);
+
+    // A full scale sine on both channels measures 0 LUFS. The gating removes the silences.
+    CHECK_NEAR(Analysis.IntegratedLoudness, 0., 0.2);
+    CHECK(std::isfinite(Analysis.LoudnessRange));
+    CHECK_NEAR(Analysis.TruePeak, 0., 0.2);
+
+    CHECK_NEAR(Analysis.LeadingSilence, 0.5, 0.001);
+    CHECK_NEAR(Analysis.TrailingSilence, 0.25, 0.001);
+}
+
+TEST(FeatureMasking)
+{
+    const auto Samples = Generate(0.5, 4., 0.25, 0.5);
+
+    const track_analysis_t All = Analyze((uint32_t) TrackFeature::All, Samples);
+
+    // Each feature on its own produces the same values as in a full analysis, and only those. Unknown feature bits are dropped.
+    for (uint32_t Feature = 0x01; Feature <= 0x10; Feature <<= 1)
+    {
+        const track_analysis_t Analysis = Analyze(Feature | 0x100, Samples);
+
+        CHECK(Analysis.Features == Feature);
+        CHECK_NEAR(Analysis.Duration, All.Duration, 1e-9);
+
+        const bool HasRMS      = (Feature == (uint32_t) TrackFeature::RMS);
+        const bool HasPeak     = (Feature == (uint32_t) TrackFeature::Peak);
+        const bool HasDR       = (Feature == (uint32_t) TrackFeature::DynamicRange);
+        const bool HasLoudness = (Feature == (uint32_t) TrackFeature::Loudness);
+        const bool HasSilence  = (Feature == (uint32_t) TrackFeature::Silence);
+
+        CHECK(HasRMS  ? (Analysis.RMS == All.RMS)                   : std::isinf(Analysis.RMS));
+        CHECK(HasPeak ? (Analysis.Peak == All.Peak)                 : std::isinf(Analysis.Peak));
+        CHECK(HasDR   ? (Analysis.DynamicRange == All.DynamicRange) : std::isinf(Analysis.DynamicRange));
+
+        CHECK(HasLoudness ? (Analysis.IntegratedLoudness == All.IntegratedLoudness) : std::isinf(Analysis.IntegratedLoudness));
+        CHECK(HasLoudness ? (Analysis.LoudnessRange == All.LoudnessRange)           : std::isinf(Analysis.LoudnessRange));
+        CHECK(HasLoudness ? (Analysis.TruePeak == All.TruePeak)                     : std::isinf(Analysis.TruePeak));
+
+        CHECK(HasSilence ? (Analysis.LeadingSilence == All.LeadingSilence)   : (Analysis.LeadingSilence == 0.));
+        CHECK(HasSilence ? (Analysis.TrailingSilence == All.TrailingSilence) : (Analysis.TrailingSilence == 0.));
+    }
+
+    // No features at all still measures the duration.
+    const track_analysis_t Analysis = Analyze(0, Samples);
+
+    CHECK(Analysis.Features == 0);
+    CHECK_NEAR(Analysis.Duration, All.Duration, 1e-9);
+    CHECK(std::isinf(Analysis.RMS) && std::isinf(Analysis.Peak));
+}
+
+TEST(Silence)
+{
+    const auto Samples = Generate(2., 0., 0., 0.);
+
+    const track_analysis_t Analysis = Analyze((uint32_t) TrackFeature::All, Samples);
+
+    // A silent track is all leading and all trailing silence and has no measurable levels.
+    CHECK_NEAR(Analysis.LeadingSilence, 2., 1e-9);
+    CHECK_NEAR(Analysis.TrailingSilence, 2., 1e-9);
+
+    CHECK(std::isinf(Analysis.RMS));
+    CHECK(std::isinf(Analysis.Peak));
+    CHECK(std::isinf(Analysis.DynamicRange));
+}
+
+TEST(ChannelCountChange)
+{
+    TrackAnalyzer Analyzer;
+
+    Analyzer.Initialize((uint32_t) TrackFeature::All, 2, SampleRate, StereoWeights);
+
+    CHECK(Analyzer.IsInitialized());
+
+    const std::vector<float> Mono(SampleRate, 1.f);
+
+    // Chunks with a different channel count are ignored.
+    Analyzer.Process(Mono.data(), Mono.size(), 1);
+
+    track_analysis_t Analysis;
+
+    Analyzer.Finish(Analysis);
+
+    CHECK(Analysis.Duration == 0.);
+    CHECK(std::isinf(Analysis.Peak));
+}
+
+/// <summary>
+/// Creates an analysis with a distinct value in every field.
+/// </summary>
+static track_analysis_t GetAnalysis()
+{
+    track_analysis_t Analysis = { };
+
+    Analysis.Features           = (uint32_t) TrackFeature::All;
+    Analysis.ChannelCount       = 6;
+    Analysis.SampleRate         = 96000;
+    Analysis.Duration           = 245.125;
+    Analysis.RMS                = -17.25;
+    Analysis.Peak               = -0.5;
+    Analysis.DynamicRange       = 9.;
+    Analysis.IntegratedLoudness = -14.125;
+    Analysis.LoudnessRange      = 6.5;
+    Analysis.TruePeak           = -std::numeric_limits<double>::infinity();
+    Analysis.LeadingSilence     = 0.25;
+    Analysis.TrailingSilence    = 1.75;
+
+    return Analysis;
+}
+
+TEST(CacheRoundTrip)
+{
+    const std::string Key = "file://C:/Music/Track.flac|0";
+
+    const track_analysis_t Expected = GetAnalysis();
+
+    std::stringstream Stream;
+
+    CHECK(TrackAnalysisCache::Write(Stream, Key, Expected));
+
+    CHECK(Stream.str().size() == sizeof(analysis_file_header_t) + Key.size() + sizeof(track_analysis_t));
+
+    track_analysis_t Analysis = { };
+
+    CHECK(TrackAnalysisCache::Read(Stream, Key, Analysis));
+    CHECK(std::memcmp(&Analysis, &Expected, sizeof(Analysis)) == 0);
+}
+
+TEST(CacheRejectsInvalidFiles)
+{
+    const std::string Key = "file://C:/Music/Track.flac|0";
+
+    std::stringstream Stream;
+
+    TrackAnalysisCache::Write(Stream, Key, GetAnalysis());
+
+    const std::string File = Stream.str();
+
+    const auto Read = [](const std::string & data, const std::string & key) -> bool
+    {
+        std::istringstream Stream(data);
+
+        track_analysis_t Analysis = GetAnalysis();
+        Analysis.Duration = 1.;
+
+        const bool Result = TrackAnalysisCache::Read(Stream, key, Analysis);
+
+        // A failed read leaves the analysis alone.
+        if (!Result)
+            CHECK(Analysis.Duration == 1.);
+
+        return Result;
+    };
+
+    CHECK(Read(File, Key));
+
+    // A different key of the same or a different length.
+    CHECK(!Read(File, "file://C:/Music/Track.flac|1"));
+    CHECK(!Read(File, "file://C:/Music/Other.flac"));
+
+    // A truncated file.
+    CHECK(!Read(File.substr(0, File.size() - 1), Key));
+    CHECK(!Read(File.substr(0, sizeof(analysis_file_header_t) - 1), Key));
+    CHECK(!Read(std::string(), Key));
+
+    // A damaged header.
+    for (size_t Offset : { offsetof(analysis_file_header_t, Magic), offsetof(analysis_file_header_t, Version), offsetof(analysis_file_header_t, Size), offsetof(analysis_file_header_t, AnalysisSize) })
+    {
+        std::string Damaged = File;
+
+        Damaged[Offset] ^= 0x01;
+
+        CHECK(!Read(Damaged, Key));
+    }
+}
+
+int main() { return RunTests(); }
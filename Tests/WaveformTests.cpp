@@ -0,0 +1,134 @@
+
+/** $VER: WaveformTests.cpp (2026.10.17) P. Stuer - Tests the waveform builder and the waveform cache. **/
+
+#include "Test.h"
+
+#include "Waveform.h"
+
+#include <sstream>
+
+TEST(BucketsCoverTheTrack)
+{
+    const uint32_t SampleRate = 1000;
+
+    WaveformBuilder Builder;
+
+    Builder.Initialize(1, SampleRate, 1000, 10);
+
+    // A ramp from 0 to 1 delivered in uneven chunks.
+    std::vector<float> Samples(1000);
+
+    for (size_t i = 0; i < Samples.size(); ++i)
+        Samples[i] = (float) i / 1000.f;
+
+    Builder.Process(Samples.data(),       333, 1);
+    Builder.Process(Samples.data() + 333, 667, 1);
+
+    waveform_t Waveform;
+
+    Builder.Finish(Waveform);
+
+    CHECK(Waveform.ChannelCount == 1);
+    CHECK(Waveform.BucketCount == 10);
+    CHECK_NEAR(Waveform.Duration, 1., 1e-9);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        CHECK_NEAR(Waveform.Envelopes[i].Min, (double) i / 10., 1e-6);
+        CHECK_NEAR(Waveform.Envelopes[i].Max, (double) (i * 100 + 99) / 1000., 1e-6);
+    }
+}
+
+TEST(ExtraChannelsAreSkipped)
+{
+    const uint32_t ChannelCount = EnvelopeDecimator::MaxChannels + 2;
+    const size_t FrameCount = 100;
+
+    WaveformBuilder Builder;
+
+    Builder.Initialize(ChannelCount, 48000, FrameCount, 4);
+
+    // Each channel has a constant value that identifies it.
+    std::vector<double> Samples(FrameCount * ChannelCount);
+
+    for (size_t i = 0; i < FrameCount; ++i)
+        for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            Samples[(i * ChannelCount) + Channel] = (double) (Channel + 1) / 64.;
+
+    Builder.Process(Samples.data(), FrameCount, ChannelCount);
+
+    waveform_t Waveform;
+
+    Builder.Finish(Waveform);
+
+    CHECK(Waveform.ChannelCount == EnvelopeDecimator::MaxChannels);
+
+    for (uint32_t Channel = 0; Channel < Waveform.ChannelCount; ++Channel)
+    {
+        for (uint32_t Bucket = 0; Bucket < Waveform.BucketCount; ++Bucket)
+        {
+            const auto & Envelope = Waveform.Envelopes[(Channel * Waveform.BucketCount) + Bucket];
+
+            CHECK_NEAR(Envelope.Min, (Channel + 1) / 64., 1e-6);
+            CHECK_NEAR(Envelope.Max, (Channel + 1) / 64., 1e-6);
+        }
+    }
+}
+
+TEST(ChunksWithOtherChannelCountsAreIgnored)
+{
+    WaveformBuilder Builder;
+
+    Builder.Initialize(2, 48000, 4, 1);
+
+    const float Stereo[] = { 0.5f, -0.5f, 0.5f, -0.5f };
+    const float Mono[]   = { 1.f, 1.f, 1.f, 1.f };
+
+    Builder.Process(Stereo, 2, 2);
+    Builder.Process(Mono,   4, 1);
+
+    waveform_t Waveform;
+
+    Builder.Finish(Waveform);
+
+    CHECK(Waveform.Envelopes[0].Max == 0.5f);
+    CHECK(Waveform.Envelopes[1].Min == -0.5f);
+}
+
+TEST(CacheRoundTrip)
+{
+    waveform_t Waveform = { 2, 3, 44100, 12.5, { } };
+
+    for (int i = 0; i < 6; ++i)
+        Waveform.Envelopes.push_back({ -i / 10.f, i / 10.f, i / 20.f });
+
+    const std::string Key = WaveformCache::GetKey("C:\\Music\\Track.flac", 1, 1234567890ull);
+
+    std::stringstream Stream;
+
+    CHECK(WaveformCache::Write(Stream, Key, Waveform));
+
+    waveform_t Copy = { };
+
+    Stream.seekg(0);
+
+    CHECK(WaveformCache::Read(Stream, Key, Copy));
+    CHECK(Copy.ChannelCount == Waveform.ChannelCount);
+    CHECK(Copy.BucketCount == Waveform.BucketCount);
+    CHECK(Copy.SampleRate == Waveform.SampleRate);
+    CHECK(Copy.Duration == Waveform.Duration);
+    CHECK(Copy.Envelopes.size() == Waveform.Envelopes.size());
+
+    for (size_t i = 0; i < Copy.Envelopes.size(); ++i)
+        CHECK((Copy.Envelopes[i].Min == Waveform.Envelopes[i].Min) && (Copy.Envelopes[i].Max == Waveform.Envelopes[i].Max) && (Copy.Envelopes[i].RMS == Waveform.Envelopes[i].RMS));
+
+    // A different key, f.e. after the file was modified, does not match.
+    Stream.seekg(0);
+
+    CHECK(!WaveformCache::Read(Stream, WaveformCache::GetKey("C:\\Music\\Track.flac", 1, 1234567891ull), Copy));
+}
+
+int main()
+{
+    return RunTests();
+}
@@ -0,0 +1,301 @@
+
+/** $VER: TrackAnalysis.cpp (2026.10.16) P. Stuer - Measures the level, dynamic range, loudness and silences of a whole track. Host-independent. **/
+
+#include "TrackAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+static const double NegativeInfinity = -std::numeric_limits<double>::infinity();
+
+static double ToDecibel(double value) noexcept;
+
+/// <summary>
+/// Prepares the analyzer for a new track. The channel weights are the BS.1770 weights used by the loudness measurement.
+/// </summary>
+void TrackAnalyzer::Initialize(uint32_t features, uint32_t channelCount, uint32_t sampleRate, const double * channelWeights)
+{
+    _Features = features & (uint32_t) TrackFeature::All;
+    _ChannelCount = std::min(channelCount, LoudnessMeter::MaxChannels);
+    _SampleRate = sampleRate;
+
+    _FrameCount = 0;
+
+    _SumOfSquares = 0.;
+    _Peak = 0.;
+
+    _BlockSize = std::max((uint64_t) (BlockDuration * sampleRate), (uint64_t) 1);
+    _BlockFrameCount = 0;
+
+    _BlockSumOfSquares.assign(_ChannelCount, 0.);
+    _BlockPeak.assign(_ChannelCount, 0.);
+    _BlockRMS.clear();
+    _BlockPeaks.clear();
+
+    _FirstSound = 0;
+    _LastSound = 0;
+    _HasSound = false;
+
+    if (_Features & (uint32_t) TrackFeature::Loudness)
+        _LoudnessMeter.Initialize(sampleRate, _ChannelCount, channelWeights);
+}
+
+/// <summary>
+/// Adds a chunk of interleaved 32-bit samples. Chunks with a different channel count are ignored.
+/// </summary>
+void TrackAnalyzer::Process(const float * samples, size_t frameCount, uint32_t channelCount) noexcept
+{
+    ProcessInternal(samples, frameCount, channelCount);
+}
+
+/// <summary>
+/// Adds a chunk of interleaved 64-bit samples. Chunks with a different channel count are ignored.
+/// </summary>
+void TrackAnalyzer::Process(const double * samples, size_t frameCount, uint32_t channelCount) noexcept
+{
+    ProcessInternal(samples, frameCount, channelCount);
+}
+
+/// <summary>
+/// Completes the measurement and returns the features of the track.
+/// </summary>
+void TrackAnalyzer::Finish(track_analysis_t & analysis)
+{
+    if (_BlockFrameCount != 0)
+        CompleteBlock();
+
+    analysis = { };
+
+    analysis.Features     = _Features;
+    analysis.ChannelCount = _ChannelCount;
+    analysis.SampleRate   = _SampleRate;
+    analysis.Duration     = (_SampleRate != 0) ? (double) _FrameCount / (double) _SampleRate : 0.;
+
+    analysis.RMS                = NegativeInfinity;
+    analysis.Peak               = NegativeInfinity;
+    analysis.DynamicRange       = NegativeInfinity;
+    analysis.IntegratedLoudness = NegativeInfinity;
+    analysis.LoudnessRange      = NegativeInfinity;
+    analysis.TruePeak           = NegativeInfinity;
+
+    if ((_Features & (uint32_t) TrackFeature::RMS) && (_FrameCount != 0))
+        analysis.RMS = ToDecibel(std::sqrt(_SumOfSquares / ((double) _FrameCount * _ChannelCount)));
+
+    if (_Features & (uint32_t) TrackFeature::Peak)
+        analysis.Peak = ToDecibel(_Peak);
+
+    if (_Features & (uint32_t) TrackFeature::DynamicRange)
+        analysis.DynamicRange = GetDynamicRange();
+
+    if (_Features & (uint32_t) TrackFeature::Loudness)
+    {
+        const loudness_t & Values = _LoudnessMeter.GetValues();
+
+        analysis.IntegratedLoudness = Values.Integrated;
+        analysis.LoudnessRange      = Values.LoudnessRange;
+        analysis.TruePeak           = Values.TruePeak;
+    }
+
+    if (_Features & (uint32_t) TrackFeature::Silence)
+    {
+        // A track that is silent from start to end consists of leading and trailing silence only.
+        analysis.LeadingSilence  = _HasSound ? (double) _FirstSound / (double) _SampleRate : analysis.Duration;
+        analysis.TrailingSilence = _HasSound ? (double) (_FrameCount - _LastSound - 1) / (double) _SampleRate : analysis.Duration;
+    }
+}
+
+/// <summary>
+/// Adds a chunk of interleaved samples to the measurement.
+/// </summary>
+template<typename T>
+void TrackAnalyzer::ProcessInternal(const T * samples, size_t frameCount, uint32_t channelCount) noexcept
+{
+    if ((_ChannelCount == 0) || (channelCount != _ChannelCount))
+        return;
+
+    const bool HasLevels  = (_Features & ((uint32_t) TrackFeature::RMS | (uint32_t) TrackFeature::Peak)) != 0;
+    const bool HasBlocks  = (_Features & (uint32_t) TrackFeature::DynamicRange) != 0;
+    const bool HasSilence = (_Features & (uint32_t) TrackFeature::Silence) != 0;
+
+    if (_Features & (uint32_t) TrackFeature::Loudness)
+        _LoudnessMeter.Process(samples, frameCount);
+
+    if (!HasLevels && !HasBlocks && !HasSilence)
+    {
+        _FrameCount += frameCount;
+
+        return;
+    }
+
+    double SumOfSquares = _SumOfSquares;
+    double Peak = _Peak;
+
+    for (size_t i = 0; i < frameCount; ++i, samples += channelCount)
+    {
+        double FramePeak = 0.;
+
+        for (uint32_t j = 0; j < channelCount; ++j)
+        {
+            const double Sample = (double) samples[j];
+            const double Square = Sample * Sample;
+            const double Magnitude = std::abs(Sample);
+
+            SumOfSquares += Square;
+            FramePeak = std::max(FramePeak, Magnitude);
+
+            if (HasBlocks)
+            {
+                _BlockSumOfSquares[j] += Square;
+                _BlockPeak[j] = std::max(_BlockPeak[j], Magnitude);
+            }
+        }
+
+        Peak = std::max(Peak, FramePeak);
+
+        if (HasSilence && (FramePeak > SilenceThreshold))
+        {
+            if (!_HasSound)
+            {
+                _FirstSound = _FrameCount;
+                _HasSound = true;
+            }
+
+            _LastSound = _FrameCount;
+        }
+
+        ++_FrameCount;
+
+        if (HasBlocks && (++_BlockFrameCount == _BlockSize))
+            CompleteBlock();
+    }
+
+    _SumOfSquares = SumOfSquares;
+    _Peak = Peak;
+}
+
+/// <summary>
+/// Stores the RMS and the peak of each channel of the current block and starts a new block.
+/// </summary>
+void TrackAnalyzer::CompleteBlock() noexcept
+{
+    for (uint32_t j = 0; j < _ChannelCount; ++j)
+    {
+        // The RMS is scaled by 3 dB so a full scale sine wave measures 0 dB, like the reference DR meter.
+        _BlockRMS.push_back(std::sqrt(2. * _BlockSumOfSquares[j] / (double) _BlockFrameCount));
+        _BlockPeaks.push_back(_BlockPeak[j]);
+
+        _BlockSumOfSquares[j] = 0.;
+        _BlockPeak[j] = 0.;
+    }
+
+    _BlockFrameCount = 0;
+}
+
+/// <summary>
+/// Gets the DR score: the ratio of the second highest block peak to the RMS of the loudest 20% of the blocks, averaged over the channels and rounded to the nearest integer.
+/// </summary>
+double TrackAnalyzer::GetDynamicRange() const noexcept
+{
+    const size_t BlockCount = (_ChannelCount != 0) ? _BlockRMS.size() / _ChannelCount : 0;
+
+    if (BlockCount == 0)
+        return NegativeInfinity;
+
+    const size_t LoudBlockCount = std::max(BlockCount / 5, (size_t) 1);
+
+    std::vector<double> RMS(BlockCount);
+    std::vector<double> Peaks(BlockCount);
+
+    double Sum = 0.;
+    uint32_t Count = 0;
+
+    for (uint32_t j = 0; j < _ChannelCount; ++j)
+    {
+        for (size_t i = 0; i < BlockCount; ++i)
+        {
+            RMS[i]   = _BlockRMS  [(i * _ChannelCount) + j];
+            Peaks[i] = _BlockPeaks[(i * _ChannelCount) + j];
+        }
+
+        std::sort(RMS.begin(), RMS.end(), std::greater<double>());
+        std::sort(Peaks.begin(), Peaks.end(), std::greater<double>());
+
+        double SumOfSquares = 0.;
+
+        for (size_t i = 0; i < LoudBlockCount; ++i)
+            SumOfSquares += RMS[i] * RMS[i];
+
+        const double LoudRMS = std::sqrt(SumOfSquares / (double) LoudBlockCount);
+        const double SecondPeak = (BlockCount > 1) ? Peaks[1] : Peaks[0];
+
+        // Silent channels do not contribute.
+        if ((LoudRMS <= 0.) || (SecondPeak <= 0.))
+            continue;
+
+        Sum += 20. * std::log10(SecondPeak / LoudRMS);
+        ++Count;
+    }
+
+    return (Count != 0) ? std::round(Sum / Count) : NegativeInfinity;
+}
+
+/// <summary>
+/// Reads an analysis from a cache file. Returns false if the file is not a valid cache file or belongs to a different key.
+/// </summary>
+bool TrackAnalysisCache::Read(std::istream & stream, const std::string & key, track_analysis_t & analysis)
+{
+    analysis_file_header_t Header = { };
+
+    if (!stream.read((char *) &Header, sizeof(Header)))
+        return false;
+
+    if ((Header.Magic != analysis_file_header_t::CurrentMagic) || (Header.Version != analysis_file_header_t::CurrentVersion) || (Header.Size != sizeof(Header)))
+        return false;
+
+    if ((Header.KeySize != key.size()) || (Header.AnalysisSize != sizeof(track_analysis_t)))
+        return false;
+
+    std::string Key(Header.KeySize, '\0');
+
+    if (!stream.read(Key.data(), (std::streamsize) Key.size()) || (Key != key))
+        return false;
+
+    track_analysis_t Analysis = { };
+
+    if (!stream.read((char *) &Analysis, sizeof(Analysis)))
+        return false;
+
+    analysis = Analysis;
+
+    return true;
+}
+
+/// <summary>
+/// Writes an analysis to a cache file.
+/// </summary>
+bool TrackAnalysisCache::Write(std::ostream & stream, const std::string & key, const track_analysis_t & analysis)
+{
+    analysis_file_header_t Header = { };
+
+    Header.Magic        = analysis_file_header_t::CurrentMagic;
+    Header.Version      = analysis_file_header_t::CurrentVersion;
+    Header.Size         = (uint16_t) sizeof(Header);
+    Header.KeySize      = (uint32_t) key.size();
+    Header.AnalysisSize = (uint32_t) sizeof(track_analysis_t);
+
+    stream.write((const char *) &Header, sizeof(Header));
+    stream.write(key.data(), (std::streamsize) key.size());
+    stream.write((const char *) &analysis, sizeof(analysis));
+
+    return stream.good();
+}
+
+/// <summary>
+/// Converts a linear value to decibel.
+/// </summary>
+static double ToDecibel(double value) noexcept
+{
+    return (value > 0.) ? 20. * std::log10(value) : NegativeInfinity;
+}
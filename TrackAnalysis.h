@@ -0,0 +1,138 @@
+
+/** $VER: TrackAnalysis.h (2026.10.16) P. Stuer - Measures the level, dynamic range, loudness and silences of a whole track. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "LoudnessMeter.h"
+
+/// <summary>
+/// Identifies the features that can be measured. Features are combined as a bit mask.
+/// </summary>
+enum class TrackFeature : uint32_t
+{
+    RMS             = 0x01,     // RMS level of all channels
+    Peak            = 0x02,     // Sample peak level of all channels
+    DynamicRange    = 0x04,     // DR score
+    Loudness        = 0x08,     // Integrated loudness, loudness range and true peak according to EBU R128
+    Silence         = 0x10,     // Duration of the leading and trailing silence
+
+    All             = 0x1F
+};
+
+/// <summary>
+/// Represents the features of a whole track. Levels are in dBFS, loudness values in LUFS, the loudness range in LU and the true peak in dBTP. Values that could not be determined are -infinity.
+/// </summary>
+struct track_analysis_t
+{
+    uint32_t Features;          // Features that were measured, see TrackFeature.
+    uint32_t ChannelCount;
+    uint32_t SampleRate;        // in Hz
+    double Duration;            // in seconds
+
+    double RMS;
+    double Peak;
+    double DynamicRange;        // in dB, rounded to the nearest integer
+
+    double IntegratedLoudness;
+    double LoudnessRange;
+    double TruePeak;
+
+    double LeadingSilence;      // in seconds
+    double TrailingSilence;     // in seconds
+};
+
+/// <summary>
+/// Measures the features of a track from consecutive chunks of decoded samples.
+/// </summary>
+class TrackAnalyzer
+{
+public:
+    TrackAnalyzer() : _Features(), _ChannelCount(), _SampleRate(), _FrameCount(), _SumOfSquares(), _Peak(), _BlockSize(), _BlockFrameCount(), _FirstSound(), _LastSound(), _HasSound() { }
+
+    void Initialize(uint32_t features, uint32_t channelCount, uint32_t sampleRate, const double * channelWeights);
+
+    void Process(const float * samples, size_t frameCount, uint32_t channelCount) noexcept;
+    void Process(const double * samples, size_t frameCount, uint32_t channelCount) noexcept;
+
+    void Finish(track_analysis_t & analysis);
+
+    bool IsInitialized() const noexcept
+    {
+        return _ChannelCount != 0;
+    }
+
+    static constexpr double SilenceThreshold = 0.001;   // Samples below -60 dBFS are considered silent.
+    static constexpr double BlockDuration = 3.;         // Length of a block of the DR measurement, in seconds
+
+private:
+    template<typename T>
+    void ProcessInternal(const T * samples, size_t frameCount, uint32_t channelCount) noexcept;
+
+    void CompleteBlock() noexcept;
+    double GetDynamicRange() const noexcept;
+
+private:
+    uint32_t _Features;
+    uint32_t _ChannelCount;
+    uint32_t _SampleRate;
+
+    uint64_t _FrameCount;       // Number of frames processed so far
+
+    double _SumOfSquares;
+    double _Peak;
+
+    // DR measurement
+    uint64_t _BlockSize;        // in frames
+    uint64_t _BlockFrameCount;  // Number of frames accumulated in the current block
+
+    std::vector<double> _BlockSumOfSquares;     // Sum of squares of the current block, per channel
+    std::vector<double> _BlockPeak;             // Peak of the current block, per channel
+    std::vector<double> _BlockRMS;              // RMS of the completed blocks, block by block, all channels of a block together
+    std::vector<double> _BlockPeaks;            // Peak of the completed blocks, block by block, all channels of a block together
+
+    // Silence detection
+    uint64_t _FirstSound;       // Index of the first frame above the silence threshold
+    uint64_t _LastSound;        // Index of the last frame above the silence threshold
+    bool _HasSound;
+
+    LoudnessMeter _LoudnessMeter;
+};
+
+#pragma pack(push, 8)
+
+/// <summary>
+/// Represents the header of a track analysis cache file. The UTF-8 key and the analysis follow the header.
+/// </summary>
+struct analysis_file_header_t
+{
+    uint32_t Magic;                     // 'FBTA'
+    uint16_t Version;
+    uint16_t Size;                      // Size of the header, in bytes.
+
+    uint32_t KeySize;                   // Size of the key, in bytes.
+    uint32_t AnalysisSize;              // Size of the analysis, in bytes.
+
+    static const uint32_t CurrentMagic = 0x41544246; // 'FBTA' in little-endian byte order.
+    static const uint16_t CurrentVersion = 1;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(analysis_file_header_t) == 16, "Unexpected analysis file header size");
+
+/// <summary>
+/// Reads and writes track analysis cache files. A file is identified by the same key as a waveform cache file.
+/// </summary>
+class TrackAnalysisCache
+{
+public:
+    static bool Read(std::istream & stream, const std::string & key, track_analysis_t & analysis);
+    static bool Write(std::ostream & stream, const std::string & key, const track_analysis_t & analysis);
+};
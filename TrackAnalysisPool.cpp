@@ -0,0 +1,320 @@
+
+/** $VER: TrackAnalysisPool.cpp (2026.10.16) P. Stuer - Analyzes library tracks in the background. **/
+
+#include "pch.h"
+
+#include "TrackAnalysisPool.h"
+#include "Waveform.h"
+#include "Exceptions.h"
+#include "Encoding.h"
+#include "Resources.h"
+#include "Support.h"
+
+#include <SDK/input.h>
+
+#include <fstream>
+
+#include <shlobj.h>
+
+#pragma hdrstop
+
+/// <summary>
+/// Queues a request. Starts an additional worker thread if all threads are busy and the maximum number of threads has not been reached yet.
+/// </summary>
+void TrackAnalysisPool::Submit(analysis_request_t && request)
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    // Restart after the pool was stopped.
+    if (_IsStopping && _hThreads.empty())
+    {
+        _IsStopping = false;
+        _Abort.reset();
+    }
+
+    _Requests.push_back(std::move(request));
+
+    const size_t IdleThreadCount = _hThreads.size() - _ActiveThreadCount;
+
+    if ((IdleThreadCount < _Requests.size()) && (_hThreads.size() < GetMaxThreadCount()))
+    {
+        HANDLE hThread = ::CreateThread(nullptr, 0, ThreadProc, this, 0, nullptr);
+
+        if (hThread == NULL)
+        {
+            // The request is served as soon as one of the existing threads becomes available.
+            if (_hThreads.empty())
+            {
+                _Requests.pop_back();
+
+                throw Win32Exception(::GetLastError(), "Failed to create track analysis thread");
+            }
+        }
+        else
+            _hThreads.push_back(hThread);
+    }
+
+    _Condition.notify_one();
+}
+
+/// <summary>
+/// Discards the queued requests and the pending results of the specified window f.e. when the panel is destroyed. Requests in progress complete but their results are discarded.
+/// </summary>
+void TrackAnalysisPool::Cancel(HWND hWnd) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    std::erase_if(_Requests, [hWnd](const analysis_request_t & request) { return request.hWnd == hWnd; });
+    std::erase_if(_Results,  [hWnd](const analysis_result_t & result)   { return result.hWnd == hWnd; });
+}
+
+/// <summary>
+/// Cancels all requests and waits for the worker threads to finish.
+/// </summary>
+void TrackAnalysisPool::Stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> Lock(_Lock);
+
+        _IsStopping = true;
+        _Requests.clear();
+    }
+
+    _Abort.abort();
+    _Condition.notify_all();
+
+    for (HANDLE hThread : _hThreads)
+    {
+        ::WaitForSingleObject(hThread, INFINITE);
+
+        ::CloseHandle(hThread);
+    }
+
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    _hThreads.clear();
+    _Results.clear();
+}
+
+/// <summary>
+/// Takes the completed results of the specified window.
+/// </summary>
+void TrackAnalysisPool::GetResults(HWND hWnd, std::vector<analysis_result_t> & results) noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    for (auto Result = _Results.begin(); Result != _Results.end();)
+    {
+        if (Result->hWnd == hWnd)
+        {
+            results.push_back(std::move(*Result));
+
+            Result = _Results.erase(Result);
+        }
+        else
+            ++Result;
+    }
+}
+
+/// <summary>
+/// Thread procedure
+/// </summary>
+DWORD WINAPI TrackAnalysisPool::ThreadProc(LPVOID lParam) noexcept
+{
+    auto This = (TrackAnalysisPool *) lParam;
+
+    if (This == nullptr)
+        return 1;
+
+    // Lower the CPU and I/O priority so scanning a whole album does not interfere with playback.
+    ::SetThreadPriority(::GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    This->Run();
+
+    return 0;
+}
+
+/// <summary>
+/// Analyzes the queued tracks until the pool is stopped.
+/// </summary>
+void TrackAnalysisPool::Run() noexcept
+{
+    for (;;)
+    {
+        analysis_request_t Request;
+
+        {
+            std::unique_lock<std::mutex> Lock(_Lock);
+
+            _Condition.wait(Lock, [this]() { return _IsStopping || !_Requests.empty(); });
+
+            if (_IsStopping)
+                return;
+
+            Request = std::move(_Requests.front());
+            _Requests.pop_front();
+
+            ++_ActiveThreadCount;
+        }
+
+        analysis_result_t Result = { };
+
+        Result.hWnd         = Request.hWnd;
+        Result.Id           = Request.Id;
+        Result.Path         = Request.Path;
+        Result.SubsongIndex = Request.SubsongIndex;
+
+        try
+        {
+            Analyze(Request, Result);
+
+            // The cache can contain more features than requested.
+            Result.Analysis.Features &= Request.Features;
+        }
+        catch (const exception_aborted &)
+        {
+            std::lock_guard<std::mutex> Lock(_Lock);
+
+            --_ActiveThreadCount;
+
+            return;
+        }
+        catch (const std::exception & e)
+        {
+            Result.ErrorMessage = e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> Lock(_Lock);
+
+            --_ActiveThreadCount;
+
+            _Results.push_back(std::move(Result));
+        }
+
+        // The window may have been destroyed in the mean time.
+        if (!::PostMessageW(Request.hWnd, UM_ANALYSIS_READY, 0, 0))
+            Cancel(Request.hWnd);
+    }
+}
+
+/// <summary>
+/// Reads the analysis from the cache or decodes the track to measure the requested features.
+/// </summary>
+void TrackAnalysisPool::Analyze(const analysis_request_t & request, analysis_result_t & result)
+{
+    service_ptr_t<input_decoder> Decoder;
+
+    input_entry::g_open_for_decoding(Decoder, nullptr, request.Path, _Abort);
+
+    // The timestamp is part of the key so a modified file is analyzed again.
+    const std::string Key = WaveformCache::GetKey(request.Path, request.SubsongIndex, Decoder->get_file_stats(_Abort).m_timestamp);
+
+    const std::wstring CacheFilePath = GetCacheFilePath(request.CacheDirectoryPath, Key);
+
+    uint32_t Features = request.Features;
+
+    {
+        std::ifstream Stream(CacheFilePath, std::ios::binary);
+
+        if (Stream.is_open() && TrackAnalysisCache::Read(Stream, Key, result.Analysis))
+        {
+            if ((result.Analysis.Features & request.Features) == request.Features)
+            {
+                result.IsCached = true;
+
+                return;
+            }
+
+            // Measure the cached features again so the cache keeps them.
+            Features |= result.Analysis.Features;
+        }
+    }
+
+    Decoder->initialize(request.SubsongIndex, input_flag_no_seeking | input_flag_no_looping, _Abort);
+
+    TrackAnalyzer Analyzer;
+    audio_chunk_impl Chunk;
+
+    while (Decoder->run(Chunk, _Abort))
+    {
+        // The sample rate and channel count of the first chunk determine the format of the analysis.
+        if (!Analyzer.IsInitialized())
+        {
+            const uint32_t ChannelCount = Chunk.get_channel_count();
+
+            if (ChannelCount > LoudnessMeter::MaxChannels)
+                throw ComponentException("Track has too many channels");
+
+            double Weights[LoudnessMeter::MaxChannels];
+
+            GetLoudnessWeights(Chunk.get_channel_config(), ChannelCount, Weights);
+
+            Analyzer.Initialize(Features, ChannelCount, Chunk.get_sample_rate(), Weights);
+        }
+
+        Analyzer.Process(Chunk.get_data(), Chunk.get_sample_count(), Chunk.get_channel_count());
+    }
+
+    if (!Analyzer.IsInitialized())
+        throw ComponentException("Track contains no samples");
+
+    Analyzer.Finish(result.Analysis);
+
+    const int ErrorCode = ::SHCreateDirectoryExW(NULL, request.CacheDirectoryPath.c_str(), nullptr);
+
+    if ((ErrorCode != ERROR_SUCCESS) && (ErrorCode != ERROR_ALREADY_EXISTS))
+    {
+        console::print(::GetErrorMessage((DWORD) ErrorCode, ::FormatText(STR_COMPONENT_BASENAME " failed to create analysis cache directory \"%s\"", ::WideToUTF8(request.CacheDirectoryPath).c_str())).c_str());
+
+        return;
+    }
+
+    // Write to a temporary file first so other threads never read a partially written cache file. The name is unique per thread because two panels can analyze the same track.
+    const std::wstring TempFilePath = CacheFilePath + ::FormatText(L".%u.tmp", (unsigned) ::GetCurrentThreadId()).c_str();
+
+    bool Success;
+
+    {
+        std::ofstream Stream(TempFilePath, std::ios::binary | std::ios::trunc);
+
+        Success = Stream.is_open() && TrackAnalysisCache::Write(Stream, Key, result.Analysis);
+    }
+
+    if (Success)
+        Success = (::MoveFileExW(TempFilePath.c_str(), CacheFilePath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE);
+
+    if (!Success)
+    {
+        ::DeleteFileW(TempFilePath.c_str());
+
+        console::printf(STR_COMPONENT_BASENAME " failed to write analysis cache file \"%s\".", ::WideToUTF8(CacheFilePath).c_str());
+    }
+}
+
+/// <summary>
+/// Gets the path of the cache file for the specified key.
+/// </summary>
+std::wstring TrackAnalysisPool::GetCacheFilePath(const std::wstring & directoryPath, const std::string & key)
+{
+    wchar_t FilePath[MAX_PATH];
+
+    ::wcscpy_s(FilePath, _countof(FilePath), directoryPath.c_str());
+
+    HRESULT hr = ::PathCchAppend(FilePath, _countof(FilePath), ::UTF8ToWide(WaveformCache::GetFileName(key, "tan")).c_str());
+
+    if (!SUCCEEDED(hr))
+        throw Win32Exception(hr, "Failed to build analysis cache file path");
+
+    return FilePath;
+}
+
+/// <summary>
+/// Gets the maximum number of worker threads. One core is left for playback and the user interface.
+/// </summary>
+size_t TrackAnalysisPool::GetMaxThreadCount() noexcept
+{
+    const DWORD ProcessorCount = ::GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+
+    return (ProcessorCount > 1) ? (size_t) ProcessorCount - 1 : 1;
+}
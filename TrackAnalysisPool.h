@@ -0,0 +1,91 @@
+
+/** $VER: TrackAnalysisPool.h (2026.10.16) P. Stuer - Analyzes library tracks in the background. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+#include "TrackAnalysis.h"
+
+/// <summary>
+/// Represents a request to analyze a track.
+/// </summary>
+struct analysis_request_t
+{
+    HWND hWnd;                          // Window that receives UM_ANALYSIS_READY when the result is available
+    uint32_t Id;                        // Identifies the request in the result
+
+    pfc::string8 Path;
+    uint32_t SubsongIndex;
+    uint32_t Features;                  // See TrackFeature.
+
+    std::wstring CacheDirectoryPath;
+};
+
+/// <summary>
+/// Represents the result of an analysis request.
+/// </summary>
+struct analysis_result_t
+{
+    HWND hWnd;
+    uint32_t Id;
+
+    pfc::string8 Path;
+    uint32_t SubsongIndex;
+    bool IsCached;                      // True if the analysis was read from the cache.
+
+    std::string ErrorMessage;           // Empty if the analysis succeeded.
+
+    track_analysis_t Analysis;
+};
+
+/// <summary>
+/// Decodes and analyzes tracks on a bounded number of low priority worker threads. Completed analyses are cached on disk. Shared by all panels; the results are routed to the window of the request.
+/// </summary>
+class TrackAnalysisPool
+{
+public:
+    TrackAnalysisPool() : _ActiveThreadCount(), _IsStopping() { }
+
+    TrackAnalysisPool(const TrackAnalysisPool &) = delete;
+    TrackAnalysisPool & operator=(const TrackAnalysisPool &) = delete;
+    TrackAnalysisPool(TrackAnalysisPool &&) = delete;
+    TrackAnalysisPool & operator=(TrackAnalysisPool &&) = delete;
+
+    virtual ~TrackAnalysisPool()
+    {
+        Stop();
+    }
+
+    void Submit(analysis_request_t && request);
+    void Cancel(HWND hWnd) noexcept;
+    void Stop() noexcept;
+
+    void GetResults(HWND hWnd, std::vector<analysis_result_t> & results) noexcept;
+
+private:
+    static DWORD WINAPI ThreadProc(LPVOID lParam) noexcept;
+
+    void Run() noexcept;
+    void Analyze(const analysis_request_t & request, analysis_result_t & result);
+
+    static std::wstring GetCacheFilePath(const std::wstring & directoryPath, const std::string & key);
+    static size_t GetMaxThreadCount() noexcept;
+
+private:
+    std::mutex _Lock;
+    std::condition_variable _Condition;
+
+    std::deque<analysis_request_t> _Requests;
+    std::vector<analysis_result_t> _Results;
+
+    std::vector<HANDLE> _hThreads;
+    size_t _ActiveThreadCount;          // Number of threads that are analyzing a track
+    bool _IsStopping;
+
+    abort_callback_impl _Abort;
+};
@@ -1,5 +1,5 @@
 
-/** $VER: UIElement.cpp (2024.12.02) P. Stuer **/
+/** $VER: UIElement.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -20,14 +20,56 @@
 
 #pragma hdrstop
 
+/// <summary>
+/// Describes the events that are sent to the script, in the order of ScriptEvent. State changes that the script must see are kept,
+/// frame notifications and onsets are dropped and periodic state updates are merged when the script falls behind.
+/// </summary>
+static const event_kind_t ScriptEvents[] =
+{
+    { L"Frame",                     EventPolicy::Drop },
+    { L"PlaybackStarting",          EventPolicy::Keep },
+    { L"PlaybackNewTrack",          EventPolicy::Keep },
+    { L"PlaybackStop",              EventPolicy::Keep },
+    { L"PlaybackSeek",              EventPolicy::Keep },
+    { L"PlaybackPause",             EventPolicy::Keep },
+    { L"PlaybackEdited",            EventPolicy::Merge },
+    { L"PlaybackDynamicInfo",       EventPolicy::Merge },
+    { L"PlaybackDynamicTrackInfo",  EventPolicy::Merge },
+    { L"PlaybackTime",              EventPolicy::Merge },
+    { L"VolumeChange",              EventPolicy::Merge },
+    { L"PlaybackClock",             EventPolicy::Merge },
+    { L"Onsets",                    EventPolicy::Drop },
+    { L"Analysis",                  EventPolicy::Keep },
+};
+
+static_assert(_countof(ScriptEvents) == (size_t) ScriptEvent::Analysis + 1, "Event kind table does not match ScriptEvent");
+
 /// <summary>
 /// Initializes a new instance.
 /// </summary>
-UIElement::UIElement() : m_bMsgHandled(FALSE)
+UIElement::UIElement() : m_bMsgHandled(FALSE), _IsNavigationCompleted(false), _IsFrozen(false), _IsHidden(false), _ClientWidth(), _LastPlaybackTime(), _SampleRate(44100), _FrameInfo(), _IsFrameNotificationPending(false), _IsBufferRequestPending(false), _IsSpectrogramRequestPending(false), _FrameReadyTime(0), _PlaybackState(), _NextWindow(-1), _IsSeekPending(false), _WindowNumber(), _WindowSamples(), _HopSamples(), _SilenceStart(), _IsIdle(), _MeterTime(), _OnsetTime(-1.), _IsOnsetNotificationPending(false), _AnalysisId(), _IsPlaylistFlushPending(false), _PlaylistFlags(), _HasPlaylistSubscription(false), _AnalyzerFormat()
 {
     _PlaybackControl = playback_control::get();
 
-    playlist_manager::get()->register_callback(this, (t_uint32) flag_all);
+    // Size the lists of the frame path up front so they don't allocate while playing.
+    _PendingOnsets.reserve(MaxPendingOnsets + 1);
+    _PostedOnsets.reserve(MaxPendingOnsets + 1);
+    _OnsetEvents.reserve(16);
+
+    _ScriptBuffer[0] = L'\0';
+
+    _EventBus.Initialize(ScriptEvents, _countof(ScriptEvents), [this](const std::wstring & message)
+    {
+        HRESULT hr = _WebView->PostWebMessageAsJson(message.c_str());
+
+        if (!SUCCEEDED(hr))
+            console::print(::GetErrorMessage(hr, ::FormatText(STR_COMPONENT_BASENAME " failed to post event %s", ::WideToUTF8(message.substr(0, 64)).c_str())).c_str());
+
+        return SUCCEEDED(hr);
+    });
+
+    // No playlist events are needed until the template declares its handlers. See SetPlaylistFlags().
+    playlist_manager::get()->register_callback(this, 0);
 }
 
 /// <summary>
@@ -47,6 +89,18 @@ LRESULT UIElement::OnCreate(LPCREATESTRUCT cs) noexcept
 {
     _UIElementTracker.Add(this);
 
+    {
+        auto PlaybackControl = playback_control::get();
+
+        _PlaybackState.Length = PlaybackControl->playback_get_length();
+        _PlaybackState.Volume = PlaybackControl->get_volume();
+        _PlaybackState.Flags  = (PlaybackControl->is_playing() ? playback_state_t::Playing : 0) | (PlaybackControl->is_paused() ? playback_state_t::Paused : 0);
+
+        _PlaybackState.Position  = PlaybackControl->playback_get_position();
+        _PlaybackState.Timestamp = ::GetTimestamp();
+        _PlaybackState.Rate      = PlaybackControl->is_playing() ? 1.f : 0.f;
+    }
+
     std::wstring WebViewVersion;
 
     if (!GetWebViewVersion(WebViewVersion))
@@ -63,6 +117,22 @@ LRESULT UIElement::OnCreate(LPCREATESTRUCT cs) noexcept
         [this](std::function<void (void)> callback)
         {
             RunAsync(callback);
+        },
+        [this](const char * path, uint32_t subsongIndex)
+        {
+            RequestWaveform(path, subsongIndex);
+        },
+        [this]()
+        {
+            return GetFrameStatistics();
+        },
+        [this](const char * path, uint32_t subsongIndex, uint32_t features)
+        {
+            return AnalyzeTrack(path, subsongIndex, features);
+        },
+        [this](const wchar_t * handlerNames)
+        {
+            return SubscribePlaylistEvents(handlerNames);
         }
     );
 
@@ -75,20 +145,6 @@ LRESULT UIElement::OnCreate(LPCREATESTRUCT cs) noexcept
 
     InitializeFileWatcher();
 
-    // Create the visualisation stream.
-    try
-    {
-        static_api_ptr_t<visualisation_manager> VisualisationManager;
-
-        VisualisationManager->create_stream(_VisualisationStream, visualisation_manager::KStreamFlagNewFFT);
-
-        _VisualisationStream->set_channel_mode(visualisation_stream_v2::channel_mode_default);
-    }
-    catch (std::exception &)
-    {
-        console::print(STR_COMPONENT_BASENAME " failed to create visualisation stream.");
-    }
-
     return 0;
 }
 
@@ -99,10 +155,14 @@ void UIElement::OnDestroy() noexcept
 {
     StopTimer();
 
-    _VisualisationStream.release();
-
     _FileWatcher.Stop();
 
+    _WaveformGenerator.Stop();
+
+    _UIElementTracker.GetTrackAnalysisPool().Cancel(m_hWnd);
+
+    ClearPlaylistEvents();
+
     DeleteWebView();
 
     _HostObject = nullptr;
@@ -110,18 +170,29 @@ void UIElement::OnDestroy() noexcept
     _UIElementTracker.Remove(this);
 }
 
+/// <summary>
+/// Handles the WM_TIMER message.
+/// </summary>
+void UIElement::OnWindowTimer(UINT_PTR timerId) noexcept
+{
+    if (timerId == PlaylistEventTimerId)
+        FlushPlaylistEvents(false);
+}
+
 /// <summary>
 /// Handles the WM_SIZE message.
 /// </summary>
 void UIElement::OnSize(UINT type, CSize size) noexcept
 {
-    if (_Controller == nullptr)
-        return;
-
     RECT Bounds;
 
     GetClientRect(&Bounds);
 
+    _ClientWidth = (uint32_t) std::max(Bounds.right - Bounds.left, 0L);
+
+    if (_Controller == nullptr)
+        return;
+
     _Controller->put_Bounds(Bounds);
 }
 
@@ -245,6 +316,34 @@ LRESULT UIElement::OnAsync(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
     return true;
 }
 
+/// <summary>
+/// Handles the completion of a waveform request.
+/// </summary>
+LRESULT UIElement::OnWaveformReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    auto Result = _WaveformGenerator.GetResult();
+
+    if (Result != nullptr)
+        PostWaveform(*Result);
+
+    return 0;
+}
+
+/// <summary>
+/// Handles the completion of one or more track analysis requests.
+/// </summary>
+LRESULT UIElement::OnAnalysisReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    _AnalysisResults.clear();
+
+    _UIElementTracker.GetTrackAnalysisPool().GetResults(m_hWnd, _AnalysisResults);
+
+    for (const auto & Result : _AnalysisResults)
+        PostAnalysis(Result);
+
+    return 0;
+}
+
 /// <summary>
 /// Handles a change of the user interface colors.
 /// </summary>
@@ -441,23 +540,50 @@ void UIElement::on_playback_starting(play_control::t_track_command command, bool
     if (command == play_control::t_track_command::track_command_settrack) CommandName = L"Set track"; else  // For internal use only, do not use.
     if (command == play_control::t_track_command::track_command_resume) CommandName = L"Resume";            // For internal use only, do not use.
 
-    const std::wstring Script = ::FormatText(L"onPlaybackStarting(\"%s\", %s)", CommandName, (paused ? L"true" : L"false"));
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"Command\":\"%s\",\"IsPaused\":%s}", CommandName, (paused ? L"true" : L"false"));
+
+    PostEvent(ScriptEvent::PlaybackStarting, _ScriptBuffer);
+
+    playback_state_t State = GetPlaybackState();
+
+    State.Flags = playback_state_t::Playing | (paused ? playback_state_t::Paused : 0);
 
-    ExecuteScript(Script);
+    PostPlaybackState(State);
 }
 
 /// <summary>
 /// Called when playback advances to a new track.
 /// </summary>
-void UIElement::on_playback_new_track(metadb_handle_ptr /*track*/)
+void UIElement::on_playback_new_track(metadb_handle_ptr track)
 {
-    const std::wstring Script = L"onPlaybackNewTrack()";
+    PostEvent(ScriptEvent::PlaybackNewTrack, nullptr);
 
-    ExecuteScript(Script);
+    {
+        playback_state_t State = GetPlaybackState();
+
+        State.Length = track.is_valid() ? track->get_length() : 0.;
+        State.Flags |= playback_state_t::Playing;
+
+        PostPlaybackState(State);
+    }
+
+    if (_Configuration._WaveformEnabled && track.is_valid())
+        RequestWaveform(track->get_path(), track->get_subsong_index());
+
+    StopTimer(); // The playback state is also read by the frame scheduler.
 
     _LastPlaybackTime = 0.;
     _SampleRate = 44100; // Temporary until we get the sample rate from the chunk.
 
+    // The integrated loudness is measured per track.
+    if (track.is_valid())
+        _LoudnessMeter.Reset();
+
+    _MeterTime = 0.;
+    _NextWindow = -1;
+
+    _UIElementTracker.GetFrameProducer().Invalidate();
+
     StartTimer();
 }
 
@@ -469,6 +595,12 @@ void UIElement::on_playback_stop(play_control::t_stop_reason reason)
     StopTimer();
 
     _LastPlaybackTime = 0.;
+    _MeterTime = 0.;
+    _NextWindow = -1;
+
+    PostPlaybackState({ 0., _PlaybackState.Volume, 0, 0. });
+
+    _UIElementTracker.GetFrameProducer().Invalidate();
 
     static const wchar_t * Reason = L"unknown";
 
@@ -477,9 +609,9 @@ void UIElement::on_playback_stop(play_control::t_stop_reason reason)
     if (reason == play_control::t_stop_reason::stop_reason_starting_another)    Reason = L"Starting another"; else
     if (reason == play_control::t_stop_reason::stop_reason_shutting_down)       Reason = L"Shutting down";
 
-    const std::wstring Script = ::FormatText(L"onPlaybackStop(\"%s\")", Reason);
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"Reason\":\"%s\"}", Reason);
 
-    ExecuteScript(Script);
+    PostEvent(ScriptEvent::PlaybackStop, _ScriptBuffer);
 }
 
 /// <summary>
@@ -487,9 +619,19 @@ void UIElement::on_playback_stop(play_control::t_stop_reason reason)
 /// </summary>
 void UIElement::on_playback_seek(double time)
 {
-    const std::wstring Script = ::FormatText(L"onPlaybackSeek(%f)", time);
+    _IsSeekPending = true;
+
+    _UIElementTracker.GetFrameProducer().Invalidate();
+
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"Time\":%f}", time);
 
-    ExecuteScript(Script);
+    PostEvent(ScriptEvent::PlaybackSeek, _ScriptBuffer);
+
+    playback_state_t State = GetPlaybackState();
+
+    State.Position = time;
+
+    PostPlaybackState(State);
 }
 
 /// <summary>
@@ -497,9 +639,15 @@ void UIElement::on_playback_seek(double time)
 /// </summary>
 void UIElement::on_playback_pause(bool paused)
 {
-    const std::wstring Script = ::FormatText(L"onPlaybackPause(%s)", (paused ? L"true" : L"false"));
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"IsPaused\":%s}", (paused ? L"true" : L"false"));
+
+    PostEvent(ScriptEvent::PlaybackPause, _ScriptBuffer);
 
-    ExecuteScript(Script);
+    playback_state_t State = GetPlaybackState();
+
+    State.Flags = paused ? (State.Flags | playback_state_t::Paused) : (State.Flags & ~playback_state_t::Paused);
+
+    PostPlaybackState(State);
 }
 
 /// <summary>
@@ -507,9 +655,7 @@ void UIElement::on_playback_pause(bool paused)
 /// </summary>
 void UIElement::on_playback_edited(metadb_handle_ptr hTrack)
 {
-    const std::wstring Script = L"onPlaybackEdited()";
-
-    ExecuteScript(Script);
+    PostEvent(ScriptEvent::PlaybackEdited, nullptr);
 }
 
 /// <summary>
@@ -517,9 +663,7 @@ void UIElement::on_playback_edited(metadb_handle_ptr hTrack)
 /// </summary>
 void UIElement::on_playback_dynamic_info(const file_info & fileInfo)
 {
-    const std::wstring Script = L"onPlaybackDynamicInfo()";
-
-    ExecuteScript(Script);
+    PostEvent(ScriptEvent::PlaybackDynamicInfo, nullptr);
 }
 
 /// <summary>
@@ -527,9 +671,7 @@ void UIElement::on_playback_dynamic_info(const file_info & fileInfo)
 /// </summary>
 void UIElement::on_playback_dynamic_info_track(const file_info & fileInfo)
 {
-    const std::wstring Script = L"onPlaybackDynamicTrackInfo()";
-
-    ExecuteScript(Script);
+    PostEvent(ScriptEvent::PlaybackDynamicTrackInfo, nullptr);
 }
 
 /// <summary>
@@ -537,9 +679,12 @@ void UIElement::on_playback_dynamic_info_track(const file_info & fileInfo)
 /// </summary>
 void UIElement::on_playback_time(double time)
 {
-    const std::wstring Script = ::FormatText(L"onPlaybackTime(%f)", time);
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"Time\":%f}", time);
 
-    ExecuteScript(Script);
+    PostEvent(ScriptEvent::PlaybackTime, _ScriptBuffer);
+
+    // Re-anchor the clock so scripts that extrapolate the position follow the output device instead of drifting away.
+    PostPlaybackState(GetPlaybackState());
 }
 
 /// <summary>
@@ -547,9 +692,37 @@ void UIElement::on_playback_time(double time)
 /// </summary>
 void UIElement::on_volume_change(float newValue) // in dBFS
 {
-    const std::wstring Script = ::FormatText(L"onVolumeChange(%f)", (double) newValue);
+    ::swprintf_s(_ScriptBuffer, _countof(_ScriptBuffer), L"{\"Volume\":%f}", (double) newValue);
+
+    PostEvent(ScriptEvent::VolumeChange, _ScriptBuffer);
 
-    ExecuteScript(Script);
+    playback_state_t State = GetPlaybackState();
+
+    State.Volume = newValue;
+
+    PostPlaybackState(State);
 }
 
 #pragma endregion
+
+/// <summary>
+/// Posts an event to the script. The data is the JSON text of the payload or null. Returns false if the event could not be sent.
+/// </summary>
+bool UIElement::PostEvent(ScriptEvent event, const wchar_t * data) noexcept
+{
+    if (_WebView == nullptr)
+        return false;
+
+    try
+    {
+        _EventBus.SetLimit(_Configuration._EventLimit);
+
+        return _EventBus.Post((size_t) event, ::GetTimestamp(), data);
+    }
+    catch (const std::exception & e)
+    {
+        console::printf(STR_COMPONENT_BASENAME " failed to post event: %s", e.what());
+
+        return false;
+    }
+}
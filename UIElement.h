@@ -1,5 +1,5 @@
 
-/** $VER: UIElement.h (2024.12.02) P. Stuer **/
+/** $VER: UIElement.h (2026.10.16) P. Stuer **/
 
 #pragma once
 
@@ -27,9 +27,46 @@
 
 #include "HostObjectImpl.h"
 #include "SharedBuffer.h"
+#include "SpectrogramBuffer.h"
+#include "SpectrumAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "LevelMeter.h"
+#include "StereoAnalyzer.h"
+#include "OnsetDetector.h"
+#include "WaveformGenerator.h"
+#include "TrackAnalysisPool.h"
+#include "FrameScheduler.h"
+#include "FrameRecorder.h"
+#include "PooledChunk.h"
+#include "PlaylistEventQueue.h"
+#include "EventBus.h"
+
+#include <atomic>
+#include <mutex>
 
 using namespace Microsoft::WRL;
 
+/// <summary>
+/// Identifies the events that are sent to the script. Indexes the table of event kinds.
+/// </summary>
+enum class ScriptEvent : uint8_t
+{
+    Frame,
+    PlaybackStarting,
+    PlaybackNewTrack,
+    PlaybackStop,
+    PlaybackSeek,
+    PlaybackPause,
+    PlaybackEdited,
+    PlaybackDynamicInfo,
+    PlaybackDynamicTrackInfo,
+    PlaybackTime,
+    VolumeChange,
+    PlaybackClock,
+    Onsets,
+    Analysis,
+};
+
 /// <summary>
 /// Implements the UIElement and Playback interface.
 /// </summary>
@@ -100,13 +137,28 @@ public:
 
     void SetConfiguration(const configuration_t & configuration) noexcept
     {
+        // The frame scheduler reads the configuration on a thread pool thread.
+        const bool IsTimerRunning = _FrameScheduler.IsRunning();
+
+        StopTimer();
+
         _Configuration = configuration;
 
+        // Apply the new settings to the analyzers of the frame while the frame scheduler is stopped.
+        if (_AnalyzerFormat.SampleRate != 0)
+            InitializeAnalyzers(_AnalyzerFormat.SampleRate, _AnalyzerFormat.ChannelCount, _AnalyzerFormat.ChannelConfig);
+
         OnConfigurationChanged();
+
+        if (IsTimerRunning)
+            StartTimer();
     }
 
     #pragma endregion
 
+    void RequestWaveform(const char * path, uint32_t subsongIndex) noexcept;
+    int AnalyzeTrack(const char * path, uint32_t subsongIndex, uint32_t features) noexcept;
+
 protected:
     /// <summary>
     /// Retrieves the GUID of the element.
@@ -174,6 +226,15 @@ public:
 
 private:
     void ExecuteScript(const std::wstring & script) const noexcept;
+    bool PostEvent(ScriptEvent event, const wchar_t * data) noexcept;
+    void SchedulePlaylistEvents() noexcept;
+    void FlushPlaylistEvents(bool all) noexcept;
+    void PostPlaylistScript(const std::wstring & script) noexcept;
+    void ClearPlaylistEvents() noexcept;
+
+    bool SubscribePlaylistEvents(const wchar_t * handlerNames) noexcept;
+    void DetectPlaylistHandlers() noexcept;
+    void SetPlaylistFlags(t_uint32 flags) noexcept;
 
     #pragma region CWindowImpl
 
@@ -185,6 +246,11 @@ private:
     LRESULT OnTemplateChanged(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
     LRESULT OnWebViewReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
     LRESULT OnAsync(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    LRESULT OnWaveformReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    LRESULT OnFrameReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    LRESULT OnOnsets(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    LRESULT OnAnalysisReady(UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    void OnWindowTimer(UINT_PTR timerId) noexcept;
 
     BEGIN_MSG_MAP_EX(UIElement)
         MSG_WM_CREATE(OnCreate)
@@ -192,17 +258,32 @@ private:
         MSG_WM_SIZE(OnSize)
         MSG_WM_ERASEBKGND(OnEraseBackground)
         MSG_WM_PAINT(OnPaint)
+        MSG_WM_TIMER(OnWindowTimer)
 
         MESSAGE_HANDLER_EX(UM_TEMPLATE_CHANGED, OnTemplateChanged)
         MESSAGE_HANDLER_EX(UM_WEB_VIEW_READY, OnWebViewReady)
         MESSAGE_HANDLER_EX(UM_ASYNC, OnAsync)
+        MESSAGE_HANDLER_EX(UM_WAVEFORM_READY, OnWaveformReady)
+        MESSAGE_HANDLER_EX(UM_FRAME_READY, OnFrameReady)
+        MESSAGE_HANDLER_EX(UM_ONSETS, OnOnsets)
+        MESSAGE_HANDLER_EX(UM_ANALYSIS_READY, OnAnalysisReady)
     END_MSG_MAP()
 
     #pragma endregion
 
     void Initialize();
 
-    HRESULT PostChunk(const audio_sample * samples, size_t sampleCount, uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig) noexcept;
+    void InitializeAnalyzers(uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig) noexcept;
+    HRESULT PostChunk(const audio_sample * samples, size_t sampleCount, uint32_t sampleRate, uint32_t channelCount, uint32_t channelConfig, double playbackTime, const window_batch_t * batch) noexcept;
+    void PostSpectrum(const audio_sample * samples, size_t sampleCount, uint32_t channelCount) noexcept;
+    void PostSpectrogram(uint32_t sampleRate, uint32_t channelCount, double playbackTime) noexcept;
+    void UpdateMeters(double playbackTime) noexcept;
+    void PostOnsets(uint32_t sampleRate);
+    size_t GetEnvelopeBucketCount() const noexcept;
+
+    void PostWaveform(const waveform_result_t & result) noexcept;
+    void PostAnalysis(const analysis_result_t & result) noexcept;
+    std::wstring GetCacheDirectoryPath(const char * directoryName) const noexcept;
 
 private:
     bool GetWebViewVersion(std::wstring & versionInfo);
@@ -230,9 +311,21 @@ private:
     void StartTimer() noexcept;
     void StopTimer() noexcept;
 
-    static void CALLBACK TimerCallback(HWND unnamedParam1, UINT unnamedParam2, UINT_PTR unnamedParam3, DWORD unnamedParam4) noexcept;
+    double GetFrameRate() const noexcept;
+    std::wstring GetFrameStatistics() const noexcept;
+    void DumpFrameStatistics() const noexcept;
 
     void OnTimer() noexcept;
+    void RenderFrame() noexcept;
+    bool GetWindowBatch(double windowOffset, double windowSize, double hopSize, uint32_t sampleRate, window_batch_t & batch) noexcept;
+    bool UpdateIdleState(uint64_t tickTime, bool isSilent) noexcept;
+    void PostIdleFrame(double playbackTime) noexcept;
+    void PostFrameNotification() noexcept;
+    void EnsureSharedBuffer(const frame_layout_t & layout) noexcept;
+    playback_state_t GetPlaybackState() const noexcept;
+    void PostPlaybackState(const playback_state_t & state) noexcept;
+    void PostPlaybackClock() noexcept;
+    void EnsureSpectrogramBuffer(const spectrogram_layout_t & layout) noexcept;
 
 protected:
     configuration_t _Configuration;
@@ -253,23 +346,120 @@ private:
 
     EventRegistrationToken _NavigationStartingToken = {};
     EventRegistrationToken _NavigationCompletedToken = {};
+    EventRegistrationToken _WebMessageReceivedToken = {};
     EventRegistrationToken _FrameCreatedToken = {};
     EventRegistrationToken _ContextMenuRequestedToken = {};
     EventRegistrationToken _BrowserProcessExitedToken = {};
 
     wil::com_ptr<HostObject> _HostObject;
 
-    bool _IsNavigationCompleted;
+    std::atomic<bool> _IsNavigationCompleted;
 
     FileWatcher _FileWatcher;
 
-    PTP_TIMER _ThreadPoolTimer;
-    bool _IsFrozen;
-    bool _IsHidden;
+    FrameScheduler _FrameScheduler;
+    std::atomic<bool> _IsFrozen;                    // Read by the frame scheduler on a thread pool thread.
+    std::atomic<bool> _IsHidden;                    // Read by the frame scheduler on a thread pool thread.
+    std::atomic<uint32_t> _ClientWidth;             // Width of the client area, in pixels. Updated on WM_SIZE so the frame scheduler does not have to query the window.
 
-    visualisation_stream_v2::ptr _VisualisationStream;
     double _LastPlaybackTime;
     uint32_t _SampleRate;
 
+    /// <summary>
+    /// Describes the last frame written to the shared buffer.
+    /// </summary>
+    struct frame_info_t
+    {
+        size_t SampleCount;
+        uint32_t SampleRate;
+        uint32_t ChannelCount;
+        uint32_t ChannelConfig;
+    };
+
+    mutable std::mutex _FrameLock;                          // Protects the shared buffer and the frame info. The buffer is allocated on the UI thread and written on a thread pool thread.
     SharedBuffer _SharedBuffer;
+    frame_info_t _FrameInfo;
+    std::atomic<bool> _IsFrameNotificationPending;  // Coalesces the onTimer() notifications when the UI thread falls behind.
+    std::atomic<bool> _IsBufferRequestPending;      // Set while the UI thread (re)allocates the shared buffer.
+
+    SpectrogramBuffer _SpectrogramBuffer;           // Ring of the most recent spectrum frames. Also protected by _FrameLock.
+    playback_state_t _PlaybackState;                // State of the player. Only changed on the UI thread. Also protected by _FrameLock.
+    std::atomic<bool> _IsSpectrogramRequestPending; // Set while the UI thread (re)allocates the spectrogram buffer.
+
+    FrameRecorder _FrameRecorder;                   // Latency histograms of the frame pipeline of this panel
+    std::atomic<uint64_t> _FrameReadyTime;          // Time the last frame was written to the shared buffer, in us
+
+    PooledChunk _FrameChunk;                        // Window of the current frame. Reused for every frame.
+
+    int64_t _NextWindow;                            // Absolute position of the first window of the next batch, in samples. -1 = restart at the next frame.
+    std::atomic<bool> _IsSeekPending;               // Set by a seek on the UI thread. The frame tick owns the window and meter state and restarts both when it consumes the flag.
+    uint64_t _WindowNumber;                         // Number of the next window
+    int64_t _WindowSamples;                         // Window size of the current sequence, in samples
+    int64_t _HopSamples;                            // Hop size of the current sequence, in samples
+
+    static constexpr int64_t MaxWindowCount = 64;   // Largest number of windows in one batch. Longer gaps start a new sequence.
+
+    uint64_t _SilenceStart;                         // Time the signal became silent or playback stopped advancing, in us. 0 = not silent.
+    bool _IsIdle;                                   // Set after the final silent frame was sent. No frames are delivered until the signal returns.
+
+    wchar_t _ScriptBuffer[256];                     // Formats the script calls and messages of the UI thread without a temporary string
+
+    SpectrumAnalyzer _SpectrumAnalyzer;
+    StereoAnalyzer _StereoAnalyzer;
+
+    struct
+    {
+        uint32_t SampleRate;
+        uint32_t ChannelCount;
+        uint32_t ChannelConfig;
+    } _AnalyzerFormat;                              // Format of the chunks the spectrum and stereo analyzers were initialized for. A sample rate of 0 = not initialized yet.
+
+    LoudnessMeter _LoudnessMeter;
+    LevelMeter _LevelMeter;
+    PooledChunk _MeterChunk;
+    double _MeterTime;                                      // Absolute playback time up to which the samples were fed to the meters, in seconds. 0 = restart at the next frame.
+
+    static constexpr double MaxMeterGap = 1.;               // Longest interval, in seconds, that is measured in one step. Longer gaps restart the continuous measurement.
+
+    /// <summary>
+    /// Describes an onset or beat waiting to be posted to the script.
+    /// </summary>
+    struct onset_info_t
+    {
+        OnsetType Type;
+        double Time;                                        // Absolute playback time, in seconds
+        float Strength;
+        float Confidence;
+        float Tempo;                                        // in BPM
+    };
+
+    OnsetDetector _OnsetDetector;
+    std::vector<onset_event_t> _OnsetEvents;                // Events detected in the current chunk
+    double _OnsetTime;                                      // Absolute playback time of position 0 of the onset detector, in seconds. Negative = restart at the next chunk.
+
+    std::mutex _OnsetLock;                                  // Protects the pending onsets. They are added on a thread pool thread and posted on the UI thread.
+    std::vector<onset_info_t> _PendingOnsets;
+    std::vector<onset_info_t> _PostedOnsets;                // Only used on the UI thread. Swapped with the pending onsets so neither list allocates in steady state.
+    std::wstring _OnsetMessage;
+    std::atomic<bool> _IsOnsetNotificationPending;          // Coalesces the onset notifications when the UI thread falls behind.
+
+    static constexpr size_t MaxPendingOnsets = 256;         // The oldest events are dropped when the UI thread falls that far behind.
+
+    static constexpr size_t MaxEnvelopeBuckets = 16384;
+
+    WaveformGenerator _WaveformGenerator;
+
+    static constexpr uint32_t WaveformBucketCount = 4096;
+
+    int _AnalysisId;                                        // Id of the last track analysis request
+    std::vector<analysis_result_t> _AnalysisResults;
+
+    PlaylistEventQueue _PlaylistEvents;                     // Playlist callbacks that are dispatched to the script once per frame
+    bool _IsPlaylistFlushPending;                           // Set while the flush timer runs
+    t_uint32 _PlaylistFlags;                                // Playlist callbacks the panel is registered for
+    bool _HasPlaylistSubscription;                          // Set when the script declared its handlers with subscribePlaylistEvents()
+
+    static constexpr UINT_PTR PlaylistEventTimerId = 1;
+
+    EventBus _EventBus;                                     // Sends the playback, frame and analysis events to the script. Only used on the UI thread.
 };
@@ -1,5 +1,5 @@
 
-/** $VER: UIElementPlaylistCallback.cpp (2024.12.02) P. Stuer **/
+/** $VER: UIElementPlaylistCallback.cpp (2026.10.16) P. Stuer **/
 
 #include "pch.h"
 
@@ -15,18 +15,50 @@
 
 #pragma hdrstop
 
+/// <summary>
+/// Maps the playlist event handlers of the script to the playlist callbacks that call them.
+/// </summary>
+static const struct { const wchar_t * Name; t_uint32 Flag; } PlaylistHandlers[] =
+{
+    { L"onPlaylistItemsAdded",                  playlist_callback::flag_on_items_added },
+    { L"onPlaylistItemsAddedBegin",             playlist_callback::flag_on_items_added },
+    { L"onPlaylistItemsAddedEnd",               playlist_callback::flag_on_items_added },
+    { L"onPlaylistItemsReordered",              playlist_callback::flag_on_items_reordered },
+    { L"onPlaylistItemsRemoving",               playlist_callback::flag_on_items_removing },
+    { L"onPlaylistItemsRemoved",                playlist_callback::flag_on_items_removed },
+    { L"onPlaylistSelectedItemsChanged",        playlist_callback::flag_on_items_selection_change },
+    { L"onPlaylistFocusedItemChanged",          playlist_callback::flag_on_item_focus_change },
+    { L"onPlaylistItemsModified",               playlist_callback::flag_on_items_modified },
+    { L"onPlaylistItemsModifiedFromPlayback",   playlist_callback::flag_on_items_modified_fromplayback },
+    { L"onPlaylistItemsReplaced",               playlist_callback::flag_on_items_replaced },
+    { L"onPlaylistItemEnsureVisible",           playlist_callback::flag_on_item_ensure_visible },
+    { L"onPlaylistActivated",                   playlist_callback::flag_on_playlist_activate },
+    { L"onPlaylistCreated",                     playlist_callback::flag_on_playlist_created },
+    { L"onPlaylistsReordered",                  playlist_callback::flag_on_playlists_reorder },
+    { L"onPlaylistsRemoving",                   playlist_callback::flag_on_playlists_removing },
+    { L"onPlaylistsRemoved",                    playlist_callback::flag_on_playlists_removed },
+    { L"onPlaylistRenamed",                     playlist_callback::flag_on_playlist_renamed },
+    { L"onPlaylistLocked",                      playlist_callback::flag_on_playlist_locked },
+    { L"onPlaylistUnlocked",                    playlist_callback::flag_on_playlist_locked },
+    { L"onDefaultFormatChanged",                playlist_callback::flag_on_default_format_changed },
+    { L"onPlaybackOrderChanged",                playlist_callback::flag_on_playback_order_changed },
+};
+
 #pragma region playlist_callback
 
 /// <summary>
-/// Called when items have been added to the specified playlist.
+/// Called when items have been added to the specified playlist. The first page of items is delivered immediately if nothing else is queued, the other pages on the following frames.
 /// </summary>
 void UIElement::on_items_added(t_size playlistIndex, t_size startIndex, metadb_handle_list_cref data, const bit_array & selection)
 {
-    const std::wstring Text = Stringify(ToJSON(data));
+    const bool IsIdle = _PlaylistEvents.IsEmpty();
 
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsAdded(%d, %d, \"%s\")", (int) playlistIndex, (int) startIndex, Text.c_str());
+    _PlaylistEvents.AddItems(playlistIndex, startIndex, data);
 
-    ExecuteScript(Script);
+    if (IsIdle)
+        FlushPlaylistEvents(false);
+    else
+        SchedulePlaylistEvents();
 }
 
 /// <summary>
@@ -34,11 +66,9 @@ void UIElement::on_items_added(t_size playlistIndex, t_size startIndex, metadb_h
 /// </summary>
 void UIElement::on_items_reordered(t_size playlistIndex, const t_size * itemOrder, t_size itemCount)
 {
-    const std::wstring Text = ToJSON(itemOrder, itemCount);
-
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsReordered(%d, \"%s\")", (int) playlistIndex, Text.c_str());
+    _PlaylistEvents.AddReorder(playlistIndex, itemOrder, itemCount);
 
-    ExecuteScript(Script);
+    SchedulePlaylistEvents();
 }
 
 /// <summary>
@@ -46,11 +76,11 @@ void UIElement::on_items_reordered(t_size playlistIndex, const t_size * itemOrde
 /// </summary>
 void UIElement::on_items_removing(t_size playlistIndex, const bit_array & mask, t_size oldCount, t_size newCount)
 {
-    const std::wstring Text = ToJSON(mask, oldCount);
+    const std::wstring Text = Stringify(ToJSON(mask, oldCount));
 
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsRemoving(%d, \"%s\", %d)", (int) playlistIndex, Text.c_str(), (int) newCount);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistItemsRemoving === \"function\") && onPlaylistItemsRemoving(%d, \"%s\", %d)", (int) playlistIndex, Text.c_str(), (int) newCount);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -58,11 +88,11 @@ void UIElement::on_items_removing(t_size playlistIndex, const bit_array & mask,
 /// </summary>
 void UIElement::on_items_removed(t_size playlistIndex, const bit_array & mask, t_size oldCount, t_size newCount)
 {
-    const std::wstring Text = ToJSON(mask, oldCount);
+    const std::wstring Text = Stringify(ToJSON(mask, oldCount));
 
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsRemoved(%d, \"%s\", %d)", (int) playlistIndex, Text.c_str(), (int) newCount);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistItemsRemoved === \"function\") && onPlaylistItemsRemoved(%d, \"%s\", %d)", (int) playlistIndex, Text.c_str(), (int) newCount);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -70,13 +100,11 @@ void UIElement::on_items_removed(t_size playlistIndex, const bit_array & mask, t
 /// </summary>
 void UIElement::on_items_modified(t_size playlistIndex, const bit_array & mask)
 {
-    t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
+    const t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
 
-    const std::wstring Text = ToJSON(mask, ItemCount);
+    _PlaylistEvents.Add(PlaylistEventType::ItemsModified, playlistIndex, mask, ItemCount);
 
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsModified(%d, \"%s\")", (int) playlistIndex, Text.c_str());
-
-    ExecuteScript(Script);
+    SchedulePlaylistEvents();
 }
 
 /// <summary>
@@ -84,13 +112,11 @@ void UIElement::on_items_modified(t_size playlistIndex, const bit_array & mask)
 /// </summary>
 void UIElement::on_items_modified_fromplayback(t_size playlistIndex, const bit_array & mask, play_control::t_display_level displayLevel)
 {
-    t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
-
-    const std::wstring Text = ToJSON(mask, ItemCount);
+    const t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
 
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsModifiedFromPlayback(%d, \"%s\")", (int) playlistIndex, Text.c_str());
+    _PlaylistEvents.Add(PlaylistEventType::ItemsModifiedFromPlayback, playlistIndex, mask, ItemCount);
 
-    ExecuteScript(Script);
+    SchedulePlaylistEvents();
 }
 
 /// <summary>
@@ -100,11 +126,11 @@ void UIElement::on_items_replaced(t_size playlistIndex, const bit_array & mask,
 {
     t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
 
-    const std::wstring Text = ToJSON(mask, ItemCount);
+    const std::wstring Text = Stringify(ToJSON(mask, ItemCount));
 
-    const std::wstring Script = ::FormatText(L"onPlaylistItemsReplaced(%d, \"%s\")", (int) playlistIndex, Text.c_str());
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistItemsReplaced === \"function\") && onPlaylistItemsReplaced(%d, \"%s\")", (int) playlistIndex, Text.c_str());
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -112,9 +138,9 @@ void UIElement::on_items_replaced(t_size playlistIndex, const bit_array & mask,
 /// </summary>
 void UIElement::on_item_ensure_visible(t_size playlistIndex, t_size itemIndex)
 {
-    const std::wstring Script = ::FormatText(L"onPlaylistItemEnsureVisible(%d, %d)", (int) playlistIndex, (int) itemIndex);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistItemEnsureVisible === \"function\") && onPlaylistItemEnsureVisible(%d, %d)", (int) playlistIndex, (int) itemIndex);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -122,9 +148,9 @@ void UIElement::on_item_ensure_visible(t_size playlistIndex, t_size itemIndex)
 /// </summary>
 void UIElement::on_playlist_created(t_size playlistIndex, const char * name, t_size size)
 {
-    const std::wstring Script = ::FormatText(L"onPlaylistCreated(%d, \"%s\")", (int) playlistIndex, ::UTF8ToWide(name, size).c_str());
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistCreated === \"function\") && onPlaylistCreated(%d, \"%s\")", (int) playlistIndex, ::UTF8ToWide(name, size).c_str());
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -132,9 +158,9 @@ void UIElement::on_playlist_created(t_size playlistIndex, const char * name, t_s
 /// </summary>
 void UIElement::on_playlist_renamed(t_size playlistIndex, const char * name, t_size size)
 {
-    const std::wstring Script = ::FormatText(L"onPlaylistRenamed(%d, \"%s\")", (int) playlistIndex, ::UTF8ToWide(name, size).c_str());
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistRenamed === \"function\") && onPlaylistRenamed(%d, \"%s\")", (int) playlistIndex, ::UTF8ToWide(name, size).c_str());
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -142,9 +168,9 @@ void UIElement::on_playlist_renamed(t_size playlistIndex, const char * name, t_s
 /// </summary>
 void UIElement::on_playlist_activate(t_size oldPlaylistIndex, t_size newPlaylistIndex)
 {
-    const std::wstring Script = ::FormatText(L"onPlaylistActivated(%d, %d)", (int) oldPlaylistIndex, (int) newPlaylistIndex);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistActivated === \"function\") && onPlaylistActivated(%d, %d)", (int) oldPlaylistIndex, (int) newPlaylistIndex);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -152,9 +178,9 @@ void UIElement::on_playlist_activate(t_size oldPlaylistIndex, t_size newPlaylist
 /// </summary>
 void UIElement::on_playlist_locked(t_size playlistIndex, bool isLocked)
 {
-    const std::wstring Script = ::FormatText(isLocked ? L"onPlaylistLocked(%d)" : L"onPlaylistUnlocked(%d)", (int) playlistIndex);
+    const std::wstring Script = ::FormatText(isLocked ? L"(typeof onPlaylistLocked === \"function\") && onPlaylistLocked(%d)" : L"(typeof onPlaylistUnlocked === \"function\") && onPlaylistUnlocked(%d)", (int) playlistIndex);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -162,13 +188,11 @@ void UIElement::on_playlist_locked(t_size playlistIndex, bool isLocked)
 /// </summary>
 void UIElement::on_items_selection_change(t_size playlistIndex, const bit_array & affectedItems, const bit_array & state)
 {
-    t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
-
-    const std::wstring Text = ToJSON(affectedItems, ItemCount);
+    const t_size ItemCount = playlist_manager_v4::get()->playlist_get_item_count(playlistIndex);
 
-    const std::wstring Script = ::FormatText(L"onPlaylistSelectedItemsChanged(%d, \"%s\")", (int) playlistIndex, Text.c_str());
+    _PlaylistEvents.Add(PlaylistEventType::ItemsSelectionChange, playlistIndex, affectedItems, ItemCount);
 
-    ExecuteScript(Script);
+    SchedulePlaylistEvents();
 }
 
 /// <summary>
@@ -176,9 +200,9 @@ void UIElement::on_items_selection_change(t_size playlistIndex, const bit_array
 /// </summary>
 void UIElement::on_item_focus_change(t_size playlistIndex, t_size fromIndex, t_size toIndex)
 {
-    const std::wstring Script = ::FormatText(L"onPlaylistFocusedItemChanged(%d, %d, %d)", (int) playlistIndex, (int) fromIndex, (int) toIndex);
+    _PlaylistEvents.AddFocusChange(playlistIndex, fromIndex, toIndex);
 
-    ExecuteScript(Script);
+    SchedulePlaylistEvents();
 }
 
 /// <summary>
@@ -188,9 +212,9 @@ void UIElement::on_playlists_reorder(const t_size * playlistOrder, t_size playli
 {
     const std::wstring Text = ToJSON(playlistOrder, playlistCount);
 
-    const std::wstring Script = ::FormatText(L"onPlaylistsReordered(\"%s\")", Text.c_str());
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistsReordered === \"function\") && onPlaylistsReordered(\"%s\")", Text.c_str());
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -198,11 +222,11 @@ void UIElement::on_playlists_reorder(const t_size * playlistOrder, t_size playli
 /// </summary>
 void UIElement::on_playlists_removing(const bit_array & mask, t_size oldCount, t_size newCount)
 {
-    const std::wstring Text = ToJSON(mask, oldCount);
+    const std::wstring Text = Stringify(ToJSON(mask, oldCount));
 
-    const std::wstring Script = ::FormatText(L"onPlaylistsRemoving(\"%s\", %d)", Text.c_str(), (int) newCount);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistsRemoving === \"function\") && onPlaylistsRemoving(\"%s\", %d)", Text.c_str(), (int) newCount);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -210,11 +234,11 @@ void UIElement::on_playlists_removing(const bit_array & mask, t_size oldCount, t
 /// </summary>
 void UIElement::on_playlists_removed(const bit_array & mask, t_size oldCount, t_size newCount)
 {
-    const std::wstring Text = ToJSON(mask, oldCount);
+    const std::wstring Text = Stringify(ToJSON(mask, oldCount));
 
-    const std::wstring Script = ::FormatText(L"onPlaylistsRemoved(\"%s\", %d)", Text.c_str(), (int) newCount);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaylistsRemoved === \"function\") && onPlaylistsRemoved(\"%s\", %d)", Text.c_str(), (int) newCount);
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -222,9 +246,9 @@ void UIElement::on_playlists_removed(const bit_array & mask, t_size oldCount, t_
 /// </summary>
 void UIElement::on_default_format_changed()
 {
-    const std::wstring Script = L"onDefaultFormatChanged()";
+    const std::wstring Script = L"(typeof onDefaultFormatChanged === \"function\") && onDefaultFormatChanged()";
 
-    ExecuteScript(Script);
+    PostPlaylistScript(Script);
 }
 
 /// <summary>
@@ -232,9 +256,184 @@ void UIElement::on_default_format_changed()
 /// </summary>
 void UIElement::on_playback_order_changed(t_size playbackOrderIndex)
 {
-    const std::wstring Script = ::FormatText(L"onPlaybackOrderChanged(%d)", (int) playbackOrderIndex);
+    const std::wstring Script = ::FormatText(L"(typeof onPlaybackOrderChanged === \"function\") && onPlaybackOrderChanged(%d)", (int) playbackOrderIndex);
+
+    PostPlaylistScript(Script);
+}
+
+/// <summary>
+/// Starts the timer that dispatches the queued playlist events at the end of the current frame, if it is not running yet.
+/// </summary>
+void UIElement::SchedulePlaylistEvents() noexcept
+{
+    if (_IsPlaylistFlushPending)
+        return;
+
+    const UINT Delay = (UINT) std::max(std::lround(1000. / GetFrameRate()), 1L);
+
+    _IsPlaylistFlushPending = (SetTimer(PlaylistEventTimerId, Delay) != 0);
+
+    // Dispatch immediately when no timer is available.
+    if (!_IsPlaylistFlushPending)
+        FlushPlaylistEvents(true);
+}
+
+/// <summary>
+/// Calls the event handler of a playlist callback that cannot be merged. The call is queued behind the pending events, f.e. the remaining pages of added items, so the script sees the events in order.
+/// </summary>
+void UIElement::PostPlaylistScript(const std::wstring & script) noexcept
+{
+    if (_PlaylistEvents.IsEmpty())
+    {
+        ExecuteScript(script);
+
+        return;
+    }
+
+    _PlaylistEvents.AddScript(script);
+
+    SchedulePlaylistEvents();
+}
+
+/// <summary>
+/// Discards the queued playlist events f.e. when the page that would receive them goes away.
+/// </summary>
+void UIElement::ClearPlaylistEvents() noexcept
+{
+    if (_IsPlaylistFlushPending)
+    {
+        KillTimer(PlaylistEventTimerId);
+
+        _IsPlaylistFlushPending = false;
+    }
+
+    _PlaylistEvents.Clear();
+}
+
+/// <summary>
+/// Dispatches the queued playlist events to the script as one batch. Unless all events are required, at most one page of added items is dispatched and the remaining events follow on the next frame.
+/// </summary>
+void UIElement::FlushPlaylistEvents(bool all) noexcept
+{
+    if (_IsPlaylistFlushPending)
+    {
+        KillTimer(PlaylistEventTimerId);
+
+        _IsPlaylistFlushPending = false;
+    }
+
+    if (_PlaylistEvents.IsEmpty())
+        return;
+
+    do
+    {
+        const std::wstring Script = _PlaylistEvents.ToScript();
+
+        ExecuteScript(Script);
+    }
+    while (all && !_PlaylistEvents.IsEmpty());
+
+    if (!_PlaylistEvents.IsEmpty())
+        SchedulePlaylistEvents();
+}
+
+/// <summary>
+/// Registers for the playlist callbacks of the specified handlers only. The handlers are a comma-separated list of names; "*" selects all handlers.
+/// Returns false if a name is unknown.
+/// </summary>
+bool UIElement::SubscribePlaylistEvents(const wchar_t * handlerNames) noexcept
+{
+    t_uint32 Flags = 0;
+
+    if (::wcscmp(handlerNames, L"*") == 0)
+        Flags = flag_all;
+    else
+    {
+        for (const wchar_t * Name = handlerNames; *Name != L'\0';)
+        {
+            const wchar_t * End = ::wcschr(Name, L',');
+
+            const size_t Length = (End != nullptr) ? (size_t) (End - Name) : ::wcslen(Name);
+
+            auto Iter = std::find_if(std::begin(PlaylistHandlers), std::end(PlaylistHandlers), [Name, Length](const auto & item) { return (::wcslen(item.Name) == Length) && (::wcsncmp(item.Name, Name, Length) == 0); });
+
+            if (Iter == std::end(PlaylistHandlers))
+                return false;
+
+            Flags |= Iter->Flag;
+
+            Name += Length + ((End != nullptr) ? 1 : 0);
+        }
+    }
+
+    _HasPlaylistSubscription = true;
+
+    SetPlaylistFlags(Flags);
+
+    return true;
+}
+
+/// <summary>
+/// Asks the script which playlist event handlers it defines and registers for their playlist callbacks only. Scripts that define no handlers cause no playlist work at all.
+/// </summary>
+void UIElement::DetectPlaylistHandlers() noexcept
+{
+    if (_WebView == nullptr)
+        return;
+
+    // The script returns a bit mask with a bit set for each handler in the table that is a function. The names are looked up in the global scope, not as window properties, so handlers declared with let or const are found too.
+    std::wstring Script = L"[";
+
+    for (const auto & Handler : PlaylistHandlers)
+    {
+        if (Script.size() > 1)
+            Script += L",";
+
+        Script += ::FormatText(L"(typeof %s === \"function\")", Handler.Name).c_str();
+    }
+
+    Script += L"].reduce((mask, isDefined, i) => isDefined ? (mask | (1 << i)) : mask, 0)";
+
+    HRESULT hr = _WebView->ExecuteScript(Script.c_str(), Microsoft::WRL::Callback<ICoreWebView2ExecuteScriptCompletedHandler>
+    (
+        [this](HRESULT errorCode, LPCWSTR resultObjectAsJson) -> HRESULT
+        {
+            // The script may have subscribed explicitly in the mean time.
+            if (!SUCCEEDED(errorCode) || (resultObjectAsJson == nullptr) || _HasPlaylistSubscription)
+                return S_OK;
+
+            const unsigned long Mask = ::wcstoul(resultObjectAsJson, nullptr, 10);
+
+            t_uint32 Flags = 0;
+
+            for (size_t i = 0; i < _countof(PlaylistHandlers); ++i)
+            {
+                if (Mask & (1UL << i))
+                    Flags |= PlaylistHandlers[i].Flag;
+            }
+
+            SetPlaylistFlags(Flags);
+
+            return S_OK;
+        }
+    ).Get());
+
+    if (!SUCCEEDED(hr))
+        console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to detect playlist event handlers").c_str());
+}
+
+/// <summary>
+/// Changes the playlist callbacks the panel is registered for.
+/// </summary>
+void UIElement::SetPlaylistFlags(t_uint32 flags) noexcept
+{
+    if (flags == _PlaylistFlags)
+        return;
+
+    // The events that were queued under the old registration are still delivered.
+    playlist_manager::get()->modify_callback(this, flags);
 
-    ExecuteScript(Script);
+    _PlaylistFlags = flags;
 }
 
 /// <summary>
@@ -1,11 +1,13 @@
 
-/** $VER: UIElementTracker.h (2024.06.12) P. Stuer - Tracks the instances of the panel. **/
+/** $VER: UIElementTracker.h (2026.10.16) P. Stuer - Tracks the instances of the panel. **/
 
 #pragma once
 
 #include "framework.h"
 
 #include "UIElement.h"
+#include "FrameProducer.h"
+#include "TrackAnalysisPool.h"
 
 class uielement_tracker_t
 {
@@ -18,6 +20,8 @@ public:
     {
         _UIElements.push_back(element);
 
+        _FrameProducer.Subscribe(element);
+
         SetCurrentElement(element);
     }
 
@@ -29,6 +33,12 @@ public:
         {
             _UIElements.erase(Iter); 
 
+            _FrameProducer.Unsubscribe(element);
+
+            // Stop the worker threads while the SDK services are still available.
+            if (_UIElements.empty())
+                _TrackAnalysisPool.Stop();
+
             SetCurrentElement(nullptr);
         }
     }
@@ -43,9 +53,27 @@ public:
         _CurrentUIElement = element;
     }
 
+    /// <summary>
+    /// Gets the producer that fetches the audio for all panels.
+    /// </summary>
+    FrameProducer & GetFrameProducer() noexcept
+    {
+        return _FrameProducer;
+    }
+
+    /// <summary>
+    /// Gets the pool that analyzes tracks for all panels.
+    /// </summary>
+    TrackAnalysisPool & GetTrackAnalysisPool() noexcept
+    {
+        return _TrackAnalysisPool;
+    }
+
 private:
     UIElement * _CurrentUIElement;
     std::vector<UIElement *> _UIElements;
+    FrameProducer _FrameProducer;
+    TrackAnalysisPool _TrackAnalysisPool;
 };
 
 extern uielement_tracker_t _UIElementTracker;
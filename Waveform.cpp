@@ -0,0 +1,241 @@
+
+/** $VER: Waveform.cpp (2026.10.16) P. Stuer - Builds and caches the min/max/RMS envelope of a whole track. Host-independent. **/
+
+#include "Waveform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+/// <summary>
+/// Prepares the builder for a new track.
+/// </summary>
+void WaveformBuilder::Initialize(uint32_t channelCount, uint32_t sampleRate, uint64_t expectedFrameCount, uint32_t bucketCount)
+{
+    _SourceChannelCount = channelCount;
+    _ChannelCount = std::min(channelCount, EnvelopeDecimator::MaxChannels);
+    _BucketCount = std::min(bucketCount, WaveformCache::MaxBucketCount);
+    _SampleRate = sampleRate;
+
+    _ExpectedFrameCount = expectedFrameCount;
+    _FrameCount = 0;
+
+    _Bucket = 0;
+    _BucketEnd = GetBucketEnd(0);
+    _BucketFrameCount = 0;
+
+    _Min.assign(_ChannelCount, std::numeric_limits<float>::max());
+    _Max.assign(_ChannelCount, std::numeric_limits<float>::lowest());
+    _Sum.assign(_ChannelCount, 0.);
+
+    _Envelopes.assign((size_t) _ChannelCount * _BucketCount, envelope_t());
+}
+
+/// <summary>
+/// Adds a chunk of interleaved 32-bit samples. Chunks with a different channel count than the first chunk are ignored.
+/// </summary>
+void WaveformBuilder::Process(const float * samples, size_t frameCount, uint32_t channelCount) noexcept
+{
+    ProcessInternal(samples, frameCount, channelCount);
+}
+
+/// <summary>
+/// Adds a chunk of interleaved 64-bit samples. Chunks with a different channel count than the first chunk are ignored.
+/// </summary>
+void WaveformBuilder::Process(const double * samples, size_t frameCount, uint32_t channelCount) noexcept
+{
+    ProcessInternal(samples, frameCount, channelCount);
+}
+
+/// <summary>
+/// Completes the envelope. Buckets beyond the end of a track that turned out shorter than expected remain silent.
+/// </summary>
+void WaveformBuilder::Finish(waveform_t & waveform)
+{
+    if ((_Bucket < _BucketCount) && (_BucketFrameCount != 0))
+        FlushBucket();
+
+    waveform.ChannelCount = _ChannelCount;
+    waveform.BucketCount  = _BucketCount;
+    waveform.SampleRate   = _SampleRate;
+    waveform.Duration     = (_SampleRate != 0) ? (double) _FrameCount / (double) _SampleRate : 0.;
+    waveform.Envelopes    = std::move(_Envelopes);
+
+    _BucketCount = 0;
+}
+
+/// <summary>
+/// Accumulates the frames bucket by bucket.
+/// </summary>
+template<typename T>
+void WaveformBuilder::ProcessInternal(const T * samples, size_t frameCount, uint32_t channelCount) noexcept
+{
+    if (!IsInitialized() || (channelCount != _SourceChannelCount))
+        return;
+
+    // Channels beyond the channels of the waveform are skipped.
+    const size_t SkippedCount = channelCount - _ChannelCount;
+
+    while (frameCount != 0)
+    {
+        // The last bucket absorbs the frames of a track that turned out longer than expected.
+        while ((_FrameCount >= _BucketEnd) && (_Bucket + 1 < _BucketCount))
+            FlushBucket();
+
+        const size_t n = (size_t) std::min((uint64_t) frameCount, _BucketEnd - _FrameCount);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (uint32_t Channel = 0; Channel < _ChannelCount; ++Channel)
+            {
+                const float Value = (float) *samples++;
+
+                _Min[Channel] = std::min(_Min[Channel], Value);
+                _Max[Channel] = std::max(_Max[Channel], Value);
+                _Sum[Channel] += (double) Value * (double) Value;
+            }
+
+            samples += SkippedCount;
+        }
+
+        frameCount        -= n;
+        _FrameCount       += n;
+        _BucketFrameCount += n;
+    }
+}
+
+/// <summary>
+/// Stores the envelope of the current bucket and starts the next one. A bucket without frames, which happens when the track has fewer frames than buckets, repeats the previous bucket.
+/// </summary>
+void WaveformBuilder::FlushBucket() noexcept
+{
+    for (uint32_t Channel = 0; Channel < _ChannelCount; ++Channel)
+    {
+        auto & Envelope = _Envelopes[((size_t) Channel * _BucketCount) + _Bucket];
+
+        if (_BucketFrameCount != 0)
+        {
+            Envelope.Min = _Min[Channel];
+            Envelope.Max = _Max[Channel];
+            Envelope.RMS = (float) std::sqrt(_Sum[Channel] / (double) _BucketFrameCount);
+        }
+        else
+        if (_Bucket != 0)
+            Envelope = (&Envelope)[-1];
+
+        _Min[Channel] = std::numeric_limits<float>::max();
+        _Max[Channel] = std::numeric_limits<float>::lowest();
+        _Sum[Channel] = 0.;
+    }
+
+    ++_Bucket;
+
+    _BucketEnd = GetBucketEnd(_Bucket);
+    _BucketFrameCount = 0;
+}
+
+/// <summary>
+/// Gets the index of the first frame after the specified bucket.
+/// </summary>
+uint64_t WaveformBuilder::GetBucketEnd(uint32_t bucket) const noexcept
+{
+    if (bucket + 1 >= _BucketCount)
+        return std::numeric_limits<uint64_t>::max();
+
+    return ((uint64_t) (bucket + 1) * _ExpectedFrameCount) / _BucketCount;
+}
+
+/// <summary>
+/// Gets the key that identifies the waveform of a track in the cache.
+/// </summary>
+std::string WaveformCache::GetKey(const char * path, uint32_t subsongIndex, uint64_t timestamp)
+{
+    char Text[48];
+
+    ::snprintf(Text, sizeof(Text), "|%u|%llu", subsongIndex, (unsigned long long) timestamp);
+
+    return std::string(path) + Text;
+}
+
+/// <summary>
+/// Gets the name of the cache file for the specified key. The name is the 64-bit FNV-1a hash of the key; collisions are detected by comparing the key stored in the file.
+/// Other caches that use the same key use a different extension.
+/// </summary>
+std::string WaveformCache::GetFileName(const std::string & key, const char * extension)
+{
+    uint64_t Hash = 0xCBF29CE484222325ull;
+
+    for (const char c : key)
+    {
+        Hash ^= (uint8_t) c;
+        Hash *= 0x100000001B3ull;
+    }
+
+    char FileName[48];
+
+    ::snprintf(FileName, sizeof(FileName), "%016llx.%.8s", (unsigned long long) Hash, extension);
+
+    return FileName;
+}
+
+/// <summary>
+/// Reads a waveform from a cache file. Returns false if the file is not a valid cache file or belongs to a different key.
+/// </summary>
+bool WaveformCache::Read(std::istream & stream, const std::string & key, waveform_t & waveform)
+{
+    waveform_file_header_t Header = { };
+
+    if (!stream.read((char *) &Header, sizeof(Header)))
+        return false;
+
+    if ((Header.Magic != waveform_file_header_t::CurrentMagic) || (Header.Version != waveform_file_header_t::CurrentVersion) || (Header.Size != sizeof(Header)))
+        return false;
+
+    if ((Header.ChannelCount == 0) || (Header.ChannelCount > EnvelopeDecimator::MaxChannels) || (Header.BucketCount == 0) || (Header.BucketCount > MaxBucketCount) || (Header.KeySize != key.size()))
+        return false;
+
+    std::string Key(Header.KeySize, '\0');
+
+    if (!stream.read(Key.data(), (std::streamsize) Key.size()) || (Key != key))
+        return false;
+
+    std::vector<envelope_t> Envelopes((size_t) Header.ChannelCount * Header.BucketCount);
+
+    if (!stream.read((char *) Envelopes.data(), (std::streamsize) (Envelopes.size() * sizeof(envelope_t))))
+        return false;
+
+    waveform.ChannelCount = Header.ChannelCount;
+    waveform.BucketCount  = Header.BucketCount;
+    waveform.SampleRate   = Header.SampleRate;
+    waveform.Duration     = Header.Duration;
+    waveform.Envelopes    = std::move(Envelopes);
+
+    return true;
+}
+
+/// <summary>
+/// Writes a waveform to a cache file.
+/// </summary>
+bool WaveformCache::Write(std::ostream & stream, const std::string & key, const waveform_t & waveform)
+{
+    if (waveform.Envelopes.size() != (size_t) waveform.ChannelCount * waveform.BucketCount)
+        return false;
+
+    waveform_file_header_t Header = { };
+
+    Header.Magic        = waveform_file_header_t::CurrentMagic;
+    Header.Version      = waveform_file_header_t::CurrentVersion;
+    Header.Size         = (uint16_t) sizeof(Header);
+    Header.ChannelCount = waveform.ChannelCount;
+    Header.BucketCount  = waveform.BucketCount;
+    Header.SampleRate   = waveform.SampleRate;
+    Header.KeySize      = (uint32_t) key.size();
+    Header.Duration     = waveform.Duration;
+
+    stream.write((const char *) &Header, sizeof(Header));
+    stream.write(key.data(), (std::streamsize) key.size());
+    stream.write((const char *) waveform.Envelopes.data(), (std::streamsize) (waveform.Envelopes.size() * sizeof(envelope_t)));
+
+    return stream.good();
+}
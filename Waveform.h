@@ -0,0 +1,114 @@
+
+/** $VER: Waveform.h (2026.10.16) P. Stuer - Builds and caches the min/max/RMS envelope of a whole track. Host-independent. **/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "EnvelopeDecimator.h"
+
+/// <summary>
+/// Represents the envelope of a whole track.
+/// </summary>
+struct waveform_t
+{
+    uint32_t ChannelCount;
+    uint32_t BucketCount;               // Number of buckets per channel
+    uint32_t SampleRate;                // in Hz
+    double Duration;                    // in seconds
+
+    std::vector<envelope_t> Envelopes;  // Channel by channel, BucketCount buckets per channel.
+};
+
+/// <summary>
+/// Builds the envelope of a track from consecutive chunks of decoded samples. Each bucket covers the same fraction of the expected length of the track.
+/// </summary>
+class WaveformBuilder
+{
+public:
+    WaveformBuilder() : _SourceChannelCount(), _ChannelCount(), _BucketCount(), _SampleRate(), _ExpectedFrameCount(), _FrameCount(), _Bucket(), _BucketEnd(), _BucketFrameCount() { }
+
+    void Initialize(uint32_t channelCount, uint32_t sampleRate, uint64_t expectedFrameCount, uint32_t bucketCount);
+
+    void Process(const float * samples, size_t frameCount, uint32_t channelCount) noexcept;
+    void Process(const double * samples, size_t frameCount, uint32_t channelCount) noexcept;
+
+    void Finish(waveform_t & waveform);
+
+    bool IsInitialized() const noexcept
+    {
+        return _BucketCount != 0;
+    }
+
+private:
+    template<typename T>
+    void ProcessInternal(const T * samples, size_t frameCount, uint32_t channelCount) noexcept;
+
+    void FlushBucket() noexcept;
+    uint64_t GetBucketEnd(uint32_t bucket) const noexcept;
+
+private:
+    uint32_t _SourceChannelCount;       // Number of channels of the track
+    uint32_t _ChannelCount;             // Number of channels in the waveform. Tracks with more than EnvelopeDecimator::MaxChannels channels only keep the first channels.
+    uint32_t _BucketCount;
+    uint32_t _SampleRate;
+
+    uint64_t _ExpectedFrameCount;
+    uint64_t _FrameCount;               // Number of frames processed so far
+
+    uint32_t _Bucket;                   // Index of the bucket being accumulated
+    uint64_t _BucketEnd;                // Index of the first frame of the next bucket
+    uint64_t _BucketFrameCount;         // Number of frames accumulated in the current bucket
+
+    std::vector<float> _Min;
+    std::vector<float> _Max;
+    std::vector<double> _Sum;
+
+    std::vector<envelope_t> _Envelopes;
+};
+
+#pragma pack(push, 8)
+
+/// <summary>
+/// Represents the header of a waveform cache file. The UTF-8 key and the envelopes follow the header.
+/// </summary>
+struct waveform_file_header_t
+{
+    uint32_t Magic;                     // 'FBWF'
+    uint16_t Version;
+    uint16_t Size;                      // Size of the header, in bytes.
+
+    uint32_t ChannelCount;
+    uint32_t BucketCount;
+    uint32_t SampleRate;
+    uint32_t KeySize;                   // Size of the key, in bytes.
+
+    double Duration;                    // in seconds
+
+    static const uint32_t CurrentMagic = 0x46574246; // 'FBWF' in little-endian byte order.
+    static const uint16_t CurrentVersion = 2; // Version 1 files of tracks with more channels than EnvelopeDecimator::MaxChannels contain silence.
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(waveform_file_header_t) == 32, "Unexpected waveform file header size");
+
+/// <summary>
+/// Reads and writes waveform cache files. A file is identified by a key built from the path, the subsong index and the timestamp of the track so a modified file is analyzed again.
+/// </summary>
+class WaveformCache
+{
+public:
+    static std::string GetKey(const char * path, uint32_t subsongIndex, uint64_t timestamp);
+    static std::string GetFileName(const std::string & key, const char * extension = "wfm");
+
+    static bool Read(std::istream & stream, const std::string & key, waveform_t & waveform);
+    static bool Write(std::ostream & stream, const std::string & key, const waveform_t & waveform);
+
+    static constexpr uint32_t MaxBucketCount = 65536;
+};
@@ -0,0 +1,210 @@
+
+/** $VER: WaveformGenerator.cpp (2026.10.16) P. Stuer - Generates the waveform of a whole track in the background. **/
+
+#include "pch.h"
+
+#include "WaveformGenerator.h"
+#include "Exceptions.h"
+#include "Encoding.h"
+#include "Resources.h"
+
+#include <SDK/input.h>
+
+#include <fstream>
+
+#include <shlobj.h>
+
+#pragma hdrstop
+
+/// <summary>
+/// Starts generating the waveform of the specified track. Cancels the request that is still in progress, if any.
+/// </summary>
+void WaveformGenerator::Start(HWND hWnd, const char * path, uint32_t subsongIndex, uint32_t bucketCount, const std::wstring & cacheDirectoryPath)
+{
+    Stop();
+
+    _ThreadParameters.This               = this;
+    _ThreadParameters.hWnd               = hWnd;
+    _ThreadParameters.Path               = path;
+    _ThreadParameters.SubsongIndex       = subsongIndex;
+    _ThreadParameters.BucketCount        = bucketCount;
+    _ThreadParameters.CacheDirectoryPath = cacheDirectoryPath;
+
+    _Abort.reset();
+
+    _hThread = ::CreateThread(nullptr, 0, ThreadProc, &_ThreadParameters, 0, nullptr);
+
+    if (_hThread == NULL)
+        throw Win32Exception(::GetLastError(), "Failed to create waveform generator thread");
+}
+
+/// <summary>
+/// Cancels the request in progress and waits for the worker thread to finish.
+/// </summary>
+void WaveformGenerator::Stop() noexcept
+{
+    if (_hThread != NULL)
+    {
+        _Abort.abort();
+
+        ::WaitForSingleObject(_hThread, INFINITE);
+
+        ::CloseHandle(_hThread);
+        _hThread = NULL;
+    }
+}
+
+/// <summary>
+/// Takes the result of the last completed request, if any.
+/// </summary>
+std::unique_ptr<waveform_result_t> WaveformGenerator::GetResult() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Lock);
+
+    return std::move(_Result);
+}
+
+/// <summary>
+/// Thread procedure
+/// </summary>
+DWORD WINAPI WaveformGenerator::ThreadProc(LPVOID lParam) noexcept
+{
+    auto Parameters = (WaveformGenerator::thread_parameters_t *) lParam;
+
+    if (Parameters == nullptr)
+        return 1;
+
+    auto Result = std::make_unique<waveform_result_t>();
+
+    Result->Path = Parameters->Path;
+    Result->SubsongIndex = Parameters->SubsongIndex;
+    Result->IsCached = false;
+
+    try
+    {
+        Parameters->This->Generate(*Result);
+    }
+    catch (const exception_aborted &)
+    {
+        return 0;
+    }
+    catch (const std::exception & e)
+    {
+        console::printf(STR_COMPONENT_BASENAME " failed to generate the waveform of \"%s\": %s", Parameters->Path.c_str(), e.what());
+
+        return 1;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Parameters->This->_Lock);
+
+        Parameters->This->_Result = std::move(Result);
+    }
+
+    ::PostMessageW(Parameters->hWnd, UM_WAVEFORM_READY, 0, 0);
+
+    return 0;
+}
+
+/// <summary>
+/// Reads the waveform from the cache or decodes the track to build it.
+/// </summary>
+void WaveformGenerator::Generate(waveform_result_t & result)
+{
+    const auto & Parameters = _ThreadParameters;
+
+    service_ptr_t<input_decoder> Decoder;
+
+    input_entry::g_open_for_decoding(Decoder, nullptr, Parameters.Path, _Abort);
+
+    // The timestamp is part of the key so a modified file is analyzed again.
+    const std::string Key = WaveformCache::GetKey(Parameters.Path, Parameters.SubsongIndex, Decoder->get_file_stats(_Abort).m_timestamp);
+
+    const std::wstring CacheFilePath = GetCacheFilePath(Key);
+
+    {
+        std::ifstream Stream(CacheFilePath, std::ios::binary);
+
+        if (Stream.is_open() && WaveformCache::Read(Stream, Key, result.Waveform) && (result.Waveform.BucketCount == Parameters.BucketCount))
+        {
+            result.IsCached = true;
+
+            return;
+        }
+    }
+
+    file_info_impl FileInfo;
+
+    Decoder->get_info(Parameters.SubsongIndex, FileInfo, _Abort);
+
+    const double Length = FileInfo.get_length(); // in seconds
+
+    if (Length <= 0.)
+        throw ComponentException("Track has no known length");
+
+    Decoder->initialize(Parameters.SubsongIndex, input_flag_no_seeking | input_flag_no_looping, _Abort);
+
+    WaveformBuilder Builder;
+    audio_chunk_impl Chunk;
+
+    while (Decoder->run(Chunk, _Abort))
+    {
+        // The sample rate and channel count of the first chunk determine the layout of the waveform.
+        if (!Builder.IsInitialized())
+            Builder.Initialize(Chunk.get_channel_count(), Chunk.get_sample_rate(), (uint64_t) ((Length * Chunk.get_sample_rate()) + 0.5), Parameters.BucketCount);
+
+        Builder.Process(Chunk.get_data(), Chunk.get_sample_count(), Chunk.get_channel_count());
+    }
+
+    if (!Builder.IsInitialized())
+        throw ComponentException("Track contains no samples");
+
+    Builder.Finish(result.Waveform);
+
+    const int ErrorCode = ::SHCreateDirectoryExW(NULL, Parameters.CacheDirectoryPath.c_str(), nullptr);
+
+    if ((ErrorCode != ERROR_SUCCESS) && (ErrorCode != ERROR_ALREADY_EXISTS))
+    {
+        console::print(::GetErrorMessage((DWORD) ErrorCode, ::FormatText(STR_COMPONENT_BASENAME " failed to create waveform cache directory \"%s\"", ::WideToUTF8(Parameters.CacheDirectoryPath).c_str())).c_str());
+
+        return;
+    }
+
+    // Write to a temporary file first so other instances never read a partially written cache file. The name is unique per thread because each panel generates the waveform of the new track.
+    const std::wstring TempFilePath = CacheFilePath + ::FormatText(L".%u.tmp", (unsigned) ::GetCurrentThreadId()).c_str();
+
+    bool Success;
+
+    {
+        std::ofstream Stream(TempFilePath, std::ios::binary | std::ios::trunc);
+
+        Success = Stream.is_open() && WaveformCache::Write(Stream, Key, result.Waveform);
+    }
+
+    if (Success)
+        Success = (::MoveFileExW(TempFilePath.c_str(), CacheFilePath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE);
+
+    if (!Success)
+    {
+        ::DeleteFileW(TempFilePath.c_str());
+
+        console::printf(STR_COMPONENT_BASENAME " failed to write waveform cache file \"%s\".", ::WideToUTF8(CacheFilePath).c_str());
+    }
+}
+
+/// <summary>
+/// Gets the path of the cache file for the specified key.
+/// </summary>
+std::wstring WaveformGenerator::GetCacheFilePath(const std::string & key) const
+{
+    wchar_t FilePath[MAX_PATH];
+
+    ::wcscpy_s(FilePath, _countof(FilePath), _ThreadParameters.CacheDirectoryPath.c_str());
+
+    HRESULT hr = ::PathCchAppend(FilePath, _countof(FilePath), ::UTF8ToWide(WaveformCache::GetFileName(key)).c_str());
+
+    if (!SUCCEEDED(hr))
+        throw Win32Exception(hr, "Failed to build waveform cache file path");
+
+    return FilePath;
+}
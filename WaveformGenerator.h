@@ -0,0 +1,71 @@
+
+/** $VER: WaveformGenerator.h (2026.10.16) P. Stuer - Generates the waveform of a whole track in the background. **/
+
+#pragma once
+
+#include "framework.h"
+
+#include <memory>
+#include <mutex>
+
+#include "Waveform.h"
+
+/// <summary>
+/// Represents the result of a waveform request.
+/// </summary>
+struct waveform_result_t
+{
+    pfc::string8 Path;
+    uint32_t SubsongIndex;
+    bool IsCached;                      // True if the waveform was read from the cache.
+
+    waveform_t Waveform;
+};
+
+/// <summary>
+/// Decodes a track on a worker thread and builds its waveform. Completed waveforms are cached on disk. Posts UM_WAVEFORM_READY to the window when a result is available.
+/// </summary>
+class WaveformGenerator
+{
+public:
+    WaveformGenerator() : _ThreadParameters(), _hThread() { }
+
+    WaveformGenerator(const WaveformGenerator &) = delete;
+    WaveformGenerator & operator=(const WaveformGenerator &) = delete;
+    WaveformGenerator(WaveformGenerator &&) = delete;
+    WaveformGenerator & operator=(WaveformGenerator &&) = delete;
+
+    virtual ~WaveformGenerator()
+    {
+        Stop();
+    }
+
+    void Start(HWND hWnd, const char * path, uint32_t subsongIndex, uint32_t bucketCount, const std::wstring & cacheDirectoryPath);
+    void Stop() noexcept;
+
+    std::unique_ptr<waveform_result_t> GetResult() noexcept;
+
+private:
+    static DWORD WINAPI ThreadProc(LPVOID lParam) noexcept;
+
+    void Generate(waveform_result_t & result);
+
+    std::wstring GetCacheFilePath(const std::string & key) const;
+
+    struct thread_parameters_t
+    {
+        WaveformGenerator * This;
+
+        HWND hWnd;
+        pfc::string8 Path;
+        uint32_t SubsongIndex;
+        uint32_t BucketCount;
+        std::wstring CacheDirectoryPath;
+    } _ThreadParameters;
+
+    HANDLE _hThread;
+    abort_callback_impl _Abort;
+
+    std::mutex _Lock;
+    std::unique_ptr<waveform_result_t> _Result;
+};
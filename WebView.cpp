@@ -1,5 +1,5 @@
 
-/** $VER: WebView.cpp (2024.11.20) P. Stuer - Creates the WebView. **/
+/** $VER: WebView.cpp (2026.10.16) P. Stuer - Creates the WebView. **/
 
 #include "pch.h"
 
@@ -17,6 +17,69 @@ using namespace Microsoft::WRL;
 static HRESULT CreateIconStream(const wchar_t * resourceName, wil::com_ptr<IStream> & stream);
 static std::string GetWebViewErrorMessage(COREWEBVIEW2_WEB_ERROR_STATUS status, const std::string & errorMessage) noexcept;
 
+/// <summary>
+/// Runs before the scripts of each page. Calls the classic event handlers of the template, f.e. onTimer(), for the events the host sends and acknowledges the processed events
+/// once all "message" event listeners of the page have run. The handlers are looked up by name in the global scope, like the host did when it called them with ExecuteScript(),
+/// so handlers declared with let or const at the top level of a script are found too.
+/// </summary>
+static const wchar_t * EventDispatcherScript = LR"(
+(() =>
+{
+    // The events are only sent to the top-level document.
+    if (window !== window.top)
+        return;
+
+    let Acknowledged = 0;
+    let IsAcknowledgePending = false;
+
+    window.chrome.webview.addEventListener("message", e =>
+    {
+        const Event = e.data;
+
+        if (!Event || (Event.Sequence === undefined))
+            return;
+
+        const Data = Event.Data;
+
+        try
+        {
+            switch (Event.Kind)
+            {
+                case "Frame":                       if (typeof onTimer === "function") onTimer(Data.SampleCount, Data.SampleRate, Data.ChannelCount, Data.ChannelConfig); break;
+                case "PlaybackStarting":            if (typeof onPlaybackStarting === "function") onPlaybackStarting(Data.Command, Data.IsPaused); break;
+                case "PlaybackNewTrack":            if (typeof onPlaybackNewTrack === "function") onPlaybackNewTrack(); break;
+                case "PlaybackStop":                if (typeof onPlaybackStop === "function") onPlaybackStop(Data.Reason); break;
+                case "PlaybackSeek":                if (typeof onPlaybackSeek === "function") onPlaybackSeek(Data.Time); break;
+                case "PlaybackPause":               if (typeof onPlaybackPause === "function") onPlaybackPause(Data.IsPaused); break;
+                case "PlaybackEdited":              if (typeof onPlaybackEdited === "function") onPlaybackEdited(); break;
+                case "PlaybackDynamicInfo":         if (typeof onPlaybackDynamicInfo === "function") onPlaybackDynamicInfo(); break;
+                case "PlaybackDynamicTrackInfo":    if (typeof onPlaybackDynamicTrackInfo === "function") onPlaybackDynamicTrackInfo(); break;
+                case "PlaybackTime":                if (typeof onPlaybackTime === "function") onPlaybackTime(Data.Time); break;
+                case "VolumeChange":                if (typeof onVolumeChange === "function") onVolumeChange(Data.Volume); break;
+            }
+        }
+        catch (ex)
+        {
+            console.error(ex);
+        }
+
+        Acknowledged = Math.max(Acknowledged, Event.Sequence);
+
+        if (IsAcknowledgePending)
+            return;
+
+        IsAcknowledgePending = true;
+
+        setTimeout(() =>
+        {
+            IsAcknowledgePending = false;
+
+            window.chrome.webview.postMessage({ Ack: Acknowledged });
+        }, 0);
+    });
+})();
+)";
+
 /// <summary>
 /// Returns true if a supported WebView version is available on this system.
 /// </summary>
@@ -240,6 +303,14 @@ HRESULT UIElement::CreateWebView()
                         (
                             [this](ICoreWebView2 * webView, ICoreWebView2NavigationStartingEventArgs * eventArgs) -> HRESULT
                             {
+                                // The new page declares its own playlist event handlers and acknowledges its own events.
+                                _HasPlaylistSubscription = false;
+
+                                _EventBus.Reset();
+
+                                ClearPlaylistEvents();
+                                SetPlaylistFlags(0);
+
                                 VARIANT RemoteObject = {};
 
                                 _HostObject.query_to<IDispatch>(&RemoteObject.pdispVal);
@@ -300,6 +371,12 @@ HRESULT UIElement::CreateWebView()
 
                                 _IsNavigationCompleted = true;
 
+                                // Give the script the current clock anchor; the next one is only posted when the player state changes.
+                                PostPlaybackClock();
+
+                                if (!_HasPlaylistSubscription)
+                                    DetectPlaylistHandlers();
+
                                 return S_OK;
                             }
                         ).Get(), &_NavigationCompletedToken);
@@ -308,6 +385,41 @@ HRESULT UIElement::CreateWebView()
                             console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to add NavigationCompleted event handler").c_str());
                     }
 
+                    // Add the script that dispatches the events of the host to the classic event handlers of the template.
+                    {
+                        hr = _WebView->AddScriptToExecuteOnDocumentCreated(EventDispatcherScript, nullptr);
+
+                        if (!SUCCEEDED(hr))
+                            console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to add event dispatcher script").c_str());
+                    }
+
+                    // Add an event handler to receive the acknowledgements of the events that the script has processed.
+                    {
+                        hr = _WebView->add_WebMessageReceived(Microsoft::WRL::Callback<ICoreWebView2WebMessageReceivedEventHandler>
+                        (
+                            [this](ICoreWebView2 * webView, ICoreWebView2WebMessageReceivedEventArgs * eventArgs) -> HRESULT
+                            {
+                                wil::unique_cotaskmem_string Message;
+
+                                HRESULT hr = eventArgs->get_WebMessageAsJson(&Message);
+
+                                if (!SUCCEEDED(hr))
+                                    return hr;
+
+                                // The acknowledgement of the event dispatcher script is {"Ack":sequence}. Other messages are ignored.
+                                uint64_t Sequence;
+
+                                if (EventBus::DecodeAcknowledgement(Message.get(), Sequence))
+                                    _EventBus.Acknowledge(Sequence);
+
+                                return S_OK;
+                            }
+                        ).Get(), &_WebMessageReceivedToken);
+
+                        if (!SUCCEEDED(hr))
+                            console::print(::GetErrorMessage(hr, STR_COMPONENT_BASENAME " failed to add WebMessageReceived event handler").c_str());
+                    }
+
                     // Add an event handler for the FrameCreated event. This handler can be used to add host objects to the created iframe.
                     {
                         wil::com_ptr<ICoreWebView2_4> WebView24 = _WebView.try_query<ICoreWebView2_4>();
@@ -475,6 +587,8 @@ void UIElement::DeleteWebView() noexcept
             if (WebView11 != nullptr)
                 WebView11->remove_ContextMenuRequested(_ContextMenuRequestedToken);
 
+            _WebView->remove_WebMessageReceived(_WebMessageReceivedToken);
+
             _WebView->remove_NavigationCompleted(_NavigationCompletedToken);
 
             _WebView->RemoveHostObjectFromScript(TEXT(STR_COMPONENT_BASENAME));
@@ -673,6 +787,32 @@ HRESULT UIElement::CreateContextMenu(const wchar_t * itemLabel, const wchar_t *
         }
 
         hr = Children->InsertValueAtIndex(0, ContextMenuItem.get());
+
+        if (!SUCCEEDED(hr))
+            return hr;
+
+        // Creates a menu item that writes the frame statistics to the console.
+        {
+            hr = Environment9->CreateContextMenuItem(L"Dump frame statistics", nullptr, COREWEBVIEW2_CONTEXT_MENU_ITEM_KIND_COMMAND, &ContextMenuItem);
+
+            if (!SUCCEEDED(hr))
+                return hr;
+
+            hr = ContextMenuItem->add_CustomItemSelected(Callback<ICoreWebView2CustomItemSelectedEventHandler>
+            (
+                [this](ICoreWebView2ContextMenuItem * sender, IUnknown * args)
+                {
+                    RunAsync([this] { DumpFrameStatistics(); });
+
+                    return S_OK;
+                }
+            ).Get(), nullptr);
+
+            if (!SUCCEEDED(hr))
+                return hr;
+        }
+
+        hr = Children->InsertValueAtIndex(1, ContextMenuItem.get());
     }
 
     return hr;